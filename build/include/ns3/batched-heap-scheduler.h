@@ -0,0 +1 @@
+#include "/root/repo/src/core/model/batched-heap-scheduler.h"
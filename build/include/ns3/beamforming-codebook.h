@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/beamforming-codebook.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/buildings/model/buildings-channel-condition-model.h"
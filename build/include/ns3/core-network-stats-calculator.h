@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/helper/core-network-stats-calculator.h"
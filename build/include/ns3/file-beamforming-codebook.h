@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/file-beamforming-codebook.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/mobility/model/geographic-positions.h"
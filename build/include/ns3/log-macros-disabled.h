@@ -0,0 +1 @@
+#include "/root/repo/src/core/model/log-macros-disabled.h"
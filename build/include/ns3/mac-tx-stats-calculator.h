@@ -0,0 +1 @@
+#include "/root/repo/src/lte/helper/mac-tx-stats-calculator.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/network/utils/mac16-address.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/mc-enb-pdcp.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/helper/mc-stats-calculator.h"
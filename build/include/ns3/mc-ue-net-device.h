@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mc-ue-net-device.h"
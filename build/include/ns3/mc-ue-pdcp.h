@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/mc-ue-pdcp.h"
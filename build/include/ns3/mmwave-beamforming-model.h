@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mmwave-beamforming-model.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mmwave-chunk-processor.h"
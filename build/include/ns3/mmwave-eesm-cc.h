@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/error-model/mmwave-eesm-cc.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/error-model/mmwave-eesm-error-model.h"
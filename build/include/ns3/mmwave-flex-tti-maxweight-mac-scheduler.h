@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mmwave-flex-tti-maxweight-mac-scheduler.h"
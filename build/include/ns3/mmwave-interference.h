@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mmwave-interference.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mmwave-lte-rrc-protocol-real.h"
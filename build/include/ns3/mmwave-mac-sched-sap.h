@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mmwave-mac-sched-sap.h"
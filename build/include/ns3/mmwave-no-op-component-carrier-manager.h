@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/model/mmwave-no-op-component-carrier-manager.h"
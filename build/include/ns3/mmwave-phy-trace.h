@@ -0,0 +1 @@
+#include "/root/repo/src/mmwave/helper/mmwave-phy-trace.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/buildings/model/oh-buildings-propagation-loss-model.h"
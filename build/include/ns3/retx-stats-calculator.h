@@ -0,0 +1 @@
+#include "/root/repo/src/lte/helper/retx-stats-calculator.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/rr-ff-mac-scheduler.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/applications/helper/three-gpp-http-helper.h"
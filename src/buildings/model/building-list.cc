@@ -28,6 +28,9 @@
 #include "ns3/object-vector.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 
@@ -77,6 +80,18 @@ class BuildingListPriv : public Object
      * \returns the container size
      */
     uint32_t GetNBuildings();
+    /**
+     * Checks if a line segment intersects a Building of the container
+     * \param l1 the first end of the line segment
+     * \param l2 the second end of the line segment
+     * \returns true if the line segment intersects at least one Building
+     */
+    bool IsIntersect(const Vector& l1, const Vector& l2);
+    /**
+     * Invalidates the grid of the Building footprints, which will be built
+     * again at the next call of IsIntersect
+     */
+    void InvalidateGrid();
 
     /**
      * Get the Singleton instance of BuildingListPriv (or create one)
@@ -98,7 +113,33 @@ class BuildingListPriv : public Object
      *
      */
     static void Delete();
+    /**
+     * Builds the grid of the Building footprints
+     */
+    void BuildGrid();
+    /**
+     * \param x the x coordinate of a position
+     * \returns the grid column of the position, clamped to the grid
+     */
+    int64_t GetColumn(double x) const;
+    /**
+     * \param y the y coordinate of a position
+     * \returns the grid row of the position, clamped to the grid
+     */
+    int64_t GetRow(double y) const;
+
     std::vector<Ptr<Building>> m_buildings; //!< Container of Building
+
+    bool m_gridValid;                          //!< true if m_grid matches the buildings
+    std::vector<Box> m_boundaries;             //!< Building boundaries, by index
+    std::vector<std::vector<uint32_t>> m_grid; //!< Building indices in each cell, row by row
+    double m_gridMinX;                         //!< x coordinate of the grid origin
+    double m_gridMinY;                         //!< y coordinate of the grid origin
+    double m_cellSize;                         //!< side of a grid cell
+    int64_t m_numColumns;                      //!< number of columns of the grid
+    int64_t m_numRows;                         //!< number of rows of the grid
+    std::vector<uint32_t> m_lastCheck; //!< last query in which each Building was checked
+    uint32_t m_query;                  //!< number of queries since the grid was built
 };
 
 NS_OBJECT_ENSURE_REGISTERED(BuildingListPriv);
@@ -146,6 +187,13 @@ BuildingListPriv::Delete()
 }
 
 BuildingListPriv::BuildingListPriv()
+    : m_gridValid(false),
+      m_gridMinX(0),
+      m_gridMinY(0),
+      m_cellSize(1),
+      m_numColumns(0),
+      m_numRows(0),
+      m_query(0)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -165,6 +213,7 @@ BuildingListPriv::DoDispose()
         *i = nullptr;
     }
     m_buildings.erase(m_buildings.begin(), m_buildings.end());
+    InvalidateGrid();
     Object::DoDispose();
 }
 
@@ -173,6 +222,7 @@ BuildingListPriv::Add(Ptr<Building> building)
 {
     uint32_t index = m_buildings.size();
     m_buildings.push_back(building);
+    InvalidateGrid();
     Simulator::ScheduleWithContext(index, TimeStep(0), &Building::Initialize, building);
     return index;
 }
@@ -204,6 +254,150 @@ BuildingListPriv::GetBuilding(uint32_t n)
     return m_buildings.at(n);
 }
 
+void
+BuildingListPriv::InvalidateGrid()
+{
+    m_gridValid = false;
+}
+
+int64_t
+BuildingListPriv::GetColumn(double x) const
+{
+    double column = std::floor((x - m_gridMinX) / m_cellSize);
+    return static_cast<int64_t>(std::min(std::max(column, 0.0), double(m_numColumns - 1)));
+}
+
+int64_t
+BuildingListPriv::GetRow(double y) const
+{
+    double row = std::floor((y - m_gridMinY) / m_cellSize);
+    return static_cast<int64_t>(std::min(std::max(row, 0.0), double(m_numRows - 1)));
+}
+
+void
+BuildingListPriv::BuildGrid()
+{
+    NS_LOG_FUNCTION(this << m_buildings.size());
+    m_boundaries.clear();
+    m_grid.clear();
+    m_lastCheck.assign(m_buildings.size(), 0);
+    m_query = 0;
+    m_gridValid = true;
+    if (m_buildings.empty())
+    {
+        m_numColumns = 0;
+        m_numRows = 0;
+        return;
+    }
+
+    m_boundaries.reserve(m_buildings.size());
+    double maxX = m_buildings.front()->GetBoundaries().xMax;
+    double maxY = m_buildings.front()->GetBoundaries().yMax;
+    m_gridMinX = m_buildings.front()->GetBoundaries().xMin;
+    m_gridMinY = m_buildings.front()->GetBoundaries().yMin;
+    double sumSides = 0;
+    for (const Ptr<Building>& building : m_buildings)
+    {
+        Box box = building->GetBoundaries();
+        m_boundaries.push_back(box);
+        m_gridMinX = std::min(m_gridMinX, box.xMin);
+        m_gridMinY = std::min(m_gridMinY, box.yMin);
+        maxX = std::max(maxX, box.xMax);
+        maxY = std::max(maxY, box.yMax);
+        sumSides += std::max(box.xMax - box.xMin, box.yMax - box.yMin);
+    }
+
+    // about one building per cell, with cells not smaller than the average building, so that
+    // a building usually spans a few cells only
+    double width = maxX - m_gridMinX;
+    double height = maxY - m_gridMinY;
+    double numBuildings = m_buildings.size();
+    m_cellSize = std::max({std::sqrt(width * height / numBuildings),
+                           std::max(width, height) / numBuildings,
+                           sumSides / numBuildings});
+    if (m_cellSize == 0)
+    {
+        m_cellSize = 1; // all the buildings are flat and at the same horizontal position
+    }
+    m_numColumns = static_cast<int64_t>(std::floor(width / m_cellSize)) + 1;
+    m_numRows = static_cast<int64_t>(std::floor(height / m_cellSize)) + 1;
+    NS_LOG_DEBUG("Grid of " << m_numColumns << "x" << m_numRows << " cells of " << m_cellSize
+                            << " m for " << m_buildings.size() << " buildings");
+
+    m_grid.resize(m_numColumns * m_numRows);
+    for (uint32_t i = 0; i < m_boundaries.size(); ++i)
+    {
+        const Box& box = m_boundaries[i];
+        for (int64_t y = GetRow(box.yMin); y <= GetRow(box.yMax); ++y)
+        {
+            for (int64_t x = GetColumn(box.xMin); x <= GetColumn(box.xMax); ++x)
+            {
+                m_grid[y * m_numColumns + x].push_back(i);
+            }
+        }
+    }
+}
+
+bool
+BuildingListPriv::IsIntersect(const Vector& l1, const Vector& l2)
+{
+    if (!m_gridValid)
+    {
+        BuildGrid();
+    }
+    if (m_buildings.empty())
+    {
+        return false;
+    }
+    if (++m_query == 0)
+    {
+        // the counter wrapped around, forget which buildings were checked
+        std::fill(m_lastCheck.begin(), m_lastCheck.end(), 0);
+        m_query = 1;
+    }
+
+    // visit the cells crossed by the horizontal projection of the segment, row by row. In each
+    // row, the columns are those spanned by the part of the segment in the row, widened by a
+    // small margin against rounding errors. A building is checked at most once per query
+    const double margin = 1e-6 * m_cellSize;
+    double segmentMinX = std::min(l1.x, l2.x);
+    double segmentMaxX = std::max(l1.x, l2.x);
+    double segmentMinY = std::min(l1.y, l2.y);
+    double segmentMaxY = std::max(l1.y, l2.y);
+    double dx = l2.x - l1.x;
+    double dy = l2.y - l1.y;
+    for (int64_t y = GetRow(segmentMinY - margin); y <= GetRow(segmentMaxY + margin); ++y)
+    {
+        double minX = segmentMinX;
+        double maxX = segmentMaxX;
+        if (dy != 0)
+        {
+            double rowMinY = std::max(segmentMinY, m_gridMinY + y * m_cellSize - margin);
+            double rowMaxY = std::min(segmentMaxY, m_gridMinY + (y + 1) * m_cellSize + margin);
+            double xa = l1.x + (rowMinY - l1.y) * dx / dy;
+            double xb = l1.x + (rowMaxY - l1.y) * dx / dy;
+            minX = std::max(segmentMinX, std::min(xa, xb));
+            maxX = std::min(segmentMaxX, std::max(xa, xb));
+        }
+        for (int64_t x = GetColumn(minX - margin); x <= GetColumn(maxX + margin); ++x)
+        {
+            for (uint32_t i : m_grid[y * m_numColumns + x])
+            {
+                if (m_lastCheck[i] == m_query)
+                {
+                    continue;
+                }
+                m_lastCheck[i] = m_query;
+                if (m_boundaries[i].IsIntersect(l1, l2))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
 } // namespace ns3
 
 /**
@@ -244,4 +438,16 @@ BuildingList::GetNBuildings()
     return BuildingListPriv::Get()->GetNBuildings();
 }
 
+bool
+BuildingList::IsIntersect(const Vector& l1, const Vector& l2)
+{
+    return BuildingListPriv::Get()->IsIntersect(l1, l2);
+}
+
+void
+BuildingList::NotifyBoundariesChanged()
+{
+    BuildingListPriv::Get()->InvalidateGrid();
+}
+
 } // namespace ns3
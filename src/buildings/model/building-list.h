@@ -23,6 +23,7 @@
 #define BUILDING_LIST_H_
 
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 #include <vector>
 
@@ -69,6 +70,25 @@ class BuildingList
      * \returns the number of buildings currently in the list.
      */
     static uint32_t GetNBuildings();
+    /**
+     * \param l1 the first end of the line segment
+     * \param l2 the second end of the line segment
+     * \returns true if the line segment intersects at least one building,
+     *          as checked by Building::IsIntersect.
+     *
+     * The horizontal footprints of the buildings are stored in a uniform
+     * grid, built at the first call after a building is added or resized,
+     * so that only the buildings in the cells crossed by the segment are
+     * checked.
+     */
+    static bool IsIntersect(const Vector& l1, const Vector& l2);
+    /**
+     * \brief Invalidate the grid used by IsIntersect.
+     *
+     * This method is called automatically from Building::SetBoundaries so
+     * the user has little reason to call it himself.
+     */
+    static void NotifyBoundariesChanged();
 };
 
 } // namespace ns3
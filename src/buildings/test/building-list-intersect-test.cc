@@ -0,0 +1,300 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/building-list.h"
+#include "ns3/building.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <ctime>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * \file building-list-intersect-test.cc
+ * \ingroup building-test
+ *
+ * \brief Tests and benchmark of the line segment queries of BuildingList.
+ */
+
+namespace
+{
+
+/**
+ * Check if a line segment intersects a building by scanning the whole
+ * BuildingList, as done before the grid was introduced
+ * \param l1 the first end of the line segment
+ * \param l2 the second end of the line segment
+ * \return true if the line segment intersects at least one building
+ */
+bool
+IsIntersectLinear(const Vector& l1, const Vector& l2)
+{
+    for (auto bit = BuildingList::Begin(); bit != BuildingList::End(); ++bit)
+    {
+        if ((*bit)->IsIntersect(l1, l2))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Create a square city grid of buildings separated by streets
+ * \param numBuildings the number of buildings, rounded up to a square number
+ * \param side the side of a building
+ * \param street the width of a street
+ * \param height the random variable of the building heights
+ * \return the side of the city
+ */
+double
+CreateCityGrid(uint32_t numBuildings,
+               double side,
+               double street,
+               Ptr<RandomVariableStream> height)
+{
+    uint32_t blocks = std::ceil(std::sqrt(numBuildings));
+    for (uint32_t i = 0; i < blocks; ++i)
+    {
+        for (uint32_t j = 0; j < blocks; ++j)
+        {
+            Ptr<Building> building = CreateObject<Building>();
+            double x = i * (side + street);
+            double y = j * (side + street);
+            building->SetBoundaries(Box(x, x + side, y, y + side, 0, height->GetValue()));
+        }
+    }
+    return blocks * (side + street);
+}
+
+} // namespace
+
+/**
+ * \ingroup building-test
+ *
+ * Check that BuildingList::IsIntersect agrees with a linear scan of the
+ * buildings, on random layouts and on segments touching the walls of a city
+ * grid, also when the boundaries of a building change after a query
+ */
+class BuildingListIntersectTestCase : public TestCase
+{
+  public:
+    BuildingListIntersectTestCase()
+        : TestCase("BuildingList::IsIntersect against a linear scan")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Compare the grid and the linear scan on a segment
+     * \param l1 the first end of the line segment
+     * \param l2 the second end of the line segment
+     */
+    void Check(const Vector& l1, const Vector& l2);
+};
+
+void
+BuildingListIntersectTestCase::Check(const Vector& l1, const Vector& l2)
+{
+    NS_TEST_EXPECT_MSG_EQ(BuildingList::IsIntersect(l1, l2),
+                          IsIntersectLinear(l1, l2),
+                          "Wrong intersection of the segment from " << l1 << " to " << l2);
+}
+
+void
+BuildingListIntersectTestCase::DoRun()
+{
+    Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+
+    // no buildings
+    Check(Vector(0, 0, 1.5), Vector(100, 100, 1.5));
+
+    // random buildings of random sizes, possibly overlapping
+    std::vector<Ptr<Building>> buildings;
+    for (uint32_t i = 0; i < 300; ++i)
+    {
+        double x = uniform->GetValue(0, 1000);
+        double y = uniform->GetValue(0, 1000);
+        Ptr<Building> building = CreateObject<Building>();
+        building->SetBoundaries(Box(x,
+                                    x + uniform->GetValue(1, 80),
+                                    y,
+                                    y + uniform->GetValue(1, 80),
+                                    0,
+                                    uniform->GetValue(5, 40)));
+        buildings.push_back(building);
+    }
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        Vector l1(uniform->GetValue(-200, 1200),
+                  uniform->GetValue(-200, 1200),
+                  uniform->GetValue(0, 50));
+        Vector l2(uniform->GetValue(-200, 1200),
+                  uniform->GetValue(-200, 1200),
+                  uniform->GetValue(0, 50));
+        Check(l1, l2);
+        Check(l1, Vector(l1.x, l2.y, l2.z)); // vertical projection
+        Check(l1, Vector(l2.x, l1.y, l2.z)); // horizontal projection
+        Check(l1, Vector(l1.x, l1.y, l2.z)); // no horizontal extent
+    }
+
+    // move a building after the grid was built
+    Box box = buildings.front()->GetBoundaries();
+    Vector center(0.5 * (box.xMin + box.xMax), 0.5 * (box.yMin + box.yMax), 1);
+    Vector far(center.x + 5000, center.y + 5000, 1);
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::IsIntersect(center, center),
+                          true,
+                          "A position inside a building must intersect it");
+    buildings.front()->SetBoundaries(
+        Box(far.x - 1, far.x + 1, far.y - 1, far.y + 1, box.zMin, box.zMax));
+    Check(center, center);
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::IsIntersect(far, far),
+                          true,
+                          "The grid was not updated with the new boundaries");
+    Simulator::Destroy();
+
+    // segments along the streets of a city grid, touching the walls
+    Ptr<ConstantRandomVariable> height = CreateObject<ConstantRandomVariable>();
+    height->SetAttribute("Constant", DoubleValue(20));
+    double side = 30;
+    double street = 10;
+    double city = CreateCityGrid(100, side, street, height);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        double wall = i * (side + street) + side;
+        Check(Vector(wall, -10, 1.5), Vector(wall, city + 10, 1.5));
+        Check(Vector(wall + 0.5 * street, -10, 1.5), Vector(wall + 0.5 * street, city, 1.5));
+        Check(Vector(-10, wall, 1.5), Vector(city + 10, wall, 1.5));
+        Check(Vector(-10, wall + 0.5 * street, 1.5), Vector(city, wall + 0.5 * street, 1.5));
+        Check(Vector(wall, wall, 1.5), Vector(wall + street, wall + street, 1.5));
+        Check(Vector(wall, wall + street, 1.5), Vector(wall + street, wall, 1.5));
+        Check(Vector(wall + 0.5 * street, 0, 25), Vector(wall + 0.5 * street, city, 19));
+    }
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup building-test
+ *
+ * \brief BuildingList test suite
+ */
+class BuildingListIntersectTestSuite : public TestSuite
+{
+  public:
+    BuildingListIntersectTestSuite()
+        : TestSuite("building-list-intersect", Type::UNIT)
+    {
+        AddTestCase(new BuildingListIntersectTestCase, TestCase::Duration::QUICK);
+    }
+};
+
+/// Static variable for test initialization
+static BuildingListIntersectTestSuite g_buildingListIntersectTestSuite;
+
+/**
+ * \ingroup building-test
+ *
+ * Measure the throughput of the line-of-sight queries in a city grid, with
+ * BuildingList::IsIntersect and with a linear scan of the buildings
+ */
+class BuildingListIntersectPerfTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param numBuildings the number of buildings of the city grid
+     */
+    BuildingListIntersectPerfTestCase(uint32_t numBuildings)
+        : TestCase("Line-of-sight queries with " + std::to_string(numBuildings) + " buildings"),
+          m_numBuildings(numBuildings)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_numBuildings; //!< number of buildings
+};
+
+void
+BuildingListIntersectPerfTestCase::DoRun()
+{
+    const uint32_t numQueries = 1000;
+    Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+    uniform->SetAttribute("Min", DoubleValue(10));
+    uniform->SetAttribute("Max", DoubleValue(40));
+    double city = CreateCityGrid(m_numBuildings, 30, 10, uniform);
+
+    // links between a UE and an eNB at most 300 m away
+    std::vector<std::pair<Vector, Vector>> links;
+    for (uint32_t i = 0; i < numQueries; ++i)
+    {
+        Vector ue(uniform->GetValue(0, city), uniform->GetValue(0, city), 1.5);
+        Vector enb(ue.x + uniform->GetValue(-300, 300), ue.y + uniform->GetValue(-300, 300), 25);
+        links.emplace_back(ue, enb);
+    }
+    BuildingList::IsIntersect(links.front().first, links.front().second); // build the grid
+
+    uint32_t blockedGrid = 0;
+    clock_t start = clock();
+    for (const auto& link : links)
+    {
+        blockedGrid += BuildingList::IsIntersect(link.first, link.second);
+    }
+    double gridMs = 1e3 * (clock() - start) / CLOCKS_PER_SEC;
+
+    uint32_t blockedLinear = 0;
+    start = clock();
+    for (const auto& link : links)
+    {
+        blockedLinear += IsIntersectLinear(link.first, link.second);
+    }
+    double linearMs = 1e3 * (clock() - start) / CLOCKS_PER_SEC;
+
+    NS_TEST_ASSERT_MSG_EQ(blockedGrid, blockedLinear, "The grid and the scan disagree");
+    std::cout << GetName() << ": " << numQueries << " queries, grid " << gridMs
+              << " ms, linear scan " << linearMs << " ms" << std::endl;
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup building-test
+ *
+ * \brief BuildingList performance suite
+ */
+class BuildingListIntersectPerfTestSuite : public TestSuite
+{
+  public:
+    BuildingListIntersectPerfTestSuite()
+        : TestSuite("building-list-intersect-perf", Type::PERFORMANCE)
+    {
+        AddTestCase(new BuildingListIntersectPerfTestCase(10), TestCase::Duration::QUICK);
+        AddTestCase(new BuildingListIntersectPerfTestCase(1000), TestCase::Duration::QUICK);
+        AddTestCase(new BuildingListIntersectPerfTestCase(100000), TestCase::Duration::EXTENSIVE);
+    }
+};
+
+/// Static variable for test initialization
+static BuildingListIntersectPerfTestSuite g_buildingListIntersectPerfTestSuite;
@@ -0,0 +1,282 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "batched-heap-scheduler.h"
+
+#include "abort.h"
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::BatchedHeapScheduler class.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BatchedHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(BatchedHeapScheduler);
+
+namespace
+{
+
+/** Number of children of a heap entry. */
+constexpr std::size_t HEAP_ARITY = 4;
+
+/**
+ * Minimum number of removed events at the front of a batch before it is
+ * compacted, so that a batch kept alive by events scheduled at the
+ * current time does not grow forever.
+ */
+constexpr std::size_t BATCH_COMPACT_THRESHOLD = 64;
+
+/**
+ * Compare the uid of an event with a uid.
+ *
+ * \param [in] ev The event.
+ * \param [in] uid The uid.
+ * \returns \c true if the uid of the event is smaller.
+ */
+bool
+IsUidLess(const Scheduler::Event& ev, uint32_t uid)
+{
+    return ev.key.m_uid < uid;
+}
+
+} // namespace
+
+TypeId
+BatchedHeapScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::BatchedHeapScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<BatchedHeapScheduler>();
+    return tid;
+}
+
+BatchedHeapScheduler::BatchedHeapScheduler()
+    : m_lastTs(0),
+      m_lastBatch(NO_BATCH)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+BatchedHeapScheduler::~BatchedHeapScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BatchedHeapScheduler::Place(std::size_t index, const HeapEntry& entry)
+{
+    m_heap[index] = entry;
+    m_batches[entry.batch].heapIndex = index;
+}
+
+void
+BatchedHeapScheduler::SiftUp(std::size_t index)
+{
+    HeapEntry entry = m_heap[index];
+    while (index > 0)
+    {
+        std::size_t parent = (index - 1) / HEAP_ARITY;
+        if (m_heap[parent].ts <= entry.ts)
+        {
+            break;
+        }
+        Place(index, m_heap[parent]);
+        index = parent;
+    }
+    Place(index, entry);
+}
+
+void
+BatchedHeapScheduler::SiftDown(std::size_t index)
+{
+    HeapEntry entry = m_heap[index];
+    std::size_t size = m_heap.size();
+    while (true)
+    {
+        std::size_t first = index * HEAP_ARITY + 1;
+        if (first >= size)
+        {
+            break;
+        }
+        std::size_t last = std::min(first + HEAP_ARITY, size);
+        std::size_t smallest = first;
+        for (std::size_t child = first + 1; child < last; ++child)
+        {
+            if (m_heap[child].ts < m_heap[smallest].ts)
+            {
+                smallest = child;
+            }
+        }
+        if (entry.ts <= m_heap[smallest].ts)
+        {
+            break;
+        }
+        Place(index, m_heap[smallest]);
+        index = smallest;
+    }
+    Place(index, entry);
+}
+
+uint32_t
+BatchedHeapScheduler::GetBatch(uint64_t ts)
+{
+    // slotted models often schedule several events in a row at the same time stamp
+    if (m_lastBatch != NO_BATCH && m_lastTs == ts)
+    {
+        return m_lastBatch;
+    }
+    auto [it, inserted] = m_batchByTs.try_emplace(ts, 0);
+    if (inserted)
+    {
+        uint32_t batch;
+        if (!m_freeBatches.empty())
+        {
+            batch = m_freeBatches.back();
+            m_freeBatches.pop_back();
+        }
+        else
+        {
+            NS_ABORT_MSG_IF(m_batches.size() >= NO_BATCH, "Too many time stamps in the schedule");
+            batch = m_batches.size();
+            m_batches.push_back({{}, 0, 0});
+        }
+        it->second = batch;
+        m_heap.push_back({ts, batch});
+        SiftUp(m_heap.size() - 1);
+    }
+    m_lastTs = ts;
+    m_lastBatch = it->second;
+    return m_lastBatch;
+}
+
+void
+BatchedHeapScheduler::ReleaseBatch(uint32_t batch)
+{
+    std::size_t index = m_batches[batch].heapIndex;
+    NS_LOG_DEBUG("Release the batch of " << m_heap[index].ts);
+    m_batchByTs.erase(m_heap[index].ts);
+    m_batches[batch].events.clear();
+    m_batches[batch].head = 0;
+    m_freeBatches.push_back(batch);
+    if (m_lastBatch == batch)
+    {
+        m_lastBatch = NO_BATCH;
+    }
+
+    HeapEntry last = m_heap.back();
+    m_heap.pop_back();
+    if (index == m_heap.size())
+    {
+        return;
+    }
+    Place(index, last);
+    if (index > 0 && last.ts < m_heap[(index - 1) / HEAP_ARITY].ts)
+    {
+        SiftUp(index);
+    }
+    else
+    {
+        SiftDown(index);
+    }
+}
+
+void
+BatchedHeapScheduler::Insert(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    Batch& batch = m_batches[GetBatch(ev.key.m_ts)];
+    // the uids grow with the scheduling order, so the event usually goes at the end
+    if (batch.head == batch.events.size() || batch.events.back().key.m_uid < ev.key.m_uid)
+    {
+        batch.events.push_back(ev);
+        return;
+    }
+    auto position = std::lower_bound(batch.events.begin() + batch.head,
+                                     batch.events.end(),
+                                     ev.key.m_uid,
+                                     IsUidLess);
+    batch.events.insert(position, ev);
+}
+
+bool
+BatchedHeapScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_heap.empty();
+}
+
+Scheduler::Event
+BatchedHeapScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    const Batch& batch = m_batches[m_heap.front().batch];
+    return batch.events[batch.head];
+}
+
+Scheduler::Event
+BatchedHeapScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    uint32_t index = m_heap.front().batch;
+    Batch& batch = m_batches[index];
+    Scheduler::Event next = batch.events[batch.head++];
+    if (batch.head == batch.events.size())
+    {
+        ReleaseBatch(index);
+    }
+    else if (batch.head >= BATCH_COMPACT_THRESHOLD && 2 * batch.head >= batch.events.size())
+    {
+        batch.events.erase(batch.events.begin(), batch.events.begin() + batch.head);
+        batch.head = 0;
+    }
+    return next;
+}
+
+void
+BatchedHeapScheduler::Remove(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    auto it = m_batchByTs.find(ev.key.m_ts);
+    NS_ASSERT_MSG(it != m_batchByTs.end(), "No event at " << ev.key.m_ts);
+    uint32_t index = it->second;
+    Batch& batch = m_batches[index];
+    auto position = std::lower_bound(batch.events.begin() + batch.head,
+                                     batch.events.end(),
+                                     ev.key.m_uid,
+                                     IsUidLess);
+    NS_ASSERT_MSG(position != batch.events.end() && position->key.m_uid == ev.key.m_uid,
+                  "Event " << ev.key.m_uid << " not found at " << ev.key.m_ts);
+    batch.events.erase(position);
+    if (batch.head == batch.events.size())
+    {
+        ReleaseBatch(index);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BATCHED_HEAP_SCHEDULER_H
+#define BATCHED_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::BatchedHeapScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary heap of same-timestamp event batches
+ *
+ * Slotted models schedule many events at the very same time stamps,
+ * such as the start of each slot or symbol. This scheduler groups the
+ * events by time stamp: the events of a time stamp are stored in a
+ * contiguous batch, sorted by uid, and only the time stamps are kept in
+ * the heap. Inserting an event at a time stamp already in the schedule
+ * is then an append to its batch, found with a hash table, and removing
+ * the next event is a pop from the front of the earliest batch.
+ *
+ * The heap is a 4-ary heap on a `std::vector` of 16-byte entries: it is
+ * half as deep as a binary heap, and the four children of an entry are
+ * contiguous, so a sift down reads them from at most two cache lines. The
+ * batches are recycled together with their memory when they become empty.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Constant        | Append to the batch of the time stamp
+ * Insert()     | Logarithmic     | New time stamp: hash table insertion, heapify
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Heap kept sorted
+ * Remove()     | Linear          | Search and erase in the batch
+ * RemoveNext() | Constant        | Pop from the front of the earliest batch
+ * RemoveNext() | Logarithmic     | Last event of the batch: heapify
+ *
+ * \par Memory Complexity
+ *
+ * Category       | Memory                             | Reason
+ * :------------- | :--------------------------------- | :-----
+ * Overhead       | 144 bytes                          | `std::vector` and `std::unordered_map`
+ * Per time stamp | About 100 bytes                    | Heap entry, batch, hash table node
+ * Per Event      | 0                                  | Events stored in the batches directly
+ */
+class BatchedHeapScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    BatchedHeapScheduler();
+    /** Destructor. */
+    ~BatchedHeapScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Index of no batch. */
+    static constexpr uint32_t NO_BATCH = UINT32_MAX;
+
+    /** The events of a time stamp. */
+    struct Batch
+    {
+        std::vector<Scheduler::Event> events; /**< Events, sorted by uid. */
+        std::size_t head;                     /**< Index of the first event not removed. */
+        std::size_t heapIndex;                /**< Index of the batch in the heap. */
+    };
+
+    /** Heap entry: a time stamp and its batch. */
+    struct HeapEntry
+    {
+        uint64_t ts;    /**< Time stamp of the batch. */
+        uint32_t batch; /**< Index of the batch in m_batches. */
+    };
+
+    /**
+     * Get the batch of a time stamp, creating it if needed.
+     *
+     * \param [in] ts The time stamp.
+     * \returns The index of the batch in m_batches.
+     */
+    uint32_t GetBatch(uint64_t ts);
+    /**
+     * Remove an empty batch from the heap and recycle it.
+     *
+     * \param [in] batch The index of the batch in m_batches.
+     */
+    void ReleaseBatch(uint32_t batch);
+    /**
+     * Move a heap entry up to its proper position.
+     *
+     * \param [in] index The index of the entry.
+     */
+    void SiftUp(std::size_t index);
+    /**
+     * Move a heap entry down to its proper position.
+     *
+     * \param [in] index The index of the entry.
+     */
+    void SiftDown(std::size_t index);
+    /**
+     * Store a heap entry at an index, and record the index in its batch.
+     *
+     * \param [in] index The index in the heap.
+     * \param [in] entry The entry.
+     */
+    inline void Place(std::size_t index, const HeapEntry& entry);
+
+    /** The time stamps of the batches, managed as a 4-ary heap. */
+    std::vector<HeapEntry> m_heap;
+    /** The batches, including the recycled ones. */
+    std::vector<Batch> m_batches;
+    /** The indexes of the recycled batches in m_batches. */
+    std::vector<uint32_t> m_freeBatches;
+    /** The batch of each time stamp in the heap. */
+    std::unordered_map<uint64_t, uint32_t> m_batchByTs;
+    /** The time stamp of the last batch returned by GetBatch. */
+    uint64_t m_lastTs;
+    /** The last batch returned by GetBatch, or NO_BATCH once it is released. */
+    uint32_t m_lastBatch;
+};
+
+} // namespace ns3
+
+#endif /* BATCHED_HEAP_SCHEDULER_H */
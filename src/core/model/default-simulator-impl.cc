@@ -19,12 +19,15 @@
 
 #include "default-simulator-impl.h"
 
+#include "abort.h"
 #include "assert.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
 
 #include <cmath>
+#include <cstring>
 
 /**
  * \file
@@ -42,13 +45,30 @@ NS_LOG_COMPONENT_DEFINE("DefaultSimulatorImpl");
 
 NS_OBJECT_ENSURE_REGISTERED(DefaultSimulatorImpl);
 
+namespace
+{
+
+/** First bytes of an event trace file. */
+constexpr char EVENT_TRACE_MAGIC[] = "NS3EVTR1";
+/** Length of EVENT_TRACE_MAGIC, without the terminating null character. */
+constexpr std::size_t EVENT_TRACE_MAGIC_SIZE = sizeof(EVENT_TRACE_MAGIC) - 1;
+
+} // namespace
+
 TypeId
 DefaultSimulatorImpl::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
-                            .SetParent<SimulatorImpl>()
-                            .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+    static TypeId tid =
+        TypeId("ns3::DefaultSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Core")
+            .AddConstructor<DefaultSimulatorImpl>()
+            .AddAttribute("EventTraceFile",
+                          "The file to write the events inserted in and removed from the "
+                          "scheduler to, or empty to disable the trace.",
+                          StringValue(""),
+                          MakeStringAccessor(&DefaultSimulatorImpl::SetEventTraceFile),
+                          MakeStringChecker());
     return tid;
 }
 
@@ -83,6 +103,7 @@ DefaultSimulatorImpl::DoDispose()
         next.impl->Unref();
     }
     m_events = nullptr;
+    SetEventTraceFile("");
     SimulatorImpl::DoDispose();
 }
 
@@ -180,7 +201,69 @@ DefaultSimulatorImpl::ProcessEventsWithContext()
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        TraceEvent(ev.key.m_ts, ev.key.m_context, ev.key.m_uid, false);
+    }
+}
+
+void
+DefaultSimulatorImpl::SetEventTraceFile(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    if (m_eventTrace.is_open())
+    {
+        m_eventTrace.close();
+    }
+    m_eventTraceFilename = filename;
+    if (filename.empty())
+    {
+        return;
+    }
+    m_eventTrace.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_UNLESS(m_eventTrace.is_open(), "Cannot open the event trace file " << filename);
+    m_eventTrace.write(EVENT_TRACE_MAGIC, EVENT_TRACE_MAGIC_SIZE);
+}
+
+void
+DefaultSimulatorImpl::TraceEvent(uint64_t ts, uint32_t context, uint32_t uid, bool remove)
+{
+    if (!m_eventTrace.is_open())
+    {
+        return;
+    }
+    uint64_t delay = ts - m_currentTs;
+    uint8_t kind = remove;
+    m_eventTrace.write(reinterpret_cast<const char*>(&m_currentTs), sizeof(m_currentTs));
+    m_eventTrace.write(reinterpret_cast<const char*>(&delay), sizeof(delay));
+    m_eventTrace.write(reinterpret_cast<const char*>(&context), sizeof(context));
+    m_eventTrace.write(reinterpret_cast<const char*>(&uid), sizeof(uid));
+    m_eventTrace.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+}
+
+std::vector<DefaultSimulatorImpl::EventTraceRecord>
+DefaultSimulatorImpl::ReadEventTrace(const std::string& filename)
+{
+    NS_LOG_FUNCTION(filename);
+    std::ifstream input(filename, std::ios::in | std::ios::binary);
+    NS_ABORT_MSG_UNLESS(input.is_open(), "Cannot open the event trace file " << filename);
+    char magic[EVENT_TRACE_MAGIC_SIZE];
+    input.read(magic, EVENT_TRACE_MAGIC_SIZE);
+    NS_ABORT_MSG_UNLESS(input && std::memcmp(magic, EVENT_TRACE_MAGIC, EVENT_TRACE_MAGIC_SIZE) == 0,
+                        filename << " is not an event trace file");
+
+    std::vector<EventTraceRecord> records;
+    EventTraceRecord record;
+    uint8_t kind;
+    while (input.read(reinterpret_cast<char*>(&record.ts), sizeof(record.ts)))
+    {
+        input.read(reinterpret_cast<char*>(&record.delay), sizeof(record.delay));
+        input.read(reinterpret_cast<char*>(&record.context), sizeof(record.context));
+        input.read(reinterpret_cast<char*>(&record.uid), sizeof(record.uid));
+        input.read(reinterpret_cast<char*>(&kind), sizeof(kind));
+        NS_ABORT_MSG_UNLESS(input, "Truncated event trace file " << filename);
+        record.remove = kind != 0;
+        records.push_back(record);
     }
+    return records;
 }
 
 void
@@ -237,6 +320,7 @@ DefaultSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
     m_uid++;
     m_unscheduledEvents++;
     m_events->Insert(ev);
+    TraceEvent(ev.key.m_ts, ev.key.m_context, ev.key.m_uid, false);
     return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -256,6 +340,7 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        TraceEvent(ev.key.m_ts, ev.key.m_context, ev.key.m_uid, false);
     }
     else
     {
@@ -339,6 +424,7 @@ DefaultSimulatorImpl::Remove(const EventId& id)
     event.key.m_context = id.GetContext();
     event.key.m_uid = id.GetUid();
     m_events->Remove(event);
+    TraceEvent(event.key.m_ts, event.key.m_context, event.key.m_uid, true);
     event.impl->Cancel();
     // whenever we remove an event from the event list, we have to unref it.
     event.impl->Unref();
@@ -22,9 +22,12 @@
 
 #include "simulator-impl.h"
 
+#include <fstream>
 #include <list>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 /**
  * \file
@@ -42,6 +45,15 @@ class Scheduler;
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * If the EventTraceFile attribute is set, the stream of the events inserted
+ * in and removed from the scheduler is written to a binary file, which can be
+ * read back with ReadEventTrace() to replay the schedule of a real run, for
+ * instance with `utils/bench-scheduler`. The file starts with the 8 bytes
+ * `NS3EVTR1`, followed by a record of 25 bytes for each event: the time step
+ * of the insertion or removal (8 bytes), the delay of the event from that time
+ * (8 bytes), its context (4 bytes), its uid (4 bytes) and 1 for a removal or 0
+ * for an insertion (1 byte), in the byte order of the host.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -57,6 +69,24 @@ class DefaultSimulatorImpl : public SimulatorImpl
     /** Destructor. */
     ~DefaultSimulatorImpl() override;
 
+    /** A record of the event trace. */
+    struct EventTraceRecord
+    {
+        uint64_t ts;      /**< Time step of the insertion or removal. */
+        uint64_t delay;   /**< Delay of the event from ts, in time steps. */
+        uint32_t context; /**< Context of the event. */
+        uint32_t uid;     /**< Uid of the event. */
+        bool remove;      /**< Whether the event is removed instead of inserted. */
+    };
+
+    /**
+     * Read an event trace written by a simulation run.
+     *
+     * \param [in] filename The name of the trace file.
+     * \returns The records of the trace.
+     */
+    static std::vector<EventTraceRecord> ReadEventTrace(const std::string& filename);
+
     // Inherited
     void Destroy() override;
     bool IsFinished() const override;
@@ -85,6 +115,19 @@ class DefaultSimulatorImpl : public SimulatorImpl
     void ProcessOneEvent();
     /** Move events from a different context into the main event queue. */
     void ProcessEventsWithContext();
+    /**
+     * Open the event trace file.
+     * \param [in] filename The name of the file, or an empty string to stop tracing.
+     */
+    void SetEventTraceFile(std::string filename);
+    /**
+     * Write a record to the event trace, if it is enabled.
+     * \param [in] ts The time step of the event.
+     * \param [in] context The context of the event.
+     * \param [in] uid The uid of the event.
+     * \param [in] remove Whether the event is removed instead of inserted.
+     */
+    inline void TraceEvent(uint64_t ts, uint32_t context, uint32_t uid, bool remove);
 
     /** Wrap an event with its execution context. */
     struct EventWithContext
@@ -136,6 +179,11 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
+
+    /** Name of the event trace file, empty if disabled. */
+    std::string m_eventTraceFilename;
+    /** Event trace file. */
+    std::ofstream m_eventTrace;
 };
 
 } // namespace ns3
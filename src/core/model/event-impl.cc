@@ -21,6 +21,9 @@
 
 #include "log.h"
 
+#include <atomic>
+#include <new>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +35,68 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Size classes of the event free lists, in bytes. */
+constexpr std::size_t EVENT_POOL_GRANULARITY = 16;
+/** Number of free lists, for the events up to 256 bytes. */
+constexpr std::size_t EVENT_POOL_CLASSES = 16;
+
+/**
+ * \ingroup events
+ * The event free lists and allocation counters of a thread. It is
+ * trivially destructible, so it can still be used while the static
+ * objects holding events are destroyed.
+ */
+struct EventPool
+{
+    /** A released event, linked in a free list. */
+    struct Block
+    {
+        Block* next; //!< Next released event.
+    };
+
+    Block* freeLists[EVENT_POOL_CLASSES]; //!< Released events, by size class.
+    EventImpl::AllocationStats stats;     //!< Allocation counters.
+    bool alive;                           //!< The free lists can take released events.
+};
+
+/** The event pool of each thread. */
+thread_local EventPool t_eventPool{};
+
+/** Release the event pool of a thread when it exits. */
+struct EventPoolGuard
+{
+    EventPoolGuard()
+    {
+        t_eventPool.alive = true;
+    }
+
+    ~EventPoolGuard()
+    {
+        t_eventPool.alive = false;
+        for (auto& freeList : t_eventPool.freeLists)
+        {
+            while (freeList)
+            {
+                EventPool::Block* block = freeList;
+                freeList = block->next;
+                ::operator delete(block);
+            }
+        }
+        t_eventPool.stats.pooledBlocks = 0;
+    }
+};
+
+/** The guard of the event pool of each thread. */
+thread_local EventPoolGuard t_eventPoolGuard;
+
+/** Whether the released events are kept for reuse. */
+std::atomic<bool> g_eventPoolEnabled{true};
+
+} // namespace
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -67,4 +132,71 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+void*
+EventImpl::operator new(std::size_t size)
+{
+    EventPool& pool = t_eventPool;
+    ++pool.stats.allocations;
+    std::size_t sizeClass = (size - 1) / EVENT_POOL_GRANULARITY;
+    if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+        return ::operator new(size);
+    }
+    if (!pool.alive)
+    {
+        // first event of this thread, or the thread is exiting
+        (void)&t_eventPoolGuard;
+    }
+    EventPool::Block* block = pool.freeLists[sizeClass];
+    if (block && g_eventPoolEnabled.load(std::memory_order_relaxed))
+    {
+        pool.freeLists[sizeClass] = block->next;
+        ++pool.stats.poolAllocations;
+        --pool.stats.pooledBlocks;
+        return block;
+    }
+    // the whole size class, so that the block can be reused by any event of the class
+    return ::operator new((sizeClass + 1) * EVENT_POOL_GRANULARITY);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    EventPool& pool = t_eventPool;
+    ++pool.stats.releases;
+    std::size_t sizeClass = (size - 1) / EVENT_POOL_GRANULARITY;
+    if (sizeClass < EVENT_POOL_CLASSES && pool.alive &&
+        g_eventPoolEnabled.load(std::memory_order_relaxed))
+    {
+        auto block = static_cast<EventPool::Block*>(p);
+        block->next = pool.freeLists[sizeClass];
+        pool.freeLists[sizeClass] = block;
+        ++pool.stats.pooledBlocks;
+        return;
+    }
+    ::operator delete(p);
+}
+
+EventImpl::AllocationStats
+EventImpl::GetAllocationStats()
+{
+    return t_eventPool.stats;
+}
+
+void
+EventImpl::ResetAllocationStats()
+{
+    EventPool& pool = t_eventPool;
+    pool.stats.allocations = 0;
+    pool.stats.poolAllocations = 0;
+    pool.stats.releases = 0;
+}
+
+void
+EventImpl::SetPoolEnabled(bool enabled)
+{
+    NS_LOG_FUNCTION(enabled);
+    g_eventPoolEnabled.store(enabled, std::memory_order_relaxed);
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -41,6 +42,11 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated and released very often, so the memory of the
+ * events up to 256 bytes is recycled through per-thread free lists, one
+ * for each multiple of 16 bytes, instead of being returned to the global
+ * allocator. The free lists are released when the thread exits.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -67,6 +73,46 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Allocate the memory of an event, from the free list of its size
+     * class if possible.
+     *
+     * \param [in] size The size of the event.
+     * \returns The memory of the event.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the memory of an event to the free list of its size class.
+     *
+     * \param [in] p The memory of the event.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
+
+    /** Event allocation counters of a thread. */
+    struct AllocationStats
+    {
+        uint64_t allocations;     //!< Events allocated.
+        uint64_t poolAllocations; //!< Events allocated from a free list.
+        uint64_t releases;        //!< Events released.
+        uint64_t pooledBlocks;    //!< Blocks currently held by the free lists.
+    };
+
+    /**
+     * \returns The event allocation counters of the calling thread, since
+     *          it started or since the last call to ResetAllocationStats().
+     */
+    static AllocationStats GetAllocationStats();
+    /** Reset the event allocation counters of the calling thread. */
+    static void ResetAllocationStats();
+    /**
+     * Enable or disable the free lists, in all the threads. This is mostly
+     * useful to measure their benefit; they are enabled by default.
+     *
+     * \param [in] enabled Whether the released events are kept for reuse.
+     */
+    static void SetPoolEnabled(bool enabled);
+
   protected:
     /**
      * Implementation for Invoke().
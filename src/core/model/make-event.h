@@ -149,7 +149,9 @@ MakeEvent(MEM mem_ptr, OBJ obj, Ts... args)
         EventMemberImpl() = delete;
 
         EventMemberImpl(OBJ obj, MEM function, Ts... args)
-            : m_function(std::bind(function, obj, args...))
+            : m_obj(obj),
+              m_function(function),
+              m_arguments(args...)
         {
         }
 
@@ -161,10 +163,15 @@ MakeEvent(MEM mem_ptr, OBJ obj, Ts... args)
       private:
         void Notify() override
         {
-            m_function();
+            std::apply([this](Ts&... args) { std::invoke(m_function, m_obj, args...); },
+                       m_arguments);
         }
 
-        std::function<void()> m_function;
+        // the arguments are stored in the event itself, like by std::bind but without the
+        // allocation of a std::function
+        OBJ m_obj;                     //!< the object
+        MEM m_function;                //!< the class method
+        std::tuple<Ts...> m_arguments; //!< the arguments
     }* ev = new EventMemberImpl(obj, mem_ptr, args...);
 
     return ev;
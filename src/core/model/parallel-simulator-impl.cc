@@ -0,0 +1,745 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "parallel-simulator-impl.h"
+
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+#include "scheduler.h"
+#include "simulator.h"
+#include "uinteger.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ParallelSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("ParallelSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(ParallelSimulatorImpl);
+
+thread_local ParallelSimulatorImpl::Partition* ParallelSimulatorImpl::m_threadPartition = nullptr;
+
+TypeId
+ParallelSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ParallelSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Core")
+            .AddConstructor<ParallelSimulatorImpl>()
+            .AddAttribute("Lookahead",
+                          "The duration of the windows in which the partitions run in "
+                          "parallel. It must not exceed the delay of the events scheduled "
+                          "from a partition to another one.",
+                          TimeValue(MicroSeconds(1)),
+                          MakeTimeAccessor(&ParallelSimulatorImpl::m_lookahead),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("ThreadCount",
+                          "The number of threads running the partitions, including the main "
+                          "one, or 0 for the number of hardware threads.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ParallelSimulatorImpl::m_threadCount),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+ParallelSimulatorImpl::ParallelSimulatorImpl()
+    : m_partitionsChanged(false),
+      m_threadCount(0),
+      m_windowEnd(0),
+      m_running(false),
+      m_stop(false),
+      m_nextActive(0),
+      m_windowCount(0),
+      m_busyWorkers(0),
+      m_exitWorkers(false),
+      m_eventsWithContextEmpty(true)
+{
+    NS_LOG_FUNCTION(this);
+    m_schedulerFactory.SetTypeId("ns3::MapScheduler");
+    CreatePartitions(0);
+    m_mainThreadId = std::this_thread::get_id();
+}
+
+ParallelSimulatorImpl::~ParallelSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+ParallelSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    ProcessEventsWithContext();
+    StopWorkers();
+
+    for (auto& partition : m_partitions)
+    {
+        for (const auto& remote : partition->outbox)
+        {
+            remote.event->Unref();
+        }
+        while (!partition->events->IsEmpty())
+        {
+            Scheduler::Event next = partition->events->RemoveNext();
+            next.impl->Unref();
+        }
+    }
+    m_partitions.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+ParallelSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+ParallelSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    NS_ABORT_MSG_IF(m_running, "Cannot change the scheduler while the simulation is running");
+    m_schedulerFactory = schedulerFactory;
+    for (auto& partition : m_partitions)
+    {
+        Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+        while (!partition->events->IsEmpty())
+        {
+            scheduler->Insert(partition->events->RemoveNext());
+        }
+        partition->events = scheduler;
+    }
+}
+
+void
+ParallelSimulatorImpl::CreatePartitions(uint32_t partition)
+{
+    NS_LOG_FUNCTION(this << partition);
+    while (m_partitions.size() <= partition)
+    {
+        auto created = std::make_unique<Partition>();
+        created->events = m_schedulerFactory.Create<Scheduler>();
+        created->uid = EventId::UID::VALID;
+        // the partition 0 is always the most advanced one outside of the windows
+        created->currentTs = m_partitions.empty() ? 0 : m_partitions.front()->currentTs;
+        created->currentUid = EventId::UID::INVALID;
+        created->currentContext = Simulator::NO_CONTEXT;
+        created->eventCount = 0;
+        created->unscheduledEvents = 0;
+        created->stop = false;
+        m_partitions.push_back(std::move(created));
+    }
+}
+
+void
+ParallelSimulatorImpl::SetContextPartition(uint32_t context, uint32_t partition)
+{
+    NS_LOG_FUNCTION(this << context << partition);
+    NS_ABORT_MSG_IF(m_running, "Cannot change the partition of a context during the simulation");
+    NS_ABORT_MSG_IF(context == Simulator::NO_CONTEXT,
+                    "The events without context always run in the partition 0");
+    CreatePartitions(partition);
+    if (GetContextPartition(context) == partition)
+    {
+        return;
+    }
+    if (partition == 0)
+    {
+        m_partitionOfContext.erase(context);
+    }
+    else
+    {
+        m_partitionOfContext[context] = partition;
+    }
+    m_partitionsChanged = true;
+}
+
+uint32_t
+ParallelSimulatorImpl::GetContextPartition(uint32_t context) const
+{
+    auto it = m_partitionOfContext.find(context);
+    return it == m_partitionOfContext.end() ? 0 : it->second;
+}
+
+ParallelSimulatorImpl::Partition&
+ParallelSimulatorImpl::GetPartition(uint32_t context) const
+{
+    return *m_partitions[GetContextPartition(context)];
+}
+
+ParallelSimulatorImpl::Partition&
+ParallelSimulatorImpl::GetCurrentPartition() const
+{
+    return m_threadPartition ? *m_threadPartition : *m_partitions.front();
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+ParallelSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+EventId
+ParallelSimulatorImpl::Insert(Partition& partition, uint64_t ts, uint32_t context, EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = partition.uid;
+    partition.uid++;
+    partition.unscheduledEvents++;
+    partition.events->Insert(ev);
+    return EventId(event, ts, context, ev.key.m_uid);
+}
+
+void
+ParallelSimulatorImpl::MovePendingEvents()
+{
+    if (!m_partitionsChanged)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    m_partitionsChanged = false;
+    for (std::size_t i = 0; i < m_partitions.size(); ++i)
+    {
+        Partition& partition = *m_partitions[i];
+        std::vector<Scheduler::Event> events;
+        while (!partition.events->IsEmpty())
+        {
+            events.push_back(partition.events->RemoveNext());
+        }
+        for (const auto& ev : events)
+        {
+            if (GetContextPartition(ev.key.m_context) == i)
+            {
+                partition.events->Insert(ev);
+                continue;
+            }
+            partition.unscheduledEvents--;
+            Insert(GetPartition(ev.key.m_context), ev.key.m_ts, ev.key.m_context, ev.impl);
+        }
+    }
+}
+
+void
+ParallelSimulatorImpl::ProcessOutboxes()
+{
+    // in the order of the partitions, so that the uids do not depend on the threads
+    for (auto& partition : m_partitions)
+    {
+        for (const auto& remote : partition->outbox)
+        {
+            Insert(GetPartition(remote.context), remote.ts, remote.context, remote.event);
+        }
+        partition->outbox.clear();
+    }
+}
+
+void
+ParallelSimulatorImpl::ProcessEventsWithContext()
+{
+    if (m_eventsWithContextEmpty)
+    {
+        return;
+    }
+
+    // swap queues
+    std::list<EventWithContext> eventsWithContext;
+    {
+        std::unique_lock lock{m_eventsWithContextMutex};
+        m_eventsWithContext.swap(eventsWithContext);
+        m_eventsWithContextEmpty = true;
+    }
+    uint64_t now = m_partitions.front()->currentTs;
+    for (const auto& event : eventsWithContext)
+    {
+        Insert(GetPartition(event.context), now + event.timestamp, event.context, event.event);
+    }
+}
+
+void
+ParallelSimulatorImpl::ProcessOneEvent(Partition& partition)
+{
+    Scheduler::Event next = partition.events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= partition.currentTs);
+    partition.unscheduledEvents--;
+    partition.eventCount++;
+
+    partition.currentTs = next.key.m_ts;
+    partition.currentContext = next.key.m_context;
+    partition.currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+ParallelSimulatorImpl::RunSerial(uint64_t ts)
+{
+    Partition& serial = *m_partitions.front();
+    while (!m_stop && !serial.events->IsEmpty() && serial.events->PeekNext().key.m_ts == ts)
+    {
+        ProcessOneEvent(serial);
+        ProcessEventsWithContext();
+    }
+}
+
+void
+ParallelSimulatorImpl::RunPartition(Partition& partition)
+{
+    m_threadPartition = &partition;
+    while (!partition.stop && !partition.events->IsEmpty() &&
+           partition.events->PeekNext().key.m_ts < m_windowEnd)
+    {
+        ProcessOneEvent(partition);
+    }
+    m_threadPartition = nullptr;
+}
+
+void
+ParallelSimulatorImpl::RunActivePartitions()
+{
+    for (std::size_t i = m_nextActive++; i < m_active.size(); i = m_nextActive++)
+    {
+        RunPartition(*m_partitions[m_active[i]]);
+    }
+}
+
+void
+ParallelSimulatorImpl::RunWindow()
+{
+    if (m_active.size() == 1 || m_threadCount == 1)
+    {
+        for (uint32_t partition : m_active)
+        {
+            RunPartition(*m_partitions[partition]);
+        }
+        return;
+    }
+
+    if (m_workers.empty())
+    {
+        StartWorkers();
+    }
+    {
+        std::unique_lock lock{m_workersMutex};
+        m_nextActive = 0;
+        m_busyWorkers = m_workers.size();
+        m_windowCount++;
+    }
+    m_windowStart.notify_all();
+    RunActivePartitions();
+    std::unique_lock lock{m_workersMutex};
+    m_windowDone.wait(lock, [this] { return m_busyWorkers == 0; });
+}
+
+void
+ParallelSimulatorImpl::StartWorkers()
+{
+    uint32_t threads = m_threadCount;
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    NS_LOG_FUNCTION(this << threads);
+    // the windows are numbered from the start of the first worker
+    m_windowCount = 0;
+    m_exitWorkers = false;
+    for (uint32_t i = 1; i < threads; ++i)
+    {
+        m_workers.emplace_back(&ParallelSimulatorImpl::WorkerLoop, this);
+    }
+    if (m_workers.empty())
+    {
+        // a single hardware thread
+        m_threadCount = 1;
+    }
+}
+
+void
+ParallelSimulatorImpl::StopWorkers()
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    {
+        std::unique_lock lock{m_workersMutex};
+        m_exitWorkers = true;
+    }
+    m_windowStart.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void
+ParallelSimulatorImpl::WorkerLoop()
+{
+    uint64_t window = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock{m_workersMutex};
+            m_windowStart.wait(lock,
+                               [this, window] { return m_exitWorkers || m_windowCount != window; });
+            if (m_exitWorkers)
+            {
+                return;
+            }
+            window = m_windowCount;
+        }
+        RunActivePartitions();
+        std::unique_lock lock{m_workersMutex};
+        if (--m_busyWorkers == 0)
+        {
+            m_windowDone.notify_one();
+        }
+    }
+}
+
+bool
+ParallelSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    return std::all_of(m_partitions.begin(), m_partitions.end(), [](const auto& partition) {
+        return partition->events->IsEmpty() && partition->outbox.empty();
+    });
+}
+
+void
+ParallelSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    // Set the current threadId as the main threadId
+    m_mainThreadId = std::this_thread::get_id();
+    MovePendingEvents();
+    ProcessEventsWithContext();
+    m_stop = false;
+    for (auto& partition : m_partitions)
+    {
+        partition->stop = false;
+    }
+    m_running = true;
+
+    Partition& serial = *m_partitions.front();
+    uint64_t lookahead = m_lookahead.GetTimeStep();
+    while (!m_stop)
+    {
+        uint64_t serialNext = UINT64_MAX;
+        if (!serial.events->IsEmpty())
+        {
+            serialNext = serial.events->PeekNext().key.m_ts;
+        }
+        uint64_t parallelNext = UINT64_MAX;
+        for (std::size_t i = 1; i < m_partitions.size(); ++i)
+        {
+            if (!m_partitions[i]->events->IsEmpty())
+            {
+                parallelNext = std::min(parallelNext, m_partitions[i]->events->PeekNext().key.m_ts);
+            }
+        }
+        if (serialNext == UINT64_MAX && parallelNext == UINT64_MAX)
+        {
+            break;
+        }
+
+        // the events of the partition 0 go first, while the other partitions wait
+        if (serialNext <= parallelNext)
+        {
+            RunSerial(serialNext);
+            continue;
+        }
+
+        m_windowEnd = parallelNext + std::min(lookahead, UINT64_MAX - parallelNext);
+        m_windowEnd = std::min(m_windowEnd, serialNext);
+        m_active.clear();
+        for (std::size_t i = 1; i < m_partitions.size(); ++i)
+        {
+            Partition& partition = *m_partitions[i];
+            if (!partition.events->IsEmpty() && partition.events->PeekNext().key.m_ts < m_windowEnd)
+            {
+                m_active.push_back(i);
+            }
+        }
+        RunWindow();
+        ProcessOutboxes();
+        for (uint32_t i : m_active)
+        {
+            serial.currentTs = std::max(serial.currentTs, m_partitions[i]->currentTs);
+        }
+        ProcessEventsWithContext();
+    }
+    m_running = false;
+
+    // If the simulator stopped naturally by lack of events, make a
+    // consistency test to check that we didn't lose any events along the way.
+    NS_ASSERT(m_stop ||
+              std::all_of(m_partitions.begin(), m_partitions.end(), [](const auto& partition) {
+                  return partition->unscheduledEvents == 0;
+              }));
+}
+
+void
+ParallelSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_threadPartition)
+    {
+        // the other partitions stop at the end of the window
+        m_threadPartition->stop = true;
+    }
+    m_stop = true;
+}
+
+EventId
+ParallelSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    return Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+ParallelSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(m_threadPartition || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::Schedule Thread-unsafe invocation!");
+
+    NS_ASSERT_MSG(delay.IsPositive(), "ParallelSimulatorImpl::Schedule(): Negative delay");
+    Partition& current = GetCurrentPartition();
+    uint64_t ts = current.currentTs + delay.GetTimeStep();
+    uint32_t context = current.currentContext;
+    // outside of the windows, the current context may have changed partition since its event
+    return Insert(m_threadPartition ? current : GetPartition(context), ts, context, event);
+}
+
+void
+ParallelSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    if (m_threadPartition)
+    {
+        Partition& current = *m_threadPartition;
+        uint64_t ts = current.currentTs + delay.GetTimeStep();
+        Partition& target = GetPartition(context);
+        if (&target == &current)
+        {
+            Insert(current, ts, context, event);
+            return;
+        }
+        NS_ABORT_MSG_IF(ts < m_windowEnd,
+                        "Event scheduled in the partition "
+                            << GetContextPartition(context) << " with a delay of "
+                            << delay.As(Time::NS) << ", shorter than the Lookahead attribute "
+                            << m_lookahead.As(Time::NS));
+        // inserted at the end of the window
+        current.outbox.push_back({ts, context, event});
+    }
+    else if (m_mainThreadId == std::this_thread::get_id())
+    {
+        uint64_t ts = m_partitions.front()->currentTs + delay.GetTimeStep();
+        Insert(GetPartition(context), ts, context, event);
+    }
+    else
+    {
+        EventWithContext ev;
+        ev.context = context;
+        // Current time added in ProcessEventsWithContext()
+        ev.timestamp = delay.GetTimeStep();
+        ev.event = event;
+        {
+            std::unique_lock lock{m_eventsWithContextMutex};
+            m_eventsWithContext.push_back(ev);
+            m_eventsWithContextEmpty = false;
+        }
+    }
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    NS_ASSERT_MSG(m_threadPartition || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::ScheduleNow Thread-unsafe invocation!");
+
+    return Schedule(Time(0), event);
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    NS_ASSERT_MSG(m_mainThreadId == std::this_thread::get_id() && !m_threadPartition,
+                  "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+
+    EventId id(Ptr<EventImpl>(event, false),
+               m_partitions.front()->currentTs,
+               0xffffffff,
+               EventId::UID::DESTROY);
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+ParallelSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrentPartition().currentTs);
+}
+
+Time
+ParallelSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - GetCurrentPartition().currentTs);
+    }
+}
+
+void
+ParallelSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Partition& partition = GetPartition(id.GetContext());
+    NS_ABORT_MSG_IF(m_threadPartition && m_threadPartition != &partition,
+                    "Cannot remove an event of the partition "
+                        << GetContextPartition(id.GetContext()) << " from another partition");
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    partition.events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    partition.unscheduledEvents--;
+}
+
+void
+ParallelSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+ParallelSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    const Partition& partition = GetPartition(id.GetContext());
+    return id.PeekEventImpl() == nullptr || id.GetTs() < partition.currentTs ||
+           (id.GetTs() == partition.currentTs && id.GetUid() <= partition.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+ParallelSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+ParallelSimulatorImpl::GetContext() const
+{
+    return GetCurrentPartition().currentContext;
+}
+
+uint64_t
+ParallelSimulatorImpl::GetEventCount() const
+{
+    uint64_t eventCount = 0;
+    for (const auto& partition : m_partitions)
+    {
+        eventCount += partition->eventCount;
+    }
+    return eventCount;
+}
+
+} // namespace ns3
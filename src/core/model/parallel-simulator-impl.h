@@ -0,0 +1,290 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARALLEL_SIMULATOR_IMPL_H
+#define PARALLEL_SIMULATOR_IMPL_H
+
+#include "nstime.h"
+#include "object-factory.h"
+#include "simulator-impl.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ParallelSimulatorImpl declaration.
+ */
+
+namespace ns3
+{
+
+// Forward
+class Scheduler;
+
+/**
+ * \ingroup simulator
+ *
+ * A shared-memory simulator implementation, which executes the events of
+ * independent groups of contexts on several threads.
+ *
+ * The contexts, which are usually node ids, are grouped in partitions with
+ * SetContextPartition(). Each partition has its own scheduler, and the
+ * partitions 1 and above are executed in parallel, by time windows, with a
+ * conservative synchronization: within a window, a partition executes its
+ * events earlier than the end of the window without waiting for the other
+ * ones. The windows are as long as the Lookahead attribute, which must not
+ * exceed the smallest delay of the events scheduled from a partition to
+ * another one, such as the propagation delay of the channels between the
+ * nodes of different partitions. An event scheduled in another partition
+ * before the end of the current window aborts the simulation.
+ *
+ * The partition 0 holds the contexts not assigned to a partition, and the
+ * events without context. Its events are executed on the main thread while
+ * the other partitions are stopped, before the events of the other
+ * partitions at the same time, so they can access any object.
+ *
+ * The simulation is deterministic, whatever the number of threads: the
+ * events scheduled to other partitions are exchanged between the windows,
+ * in the order of their source partitions, and the uids of the events are
+ * assigned by partition.
+ *
+ * The partitions must not share mutable state, apart from the events they
+ * schedule to each other with Simulator::ScheduleWithContext: the models of
+ * ns-3 are not thread-safe, and the reference counts are not atomic. In
+ * particular, an object used by the nodes of several partitions, such as a
+ * channel whose propagation loss or fading models keep a cache, must not be
+ * used from parallel partitions. The partitions can create packets
+ * concurrently, but a packet, or a copy made by Packet::Copy, which shares
+ * its buffers, must not be passed to another partition: the only channel
+ * between partitions is the PointToPointPartitionChannel, which delivers a
+ * serialized copy of each packet. The packet uids are unique, but their
+ * values depend on the number of threads. An EventId can only be used from
+ * the partition of its event, or from the partition 0.
+ * Simulator::Stop() called by a parallel partition stops it immediately, and
+ * the other ones at the end of the current window.
+ */
+class ParallelSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    ParallelSimulatorImpl();
+    /** Destructor. */
+    ~ParallelSimulatorImpl() override;
+
+    /**
+     * Assign a context to a partition. This cannot be done while the
+     * simulation is running. The pending events of the context are moved to
+     * the new partition, with new uids.
+     *
+     * \param [in] context The context, usually a node id.
+     * \param [in] partition The partition, 0 for the serial one.
+     */
+    void SetContextPartition(uint32_t context, uint32_t partition);
+    /**
+     * Get the partition of a context.
+     *
+     * \param [in] context The context.
+     * \returns The partition of the context, 0 if it was not assigned.
+     */
+    uint32_t GetContextPartition(uint32_t context) const;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+  private:
+    void DoDispose() override;
+
+    /** An event scheduled by a partition in another one. */
+    struct RemoteEvent
+    {
+        uint64_t ts;      /**< Time stamp of the event. */
+        uint32_t context; /**< Context of the event. */
+        EventImpl* event; /**< The event implementation. */
+    };
+
+    /** The events of a group of contexts, and their execution state. */
+    struct Partition
+    {
+        Ptr<Scheduler> events;           /**< The event list. */
+        uint32_t uid;                    /**< Next event uid. */
+        uint64_t currentTs;              /**< Time stamp of the current event. */
+        uint32_t currentUid;             /**< Uid of the current event. */
+        uint32_t currentContext;         /**< Context of the current event. */
+        uint64_t eventCount;             /**< Number of events executed. */
+        int unscheduledEvents;           /**< Number of events in the event list. */
+        bool stop;                       /**< Whether the partition was stopped. */
+        std::vector<RemoteEvent> outbox; /**< Events scheduled in other partitions. */
+    };
+
+    /** An event scheduled from a thread which is not a simulator thread. */
+    struct EventWithContext
+    {
+        uint32_t context;   /**< The event context. */
+        uint64_t timestamp; /**< Event delay. */
+        EventImpl* event;   /**< The event implementation. */
+    };
+
+    /**
+     * Get the partition of a context.
+     * \param [in] context The context.
+     * \returns The partition.
+     */
+    Partition& GetPartition(uint32_t context) const;
+    /**
+     * Get the partition of the calling thread.
+     * \returns The partition executing events on this thread, or the
+     *          partition 0 on the main thread.
+     */
+    Partition& GetCurrentPartition() const;
+    /**
+     * Create the partitions up to an index.
+     * \param [in] partition The index of the last partition.
+     */
+    void CreatePartitions(uint32_t partition);
+    /**
+     * Insert an event in a partition.
+     * \param [in] partition The partition.
+     * \param [in] ts The time stamp of the event.
+     * \param [in] context The context of the event.
+     * \param [in] event The event implementation.
+     * \returns The EventId of the event.
+     */
+    EventId Insert(Partition& partition, uint64_t ts, uint32_t context, EventImpl* event);
+    /** Move the pending events whose context changed partition. */
+    void MovePendingEvents();
+    /** Move the events scheduled in other partitions to their partitions. */
+    void ProcessOutboxes();
+    /** Move events from the other threads into the partitions. */
+    void ProcessEventsWithContext();
+    /**
+     * Process the next event of a partition.
+     * \param [in] partition The partition.
+     */
+    void ProcessOneEvent(Partition& partition);
+    /**
+     * Process the events of the partition 0 at a time stamp.
+     * \param [in] ts The time stamp.
+     */
+    void RunSerial(uint64_t ts);
+    /** Process the events of the parallel partitions until m_windowEnd. */
+    void RunWindow();
+    /**
+     * Process the events of the partitions in m_active not taken yet by
+     * another thread.
+     */
+    void RunActivePartitions();
+    /**
+     * Process the events of a partition until m_windowEnd.
+     * \param [in] partition The partition.
+     */
+    void RunPartition(Partition& partition);
+    /** The loop of the worker threads. */
+    void WorkerLoop();
+    /** Start the worker threads. */
+    void StartWorkers();
+    /** Stop and join the worker threads. */
+    void StopWorkers();
+
+    /** The partition whose events the calling thread is executing, if any. */
+    static thread_local Partition* m_threadPartition;
+
+    /** The partitions, the partition 0 first. */
+    std::vector<std::unique_ptr<Partition>> m_partitions;
+    /** The partition of the contexts assigned to a parallel partition. */
+    std::unordered_map<uint32_t, uint32_t> m_partitionOfContext;
+    /** Whether the partition of a context changed since the last run. */
+    bool m_partitionsChanged;
+    /** The factory of the schedulers of the partitions. */
+    ObjectFactory m_schedulerFactory;
+
+    /** Duration of the windows of parallel execution. */
+    Time m_lookahead;
+    /** Number of threads, including the main one. */
+    uint32_t m_threadCount;
+    /** End of the current window, excluded. */
+    uint64_t m_windowEnd;
+    /** Whether the simulation is running. */
+    bool m_running;
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+
+    /** The partitions with events in the current window. */
+    std::vector<uint32_t> m_active;
+    /** Index in m_active of the next partition to run. */
+    std::atomic<std::size_t> m_nextActive;
+    /** The worker threads. */
+    std::vector<std::thread> m_workers;
+    /** Protects the synchronization state of the worker threads. */
+    std::mutex m_workersMutex;
+    /** Signals a new window to the worker threads. */
+    std::condition_variable m_windowStart;
+    /** Signals the end of the window to the main thread. */
+    std::condition_variable m_windowDone;
+    /** Number of windows started. */
+    uint64_t m_windowCount;
+    /** Number of worker threads still running the current window. */
+    uint32_t m_busyWorkers;
+    /** Whether the worker threads must exit. */
+    bool m_exitWorkers;
+
+    /** Events scheduled from the threads which are not simulator threads. */
+    std::list<EventWithContext> m_eventsWithContext;
+    /** Whether m_eventsWithContext is empty. */
+    std::atomic<bool> m_eventsWithContextEmpty;
+    /** Protects m_eventsWithContext. */
+    std::mutex m_eventsWithContextMutex;
+
+    /** The events to run at Destroy(). */
+    std::list<EventId> m_destroyEvents;
+
+    /** Main execution thread. */
+    std::thread::id m_mainThreadId;
+};
+
+} // namespace ns3
+
+#endif /* PARALLEL_SIMULATOR_IMPL_H */
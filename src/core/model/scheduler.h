@@ -95,6 +95,14 @@ class EventImpl;
  *      <th class="markdownTableHeadLeft"> Per %Event</th>
  * </tr>
  * <tr class="markdownTableBody">
+ *      <td class="markdownTableBodyLeft"> BatchedHeapScheduler </td>
+ *      <td class="markdownTableBodyLeft"> 4-ary heap of time stamp batches </td>
+ *      <td class="markdownTableBodyLeft"> Constant / Logarithmic </td>
+ *      <td class="markdownTableBodyLeft"> Constant / Logarithmic </td>
+ *      <td class="markdownTableBodyLeft"> 144 bytes </td>
+ *      <td class="markdownTableBodyLeft"> 0 </td>
+ * </tr>
+ * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> CalendarScheduler </td>
  *      <td class="markdownTableBodyLeft"> `<std::list> []` </td>
  *      <td class="markdownTableBodyLeft"> Constant </td>
@@ -16,13 +16,20 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/batched-heap-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/default-simulator-impl.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
+#include "ns3/parallel-simulator-impl.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -707,6 +714,493 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the events are recycled through the free lists of
+ * EventImpl, whatever their size, and that their arguments are preserved.
+ */
+class SimulatorEventPoolTestCase : public TestCase
+{
+  public:
+    SimulatorEventPoolTestCase();
+    void DoRun() override;
+
+  private:
+    /** An argument too large for the event to fit in a free list. */
+    struct LargeArgument
+    {
+        uint64_t values[40]; //!< The values.
+    };
+
+    /**
+     * Small event.
+     * \param a First value.
+     * \param b Second value.
+     * \param label A label appended to the labels of the events.
+     */
+    void SmallEvent(uint32_t a, uint64_t b, std::string label);
+    /**
+     * Large event.
+     * \param argument Large argument.
+     * \param weight Weight of the sum of the values of the argument.
+     */
+    void LargeEvent(LargeArgument argument, uint32_t weight);
+
+    uint64_t m_smallSum; //!< Sum of the values of the small events.
+    uint64_t m_largeSum; //!< Sum of the values of the large events.
+    std::string m_labels; //!< Labels of the small events.
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase()
+    : TestCase("Check the recycling of the events through the free lists")
+{
+}
+
+void
+SimulatorEventPoolTestCase::SmallEvent(uint32_t a, uint64_t b, std::string label)
+{
+    m_smallSum += a * b;
+    m_labels += label;
+}
+
+void
+SimulatorEventPoolTestCase::LargeEvent(LargeArgument argument, uint32_t weight)
+{
+    for (uint64_t value : argument.values)
+    {
+        m_largeSum += weight * value;
+    }
+}
+
+void
+SimulatorEventPoolTestCase::DoRun()
+{
+    const uint32_t rounds = 10;
+    const uint32_t eventsPerRound = 100;
+    LargeArgument large;
+    for (uint32_t i = 0; i < 40; ++i)
+    {
+        large.values[i] = i;
+    }
+
+    for (bool enabled : {false, true})
+    {
+        EventImpl::SetPoolEnabled(enabled);
+        EventImpl::ResetAllocationStats();
+        m_smallSum = 0;
+        m_largeSum = 0;
+        m_labels.clear();
+
+        // each round reuses the events released by the previous one
+        for (uint32_t round = 0; round < rounds; ++round)
+        {
+            for (uint32_t i = 0; i < eventsPerRound; ++i)
+            {
+                Simulator::Schedule(Seconds(round),
+                                    &SimulatorEventPoolTestCase::SmallEvent,
+                                    this,
+                                    i,
+                                    round,
+                                    "s");
+                Simulator::Schedule(Seconds(round),
+                                    &SimulatorEventPoolTestCase::LargeEvent,
+                                    this,
+                                    large,
+                                    round);
+            }
+            Simulator::Run();
+        }
+        Simulator::Destroy();
+
+        // sum over the rounds and the events of i * round, and of round * (0 + ... + 39)
+        uint64_t roundSum = rounds * (rounds - 1) / 2;
+        NS_TEST_EXPECT_MSG_EQ(m_smallSum,
+                              roundSum * eventsPerRound * (eventsPerRound - 1) / 2,
+                              "Wrong arguments of the small events");
+        NS_TEST_EXPECT_MSG_EQ(m_largeSum,
+                              roundSum * eventsPerRound * 40 * 39 / 2,
+                              "Wrong arguments of the large events");
+        NS_TEST_EXPECT_MSG_EQ(m_labels,
+                              std::string(rounds * eventsPerRound, 's'),
+                              "Wrong labels of the small events");
+
+        EventImpl::AllocationStats stats = EventImpl::GetAllocationStats();
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(stats.allocations,
+                                    2 * rounds * eventsPerRound,
+                                    "Missing event allocations");
+        NS_TEST_EXPECT_MSG_EQ(stats.releases,
+                              stats.allocations,
+                              "All the events must be released");
+        if (enabled)
+        {
+            // only the small events of all the rounds but the first one can be recycled
+            NS_TEST_EXPECT_MSG_GT_OR_EQ(stats.poolAllocations,
+                                        (rounds - 1) * eventsPerRound,
+                                        "The small events were not recycled");
+            NS_TEST_EXPECT_MSG_LT_OR_EQ(stats.poolAllocations,
+                                        stats.allocations - rounds * eventsPerRound,
+                                        "The large events must not be recycled");
+        }
+        else
+        {
+            NS_TEST_EXPECT_MSG_EQ(stats.poolAllocations, 0, "The free lists are disabled");
+        }
+    }
+    EventImpl::SetPoolEnabled(true);
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that a scheduler returns the events in the same order as
+ * MapScheduler, with many events at the same time stamps.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Factory of the scheduler to check.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    /**
+     * Check that the next events of the two schedulers are the same.
+     * \param scheduler The scheduler to check.
+     * \param reference The reference scheduler.
+     */
+    void CheckNext(Ptr<Scheduler> scheduler, Ptr<Scheduler> reference);
+
+    ObjectFactory m_schedulerFactory; //!< Factory of the scheduler to check.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the order of the events of " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::CheckNext(Ptr<Scheduler> scheduler, Ptr<Scheduler> reference)
+{
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), reference->IsEmpty(), "Wrong size");
+    if (reference->IsEmpty())
+    {
+        return;
+    }
+    Scheduler::Event next = scheduler->PeekNext();
+    Scheduler::Event expected = reference->PeekNext();
+    NS_TEST_EXPECT_MSG_EQ(next.key.m_ts, expected.key.m_ts, "Wrong time stamp");
+    NS_TEST_EXPECT_MSG_EQ(next.key.m_uid, expected.key.m_uid, "Wrong uid");
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    Ptr<Scheduler> reference = CreateObject<MapScheduler>();
+    Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+
+    // events at the same time stamps, some of them inserted in decreasing uid order
+    uint32_t uid = 1000;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        Scheduler::Event ev = {nullptr, {i % 7, --uid, 0}};
+        scheduler->Insert(ev);
+        reference->Insert(ev);
+    }
+
+    // slot-aligned time stamps, with removals of the next and of random events
+    std::vector<Scheduler::Event> events;
+    uint64_t now = 0;
+    uid = 1000;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        double action = uniform->GetValue();
+        if (action < 0.5 || reference->IsEmpty())
+        {
+            uint64_t ts = now + 125 * uniform->GetInteger(0, 40);
+            Scheduler::Event ev = {nullptr, {ts, uid++, 0}};
+            scheduler->Insert(ev);
+            reference->Insert(ev);
+            events.push_back(ev);
+        }
+        else if (action < 0.9)
+        {
+            Scheduler::Event next = scheduler->RemoveNext();
+            Scheduler::Event expected = reference->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(next.key.m_uid, expected.key.m_uid, "Wrong next event");
+            now = next.key.m_ts;
+        }
+        else
+        {
+            // remove a random event still in the schedule
+            std::size_t index = uniform->GetInteger(0, events.size() - 1);
+            Scheduler::Event ev = events[index];
+            events[index] = events.back();
+            events.pop_back();
+            // the events are removed in order, so the earlier ones were removed already
+            if (!reference->IsEmpty() && !(ev.key < reference->PeekNext().key))
+            {
+                scheduler->Remove(ev);
+                reference->Remove(ev);
+            }
+        }
+        CheckNext(scheduler, reference);
+    }
+
+    while (!reference->IsEmpty())
+    {
+        CheckNext(scheduler, reference);
+        scheduler->RemoveNext();
+        reference->RemoveNext();
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "Events left in the scheduler");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event trace written by DefaultSimulatorImpl.
+ */
+class SimulatorEventTraceTestCase : public TestCase
+{
+  public:
+    SimulatorEventTraceTestCase();
+    void DoRun() override;
+
+  private:
+    /** Event scheduling another event. */
+    void Reschedule();
+};
+
+SimulatorEventTraceTestCase::SimulatorEventTraceTestCase()
+    : TestCase("Check the event trace of DefaultSimulatorImpl")
+{
+}
+
+void
+SimulatorEventTraceTestCase::Reschedule()
+{
+    Simulator::Schedule(MilliSeconds(1), &Simulator::Stop);
+}
+
+void
+SimulatorEventTraceTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("simulator-event-trace.bin");
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventTraceFile", StringValue(filename));
+
+    EventId first = Simulator::Schedule(Seconds(1), &SimulatorEventTraceTestCase::Reschedule, this);
+    Simulator::ScheduleWithContext(7, Seconds(2), &Simulator::Stop);
+    EventId removed = Simulator::Schedule(Seconds(3), &Simulator::Stop);
+    Simulator::Remove(removed);
+    Simulator::Run();
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventTraceFile", StringValue(""));
+
+    std::vector<DefaultSimulatorImpl::EventTraceRecord> records =
+        DefaultSimulatorImpl::ReadEventTrace(filename);
+    NS_TEST_ASSERT_MSG_EQ(records.size(), 5, "Wrong number of records");
+
+    NS_TEST_EXPECT_MSG_EQ(records[0].ts, 0, "Wrong time of the first insertion");
+    NS_TEST_EXPECT_MSG_EQ(TimeStep(records[0].delay), Seconds(1), "Wrong delay");
+    NS_TEST_EXPECT_MSG_EQ(records[0].uid, first.GetUid(), "Wrong uid");
+    NS_TEST_EXPECT_MSG_EQ(records[0].remove, false, "Wrong kind of record");
+
+    NS_TEST_EXPECT_MSG_EQ(records[1].context, 7, "Wrong context");
+    NS_TEST_EXPECT_MSG_EQ(TimeStep(records[1].delay), Seconds(2), "Wrong delay");
+
+    NS_TEST_EXPECT_MSG_EQ(records[2].uid, removed.GetUid(), "Wrong uid");
+    NS_TEST_EXPECT_MSG_EQ(records[2].remove, false, "Wrong kind of record");
+    NS_TEST_EXPECT_MSG_EQ(records[3].uid, removed.GetUid(), "Wrong uid of the removed event");
+    NS_TEST_EXPECT_MSG_EQ(records[3].remove, true, "The event was not removed");
+    NS_TEST_EXPECT_MSG_EQ(TimeStep(records[3].delay), Seconds(3), "Wrong delay");
+
+    NS_TEST_EXPECT_MSG_EQ(TimeStep(records[4].ts), Seconds(1), "Wrong time of the insertion");
+    NS_TEST_EXPECT_MSG_EQ(TimeStep(records[4].delay), MilliSeconds(1), "Wrong delay");
+    NS_TEST_EXPECT_MSG_EQ(records[4].remove, false, "Wrong kind of record");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that ParallelSimulatorImpl executes the same events as
+ * DefaultSimulatorImpl, whatever the number of threads.
+ *
+ * Tokens move between contexts spread over several partitions, with delays
+ * computed from their values, and an event without context samples the
+ * number of events received by the contexts.
+ */
+class ParallelSimulatorTestCase : public TestCase
+{
+  public:
+    ParallelSimulatorTestCase();
+    void DoRun() override;
+
+  private:
+    /** The events received by a context: time stamp and token value. */
+    using Received = std::vector<std::pair<uint64_t, uint32_t>>;
+
+    /**
+     * Run the scenario.
+     * \param [in] simulatorType The simulator implementation.
+     * \param [in] threads The number of threads of ParallelSimulatorImpl.
+     * \returns The number of events executed.
+     */
+    uint64_t RunScenario(const std::string& simulatorType, uint32_t threads);
+    /**
+     * Receive a token and send it to the same context or to another one.
+     * \param [in] context The context of the event.
+     * \param [in] value The value of the token.
+     */
+    void Receive(uint32_t context, uint32_t value);
+    /** Count the events received by all the contexts. */
+    void Sample();
+
+    std::vector<Received> m_received;     //!< The events received by each context.
+    std::vector<uint32_t> m_wrongContext; //!< Wrong contexts seen by each context.
+    std::vector<std::size_t> m_samples;   //!< The number of events received over time.
+};
+
+/** Number of contexts of ParallelSimulatorTestCase. */
+static constexpr uint32_t PARALLEL_TEST_CONTEXTS = 16;
+
+ParallelSimulatorTestCase::ParallelSimulatorTestCase()
+    : TestCase("Check the events executed by ParallelSimulatorImpl")
+{
+}
+
+void
+ParallelSimulatorTestCase::Receive(uint32_t context, uint32_t value)
+{
+    // only the data of this context, the partitions may run concurrently
+    m_received[context].emplace_back(Simulator::Now().GetTimeStep(), value);
+    if (Simulator::GetContext() != context)
+    {
+        m_wrongContext[context]++;
+    }
+    uint32_t next = value * 1103515245 + 12345;
+    if (next % 4 == 0)
+    {
+        uint32_t to = (context + 1 + (next >> 8) % (PARALLEL_TEST_CONTEXTS - 1)) %
+                      PARALLEL_TEST_CONTEXTS;
+        Simulator::ScheduleWithContext(to,
+                                       MicroSeconds(1) + NanoSeconds((next >> 4) % 500),
+                                       &ParallelSimulatorTestCase::Receive,
+                                       this,
+                                       to,
+                                       next);
+    }
+    else
+    {
+        Simulator::Schedule(NanoSeconds(1 + (next >> 4) % 1000),
+                            &ParallelSimulatorTestCase::Receive,
+                            this,
+                            context,
+                            next);
+    }
+}
+
+void
+ParallelSimulatorTestCase::Sample()
+{
+    std::size_t received = 0;
+    for (const auto& events : m_received)
+    {
+        received += events.size();
+    }
+    m_samples.push_back(received);
+    Simulator::Schedule(MicroSeconds(100), &ParallelSimulatorTestCase::Sample, this);
+}
+
+uint64_t
+ParallelSimulatorTestCase::RunScenario(const std::string& simulatorType, uint32_t threads)
+{
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue(simulatorType));
+    Config::SetDefault("ns3::ParallelSimulatorImpl::ThreadCount", UintegerValue(threads));
+    Config::SetDefault("ns3::ParallelSimulatorImpl::Lookahead", TimeValue(MicroSeconds(1)));
+    m_received.assign(PARALLEL_TEST_CONTEXTS, {});
+    m_wrongContext.assign(PARALLEL_TEST_CONTEXTS, 0);
+    m_samples.clear();
+
+    Simulator::Stop(MilliSeconds(1));
+    Simulator::Schedule(MicroSeconds(50), &ParallelSimulatorTestCase::Sample, this);
+    for (uint32_t context = 0; context < PARALLEL_TEST_CONTEXTS; ++context)
+    {
+        for (uint32_t token = 0; token < 2; ++token)
+        {
+            Simulator::ScheduleWithContext(context,
+                                           NanoSeconds(token),
+                                           &ParallelSimulatorTestCase::Receive,
+                                           this,
+                                           context,
+                                           context * 2 + token);
+        }
+    }
+    // the context 0 stays in the serial partition, the events above are moved
+    Ptr<ParallelSimulatorImpl> impl =
+        DynamicCast<ParallelSimulatorImpl>(Simulator::GetImplementation());
+    for (uint32_t context = 1; impl && context < PARALLEL_TEST_CONTEXTS; ++context)
+    {
+        impl->SetContextPartition(context, 1 + context % 4);
+    }
+
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MilliSeconds(1), "Wrong stop time");
+    uint64_t eventCount = Simulator::GetEventCount();
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    return eventCount;
+}
+
+void
+ParallelSimulatorTestCase::DoRun()
+{
+    uint64_t eventCount = RunScenario("ns3::DefaultSimulatorImpl", 1);
+    std::vector<Received> reference = m_received;
+    // the order of the events of a context at the same time may differ
+    for (auto& events : reference)
+    {
+        std::sort(events.begin(), events.end());
+    }
+
+    std::vector<Received> serial;
+    std::vector<std::size_t> serialSamples;
+    for (uint32_t threads : {1, 4})
+    {
+        NS_TEST_EXPECT_MSG_EQ(RunScenario("ns3::ParallelSimulatorImpl", threads),
+                              eventCount,
+                              "Wrong number of events with " << threads << " threads");
+        if (threads == 1)
+        {
+            serial = m_received;
+            serialSamples = m_samples;
+        }
+        else
+        {
+            // deterministic, whatever the number of threads
+            NS_TEST_EXPECT_MSG_EQ((m_received == serial), true, "The events differ");
+            NS_TEST_EXPECT_MSG_EQ((m_samples == serialSamples), true, "The samples differ");
+        }
+        for (uint32_t context = 0; context < PARALLEL_TEST_CONTEXTS; ++context)
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_wrongContext[context], 0, "Wrong context");
+            std::sort(m_received[context].begin(), m_received[context].end());
+            NS_TEST_EXPECT_MSG_EQ((m_received[context] == reference[context]),
+                                  true,
+                                  "Events of the context " << context
+                                                           << " differ from DefaultSimulatorImpl");
+        }
+    }
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -730,6 +1224,12 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(BatchedHeapScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        AddTestCase(new SimulatorEventPoolTestCase, TestCase::Duration::QUICK);
+        AddTestCase(new SimulatorEventTraceTestCase, TestCase::Duration::QUICK);
+        AddTestCase(new ParallelSimulatorTestCase, TestCase::Duration::QUICK);
     }
 };
 
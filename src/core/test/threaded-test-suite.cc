@@ -292,6 +292,7 @@ class ThreadedSimulatorTestSuite : public TestSuite
         std::string simulatorTypes[] = {
             "ns3::RealtimeSimulatorImpl",
             "ns3::DefaultSimulatorImpl",
+            "ns3::ParallelSimulatorImpl",
         };
         std::string schedulerTypes[] = {
             "ns3::ListScheduler",
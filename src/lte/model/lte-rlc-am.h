@@ -34,6 +34,7 @@
 #include <ns3/lte-rlc-sequence-number.h>
 #include <ns3/lte-rlc.h>
 
+#include <deque>
 #include <fstream>
 #include <map>
 #include <string>
@@ -178,7 +179,7 @@ class LteRlcAm : public LteRlc
     void BufferSizeTrace();
 
   private:
-    std::vector<Ptr<Packet>> m_txonBuffer; ///< Transmission buffer
+    std::deque<Ptr<Packet>> m_txonBuffer; ///< Transmission buffer
 
     struct RetxSegPdu
     {
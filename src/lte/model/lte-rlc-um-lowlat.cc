@@ -228,7 +228,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txO
     Ptr<Packet> firstSegment = (*(m_txBuffer.begin()))->Copy();
     m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize();
     NS_LOG_LOGIC("txBufferSize      = " << m_txBufferSize);
-    m_txBuffer.erase(m_txBuffer.begin());
+    m_txBuffer.pop_front();
 
     while (firstSegment && (firstSegment->GetSize() > 0) && (nextSegmentSize > 0))
     {
@@ -276,7 +276,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txO
             {
                 firstSegment->AddPacketTag(oldTag);
 
-                m_txBuffer.insert(m_txBuffer.begin(), firstSegment);
+                m_txBuffer.push_front(firstSegment);
                 m_txBufferSize += (*(m_txBuffer.begin()))->GetSize();
 
                 NS_LOG_LOGIC("    TX buffer: Give back the remaining segment");
@@ -382,7 +382,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txO
             // (more segments)
             firstSegment = (*(m_txBuffer.begin()))->Copy();
             m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize();
-            m_txBuffer.erase(m_txBuffer.begin());
+            m_txBuffer.pop_front();
             NS_LOG_LOGIC("        txBufferSize = " << m_txBufferSize);
         }
     }
@@ -475,7 +475,7 @@ LteRlcUmLowLat::DoNotifyHarqDeliveryFailure()
 std::vector<Ptr<Packet>>
 LteRlcUmLowLat::GetTxBuffer()
 {
-    return m_txBuffer;
+    return std::vector<Ptr<Packet>>(m_txBuffer.begin(), m_txBuffer.end());
 }
 
 void
@@ -91,7 +91,7 @@ class LteRlcUmLowLat : public LteRlc
   private:
     uint32_t m_maxTxBufferSize;
     uint32_t m_txBufferSize;
-    std::vector<Ptr<Packet>> m_txBuffer;        // Transmission buffer
+    std::deque<Ptr<Packet>> m_txBuffer;         // Transmission buffer
     std::map<uint16_t, Ptr<Packet>> m_rxBuffer; // Reception buffer
     std::vector<Ptr<Packet>> m_reasBuffer;      // Reassembling buffer
 
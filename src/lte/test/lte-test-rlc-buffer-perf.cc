@@ -0,0 +1,162 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/lte-rlc-um-lowlat.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <ctime>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * \file lte-test-rlc-buffer-perf.cc
+ * \ingroup lte-test
+ *
+ * \brief Measure the time spent by the RLC entities to drain a large backlog
+ * of SDUs from their transmission buffer.
+ */
+
+/**
+ * \ingroup lte-test
+ *
+ * \brief MAC SAP provider which counts the PDUs sent by the RLC
+ */
+class PerfMacSapProvider : public LteMacSapProvider
+{
+  public:
+    void TransmitPdu(TransmitPduParameters params) override
+    {
+        m_numPdus++;
+    }
+
+    void ReportBufferStatus(ReportBufferStatusParameters params) override
+    {
+    }
+
+    uint32_t m_numPdus{0}; //!< number of PDUs received
+};
+
+/**
+ * \ingroup lte-test
+ *
+ * \brief Fill the transmission buffer of an RLC entity with m_numSdus SDUs,
+ * then send TX opportunities until the buffer is empty
+ */
+class LteRlcBufferPerfTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param rlcType the TypeId name of the RLC entity
+     * \param numSdus the number of SDUs in the backlog
+     */
+    LteRlcBufferPerfTestCase(std::string rlcType, uint32_t numSdus)
+        : TestCase(rlcType + " drain time with a backlog of " + std::to_string(numSdus) + " SDUs"),
+          m_rlcType(rlcType),
+          m_numSdus(numSdus)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    std::string m_rlcType;                         //!< TypeId name of the RLC entity
+    uint32_t m_numSdus;                            //!< SDUs in the backlog
+    static const uint32_t m_sduSize = 100;         //!< size of each SDU (bytes)
+    static const uint32_t m_txOpportunity = 30000; //!< size of each TX opportunity (bytes)
+};
+
+void
+LteRlcBufferPerfTestCase::DoRun()
+{
+    uint16_t rnti = 1;
+    uint8_t lcid = 3;
+
+    ObjectFactory factory(m_rlcType);
+    factory.Set("MaxTxBufferSize", UintegerValue(m_numSdus * m_sduSize));
+    Ptr<LteRlc> rlc = factory.Create<LteRlc>();
+    rlc->SetRnti(rnti);
+    rlc->SetLcId(lcid);
+    PerfMacSapProvider macSapProvider;
+    rlc->SetLteMacSapProvider(&macSapProvider);
+
+    LteRlcSapProvider::TransmitPdcpPduParameters sdu;
+    sdu.rnti = rnti;
+    sdu.lcid = lcid;
+
+    LteMacSapUser::TxOpportunityParameters txOp;
+    txOp.bytes = m_txOpportunity;
+    txOp.layer = 0;
+    txOp.harqId = 0;
+    txOp.componentCarrierId = 0;
+    txOp.rnti = rnti;
+    txOp.lcid = lcid;
+
+    clock_t start = clock();
+    for (uint32_t i = 0; i < m_numSdus; i++)
+    {
+        sdu.pdcpPdu = Create<Packet>(m_sduSize);
+        rlc->GetLteRlcSapProvider()->TransmitPdcpPdu(sdu);
+    }
+    clock_t enqueued = clock();
+    // each TX opportunity carries about 300 SDUs, so the backlog is drained before the AM
+    // transmitting window stalls
+    Ptr<LteRlcAm> rlcAm = DynamicCast<LteRlcAm>(rlc);
+    Ptr<LteRlcUmLowLat> rlcUm = DynamicCast<LteRlcUmLowLat>(rlc);
+    uint32_t txBufferSize = m_numSdus * m_sduSize;
+    for (uint32_t i = 0; i < 2 * m_numSdus * m_sduSize / m_txOpportunity && txBufferSize > 0; i++)
+    {
+        rlc->GetLteMacSapUser()->NotifyTxOpportunity(txOp);
+        txBufferSize = rlcAm ? rlcAm->GetTxBufferSize() : rlcUm->GetTxBufferSize();
+    }
+    clock_t drained = clock();
+
+    NS_TEST_ASSERT_MSG_EQ(txBufferSize, 0, "The backlog was not drained");
+    NS_TEST_ASSERT_MSG_GT(macSapProvider.m_numPdus, 0, "No PDU sent");
+
+    std::cout << GetName() << ": enqueue " << 1e3 * (enqueued - start) / CLOCKS_PER_SEC
+              << " ms, drain " << 1e3 * (drained - enqueued) / CLOCKS_PER_SEC << " ms in "
+              << macSapProvider.m_numPdus << " PDUs" << std::endl;
+
+    rlc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup lte-test
+ *
+ * \brief Performance suite for the RLC transmission buffers
+ */
+class LteRlcBufferPerfTestSuite : public TestSuite
+{
+  public:
+    LteRlcBufferPerfTestSuite()
+        : TestSuite("lte-rlc-buffer-perf", Type::PERFORMANCE)
+    {
+        AddTestCase(new LteRlcBufferPerfTestCase("ns3::LteRlcAm", 100000), Duration::QUICK);
+        AddTestCase(new LteRlcBufferPerfTestCase("ns3::LteRlcUmLowLat", 100000), Duration::QUICK);
+    }
+};
+
+static LteRlcBufferPerfTestSuite lteRlcBufferPerfTestSuite; //!< RLC buffer perf suite
@@ -31,13 +31,48 @@ using namespace mmwave;
 /*
  * This example shows how to cofigure the beamforming model to use a codebook.
  * The scenario is the same as in mmwave-simple-building-obstacle.cc.
+ * When the beam pairs are periodically updated (updatePeriod > 0), a tracking
+ * radius larger than 0 restricts most of the updates to the neighbourhood of
+ * the previous beam pair. The number of full sweeps, of tracking updates and of
+ * evaluated codeword pairs is printed at the end of the simulation.
  */
+
+static uint32_t g_numSweeps = 0;      //!< number of full sweeps
+static uint32_t g_numTracks = 0;      //!< number of tracking updates
+static uint64_t g_numEvaluations = 0; //!< number of evaluated codeword pairs
+
+static void
+BeamSearch(bool fullSweep, uint32_t numEvaluations)
+{
+    if (fullSweep)
+    {
+        g_numSweeps++;
+    }
+    else
+    {
+        g_numTracks++;
+    }
+    g_numEvaluations += numEvaluations;
+}
+
 int
 main(int argc, char* argv[])
 {
+    double updatePeriod = 0.0;
+    uint32_t trackingRadius = 0;
+
     CommandLine cmd;
+    cmd.AddValue("updatePeriod",
+                 "Update period of the beam pairs [ms], 0 to disable",
+                 updatePeriod);
+    cmd.AddValue("trackingRadius", "Codewords searched around the previous ones", trackingRadius);
     cmd.Parse(argc, argv);
 
+    Config::SetDefault("ns3::MmWaveCodebookBeamforming::UpdatePeriod",
+                       TimeValue(MilliSeconds(updatePeriod)));
+    Config::SetDefault("ns3::MmWaveCodebookBeamforming::TrackingRadius",
+                       UintegerValue(trackingRadius));
+
     Ptr<MmWaveHelper> ptr_mmWave = CreateObject<MmWaveHelper>();
     ptr_mmWave->SetChannelConditionModelType("ns3::BuildingsChannelConditionModel");
 
@@ -103,8 +138,24 @@ main(int argc, char* argv[])
     EpsBearer bearer(q);
     ptr_mmWave->ActivateDataRadioBearer(ueNetDev, bearer);
 
+    enbNetDev.Get(0)
+        ->GetObject<MmWaveEnbNetDevice>()
+        ->GetPhy()
+        ->GetDlSpectrumPhy()
+        ->GetBeamformingModel()
+        ->TraceConnectWithoutContext("BeamSearch", MakeCallback(&BeamSearch));
+    ueNetDev.Get(0)
+        ->GetObject<MmWaveUeNetDevice>()
+        ->GetPhy()
+        ->GetDlSpectrumPhy()
+        ->GetBeamformingModel()
+        ->TraceConnectWithoutContext("BeamSearch", MakeCallback(&BeamSearch));
+
     Simulator::Stop(Seconds(1));
     Simulator::Run();
+
+    std::cout << "Full sweeps: " << g_numSweeps << ", tracking updates: " << g_numTracks
+              << ", evaluated codeword pairs: " << g_numEvaluations << std::endl;
     Simulator::Destroy();
     return 0;
 }
@@ -0,0 +1,48 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Convert a codebook in the text format of src/mmwave/model/Codebooks into
+ * the binary format which FileBeamformingCodebook can memory-map.
+ *
+ * ./ns3 run "mmwave-codebook-converter --input=src/mmwave/model/Codebooks/8x8.txt
+ *            --output=src/mmwave/model/Codebooks/8x8.bin"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/file-beamforming-codebook.h"
+
+using namespace ns3;
+using namespace mmwave;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Text codebook to convert", input);
+    cmd.AddValue("output", "Binary codebook to create", output);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(input.empty() || output.empty(), "Both --input and --output are required");
+
+    FileBeamformingCodebook::ConvertToBinary(input, output);
+    return 0;
+}
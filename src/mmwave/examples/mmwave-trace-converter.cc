@@ -0,0 +1,47 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Convert a PHY or MAC trace written with the BinaryOutput attribute of
+ * MmWavePhyTrace or MmWaveMacTrace into the usual tab-separated text format.
+ *
+ * ./ns3 run "mmwave-trace-converter --input=RxPacketTrace.bin --output=RxPacketTrace.txt"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mmwave-trace-sink.h"
+
+using namespace ns3;
+using namespace mmwave;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Binary trace file to convert", input);
+    cmd.AddValue("output", "Text trace file to create", output);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(input.empty() || output.empty(), "Both --input and --output are required");
+
+    MmWaveTraceSink::ConvertToText(input, output);
+    return 0;
+}
@@ -37,6 +37,7 @@
 #include <ns3/log.h>
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace ns3
@@ -50,7 +51,7 @@ namespace mmwave
 NS_OBJECT_ENSURE_REGISTERED(MmWaveBearerStatsCalculator);
 
 MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator()
-    : m_firstWrite(true),
+    : m_delayHistogramBins(0),
       m_pendingOutput(false),
       m_aggregatedStats(true),
       m_protocolType("RLC")
@@ -59,7 +60,7 @@ MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator()
 }
 
 MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator(std::string protocolType)
-    : m_firstWrite(true),
+    : m_delayHistogramBins(0),
       m_pendingOutput(false),
       m_aggregatedStats(true)
 {
@@ -85,6 +86,19 @@ MmWaveBearerStatsCalculator::GetTypeId(void)
                           BooleanValue(true),
                           MakeBooleanAccessor(&MmWaveBearerStatsCalculator::m_aggregatedStats),
                           MakeBooleanChecker())
+            .AddAttribute("DelayHistogramBins",
+                          "Number of bins of the per-bearer PDU delay histogram appended to "
+                          "each aggregated record. The last bin also counts the delays "
+                          "beyond its upper bound. If 0, no histogram is computed. It must not be "
+                          "changed once the first PDU has been traced",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MmWaveBearerStatsCalculator::m_delayHistogramBins),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("DelayHistogramBinWidth",
+                          "Width of the bins of the PDU delay histogram",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&MmWaveBearerStatsCalculator::m_delayHistogramBinWidth),
+                          MakeTimeChecker(NanoSeconds(1)))
             .AddAttribute("StartTime",
                           "Start time of the on going epoch.",
                           TimeValue(Seconds(0.)),
@@ -128,6 +142,9 @@ MmWaveBearerStatsCalculator::DoDispose()
     {
         ShowResults();
     }
+    m_ulOutFile.close();
+    m_dlOutFile.close();
+    LteStatsCalculator::DoDispose();
 }
 
 void
@@ -162,6 +179,130 @@ MmWaveBearerStatsCalculator::GetEpoch() const
     return m_epochDuration;
 }
 
+void
+MmWaveBearerStatsCalculator::OnlineStats::Update(double value)
+{
+    count++;
+    if (count == 1)
+    {
+        mean = value;
+        s = 0;
+        min = value;
+        max = value;
+    }
+    else
+    {
+        double prevMean = mean;
+        mean = prevMean + (value - prevMean) / count;
+        s += (value - prevMean) * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+}
+
+std::vector<double>
+MmWaveBearerStatsCalculator::OnlineStats::Get() const
+{
+    if (count == 0)
+    {
+        return std::vector<double>(4, 0.0);
+    }
+    return {mean, count > 1 ? std::sqrt(s / (count - 1)) : 0.0, min, max};
+}
+
+uint32_t
+MmWaveBearerStatsCalculator::GetBearerIndex(DirectionStats& dir, uint64_t imsi, uint8_t lcid)
+{
+    auto ret = dir.index.emplace((imsi << 8) | lcid, dir.stats.size());
+    if (ret.second)
+    {
+        NS_LOG_DEBUG(this << " Creating stats for IMSI " << imsi << " and LCID " << +lcid);
+        dir.bearers.emplace_back(imsi, lcid);
+        dir.stats.emplace_back();
+        dir.delayHistogram.resize(dir.stats.size() * m_delayHistogramBins, 0);
+        dir.order.clear(); // sorted again at the next write
+    }
+    return ret.first->second;
+}
+
+const MmWaveBearerStatsCalculator::BearerStats*
+MmWaveBearerStatsCalculator::FindBearerStats(const DirectionStats& dir,
+                                             uint64_t imsi,
+                                             uint8_t lcid) const
+{
+    auto it = dir.index.find((imsi << 8) | lcid);
+    return it != dir.index.end() ? &dir.stats[it->second] : nullptr;
+}
+
+void
+MmWaveBearerStatsCalculator::UpdateTx(DirectionStats& dir,
+                                      uint16_t cellId,
+                                      uint64_t imsi,
+                                      uint16_t rnti,
+                                      uint8_t lcid,
+                                      uint32_t packetSize)
+{
+    if (Simulator::Now() >= m_startTime)
+    {
+        BearerStats& stats = dir.stats[GetBearerIndex(dir, imsi, lcid)];
+        stats.cellId = cellId;
+        stats.rnti = rnti;
+        stats.txPackets++;
+        stats.txBytes += packetSize;
+    }
+    m_pendingOutput = true;
+}
+
+void
+MmWaveBearerStatsCalculator::UpdateRx(DirectionStats& dir,
+                                      uint16_t cellId,
+                                      uint64_t imsi,
+                                      uint8_t lcid,
+                                      uint32_t packetSize,
+                                      uint64_t delay)
+{
+    if (Simulator::Now() >= m_startTime)
+    {
+        uint32_t i = GetBearerIndex(dir, imsi, lcid);
+        BearerStats& stats = dir.stats[i];
+        stats.cellId = cellId;
+        stats.rxPackets++;
+        stats.rxBytes += packetSize;
+        stats.delay.Update(delay);
+        stats.pduSize.Update(packetSize);
+        if (m_delayHistogramBins > 0)
+        {
+            uint64_t bin = delay / m_delayHistogramBinWidth.GetNanoSeconds();
+            dir.delayHistogram[i * m_delayHistogramBins +
+                               std::min<uint64_t>(bin, m_delayHistogramBins - 1)]++;
+        }
+    }
+    m_pendingOutput = true;
+}
+
+void
+MmWaveBearerStatsCalculator::WriteRawPdu(std::ofstream& outFile,
+                                         const std::string& filename,
+                                         const char* type,
+                                         uint16_t cellId,
+                                         uint64_t imsi,
+                                         uint16_t rnti,
+                                         uint8_t lcid,
+                                         uint32_t packetSize,
+                                         uint64_t delay)
+{
+    if (!outFile.is_open())
+    {
+        outFile.open(filename.c_str());
+        outFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t\n";
+    }
+    // the records are not flushed one by one, the file is flushed when the calculator is
+    // disposed
+    outFile << type << "\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId
+            << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize
+            << "\t" << delay << "\t\n";
+}
+
 void
 MmWaveBearerStatsCalculator::UlTxPdu(uint16_t cellId,
                                      uint64_t imsi,
@@ -172,26 +313,19 @@ MmWaveBearerStatsCalculator::UlTxPdu(uint16_t cellId,
     NS_LOG_FUNCTION(this << "UlTxPdu" << cellId << imsi << rnti << (uint32_t)lcid << packetSize);
     if (m_aggregatedStats)
     {
-        ImsiLcidPair_t p(imsi, lcid);
-        if (Simulator::Now() >= m_startTime)
-        {
-            m_ulCellId[p] = cellId;
-            m_flowId[p] = LteFlowId_t(rnti, lcid);
-            m_ulTxPackets[p]++;
-            m_ulTxData[p] += packetSize;
-        }
-        m_pendingOutput = true;
+        UpdateTx(m_ul, cellId, imsi, rnti, lcid, packetSize);
     }
     else
     {
-        if (!m_ulOutFile.is_open())
-        {
-            m_ulOutFile.open(GetUlOutputFilename().c_str());
-            m_ulOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_ulOutFile << "Tx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << 0 << "\t" << std::endl;
+        WriteRawPdu(m_ulOutFile,
+                    GetUlOutputFilename(),
+                    "Tx",
+                    cellId,
+                    imsi,
+                    rnti,
+                    lcid,
+                    packetSize,
+                    0);
     }
 }
 
@@ -205,26 +339,19 @@ MmWaveBearerStatsCalculator::DlTxPdu(uint16_t cellId,
     NS_LOG_FUNCTION(this << "DlTxPDU" << cellId << imsi << rnti << (uint32_t)lcid << packetSize);
     if (m_aggregatedStats)
     {
-        ImsiLcidPair_t p(imsi, lcid);
-        if (Simulator::Now() >= m_startTime)
-        {
-            m_dlCellId[p] = cellId;
-            m_flowId[p] = LteFlowId_t(rnti, lcid);
-            m_dlTxPackets[p]++;
-            m_dlTxData[p] += packetSize;
-        }
-        m_pendingOutput = true;
+        UpdateTx(m_dl, cellId, imsi, rnti, lcid, packetSize);
     }
     else
     {
-        if (!m_dlOutFile.is_open())
-        {
-            m_dlOutFile.open(GetDlOutputFilename().c_str());
-            m_dlOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_dlOutFile << "Tx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << 0 << "\t" << std::endl;
+        WriteRawPdu(m_dlOutFile,
+                    GetDlOutputFilename(),
+                    "Tx",
+                    cellId,
+                    imsi,
+                    rnti,
+                    lcid,
+                    packetSize,
+                    0);
     }
 }
 
@@ -240,36 +367,19 @@ MmWaveBearerStatsCalculator::UlRxPdu(uint16_t cellId,
                          << delay);
     if (m_aggregatedStats)
     {
-        ImsiLcidPair_t p(imsi, lcid);
-        if (Simulator::Now() >= m_startTime)
-        {
-            m_ulCellId[p] = cellId;
-            m_ulRxPackets[p]++;
-            m_ulRxData[p] += packetSize;
-
-            Uint64StatsMap::iterator it = m_ulDelay.find(p);
-            if (it == m_ulDelay.end())
-            {
-                NS_LOG_DEBUG(this << " Creating UL stats calculators for IMSI " << p.m_imsi
-                                  << " and LCID " << (uint32_t)p.m_lcId);
-                m_ulDelay[p] = CreateObject<MinMaxAvgTotalCalculator<uint64_t>>();
-                m_ulPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t>>();
-            }
-            m_ulDelay[p]->Update(delay);
-            m_ulPduSize[p]->Update(packetSize);
-        }
-        m_pendingOutput = true;
+        UpdateRx(m_ul, cellId, imsi, lcid, packetSize, delay);
     }
     else
     {
-        if (!m_ulOutFile.is_open())
-        {
-            m_ulOutFile.open(GetUlOutputFilename().c_str());
-            m_ulOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_ulOutFile << "Rx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << delay << "\t" << std::endl;
+        WriteRawPdu(m_ulOutFile,
+                    GetUlOutputFilename(),
+                    "Rx",
+                    cellId,
+                    imsi,
+                    rnti,
+                    lcid,
+                    packetSize,
+                    delay);
     }
 }
 
@@ -285,36 +395,19 @@ MmWaveBearerStatsCalculator::DlRxPdu(uint16_t cellId,
                          << delay);
     if (m_aggregatedStats)
     {
-        ImsiLcidPair_t p(imsi, lcid);
-        if (Simulator::Now() >= m_startTime)
-        {
-            m_dlCellId[p] = cellId;
-            m_dlRxPackets[p]++;
-            m_dlRxData[p] += packetSize;
-
-            Uint64StatsMap::iterator it = m_dlDelay.find(p);
-            if (it == m_dlDelay.end())
-            {
-                NS_LOG_DEBUG(this << " Creating DL stats calculators for IMSI " << p.m_imsi
-                                  << " and LCID " << (uint32_t)p.m_lcId);
-                m_dlDelay[p] = CreateObject<MinMaxAvgTotalCalculator<uint64_t>>();
-                m_dlPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t>>();
-            }
-            m_dlDelay[p]->Update(delay);
-            m_dlPduSize[p]->Update(packetSize);
-        }
-        m_pendingOutput = true;
+        UpdateRx(m_dl, cellId, imsi, lcid, packetSize, delay);
     }
     else
     {
-        if (!m_dlOutFile.is_open())
-        {
-            m_dlOutFile.open(GetDlOutputFilename().c_str());
-            m_dlOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_dlOutFile << "Rx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << delay << "\t" << std::endl;
+        WriteRawPdu(m_dlOutFile,
+                    GetDlOutputFilename(),
+                    "Rx",
+                    cellId,
+                    imsi,
+                    rnti,
+                    lcid,
+                    packetSize,
+                    delay);
     }
 }
 
@@ -325,167 +418,112 @@ MmWaveBearerStatsCalculator::ShowResults(void)
     NS_LOG_INFO("Write stats in " << GetUlOutputFilename().c_str() << " and in "
                                   << GetDlOutputFilename().c_str());
 
-    std::ofstream ulOutFile;
-    std::ofstream dlOutFile;
-
-    if (m_firstWrite == true)
+    if (!m_ulOutFile.is_open() || !m_dlOutFile.is_open())
     {
-        ulOutFile.open(GetUlOutputFilename().c_str());
-        if (!ulOutFile.is_open())
+        m_ulOutFile.open(GetUlOutputFilename().c_str());
+        if (!m_ulOutFile.is_open())
         {
             NS_LOG_ERROR("Can't open file " << GetUlOutputFilename().c_str());
             return;
         }
 
-        dlOutFile.open(GetDlOutputFilename().c_str());
-        if (!dlOutFile.is_open())
+        m_dlOutFile.open(GetDlOutputFilename().c_str());
+        if (!m_dlOutFile.is_open())
         {
             NS_LOG_ERROR("Can't open file " << GetDlOutputFilename().c_str());
             return;
         }
-        m_firstWrite = false;
-        ulOutFile << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
-        ulOutFile << "delay\tstdDev\tmin\tmax\t";
-        ulOutFile << "PduSize\tstdDev\tmin\tmax";
-        ulOutFile << std::endl;
-        dlOutFile << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
-        dlOutFile << "delay\tstdDev\tmin\tmax\t";
-        dlOutFile << "PduSize\tstdDev\tmin\tmax";
-        dlOutFile << std::endl;
-    }
-    else
-    {
-        ulOutFile.open(GetUlOutputFilename().c_str(), std::ios_base::app);
-        if (!ulOutFile.is_open())
-        {
-            NS_LOG_ERROR("Can't open file " << GetUlOutputFilename().c_str());
-            return;
-        }
-
-        dlOutFile.open(GetDlOutputFilename().c_str(), std::ios_base::app);
-        if (!dlOutFile.is_open())
+        for (std::ofstream* outFile : {&m_ulOutFile, &m_dlOutFile})
         {
-            NS_LOG_ERROR("Can't open file " << GetDlOutputFilename().c_str());
-            return;
+            *outFile << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\t";
+            *outFile << "nTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
+            *outFile << "delay\tstdDev\tmin\tmax\t";
+            *outFile << "PduSize\tstdDev\tmin\tmax";
+            if (m_delayHistogramBins > 0)
+            {
+                *outFile << "\tdelayHistogram(" << m_delayHistogramBins << "x"
+                         << m_delayHistogramBinWidth.GetSeconds() << "s)";
+            }
+            *outFile << "\n";
         }
     }
 
-    WriteUlResults(ulOutFile);
-    WriteDlResults(dlOutFile);
+    WriteResults(m_ulOutFile, m_ul);
+    WriteResults(m_dlOutFile, m_dl);
     m_pendingOutput = false;
 }
 
 void
-MmWaveBearerStatsCalculator::WriteUlResults(std::ofstream& outFile)
+MmWaveBearerStatsCalculator::WriteResults(std::ofstream& outFile, DirectionStats& dir)
 {
     NS_LOG_FUNCTION(this);
 
-    // Get the unique IMSI / LCID list
-
-    std::vector<ImsiLcidPair_t> pairVector;
-    for (Uint32Map::iterator it = m_ulTxPackets.begin(); it != m_ulTxPackets.end(); ++it)
+    // write the bearers in the order of their (IMSI, LCID) pair
+    if (dir.order.size() != dir.bearers.size())
     {
-        if (find(pairVector.begin(), pairVector.end(), (*it).first) == pairVector.end())
+        dir.order.resize(dir.bearers.size());
+        for (uint32_t i = 0; i < dir.order.size(); i++)
         {
-            pairVector.push_back((*it).first);
+            dir.order[i] = i;
         }
+        std::sort(dir.order.begin(), dir.order.end(), [&dir](uint32_t a, uint32_t b) {
+            return dir.bearers[a] < dir.bearers[b];
+        });
     }
 
     Time endTime = m_startTime + m_epochDuration;
-    for (std::vector<ImsiLcidPair_t>::iterator it = pairVector.begin(); it != pairVector.end();
-         ++it)
+    for (uint32_t i : dir.order)
     {
-        ImsiLcidPair_t p = *it;
+        const BearerStats& stats = dir.stats[i];
+        if (stats.txPackets == 0)
+        {
+            continue; // only the bearers which transmitted in this epoch are written
+        }
         outFile << m_startTime.GetNanoSeconds() / 1.0e9 << "\t";
         outFile << endTime.GetNanoSeconds() / 1.0e9 << "\t";
-        outFile << GetUlCellId(p.m_imsi, p.m_lcId) << "\t";
-        outFile << p.m_imsi << "\t";
-        outFile << m_flowId[p].m_rnti << "\t";
-        outFile << (uint32_t)m_flowId[p].m_lcId << "\t";
-        outFile << GetUlTxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetUlTxData(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetUlRxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetUlRxData(p.m_imsi, p.m_lcId) << "\t";
-        std::vector<double> stats = GetUlDelayStats(p.m_imsi, p.m_lcId);
-        for (std::vector<double>::iterator it = stats.begin(); it != stats.end(); ++it)
+        outFile << stats.cellId << "\t";
+        outFile << dir.bearers[i].m_imsi << "\t";
+        outFile << stats.rnti << "\t";
+        outFile << (uint32_t)dir.bearers[i].m_lcId << "\t";
+        outFile << stats.txPackets << "\t";
+        outFile << stats.txBytes << "\t";
+        outFile << stats.rxPackets << "\t";
+        outFile << stats.rxBytes << "\t";
+        for (double value : stats.delay.Get())
+        {
+            outFile << value * 1e-9 << "\t";
+        }
+        for (double value : stats.pduSize.Get())
         {
-            outFile << (*it) * 1e-9 << "\t";
+            outFile << value << "\t";
         }
-        stats = GetUlPduSizeStats(p.m_imsi, p.m_lcId);
-        for (std::vector<double>::iterator it = stats.begin(); it != stats.end(); ++it)
+        for (uint32_t bin = 0; bin < m_delayHistogramBins; bin++)
         {
-            outFile << (*it) << "\t";
+            outFile << dir.delayHistogram[i * m_delayHistogramBins + bin] << "\t";
         }
-        outFile << std::endl;
+        outFile << "\n";
     }
-
-    outFile.close();
+    outFile.flush();
 }
 
 void
-MmWaveBearerStatsCalculator::WriteDlResults(std::ofstream& outFile)
+MmWaveBearerStatsCalculator::ResetResults(void)
 {
     NS_LOG_FUNCTION(this);
 
-    // Get the unique IMSI list
-    std::vector<ImsiLcidPair_t> pairVector;
-    for (Uint32Map::iterator it = m_dlTxPackets.begin(); it != m_dlTxPackets.end(); ++it)
-    {
-        if (find(pairVector.begin(), pairVector.end(), (*it).first) == pairVector.end())
-        {
-            pairVector.push_back((*it).first);
-        }
-    }
-
-    Time endTime = m_startTime + m_epochDuration;
-    for (std::vector<ImsiLcidPair_t>::iterator pair = pairVector.begin(); pair != pairVector.end();
-         ++pair)
+    for (DirectionStats* dir : {&m_ul, &m_dl})
     {
-        ImsiLcidPair_t p = *pair;
-        outFile << m_startTime.GetNanoSeconds() / 1.0e9 << "\t";
-        outFile << endTime.GetNanoSeconds() / 1.0e9 << "\t";
-        outFile << GetDlCellId(p.m_imsi, p.m_lcId) << "\t";
-        outFile << p.m_imsi << "\t";
-        outFile << m_flowId[p].m_rnti << "\t";
-        outFile << (uint32_t)m_flowId[p].m_lcId << "\t";
-        outFile << GetDlTxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetDlTxData(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetDlRxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetDlRxData(p.m_imsi, p.m_lcId) << "\t";
-        std::vector<double> stats = GetDlDelayStats(p.m_imsi, p.m_lcId);
-        for (std::vector<double>::iterator it = stats.begin(); it != stats.end(); ++it)
-        {
-            outFile << (*it) * 1e-9 << "\t";
-        }
-        stats = GetDlPduSizeStats(p.m_imsi, p.m_lcId);
-        for (std::vector<double>::iterator it = stats.begin(); it != stats.end(); ++it)
+        for (BearerStats& stats : dir->stats)
         {
-            outFile << (*it) << "\t";
+            stats.txPackets = 0;
+            stats.txBytes = 0;
+            stats.rxPackets = 0;
+            stats.rxBytes = 0;
+            stats.delay = OnlineStats();
+            stats.pduSize = OnlineStats();
         }
-        outFile << std::endl;
+        std::fill(dir->delayHistogram.begin(), dir->delayHistogram.end(), 0);
     }
-
-    outFile.close();
-}
-
-void
-MmWaveBearerStatsCalculator::ResetResults(void)
-{
-    NS_LOG_FUNCTION(this);
-
-    m_ulTxPackets.erase(m_ulTxPackets.begin(), m_ulTxPackets.end());
-    m_ulRxPackets.erase(m_ulRxPackets.begin(), m_ulRxPackets.end());
-    m_ulRxData.erase(m_ulRxData.begin(), m_ulRxData.end());
-    m_ulTxData.erase(m_ulTxData.begin(), m_ulTxData.end());
-    m_ulDelay.erase(m_ulDelay.begin(), m_ulDelay.end());
-    m_ulPduSize.erase(m_ulPduSize.begin(), m_ulPduSize.end());
-
-    m_dlTxPackets.erase(m_dlTxPackets.begin(), m_dlTxPackets.end());
-    m_dlRxPackets.erase(m_dlRxPackets.begin(), m_dlRxPackets.end());
-    m_dlRxData.erase(m_dlRxData.begin(), m_dlRxData.end());
-    m_dlTxData.erase(m_dlTxData.begin(), m_dlTxData.end());
-    m_dlDelay.erase(m_dlDelay.begin(), m_dlDelay.end());
-    m_dlPduSize.erase(m_dlPduSize.begin(), m_dlPduSize.end());
 }
 
 void
@@ -514,196 +552,138 @@ uint32_t
 MmWaveBearerStatsCalculator::GetUlTxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulTxPackets[p];
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    return stats ? stats->txPackets : 0;
 }
 
 uint32_t
 MmWaveBearerStatsCalculator::GetUlRxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulRxPackets[p];
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    return stats ? stats->rxPackets : 0;
 }
 
 uint64_t
 MmWaveBearerStatsCalculator::GetUlTxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulTxData[p];
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    return stats ? stats->txBytes : 0;
 }
 
 uint64_t
 MmWaveBearerStatsCalculator::GetUlRxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulRxData[p];
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    return stats ? stats->rxBytes : 0;
+}
+
+uint32_t
+MmWaveBearerStatsCalculator::GetUlCellId(uint64_t imsi, uint8_t lcid)
+{
+    NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    return stats ? stats->cellId : 0;
 }
 
 double
 MmWaveBearerStatsCalculator::GetUlDelay(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    Uint64StatsMap::iterator it = m_ulDelay.find(p);
-    if (it == m_ulDelay.end())
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    if (!stats || stats->delay.count == 0)
     {
         NS_LOG_ERROR("UL delay for " << imsi << " - " << (uint16_t)lcid << " not found");
         return 0;
     }
-    return m_ulDelay[p]->getMean();
+    return stats->delay.mean;
 }
 
 std::vector<double>
 MmWaveBearerStatsCalculator::GetUlDelayStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint64StatsMap::iterator it = m_ulDelay.find(p);
-    if (it == m_ulDelay.end())
-    {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
-    }
-    stats.push_back(m_ulDelay[p]->getMean());
-    stats.push_back(m_ulDelay[p]->getStddev());
-    stats.push_back(m_ulDelay[p]->getMin());
-    stats.push_back(m_ulDelay[p]->getMax());
-    return stats;
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    return stats ? stats->delay.Get() : std::vector<double>(4, 0.0);
 }
 
 std::vector<double>
 MmWaveBearerStatsCalculator::GetUlPduSizeStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint32StatsMap::iterator it = m_ulPduSize.find(p);
-    if (it == m_ulPduSize.end())
-    {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
-    }
-    stats.push_back(m_ulPduSize[p]->getMean());
-    stats.push_back(m_ulPduSize[p]->getStddev());
-    stats.push_back(m_ulPduSize[p]->getMin());
-    stats.push_back(m_ulPduSize[p]->getMax());
-    return stats;
+    const BearerStats* stats = FindBearerStats(m_ul, imsi, lcid);
+    return stats ? stats->pduSize.Get() : std::vector<double>(4, 0.0);
 }
 
 uint32_t
 MmWaveBearerStatsCalculator::GetDlTxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlTxPackets[p];
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    return stats ? stats->txPackets : 0;
 }
 
 uint32_t
 MmWaveBearerStatsCalculator::GetDlRxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlRxPackets[p];
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    return stats ? stats->rxPackets : 0;
 }
 
 uint64_t
 MmWaveBearerStatsCalculator::GetDlTxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlTxData[p];
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    return stats ? stats->txBytes : 0;
 }
 
 uint64_t
 MmWaveBearerStatsCalculator::GetDlRxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlRxData[p];
-}
-
-uint32_t
-MmWaveBearerStatsCalculator::GetUlCellId(uint64_t imsi, uint8_t lcid)
-{
-    NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulCellId[p];
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    return stats ? stats->rxBytes : 0;
 }
 
 uint32_t
 MmWaveBearerStatsCalculator::GetDlCellId(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlCellId[p];
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    return stats ? stats->cellId : 0;
 }
 
 double
 MmWaveBearerStatsCalculator::GetDlDelay(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    Uint64StatsMap::iterator it = m_dlDelay.find(p);
-    if (it == m_dlDelay.end())
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    if (!stats || stats->delay.count == 0)
     {
-        NS_LOG_ERROR("DL delay for " << imsi << " not found");
+        NS_LOG_ERROR("DL delay for " << imsi << " - " << (uint16_t)lcid << " not found");
         return 0;
     }
-    return m_dlDelay[p]->getMean();
+    return stats->delay.mean;
 }
 
 std::vector<double>
 MmWaveBearerStatsCalculator::GetDlDelayStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint64StatsMap::iterator it = m_dlDelay.find(p);
-    if (it == m_dlDelay.end())
-    {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
-    }
-    stats.push_back(m_dlDelay[p]->getMean());
-    stats.push_back(m_dlDelay[p]->getStddev());
-    stats.push_back(m_dlDelay[p]->getMin());
-    stats.push_back(m_dlDelay[p]->getMax());
-    return stats;
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    return stats ? stats->delay.Get() : std::vector<double>(4, 0.0);
 }
 
 std::vector<double>
 MmWaveBearerStatsCalculator::GetDlPduSizeStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint32StatsMap::iterator it = m_dlPduSize.find(p);
-    if (it == m_dlPduSize.end())
-    {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
-    }
-    stats.push_back(m_dlPduSize[p]->getMean());
-    stats.push_back(m_dlPduSize[p]->getStddev());
-    stats.push_back(m_dlPduSize[p]->getMin());
-    stats.push_back(m_dlPduSize[p]->getMax());
-    return stats;
+    const BearerStats* stats = FindBearerStats(m_dl, imsi, lcid);
+    return stats ? stats->pduSize.Get() : std::vector<double>(4, 0.0);
 }
 
 std::string
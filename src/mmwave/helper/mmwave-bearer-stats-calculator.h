@@ -37,6 +37,8 @@
 #include <fstream>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -76,6 +78,11 @@ typedef std::map<ImsiLcidPair_t, LteFlowId_t> FlowIdMap;
  *   - Average, min, max and standard deviation of PDU delay (delay is
  *     calculated from the generation of the PDU to its reception)
  *   - Average, min, max and standard deviation of PDU size
+ *   - Optionally, the histogram of the PDU delay (see the DelayHistogramBins
+ *     attribute)
+ *
+ * If the AggregatedStats attribute is false, one record per PDU is written
+ * instead, which is useful for debugging but much larger.
  */
 class MmWaveBearerStatsCalculator : public LteStatsCalculator
 {
@@ -346,30 +353,152 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
     std::vector<double> GetDlPduSizeStats(uint64_t imsi, uint8_t lcid);
 
   private:
+    /**
+     * Online statistics of a sequence of samples, computed as in
+     * MinMaxAvgTotalCalculator
+     */
+    struct OnlineStats
+    {
+        /**
+         * Add a sample
+         * \param value the sample
+         */
+        void Update(double value);
+
+        /**
+         * \return the mean, standard deviation, min and max of the samples, or
+         *         four zeros if there are no samples
+         */
+        std::vector<double> Get() const;
+
+        uint32_t count{0}; //!< number of samples
+        double mean{0};    //!< mean of the samples
+        double s{0};       //!< sum of the squared deviations from the mean
+        double min{0};     //!< smallest sample
+        double max{0};     //!< largest sample
+    };
+
+    /**
+     * Statistics of a radio bearer in one direction, during the ongoing epoch
+     */
+    struct BearerStats
+    {
+        uint16_t cellId{0};    //!< CellId of the last PDU, kept across epochs
+        uint16_t rnti{0};      //!< RNTI of the last transmitted PDU, kept across epochs
+        uint32_t txPackets{0}; //!< number of transmitted PDUs
+        uint64_t txBytes{0};   //!< transmitted bytes
+        uint32_t rxPackets{0}; //!< number of received PDUs
+        uint64_t rxBytes{0};   //!< received bytes
+        OnlineStats delay;     //!< delay of the received PDUs, in nanoseconds
+        OnlineStats pduSize;   //!< size of the received PDUs, in bytes
+    };
+
+    /**
+     * Statistics of all the radio bearers in one direction. The bearers are
+     * stored in flat arrays, in order of appearance, and are never removed:
+     * at the end of each epoch only their counters are reset.
+     */
+    struct DirectionStats
+    {
+        std::unordered_map<uint64_t, uint32_t> index; //!< array position by (IMSI, LCID) key
+        std::vector<ImsiLcidPair_t> bearers;          //!< (IMSI, LCID) pair of each bearer
+        std::vector<BearerStats> stats;               //!< statistics of each bearer
+        std::vector<uint32_t> delayHistogram;         //!< delay histogram of each bearer
+        std::vector<uint32_t> order;                  //!< bearers sorted by (IMSI, LCID)
+    };
+
+    /**
+     * Get the statistics of a bearer, adding it if it is new
+     * \param dir the direction
+     * \param imsi the IMSI
+     * \param lcid the LCID
+     * \return the position of the bearer in the arrays of dir
+     */
+    uint32_t GetBearerIndex(DirectionStats& dir, uint64_t imsi, uint8_t lcid);
+
+    /**
+     * Find the statistics of a bearer
+     * \param dir the direction
+     * \param imsi the IMSI
+     * \param lcid the LCID
+     * \return the statistics of the bearer, or nullptr if it never sent a PDU
+     */
+    const BearerStats* FindBearerStats(const DirectionStats& dir,
+                                       uint64_t imsi,
+                                       uint8_t lcid) const;
+
+    /**
+     * Update the statistics of a bearer with a transmitted PDU
+     * \param dir the direction
+     * \param cellId CellId of the attached Enb
+     * \param imsi IMSI of the UE
+     * \param rnti C-RNTI of the UE
+     * \param lcid LCID of the bearer
+     * \param packetSize size of the PDU in bytes
+     */
+    void UpdateTx(DirectionStats& dir,
+                  uint16_t cellId,
+                  uint64_t imsi,
+                  uint16_t rnti,
+                  uint8_t lcid,
+                  uint32_t packetSize);
+
+    /**
+     * Update the statistics of a bearer with a received PDU
+     * \param dir the direction
+     * \param cellId CellId of the attached Enb
+     * \param imsi IMSI of the UE
+     * \param lcid LCID of the bearer
+     * \param packetSize size of the PDU in bytes
+     * \param delay RLC to RLC delay in nanoseconds
+     */
+    void UpdateRx(DirectionStats& dir,
+                  uint16_t cellId,
+                  uint64_t imsi,
+                  uint8_t lcid,
+                  uint32_t packetSize,
+                  uint64_t delay);
+
+    /**
+     * Write a PDU to a raw output file, opening it and writing the column
+     * descriptions the first time
+     * \param outFile the output file
+     * \param filename the name of the output file
+     * \param type "Tx" or "Rx"
+     * \param cellId CellId of the attached Enb
+     * \param imsi IMSI of the UE
+     * \param rnti C-RNTI of the UE
+     * \param lcid LCID of the bearer
+     * \param packetSize size of the PDU in bytes
+     * \param delay RLC to RLC delay in nanoseconds
+     */
+    void WriteRawPdu(std::ofstream& outFile,
+                     const std::string& filename,
+                     const char* type,
+                     uint16_t cellId,
+                     uint64_t imsi,
+                     uint16_t rnti,
+                     uint8_t lcid,
+                     uint32_t packetSize,
+                     uint64_t delay);
+
     /**
      * Called after each epoch to write collected
      * statistics to output files. During first call
      * it opens output files and write columns descriptions.
-     * During next calls it opens output files in append mode.
+     * The files stay open until the calculator is disposed.
      */
     void ShowResults(void);
 
     /**
-     * Writes collected statistics to UL output file and
-     * closes UL output file.
-     * @param outFile ofstream for UL statistics
-     */
-    void WriteUlResults(std::ofstream& outFile);
-
-    /**
-     * Writes collected statistics to DL output file and
-     * closes DL output file.
-     * @param outFile ofstream for DL statistics
+     * Writes the statistics collected in one direction during the epoch
+     * @param outFile ofstream for the statistics
+     * @param dir the statistics
      */
-    void WriteDlResults(std::ofstream& outFile);
+    void WriteResults(std::ofstream& outFile, DirectionStats& dir);
 
     /**
-     * Erases collected statistics
+     * Resets the collected statistics
      */
     void ResetResults(void);
 
@@ -388,23 +517,11 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
 
     EventId m_endEpochEvent; //!< Event id for next end epoch event
 
-    FlowIdMap m_flowId; //!< List of FlowIds, ie. (RNTI, LCID) by (IMSI, LCID) pair
-
-    Uint32Map m_dlCellId;       //!< List of DL CellIds by (IMSI, LCID) pair
-    Uint32Map m_dlTxPackets;    //!< Number of DL TX Packets by (IMSI, LCID) pair
-    Uint32Map m_dlRxPackets;    //!< Number of DL RX Packets by (IMSI, LCID) pair
-    Uint64Map m_dlTxData;       //!< Amount of DL TX Data by (IMSI, LCID) pair
-    Uint64Map m_dlRxData;       //!< Amount of DL RX Data by (IMSI, LCID) pair
-    Uint64StatsMap m_dlDelay;   //!< DL delay by (IMSI, LCID) pair
-    Uint32StatsMap m_dlPduSize; //!< DL PDU Size by (IMSI, LCID) pair
+    DirectionStats m_dl; //!< DL statistics
+    DirectionStats m_ul; //!< UL statistics
 
-    Uint32Map m_ulCellId;       //!< List of UL CellIds by (IMSI, LCID) pair
-    Uint32Map m_ulTxPackets;    //!< Number of UL TX Packets by (IMSI, LCID) pair
-    Uint32Map m_ulRxPackets;    //!< Number of UL RX Packets by (IMSI, LCID) pair
-    Uint64Map m_ulTxData;       //!< Amount of UL TX Data by (IMSI, LCID) pair
-    Uint64Map m_ulRxData;       //!< Amount of UL RX Data by (IMSI, LCID) pair
-    Uint64StatsMap m_ulDelay;   //!< UL delay by (IMSI, LCID) pair
-    Uint32StatsMap m_ulPduSize; //!< UL PDU Size by (IMSI, LCID) pair
+    uint32_t m_delayHistogramBins; //!< number of bins of the delay histograms
+    Time m_delayHistogramBinWidth; //!< width of the bins of the delay histograms
 
     /**
      * Start time of the on going epoch
@@ -416,11 +533,6 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
      */
     Time m_epochDuration;
 
-    /**
-     * true if output files have not been opened yet
-     */
-    bool m_firstWrite;
-
     /**
      * true if any output is pending
      */
@@ -42,8 +42,15 @@
 #include <ns3/log.h>
 #include <ns3/lte-enb-net-device.h>
 #include <ns3/lte-enb-rrc.h>
+#include <ns3/lte-pdcp.h>
+#include <ns3/lte-radio-bearer-info.h>
+#include <ns3/lte-rlc.h>
 #include <ns3/lte-ue-net-device.h>
 #include <ns3/lte-ue-rrc.h>
+#include <ns3/node-list.h>
+#include <ns3/node.h>
+#include <ns3/object-map.h>
+#include <ns3/pointer.h>
 
 namespace ns3
 {
@@ -79,35 +86,26 @@ struct MmWaveBoundCallbackArgument : public SimpleRefCount<MmWaveBoundCallbackAr
     uint16_t cellId;                        //!< cellId
 };
 
-struct McMmWaveBoundCallbackArgument : public SimpleRefCount<McMmWaveBoundCallbackArgument>
-{
-  public:
-    Ptr<McStatsCalculator> stats;
-};
-
 /**
  * Callback function for DL TX statistics for both RLC and PDCP
  * /param arg
- * /param path
  * /param rnti
  * /param lcid
  * /param packetSize
  */
 void
 DlTxPduCallback(Ptr<MmWaveBoundCallbackArgument> arg,
-                std::string path,
                 uint16_t rnti,
                 uint8_t lcid,
                 uint32_t packetSize)
 {
-    NS_LOG_FUNCTION(path << rnti << (uint16_t)lcid << packetSize);
+    NS_LOG_FUNCTION(rnti << (uint16_t)lcid << packetSize);
     arg->stats->DlTxPdu(arg->cellId, arg->imsi, rnti, lcid, packetSize);
 }
 
 /**
  * Callback function for DL RX statistics for both RLC and PDCP
  * /param arg
- * /param path
  * /param rnti
  * /param lcid
  * /param packetSize
@@ -115,32 +113,29 @@ DlTxPduCallback(Ptr<MmWaveBoundCallbackArgument> arg,
  */
 void
 DlRxPduCallback(Ptr<MmWaveBoundCallbackArgument> arg,
-                std::string path,
                 uint16_t rnti,
                 uint8_t lcid,
                 uint32_t packetSize,
                 uint64_t delay)
 {
-    NS_LOG_FUNCTION(path << rnti << (uint16_t)lcid << packetSize << delay);
+    NS_LOG_FUNCTION(rnti << (uint16_t)lcid << packetSize << delay);
     arg->stats->DlRxPdu(arg->cellId, arg->imsi, rnti, lcid, packetSize, delay);
 }
 
 /**
  * Callback function for UL TX statistics for both RLC and PDCP
  * /param arg
- * /param path
  * /param rnti
  * /param lcid
  * /param packetSize
  */
 void
 UlTxPduCallback(Ptr<MmWaveBoundCallbackArgument> arg,
-                std::string path,
                 uint16_t rnti,
                 uint8_t lcid,
                 uint32_t packetSize)
 {
-    NS_LOG_FUNCTION(path << rnti << (uint16_t)lcid << packetSize);
+    NS_LOG_FUNCTION(rnti << (uint16_t)lcid << packetSize);
 
     arg->stats->UlTxPdu(arg->cellId, arg->imsi, rnti, lcid, packetSize);
 }
@@ -148,7 +143,6 @@ UlTxPduCallback(Ptr<MmWaveBoundCallbackArgument> arg,
 /**
  * Callback function for UL RX statistics for both RLC and PDCP
  * /param arg
- * /param path
  * /param rnti
  * /param lcid
  * /param packetSize
@@ -156,39 +150,133 @@ UlTxPduCallback(Ptr<MmWaveBoundCallbackArgument> arg,
  */
 void
 UlRxPduCallback(Ptr<MmWaveBoundCallbackArgument> arg,
-                std::string path,
                 uint16_t rnti,
                 uint8_t lcid,
                 uint32_t packetSize,
                 uint64_t delay)
 {
-    NS_LOG_FUNCTION(path << rnti << (uint16_t)lcid << packetSize << delay);
+    NS_LOG_FUNCTION(rnti << (uint16_t)lcid << packetSize << delay);
 
     arg->stats->UlRxPdu(arg->cellId, arg->imsi, rnti, lcid, packetSize, delay);
 }
 
 void
-SwitchToLteCallback(Ptr<McMmWaveBoundCallbackArgument> arg,
-                    std::string path,
-                    uint64_t imsi,
-                    uint16_t cellId,
-                    uint16_t rnti)
+SwitchToLteCallback(Ptr<McStatsCalculator> stats, uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
-    NS_LOG_FUNCTION(path << rnti << cellId << imsi);
+    NS_LOG_FUNCTION(rnti << cellId << imsi);
 
-    arg->stats->SwitchToLte(imsi, cellId, rnti);
+    stats->SwitchToLte(imsi, cellId, rnti);
 }
 
 void
-SwitchToMmWaveCallback(Ptr<McMmWaveBoundCallbackArgument> arg,
-                       std::string path,
-                       uint64_t imsi,
-                       uint16_t cellId,
-                       uint16_t rnti)
+SwitchToMmWaveCallback(Ptr<McStatsCalculator> stats, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+    NS_LOG_FUNCTION(rnti << cellId << imsi);
+
+    stats->SwitchToMmWave(imsi, cellId, rnti);
+}
+
+/**
+ * Get the RRC instance stored in a pointer attribute of a device
+ * /param device the device
+ * /param name the name of the attribute
+ * /return the RRC instance, or 0 if the device has no such attribute
+ */
+template <class T>
+Ptr<T>
+GetDeviceRrc(Ptr<NetDevice> device, const std::string& name)
 {
-    NS_LOG_FUNCTION(path << rnti << cellId << imsi);
+    TypeId::AttributeInformation info;
+    if (!device->GetInstanceTypeId().LookupAttributeByName(name, &info))
+    {
+        return nullptr;
+    }
+    PointerValue rrc;
+    device->GetAttribute(name, rrc);
+    return rrc.Get<T>();
+}
 
-    arg->stats->SwitchToMmWave(imsi, cellId, rnti);
+/**
+ * Get a signaling radio bearer of an UE RRC or of an UE Manager
+ * /param rrc the LteUeRrc or UeManager instance
+ * /param name the name of the bearer attribute, Srb0 or Srb1
+ * /return the bearer, or 0 if it is not set up
+ */
+Ptr<LteRadioBearerInfo>
+GetSrb(Ptr<Object> rrc, const std::string& name)
+{
+    PointerValue srb;
+    rrc->GetAttribute(name, srb);
+    return srb.Get<LteRadioBearerInfo>();
+}
+
+/**
+ * Get the data radio bearers of an UE RRC or of an UE Manager
+ * /param rrc the LteUeRrc or UeManager instance
+ * /return the bearers
+ */
+std::vector<Ptr<LteDataRadioBearerInfo>>
+GetDrbs(Ptr<Object> rrc)
+{
+    ObjectMapValue drbMap;
+    rrc->GetAttribute("DataRadioBearerMap", drbMap);
+    std::vector<Ptr<LteDataRadioBearerInfo>> drbs;
+    for (ObjectMapValue::Iterator it = drbMap.Begin(); it != drbMap.End(); ++it)
+    {
+        drbs.push_back(DynamicCast<LteDataRadioBearerInfo>(it->second));
+    }
+    return drbs;
+}
+
+/**
+ * Get the RLC instances of the secondary (MC) bearers of an UE RRC or of an
+ * UE Manager
+ * /param rrc the LteUeRrc or UeManager instance
+ * /return the RLC instances
+ */
+std::vector<Ptr<LteRlc>>
+GetSecondaryRlcs(Ptr<Object> rrc)
+{
+    ObjectMapValue rlcMap;
+    rrc->GetAttribute("DataRadioRlcMap", rlcMap);
+    std::vector<Ptr<LteRlc>> rlcs;
+    for (ObjectMapValue::Iterator it = rlcMap.Begin(); it != rlcMap.End(); ++it)
+    {
+        rlcs.push_back(DynamicCast<RlcBearerInfo>(it->second)->m_rlc);
+    }
+    return rlcs;
+}
+
+/**
+ * Connect the sinks of the transmitted and received PDUs to a RLC or PDCP instance
+ * /param layer the RLC or PDCP instance, nothing is done if it is 0
+ * /param txPdu the sink of the TxPDU trace source
+ * /param rxPdu the sink of the RxPDU trace source
+ */
+void
+ConnectPduTraces(Ptr<Object> layer, const CallbackBase& txPdu, const CallbackBase& rxPdu)
+{
+    if (layer)
+    {
+        layer->TraceConnectWithoutContext("TxPDU", txPdu);
+        layer->TraceConnectWithoutContext("RxPDU", rxPdu);
+    }
+}
+
+/**
+ * Disconnect the sinks of the transmitted and received PDUs from a RLC or PDCP instance
+ * /param layer the RLC or PDCP instance, nothing is done if it is 0
+ * /param txPdu the sink of the TxPDU trace source
+ * /param rxPdu the sink of the RxPDU trace source
+ */
+void
+DisconnectPduTraces(Ptr<Object> layer, const CallbackBase& txPdu, const CallbackBase& rxPdu)
+{
+    if (layer)
+    {
+        layer->TraceDisconnectWithoutContext("TxPDU", txPdu);
+        layer->TraceDisconnectWithoutContext("RxPDU", rxPdu);
+    }
 }
 
 MmWaveBearerStatsConnector::MmWaveBearerStatsConnector()
@@ -291,6 +379,7 @@ void
 MmWaveBearerStatsConnector::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_ueManagerByCellIdRnti.clear();
 }
 
 void
@@ -320,52 +409,7 @@ MmWaveBearerStatsConnector::EnsureConnected()
     NS_LOG_FUNCTION(this);
     if (!m_connected)
     {
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteEnbRrc/NewUeContext",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyNewUeContextEnb, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteUeRrc/RandomAccessSuccessful",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyRandomAccessSuccessfulUe, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/MmWaveUeRrc/RandomAccessSuccessful",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyRandomAccessSuccessfulUe, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteEnbRrc/ConnectionReconfiguration",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyConnectionReconfigurationEnb,
-                              this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteUeRrc/ConnectionReconfiguration",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyConnectionReconfigurationUe,
-                              this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/MmWaveUeRrc/ConnectionReconfiguration",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyConnectionReconfigurationUe,
-                              this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteEnbRrc/HandoverStart",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverStartEnb, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteUeRrc/HandoverStart",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverStartUe, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/MmWaveUeRrc/HandoverStart",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverStartUe, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteEnbRrc/HandoverEndOk",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverEndOkEnb, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverEndOkUe, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/MmWaveUeRrc/HandoverEndOk",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverEndOkUe, this));
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteUeRrc/SwitchToMmWave",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifySwitchToMmWaveUe, this));
-        // mmWave SINR from RT, LTE SINR from the PHY callbacks
-        Config::ConnectFailSafe(
-            "/NodeList/*/DeviceList/*/LteEnbRrc/NotifyMmWaveSinr",
-            MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyMmWaveSinr, this));
+        ConnectRrcTraces();
         Config::ConnectFailSafe(
             "/NodeList/*/DeviceList/*/LteUePhy/ReportCurrentCellRsrpSinr",
             MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyLteSinr, this));
@@ -373,126 +417,207 @@ MmWaveBearerStatsConnector::EnsureConnected()
     }
 }
 
+void
+MmWaveBearerStatsConnector::ConnectRrcTraces()
+{
+    NS_LOG_FUNCTION(this);
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node)
+    {
+        for (uint32_t i = 0; i < (*node)->GetNDevices(); ++i)
+        {
+            Ptr<NetDevice> device = (*node)->GetDevice(i);
+
+            Ptr<LteEnbRrc> enbRrc = GetDeviceRrc<LteEnbRrc>(device, "LteEnbRrc");
+            if (enbRrc)
+            {
+                enbRrc->TraceConnectWithoutContext(
+                    "NewUeContext",
+                    MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyNewUeContextEnb,
+                                      this,
+                                      enbRrc));
+                enbRrc->TraceConnectWithoutContext(
+                    "ConnectionReconfiguration",
+                    MakeBoundCallback(
+                        &MmWaveBearerStatsConnector::NotifyConnectionReconfigurationEnb,
+                        this,
+                        enbRrc));
+                enbRrc->TraceConnectWithoutContext(
+                    "HandoverStart",
+                    MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverStartEnb,
+                                      this,
+                                      enbRrc));
+                enbRrc->TraceConnectWithoutContext(
+                    "HandoverEndOk",
+                    MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverEndOkEnb,
+                                      this,
+                                      enbRrc));
+                // mmWave SINR from RT, LTE SINR from the PHY callbacks
+                enbRrc->TraceConnectWithoutContext(
+                    "NotifyMmWaveSinr",
+                    MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyMmWaveSinr, this));
+            }
+
+            // MC devices have both a LTE and a mmWave RRC
+            for (const std::string name : {"LteUeRrc", "MmWaveUeRrc"})
+            {
+                Ptr<LteUeRrc> ueRrc = GetDeviceRrc<LteUeRrc>(device, name);
+                if (!ueRrc)
+                {
+                    continue;
+                }
+                ueRrc->TraceConnectWithoutContext(
+                    "RandomAccessSuccessful",
+                    MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyRandomAccessSuccessfulUe,
+                                      this,
+                                      ueRrc));
+                ueRrc->TraceConnectWithoutContext(
+                    "ConnectionReconfiguration",
+                    MakeBoundCallback(
+                        &MmWaveBearerStatsConnector::NotifyConnectionReconfigurationUe,
+                        this,
+                        ueRrc));
+                ueRrc->TraceConnectWithoutContext(
+                    "HandoverStart",
+                    MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverStartUe,
+                                      this,
+                                      ueRrc));
+                ueRrc->TraceConnectWithoutContext(
+                    "HandoverEndOk",
+                    MakeBoundCallback(&MmWaveBearerStatsConnector::NotifyHandoverEndOkUe,
+                                      this,
+                                      ueRrc));
+                if (name == "LteUeRrc")
+                {
+                    ueRrc->TraceConnectWithoutContext(
+                        "SwitchToMmWave",
+                        MakeBoundCallback(&MmWaveBearerStatsConnector::NotifySwitchToMmWaveUe,
+                                          this,
+                                          ueRrc));
+                }
+            }
+        }
+    }
+}
+
 void
 MmWaveBearerStatsConnector::NotifyRandomAccessSuccessfulUe(MmWaveBearerStatsConnector* c,
-                                                           std::string context,
+                                                           Ptr<LteUeRrc> ueRrc,
                                                            uint64_t imsi,
                                                            uint16_t cellId,
                                                            uint16_t rnti)
 {
-    c->ConnectSrb0Traces(context, imsi, cellId, rnti);
+    c->ConnectSrb0Traces(ueRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyConnectionSetupUe(MmWaveBearerStatsConnector* c,
-                                                    std::string context,
+                                                    Ptr<LteUeRrc> ueRrc,
                                                     uint64_t imsi,
                                                     uint16_t cellId,
                                                     uint16_t rnti)
 {
-    c->ConnectSrb1TracesUe(context, imsi, cellId, rnti);
+    c->ConnectSrb1TracesUe(ueRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyConnectionReconfigurationUe(MmWaveBearerStatsConnector* c,
-                                                              std::string context,
+                                                              Ptr<LteUeRrc> ueRrc,
                                                               uint64_t imsi,
                                                               uint16_t cellId,
                                                               uint16_t rnti)
 {
-    c->ConnectTracesUeIfFirstTime(context, imsi, cellId, rnti);
+    c->ConnectTracesUeIfFirstTime(ueRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyHandoverStartUe(MmWaveBearerStatsConnector* c,
-                                                  std::string context,
+                                                  Ptr<LteUeRrc> ueRrc,
                                                   uint64_t imsi,
                                                   uint16_t cellId,
                                                   uint16_t rnti,
                                                   uint16_t targetCellId)
 {
     c->PrintUeStartHandover(imsi, cellId, targetCellId, rnti);
-    c->DisconnectTracesUe(context, imsi, cellId, rnti);
+    c->DisconnectTracesUe(ueRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyHandoverEndOkUe(MmWaveBearerStatsConnector* c,
-                                                  std::string context,
+                                                  Ptr<LteUeRrc> ueRrc,
                                                   uint64_t imsi,
                                                   uint16_t cellId,
                                                   uint16_t rnti)
 {
     c->PrintUeEndHandover(imsi, cellId, rnti);
-    c->ConnectSrb1TracesUe(context, imsi, cellId, rnti);
-    c->ConnectDrbTracesUe(context, imsi, cellId, rnti);
+    c->ConnectSrb1TracesUe(ueRrc, imsi, cellId, rnti);
+    c->ConnectDrbTracesUe(ueRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyNewUeContextEnb(MmWaveBearerStatsConnector* c,
-                                                  std::string context,
+                                                  Ptr<LteEnbRrc> enbRrc,
                                                   uint16_t cellId,
                                                   uint16_t rnti)
 {
-    c->StoreUeManagerPath(context, cellId, rnti);
+    c->StoreUeManager(enbRrc, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyConnectionReconfigurationEnb(MmWaveBearerStatsConnector* c,
-                                                               std::string context,
+                                                               Ptr<LteEnbRrc> enbRrc,
                                                                uint64_t imsi,
                                                                uint16_t cellId,
                                                                uint16_t rnti)
 {
-    c->ConnectTracesEnbIfFirstTime(context, imsi, cellId, rnti);
+    c->ConnectTracesEnbIfFirstTime(enbRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyHandoverStartEnb(MmWaveBearerStatsConnector* c,
-                                                   std::string context,
+                                                   Ptr<LteEnbRrc> enbRrc,
                                                    uint64_t imsi,
                                                    uint16_t cellId,
                                                    uint16_t rnti,
                                                    uint16_t targetCellId)
 {
     c->PrintEnbStartHandover(imsi, cellId, targetCellId, rnti);
-    c->DisconnectTracesEnb(context, imsi, cellId, rnti);
+    c->DisconnectTracesEnb(enbRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyHandoverEndOkEnb(MmWaveBearerStatsConnector* c,
-                                                   std::string context,
+                                                   Ptr<LteEnbRrc> enbRrc,
                                                    uint64_t imsi,
                                                    uint16_t cellId,
                                                    uint16_t rnti)
 {
     c->PrintEnbEndHandover(imsi, cellId, rnti);
-    c->ConnectSrb1TracesEnb(context, imsi, cellId, rnti);
-    c->ConnectDrbTracesEnb(context, imsi, cellId, rnti);
+    c->ConnectSrb1TracesEnb(enbRrc, imsi, cellId, rnti);
+    c->ConnectDrbTracesEnb(enbRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifySwitchToMmWaveUe(MmWaveBearerStatsConnector* c,
-                                                   std::string context,
+                                                   Ptr<LteUeRrc> ueRrc,
                                                    uint64_t imsi,
                                                    uint16_t cellId,
                                                    uint16_t rnti)
 {
-    c->ConnectSecondaryTracesUe(context, imsi, cellId, rnti);
+    c->ConnectSecondaryTracesUe(ueRrc, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifySecondaryMmWaveEnbAvailable(MmWaveBearerStatsConnector* c,
-                                                              std::string context,
+                                                              Ptr<UeManager> ueManager,
                                                               uint64_t imsi,
                                                               uint16_t cellId,
                                                               uint16_t rnti)
 {
-    c->ConnectSecondaryTracesEnb(context, imsi, cellId, rnti);
+    c->ConnectSecondaryTracesEnb(ueManager, imsi, cellId, rnti);
 }
 
 void
 MmWaveBearerStatsConnector::NotifyMmWaveSinr(MmWaveBearerStatsConnector* c,
-                                             std::string context,
                                              uint64_t imsi,
                                              uint16_t cellId,
                                              long double sinr)
@@ -682,40 +807,41 @@ MmWaveBearerStatsConnector::PrintUeEndHandover(uint64_t imsi, uint16_t targetCel
 }
 
 void
-MmWaveBearerStatsConnector::StoreUeManagerPath(std::string context, uint16_t cellId, uint16_t rnti)
+MmWaveBearerStatsConnector::StoreUeManager(Ptr<LteEnbRrc> enbRrc, uint16_t cellId, uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context << cellId << rnti);
-    std::ostringstream ueManagerPath;
-    ueManagerPath << context.substr(0, context.rfind("/")) << "/UeMap/" << (uint32_t)rnti;
+    NS_LOG_FUNCTION(this << enbRrc << cellId << rnti);
+    Ptr<UeManager> ueManager = enbRrc->GetUeManager(rnti);
     CellIdRnti key;
     key.cellId = cellId;
     key.rnti = rnti;
-    m_ueManagerPathByCellIdRnti[key] = ueManagerPath.str();
+    m_ueManagerByCellIdRnti[key] = ueManager;
 
     if (m_rlcStats)
     {
-        Config::ConnectFailSafe(ueManagerPath.str() + "/SecondaryRlcCreated",
-                                MakeBoundCallback(&NotifySecondaryMmWaveEnbAvailable, this));
+        ueManager->TraceConnectWithoutContext(
+            "SecondaryRlcCreated",
+            MakeBoundCallback(&NotifySecondaryMmWaveEnbAvailable, this, ueManager));
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectSrb0Traces(std::string context,
+MmWaveBearerStatsConnector::ConnectSrb0Traces(Ptr<LteUeRrc> ueRrc,
                                               uint64_t imsi,
                                               uint16_t cellId,
                                               uint16_t rnti)
 {
     NS_LOG_FUNCTION(this << imsi << cellId << rnti);
-    std::string ueRrcPath = context.substr(0, context.rfind("/"));
     CellIdRnti key;
     key.cellId = cellId;
     key.rnti = rnti;
-    std::map<CellIdRnti, std::string>::iterator it = m_ueManagerPathByCellIdRnti.find(key);
-    NS_ASSERT(it != m_ueManagerPathByCellIdRnti.end());
-    std::string ueManagerPath = it->second;
-    NS_LOG_LOGIC(this << " ueManagerPath: " << ueManagerPath);
-    m_ueManagerPathByCellIdRnti.erase(it);
-
+    std::map<CellIdRnti, Ptr<UeManager>>::iterator it = m_ueManagerByCellIdRnti.find(key);
+    NS_ASSERT(it != m_ueManagerByCellIdRnti.end());
+    Ptr<UeManager> ueManager = it->second;
+    m_ueManagerByCellIdRnti.erase(it);
+
+    Ptr<LteRadioBearerInfo> ueSrb0 = GetSrb(ueRrc, "Srb0");
+    Ptr<LteRadioBearerInfo> enbSrb0 = GetSrb(ueManager, "Srb0");
+    Ptr<LteRadioBearerInfo> enbSrb1 = GetSrb(ueManager, "Srb1");
     if (m_rlcStats)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
@@ -723,33 +849,29 @@ MmWaveBearerStatsConnector::ConnectSrb0Traces(std::string context,
         arg->cellId = cellId;
         arg->stats = m_rlcStats;
 
-        // diconnect eventually previously connected SRB0 both at UE and eNB
-        Config::Disconnect(ueRrcPath + "/Srb0/LteRlc/TxPDU",
-                           MakeBoundCallback(&UlTxPduCallback, arg));
-        Config::Disconnect(ueRrcPath + "/Srb0/LteRlc/RxPDU",
-                           MakeBoundCallback(&DlRxPduCallback, arg));
-        Config::Disconnect(ueManagerPath + "/Srb0/LteRlc/TxPDU",
-                           MakeBoundCallback(&DlTxPduCallback, arg));
-        Config::Disconnect(ueManagerPath + "/Srb0/LteRlc/RxPDU",
-                           MakeBoundCallback(&UlRxPduCallback, arg));
-
         // connect SRB0 both at UE and eNB
-        Config::ConnectFailSafe(ueRrcPath + "/Srb0/LteRlc/TxPDU",
-                                MakeBoundCallback(&UlTxPduCallback, arg));
-        Config::ConnectFailSafe(ueRrcPath + "/Srb0/LteRlc/RxPDU",
-                                MakeBoundCallback(&DlRxPduCallback, arg));
-        Config::ConnectFailSafe(ueManagerPath + "/Srb0/LteRlc/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
-        Config::ConnectFailSafe(ueManagerPath + "/Srb0/LteRlc/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
+        if (ueSrb0)
+        {
+            ConnectPduTraces(ueSrb0->m_rlc,
+                             MakeBoundCallback(&UlTxPduCallback, arg),
+                             MakeBoundCallback(&DlRxPduCallback, arg));
+        }
+        if (enbSrb0)
+        {
+            ConnectPduTraces(enbSrb0->m_rlc,
+                             MakeBoundCallback(&DlTxPduCallback, arg),
+                             MakeBoundCallback(&UlRxPduCallback, arg));
+        }
 
         // connect SRB1 at eNB only (at UE SRB1 will be setup later)
-        Config::ConnectFailSafe(ueManagerPath + "/Srb1/LteRlc/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
-        Config::ConnectFailSafe(ueManagerPath + "/Srb1/LteRlc/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
+        if (enbSrb1)
+        {
+            ConnectPduTraces(enbSrb1->m_rlc,
+                             MakeBoundCallback(&DlTxPduCallback, arg),
+                             MakeBoundCallback(&UlRxPduCallback, arg));
+        }
     }
-    if (m_pdcpStats)
+    if (m_pdcpStats && enbSrb1)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
         arg->imsi = imsi;
@@ -757,95 +879,96 @@ MmWaveBearerStatsConnector::ConnectSrb0Traces(std::string context,
         arg->stats = m_pdcpStats;
 
         // connect SRB1 at eNB only (at UE SRB1 will be setup later)
-        Config::ConnectFailSafe(ueManagerPath + "/Srb1/LtePdcp/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
-        Config::ConnectFailSafe(ueManagerPath + "/Srb1/LtePdcp/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
+        ConnectPduTraces(enbSrb1->m_pdcp,
+                         MakeBoundCallback(&DlTxPduCallback, arg),
+                         MakeBoundCallback(&UlRxPduCallback, arg));
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectTracesUeIfFirstTime(std::string context,
+MmWaveBearerStatsConnector::ConnectTracesUeIfFirstTime(Ptr<LteUeRrc> ueRrc,
                                                        uint64_t imsi,
                                                        uint16_t cellId,
                                                        uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
+    NS_LOG_FUNCTION(this << ueRrc << imsi);
 
     // Connect PDCP and RLC traces for SRB1
     if (m_imsiSeenUeSrb.find(imsi) == m_imsiSeenUeSrb.end())
     {
         m_imsiSeenUeSrb.insert(imsi);
-        ConnectSrb1TracesUe(context, imsi, cellId, rnti);
+        ConnectSrb1TracesUe(ueRrc, imsi, cellId, rnti);
     }
 
-    std::string basePath = context.substr(0, context.rfind("/"));
-    Config::MatchContainer rlc_container =
-        Config::LookupMatches(basePath + "/DataRadioBearerMap/*/LteRlc/");
-    uint16_t numberOfRlc = rlc_container.GetN();
+    uint16_t numberOfRlc = 0;
+    for (const Ptr<LteDataRadioBearerInfo>& drb : GetDrbs(ueRrc))
+    {
+        numberOfRlc += (drb->m_rlc != nullptr);
+    }
 
     // Connect PDCP and RLC for data radio bearers
     std::map<uint64_t, uint16_t>::iterator it = m_imsiSeenUeDrb.find(imsi);
-    if (m_imsiSeenUeDrb.find(imsi) == m_imsiSeenUeDrb.end() && rlc_container.GetN() > 0)
+    if (it == m_imsiSeenUeDrb.end())
+    {
+        if (numberOfRlc > 0)
+        {
+            // If it is the first time for this imsi
+            NS_LOG_DEBUG("Insert imsi " + std::to_string(imsi));
+            m_imsiSeenUeDrb.insert(m_imsiSeenUeDrb.end(),
+                                   std::pair<uint64_t, uint16_t>(imsi, 1));
+            ConnectDrbTracesUe(ueRrc, imsi, cellId, rnti);
+        }
+    }
+    else if (it->second < numberOfRlc)
     {
-        // If it is the first time for this imsi
-        NS_LOG_DEBUG("Insert imsi " + std::to_string(imsi));
-        m_imsiSeenUeDrb.insert(m_imsiSeenUeDrb.end(), std::pair<uint64_t, uint16_t>(imsi, 1));
-        ConnectDrbTracesUe(context, imsi, cellId, rnti);
+        // If this imsi has already been connected but a new DRB is established
+        NS_LOG_DEBUG("There is a new RLC. Call ConnectDrbTracesUe to connect the traces.");
+        it->second++; // TODO Check if there could be more than one RLC to connect
+        DisconnectDrbTracesUe(ueRrc, imsi, cellId, rnti);
+        ConnectDrbTracesUe(ueRrc, imsi, cellId, rnti);
     }
     else
     {
-        if (it->second < numberOfRlc)
-        {
-            // If this imsi has already been connected but a new DRB is established
-            NS_LOG_DEBUG("There is a new RLC. Call ConnectDrbTracesUe to connect the traces.");
-            it->second++; // TODO Check if there could be more than one RLC to connect
-            DisconnectDrbTracesUe(context, imsi, cellId, rnti);
-            ConnectDrbTracesUe(context, imsi, cellId, rnti);
-        }
-        else
-        {
-            // it->second = numberOfRlc; //One or more DRBs could have been removed
-            NS_LOG_DEBUG(
-                "All RLCs traces are already connected. No need for a call to ConnectDrbTracesUe.");
-        }
+        // it->second = numberOfRlc; //One or more DRBs could have been removed
+        NS_LOG_DEBUG(
+            "All RLCs traces are already connected. No need for a call to ConnectDrbTracesUe.");
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectTracesEnbIfFirstTime(std::string context,
+MmWaveBearerStatsConnector::ConnectTracesEnbIfFirstTime(Ptr<LteEnbRrc> enbRrc,
                                                         uint64_t imsi,
                                                         uint16_t cellId,
                                                         uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
+    NS_LOG_FUNCTION(this << enbRrc << imsi);
 
     // NB SRB1 traces are already connected
 
     // Connect PDCP and RLC for data radio bearers
     // Look for the RLCs
-    std::string basePath =
-        context.substr(0, context.rfind("/")) + "/UeMap/" + std::to_string((uint32_t)rnti);
-    Config::MatchContainer rlc_container =
-        Config::LookupMatches(basePath + "/DataRadioBearerMap/*/LteRlc/");
+    bool hasRlc = false;
+    for (const Ptr<LteDataRadioBearerInfo>& drb : GetDrbs(enbRrc->GetUeManager(rnti)))
+    {
+        hasRlc |= (drb->m_rlc != nullptr);
+    }
 
-    if (m_imsiSeenEnbDrb.find(imsi) == m_imsiSeenEnbDrb.end() && rlc_container.GetN() > 0)
+    if (m_imsiSeenEnbDrb.find(imsi) == m_imsiSeenEnbDrb.end() && hasRlc)
     {
         // it is executed only if there exist at least one rlc layer
         m_imsiSeenEnbDrb.insert(imsi);
-        ConnectDrbTracesEnb(context, imsi, cellId, rnti);
+        ConnectDrbTracesEnb(enbRrc, imsi, cellId, rnti);
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectDrbTracesUe(std::string context,
+MmWaveBearerStatsConnector::ConnectDrbTracesUe(Ptr<LteUeRrc> ueRrc,
                                                uint64_t imsi,
                                                uint16_t cellId,
                                                uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
-    NS_LOG_LOGIC(this << "expected context should match /NodeList/*/DeviceList/*/LteUeRrc/");
-    std::string basePath = context.substr(0, context.rfind("/"));
+    NS_LOG_FUNCTION(this << ueRrc << imsi);
+    std::vector<Ptr<LteDataRadioBearerInfo>> drbs = GetDrbs(ueRrc);
     if (m_rlcStats)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
@@ -856,10 +979,10 @@ MmWaveBearerStatsConnector::ConnectDrbTracesUe(std::string context,
         m_rlcDrbDlRxCb[imsi] = MakeBoundCallback(&DlRxPduCallback, arg);
         m_rlcDrbUlTxCb[imsi] = MakeBoundCallback(&UlTxPduCallback, arg);
 
-        Config::ConnectFailSafe(basePath + "/DataRadioBearerMap/*/LteRlc/TxPDU",
-                                m_rlcDrbUlTxCb.at(imsi));
-        Config::ConnectFailSafe(basePath + "/DataRadioBearerMap/*/LteRlc/RxPDU",
-                                m_rlcDrbDlRxCb.at(imsi));
+        for (const Ptr<LteDataRadioBearerInfo>& drb : drbs)
+        {
+            ConnectPduTraces(drb->m_rlc, m_rlcDrbUlTxCb.at(imsi), m_rlcDrbDlRxCb.at(imsi));
+        }
     }
     if (m_pdcpStats)
     {
@@ -871,114 +994,111 @@ MmWaveBearerStatsConnector::ConnectDrbTracesUe(std::string context,
         m_pdcpDrbDlRxCb[imsi] = MakeBoundCallback(&DlRxPduCallback, arg);
         m_pdcpDrbUlTxCb[imsi] = MakeBoundCallback(&UlTxPduCallback, arg);
 
-        Config::ConnectFailSafe(basePath + "/DataRadioBearerMap/*/LtePdcp/RxPDU",
-                                m_pdcpDrbDlRxCb.at(imsi));
-        Config::ConnectFailSafe(basePath + "/DataRadioBearerMap/*/LtePdcp/TxPDU",
-                                m_pdcpDrbUlTxCb.at(imsi));
+        for (const Ptr<LteDataRadioBearerInfo>& drb : drbs)
+        {
+            ConnectPduTraces(drb->m_pdcp, m_pdcpDrbUlTxCb.at(imsi), m_pdcpDrbDlRxCb.at(imsi));
+        }
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectSrb1TracesUe(std::string ueRrcPath,
+MmWaveBearerStatsConnector::ConnectSrb1TracesUe(Ptr<LteUeRrc> ueRrc,
                                                 uint64_t imsi,
                                                 uint16_t cellId,
                                                 uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << ueRrcPath);
-    NS_LOG_LOGIC(this << "expected context should match /NodeList/*/DeviceList/*/LteUeRrc/");
-    std::string basePath = ueRrcPath.substr(0, ueRrcPath.rfind("/"));
-    NS_LOG_FUNCTION(this << imsi << cellId << rnti);
-    if (m_rlcStats)
+    NS_LOG_FUNCTION(this << ueRrc << imsi << cellId << rnti);
+    Ptr<LteRadioBearerInfo> srb1 = GetSrb(ueRrc, "Srb1");
+    if (m_rlcStats && srb1)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
         arg->imsi = imsi;
         arg->cellId = cellId;
         arg->stats = m_rlcStats;
-        Config::ConnectFailSafe(basePath + "/Srb1/LteRlc/TxPDU",
-                                MakeBoundCallback(&UlTxPduCallback, arg));
-        Config::ConnectFailSafe(basePath + "/Srb1/LteRlc/RxPDU",
-                                MakeBoundCallback(&DlRxPduCallback, arg));
+        ConnectPduTraces(srb1->m_rlc,
+                         MakeBoundCallback(&UlTxPduCallback, arg),
+                         MakeBoundCallback(&DlRxPduCallback, arg));
     }
-    if (m_pdcpStats)
+    if (m_pdcpStats && srb1)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
         arg->imsi = imsi;
         arg->cellId = cellId;
         arg->stats = m_pdcpStats;
-        Config::ConnectFailSafe(basePath + "/Srb1/LtePdcp/RxPDU",
-                                MakeBoundCallback(&DlRxPduCallback, arg));
-        Config::ConnectFailSafe(basePath + "/Srb1/LtePdcp/TxPDU",
-                                MakeBoundCallback(&UlTxPduCallback, arg));
+        ConnectPduTraces(srb1->m_pdcp,
+                         MakeBoundCallback(&UlTxPduCallback, arg),
+                         MakeBoundCallback(&DlRxPduCallback, arg));
     }
     if (m_mcStats)
     {
-        Ptr<McMmWaveBoundCallbackArgument> arg = Create<McMmWaveBoundCallbackArgument>();
-        arg->stats = m_mcStats;
-        Config::ConnectFailSafe(basePath + "/SwitchToLte",
-                                MakeBoundCallback(&SwitchToLteCallback, arg));
-        Config::ConnectFailSafe(basePath + "/SwitchToMmWave",
-                                MakeBoundCallback(&SwitchToMmWaveCallback, arg));
+        ueRrc->TraceConnectWithoutContext("SwitchToLte",
+                                          MakeBoundCallback(&SwitchToLteCallback, m_mcStats));
+        ueRrc->TraceConnectWithoutContext("SwitchToMmWave",
+                                          MakeBoundCallback(&SwitchToMmWaveCallback, m_mcStats));
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectSrb1TracesEnb(std::string context,
+MmWaveBearerStatsConnector::ConnectSrb1TracesEnb(Ptr<LteEnbRrc> enbRrc,
                                                  uint64_t imsi,
                                                  uint16_t cellId,
                                                  uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
-    NS_LOG_LOGIC(this << "expected context  should match /NodeList/*/DeviceList/*/LteEnbRrc/");
-    std::ostringstream basePath;
-    basePath << context.substr(0, context.rfind("/")) << "/UeMap/" << (uint32_t)rnti;
+    NS_LOG_FUNCTION(this << enbRrc << imsi << rnti);
+    Ptr<UeManager> ueManager = enbRrc->GetUeManager(rnti);
+    Ptr<LteRadioBearerInfo> srb0 = GetSrb(ueManager, "Srb0");
+    Ptr<LteRadioBearerInfo> srb1 = GetSrb(ueManager, "Srb1");
     if (m_rlcStats)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
         arg->imsi = imsi;
         arg->cellId = cellId;
         arg->stats = m_rlcStats;
-        Config::ConnectFailSafe(basePath.str() + "/Srb0/LteRlc/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
-        Config::ConnectFailSafe(basePath.str() + "/Srb0/LteRlc/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
-        Config::ConnectFailSafe(basePath.str() + "/Srb1/LteRlc/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
-        Config::ConnectFailSafe(basePath.str() + "/Srb1/LteRlc/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
+        if (srb0)
+        {
+            ConnectPduTraces(srb0->m_rlc,
+                             MakeBoundCallback(&DlTxPduCallback, arg),
+                             MakeBoundCallback(&UlRxPduCallback, arg));
+        }
+        if (srb1)
+        {
+            ConnectPduTraces(srb1->m_rlc,
+                             MakeBoundCallback(&DlTxPduCallback, arg),
+                             MakeBoundCallback(&UlRxPduCallback, arg));
+        }
     }
-    if (m_pdcpStats)
+    if (m_pdcpStats && srb1)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
         arg->imsi = imsi;
         arg->cellId = cellId;
         arg->stats = m_pdcpStats;
-        Config::ConnectFailSafe(basePath.str() + "/Srb1/LtePdcp/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
-        Config::ConnectFailSafe(basePath.str() + "/Srb1/LtePdcp/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
+        ConnectPduTraces(srb1->m_pdcp,
+                         MakeBoundCallback(&DlTxPduCallback, arg),
+                         MakeBoundCallback(&UlRxPduCallback, arg));
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectDrbTracesEnb(std::string context,
+MmWaveBearerStatsConnector::ConnectDrbTracesEnb(Ptr<LteEnbRrc> enbRrc,
                                                 uint64_t imsi,
                                                 uint16_t cellId,
                                                 uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
-    NS_LOG_LOGIC(this << "expected context  should match /NodeList/*/DeviceList/*/LteEnbRrc/");
-    std::ostringstream basePath;
-    basePath << context.substr(0, context.rfind("/")) << "/UeMap/" << (uint32_t)rnti;
+    NS_LOG_FUNCTION(this << enbRrc << imsi << rnti);
+    std::vector<Ptr<LteDataRadioBearerInfo>> drbs = GetDrbs(enbRrc->GetUeManager(rnti));
     if (m_rlcStats)
     {
         Ptr<MmWaveBoundCallbackArgument> arg = Create<MmWaveBoundCallbackArgument>();
         arg->imsi = imsi;
         arg->cellId = cellId;
         arg->stats = m_rlcStats;
-        Config::ConnectFailSafe(basePath.str() + "/DataRadioBearerMap/*/LteRlc/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
-        Config::ConnectFailSafe(basePath.str() + "/DataRadioBearerMap/*/LteRlc/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
+        for (const Ptr<LteDataRadioBearerInfo>& drb : drbs)
+        {
+            ConnectPduTraces(drb->m_rlc,
+                             MakeBoundCallback(&DlTxPduCallback, arg),
+                             MakeBoundCallback(&UlRxPduCallback, arg));
+        }
     }
     if (m_pdcpStats)
     {
@@ -986,70 +1106,58 @@ MmWaveBearerStatsConnector::ConnectDrbTracesEnb(std::string context,
         arg->imsi = imsi;
         arg->cellId = cellId;
         arg->stats = m_pdcpStats;
-        Config::ConnectFailSafe(basePath.str() + "/DataRadioBearerMap/*/LtePdcp/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
-        Config::ConnectFailSafe(basePath.str() + "/DataRadioBearerMap/*/LtePdcp/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
+        for (const Ptr<LteDataRadioBearerInfo>& drb : drbs)
+        {
+            ConnectPduTraces(drb->m_pdcp,
+                             MakeBoundCallback(&DlTxPduCallback, arg),
+                             MakeBoundCallback(&UlRxPduCallback, arg));
+        }
     }
 }
 
 void
-MmWaveBearerStatsConnector::DisconnectTracesUe(std::string context,
+MmWaveBearerStatsConnector::DisconnectTracesUe(Ptr<LteUeRrc> ueRrc,
                                                uint64_t imsi,
                                                uint16_t cellId,
                                                uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
-    NS_LOG_LOGIC(this << "expected context should match /NodeList/*/DeviceList/*/LteUeRrc/");
-    std::string basePath = context.substr(0, context.rfind("/"));
-    Config::MatchContainer objects =
-        Config::LookupMatches(basePath + "/DataRadioBearerMap/*/LteRlc/");
-    NS_LOG_LOGIC("basePath " << basePath);
+    NS_LOG_FUNCTION(this << ueRrc << imsi);
 
     if (m_mcStats)
     {
-        Ptr<McMmWaveBoundCallbackArgument> arg = Create<McMmWaveBoundCallbackArgument>();
-        arg->stats = m_mcStats;
-        Config::Disconnect(basePath + "/SwitchToLte", MakeBoundCallback(&SwitchToLteCallback, arg));
-        Config::Disconnect(basePath + "/SwitchToMmWave",
-                           MakeBoundCallback(&SwitchToMmWaveCallback, arg));
+        ueRrc->TraceDisconnectWithoutContext("SwitchToLte",
+                                             MakeBoundCallback(&SwitchToLteCallback, m_mcStats));
+        ueRrc->TraceDisconnectWithoutContext(
+            "SwitchToMmWave",
+            MakeBoundCallback(&SwitchToMmWaveCallback, m_mcStats));
     }
 }
 
 void
-MmWaveBearerStatsConnector::DisconnectDrbTracesUe(std::string context,
+MmWaveBearerStatsConnector::DisconnectDrbTracesUe(Ptr<LteUeRrc> ueRrc,
                                                   uint64_t imsi,
                                                   uint16_t cellId,
                                                   uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
-    NS_LOG_LOGIC(this << "expected context should match /NodeList/*/DeviceList/*/LteUeRrc/");
-    std::string basePath = context.substr(0, context.rfind("/"));
-    NS_LOG_LOGIC("basePath " << basePath);
+    NS_LOG_FUNCTION(this << ueRrc << imsi);
+    std::vector<Ptr<LteDataRadioBearerInfo>> drbs = GetDrbs(ueRrc);
+    NS_LOG_LOGIC("Number of DRBs to disconnect " << drbs.size());
 
-    if (m_rlcStats)
-    {
-        Config::MatchContainer rlc_container =
-            Config::LookupMatches(basePath + "/DataRadioBearerMap/*/LteRlc/");
-        NS_LOG_LOGIC("Number of RLC to disconnect " << rlc_container.GetN());
-
-        rlc_container.Disconnect("RxPDU", m_rlcDrbDlRxCb.at(imsi));
-        rlc_container.Disconnect("TxPDU", m_rlcDrbUlTxCb.at(imsi));
-    }
-
-    if (m_pdcpStats)
+    for (const Ptr<LteDataRadioBearerInfo>& drb : drbs)
     {
-        Config::MatchContainer pdcp_container =
-            Config::LookupMatches(basePath + "/DataRadioBearerMap/*/LtePdcp/");
-        NS_LOG_LOGIC("Number of PDCP to disconnect " << pdcp_container.GetN());
-
-        pdcp_container.Disconnect("RxPDU", m_pdcpDrbDlRxCb.at(imsi));
-        pdcp_container.Disconnect("TxPDU", m_pdcpDrbUlTxCb.at(imsi));
+        if (m_rlcStats)
+        {
+            DisconnectPduTraces(drb->m_rlc, m_rlcDrbUlTxCb.at(imsi), m_rlcDrbDlRxCb.at(imsi));
+        }
+        if (m_pdcpStats)
+        {
+            DisconnectPduTraces(drb->m_pdcp, m_pdcpDrbUlTxCb.at(imsi), m_pdcpDrbDlRxCb.at(imsi));
+        }
     }
 }
 
 void
-MmWaveBearerStatsConnector::DisconnectTracesEnb(std::string context,
+MmWaveBearerStatsConnector::DisconnectTracesEnb(Ptr<LteEnbRrc> enbRrc,
                                                 uint64_t imsi,
                                                 uint16_t cellId,
                                                 uint16_t rnti)
@@ -1058,16 +1166,12 @@ MmWaveBearerStatsConnector::DisconnectTracesEnb(std::string context,
 }
 
 void
-MmWaveBearerStatsConnector::ConnectSecondaryTracesUe(std::string context,
+MmWaveBearerStatsConnector::ConnectSecondaryTracesUe(Ptr<LteUeRrc> ueRrc,
                                                      uint64_t imsi,
                                                      uint16_t cellId,
                                                      uint16_t rnti)
 {
-    NS_LOG_LOGIC(this << context);
-    NS_LOG_LOGIC(this << "expected context should match /NodeList/*/DeviceList/*/LteUeRrc/");
-    std::string basePath = context.substr(0, context.rfind("/"));
-    Config::MatchContainer objects = Config::LookupMatches(basePath + "/DataRadioRlcMap/*");
-    NS_LOG_LOGIC("basePath " << basePath);
+    NS_LOG_FUNCTION(this << ueRrc << imsi);
 
     if (m_rlcStats)
     {
@@ -1076,27 +1180,22 @@ MmWaveBearerStatsConnector::ConnectSecondaryTracesUe(std::string context,
         arg->cellId = cellId;
         arg->stats = m_rlcStats;
         // for MC devices
-        Config::ConnectFailSafe(basePath + "/DataRadioRlcMap/*/LteRlc/TxPDU",
-                                MakeBoundCallback(&UlTxPduCallback, arg));
-        Config::ConnectFailSafe(basePath + "/DataRadioRlcMap/*/LteRlc/RxPDU",
-                                MakeBoundCallback(&DlRxPduCallback, arg));
+        for (const Ptr<LteRlc>& rlc : GetSecondaryRlcs(ueRrc))
+        {
+            ConnectPduTraces(rlc,
+                             MakeBoundCallback(&UlTxPduCallback, arg),
+                             MakeBoundCallback(&DlRxPduCallback, arg));
+        }
     }
 }
 
 void
-MmWaveBearerStatsConnector::ConnectSecondaryTracesEnb(std::string context,
+MmWaveBearerStatsConnector::ConnectSecondaryTracesEnb(Ptr<UeManager> ueManager,
                                                       uint64_t imsi,
                                                       uint16_t cellId,
                                                       uint16_t rnti)
 {
-    NS_LOG_FUNCTION(this << context);
-    NS_LOG_LOGIC(
-        this << "expected context should match /NodeList/*/DeviceList/*/LteEnbRrc/UeMap/*");
-    std::ostringstream basePath;
-    basePath << context.substr(0, context.rfind("/"));
-    Config::MatchContainer objects =
-        Config::LookupMatches(basePath.str() + "/DataRadioRlcMap/*/LteRlc/");
-    NS_LOG_LOGIC("basePath " << basePath.str());
+    NS_LOG_FUNCTION(this << ueManager << imsi);
 
     if (m_rlcStats)
     {
@@ -1105,10 +1204,12 @@ MmWaveBearerStatsConnector::ConnectSecondaryTracesEnb(std::string context,
         arg->cellId = cellId;
         arg->stats = m_rlcStats;
         // for MC devices
-        Config::ConnectFailSafe(basePath.str() + "/DataRadioRlcMap/*/LteRlc/RxPDU",
-                                MakeBoundCallback(&UlRxPduCallback, arg));
-        Config::ConnectFailSafe(basePath.str() + "/DataRadioRlcMap/*/LteRlc/TxPDU",
-                                MakeBoundCallback(&DlTxPduCallback, arg));
+        for (const Ptr<LteRlc>& rlc : GetSecondaryRlcs(ueManager))
+        {
+            ConnectPduTraces(rlc,
+                             MakeBoundCallback(&DlTxPduCallback, arg),
+                             MakeBoundCallback(&UlRxPduCallback, arg));
+        }
     }
 }
 
@@ -51,6 +51,10 @@
 namespace ns3
 {
 
+class LteEnbRrc;
+class LteUeRrc;
+class UeManager;
+
 namespace mmwave
 {
 
@@ -67,6 +71,12 @@ class MmWaveBearerStatsCalculator;
  * Usually user do not use this class. All he/she needs to
  * to do is to call: LteHelper::EnablePdcpTraces() and/or
  * LteHelper::EnableRlcTraces().
+ *
+ * The RRC trace sources of the devices installed when the first calculator
+ * is enabled are connected once, bound to their RRC instance. The RLC and
+ * PDCP instances of a radio bearer are then reached directly from the RRC
+ * which notifies the bearer, so that connecting them does not resolve any
+ * Config path.
  */
 
 class MmWaveBearerStatsConnector : public Object
@@ -109,19 +119,21 @@ class MmWaveBearerStatsConnector : public Object
      */
     void EnsureConnected();
 
-    // trace sinks, to be used with MakeBoundCallback
+    // trace sinks, to be used with MakeBoundCallback. They are bound to the
+    // RRC instance that owns the trace source, so that the radio bearers of a
+    // UE are reached directly from it, without resolving any Config path
 
     /**
      * Function hooked to RandomAccessSuccessful trace source at UE RRC,
      * which is fired upon successful completion of the random access procedure
      * \param c
-     * \param context
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
     static void NotifyRandomAccessSuccessfulUe(MmWaveBearerStatsConnector* c,
-                                               std::string context,
+                                               Ptr<LteUeRrc> ueRrc,
                                                uint64_t imsi,
                                                uint16_t cellid,
                                                uint16_t rnti);
@@ -129,13 +141,13 @@ class MmWaveBearerStatsConnector : public Object
     /**
      * Sink connected source of UE Connection Setup trace. Not used.
      * \param c
-     * \param context
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
     static void NotifyConnectionSetupUe(MmWaveBearerStatsConnector* c,
-                                        std::string context,
+                                        Ptr<LteUeRrc> ueRrc,
                                         uint64_t imsi,
                                         uint16_t cellid,
                                         uint16_t rnti);
@@ -144,13 +156,13 @@ class MmWaveBearerStatsConnector : public Object
      * Function hooked to ConnectionReconfiguration trace source at UE RRC,
      * which is fired upon RRC connection reconfiguration
      * \param c
-     * \param context
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
     static void NotifyConnectionReconfigurationUe(MmWaveBearerStatsConnector* c,
-                                                  std::string context,
+                                                  Ptr<LteUeRrc> ueRrc,
                                                   uint64_t imsi,
                                                   uint16_t cellid,
                                                   uint16_t rnti);
@@ -159,14 +171,14 @@ class MmWaveBearerStatsConnector : public Object
      * Function hooked to HandoverStart trace source at UE RRC,
      * which is fired upon start of a handover procedure
      * \param c
-     * \param context
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      * \param targetCellId
      */
     static void NotifyHandoverStartUe(MmWaveBearerStatsConnector* c,
-                                      std::string context,
+                                      Ptr<LteUeRrc> ueRrc,
                                       uint64_t imsi,
                                       uint16_t cellid,
                                       uint16_t rnti,
@@ -176,13 +188,13 @@ class MmWaveBearerStatsConnector : public Object
      * Function hooked to HandoverStart trace source at UE RRC,
      * which is fired upon successful termination of a handover procedure
      * \param c
-     * \param context
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
     static void NotifyHandoverEndOkUe(MmWaveBearerStatsConnector* c,
-                                      std::string context,
+                                      Ptr<LteUeRrc> ueRrc,
                                       uint64_t imsi,
                                       uint16_t cellid,
                                       uint16_t rnti);
@@ -191,12 +203,12 @@ class MmWaveBearerStatsConnector : public Object
      * Function hooked to NewUeContext trace source at eNB RRC,
      * which is fired upon creation of a new UE context
      * \param c
-     * \param context
+     * \param enbRrc
      * \param cellid
      * \param rnti
      */
     static void NotifyNewUeContextEnb(MmWaveBearerStatsConnector* c,
-                                      std::string context,
+                                      Ptr<LteEnbRrc> enbRrc,
                                       uint16_t cellid,
                                       uint16_t rnti);
 
@@ -204,13 +216,13 @@ class MmWaveBearerStatsConnector : public Object
      * Function hooked to ConnectionReconfiguration trace source at eNB RRC,
      * which is fired upon RRC connection reconfiguration
      * \param c
-     * \param context
+     * \param enbRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
     static void NotifyConnectionReconfigurationEnb(MmWaveBearerStatsConnector* c,
-                                                   std::string context,
+                                                   Ptr<LteEnbRrc> enbRrc,
                                                    uint64_t imsi,
                                                    uint16_t cellid,
                                                    uint16_t rnti);
@@ -219,14 +231,14 @@ class MmWaveBearerStatsConnector : public Object
      * Function hooked to HandoverStart trace source at eNB RRC,
      * which is fired upon start of a handover procedure
      * \param c
-     * \param context
+     * \param enbRrc
      * \param imsi
      * \param cellid
      * \param rnti
      * \param targetCellId
      */
     static void NotifyHandoverStartEnb(MmWaveBearerStatsConnector* c,
-                                       std::string context,
+                                       Ptr<LteEnbRrc> enbRrc,
                                        uint64_t imsi,
                                        uint16_t cellid,
                                        uint16_t rnti,
@@ -236,32 +248,31 @@ class MmWaveBearerStatsConnector : public Object
      * Function hooked to HandoverEndOk trace source at eNB RRC,
      * which is fired upon successful termination of a handover procedure
      * \param c
-     * \param context
+     * \param enbRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
     static void NotifyHandoverEndOkEnb(MmWaveBearerStatsConnector* c,
-                                       std::string context,
+                                       Ptr<LteEnbRrc> enbRrc,
                                        uint64_t imsi,
                                        uint16_t cellid,
                                        uint16_t rnti);
 
     // TODO doc
     static void NotifySwitchToMmWaveUe(MmWaveBearerStatsConnector* c,
-                                       std::string context,
+                                       Ptr<LteUeRrc> ueRrc,
                                        uint64_t imsi,
                                        uint16_t cellId,
                                        uint16_t rnti);
 
     static void NotifySecondaryMmWaveEnbAvailable(MmWaveBearerStatsConnector* c,
-                                                  std::string context,
+                                                  Ptr<UeManager> ueManager,
                                                   uint64_t imsi,
                                                   uint16_t cellId,
                                                   uint16_t rnti);
 
     static void NotifyMmWaveSinr(MmWaveBearerStatsConnector* c,
-                                 std::string context,
                                  uint64_t imsi,
                                  uint16_t cellId,
                                  long double sinr);
@@ -293,32 +304,39 @@ class MmWaveBearerStatsConnector : public Object
 
   private:
     /**
-     * Creates UE Manager path and stores it in m_ueManagerPathByCellIdRnti
-     * \param ueManagerPath
+     * Connects the RRC trace sources of all the eNB and UE devices
+     * installed so far
+     */
+    void ConnectRrcTraces();
+
+    /**
+     * Stores the UE Manager in m_ueManagerByCellIdRnti and connects its
+     * SecondaryRlcCreated trace source
+     * \param enbRrc
      * \param cellId
      * \param rnti
      */
-    void StoreUeManagerPath(std::string ueManagerPath, uint16_t cellId, uint16_t rnti);
+    void StoreUeManager(Ptr<LteEnbRrc> enbRrc, uint16_t cellId, uint16_t rnti);
 
     /**
      * Connects Srb0 trace sources at UE and eNB to RLC and PDCP calculators,
      * and Srb1 trace sources at eNB to RLC and PDCP calculators,
-     * \param ueRrcPath
+     * \param ueRrc
      * \param imsi
      * \param cellId
      * \param rnti
      */
-    void ConnectSrb0Traces(std::string ueRrcPath, uint64_t imsi, uint16_t cellId, uint16_t rnti);
+    void ConnectSrb0Traces(Ptr<LteUeRrc> ueRrc, uint64_t imsi, uint16_t cellId, uint16_t rnti);
 
     /**
      * Connects all trace sources at UE to RLC and PDCP calculators.
      * This function can connect traces only once for UE.
-     * \param context
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void ConnectTracesUeIfFirstTime(std::string context,
+    void ConnectTracesUeIfFirstTime(Ptr<LteUeRrc> ueRrc,
                                     uint64_t imsi,
                                     uint16_t cellid,
                                     uint16_t rnti);
@@ -326,87 +344,89 @@ class MmWaveBearerStatsConnector : public Object
     /**
      * Connects all trace sources at eNB to RLC and PDCP calculators.
      * This function can connect traces only once for eNB.
-     * \param context
+     * \param enbRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void ConnectTracesEnbIfFirstTime(std::string context,
+    void ConnectTracesEnbIfFirstTime(Ptr<LteEnbRrc> enbRrc,
                                      uint64_t imsi,
                                      uint16_t cellid,
                                      uint16_t rnti);
 
     /**
      * Connects DRBs trace sources at UE to RLC and PDCP calculators.
-     * \param context
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void ConnectDrbTracesUe(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti);
+    void ConnectDrbTracesUe(Ptr<LteUeRrc> ueRrc, uint64_t imsi, uint16_t cellid, uint16_t rnti);
 
     /**
      * Connects SRB1 trace sources at UE to RLC and PDCP calculators
-     * \param ueRrcPath
+     * \param ueRrc
      * \param imsi
      * \param cellId
      * \param rnti
      */
-    void ConnectSrb1TracesUe(std::string ueRrcPath, uint64_t imsi, uint16_t cellId, uint16_t rnti);
+    void ConnectSrb1TracesUe(Ptr<LteUeRrc> ueRrc, uint64_t imsi, uint16_t cellId, uint16_t rnti);
 
     /**
-     * Disconnects all trace sources at UE to RLC and PDCP calculators.
-     * Function is not implemented.
-     * \param context
+     * Disconnects the multi-connectivity trace sources at UE from the
+     * multi-connectivity calculator. They are connected again with SRB1.
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void DisconnectTracesUe(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti);
+    void DisconnectTracesUe(Ptr<LteUeRrc> ueRrc, uint64_t imsi, uint16_t cellid, uint16_t rnti);
 
     /**
-     * Disconnects DRB trace sources at UE to RLC and PDCP calculators.
-     * Function is not implemented.
-     * \param context
+     * Disconnects DRB trace sources at UE from RLC and PDCP calculators.
+     * \param ueRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void DisconnectDrbTracesUe(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti);
+    void DisconnectDrbTracesUe(Ptr<LteUeRrc> ueRrc,
+                               uint64_t imsi,
+                               uint16_t cellid,
+                               uint16_t rnti);
 
     /**
      * Connects SRB1 trace sources at eNB to RLC and PDCP calculators
-     * \param context
+     * \param enbRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void ConnectSrb1TracesEnb(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti);
+    void ConnectSrb1TracesEnb(Ptr<LteEnbRrc> enbRrc, uint64_t imsi, uint16_t cellid, uint16_t rnti);
 
     /**
      * Connects DRBs trace sources at eNB to RLC and PDCP calculators
-     * \param context
+     * \param enbRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void ConnectDrbTracesEnb(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti);
+    void ConnectDrbTracesEnb(Ptr<LteEnbRrc> enbRrc, uint64_t imsi, uint16_t cellid, uint16_t rnti);
 
     /**
      * Disconnects all trace sources at eNB to RLC and PDCP calculators.
      * Function is not implemented.
-     * \param context
+     * \param enbRrc
      * \param imsi
      * \param cellid
      * \param rnti
      */
-    void DisconnectTracesEnb(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti);
+    void DisconnectTracesEnb(Ptr<LteEnbRrc> enbRrc, uint64_t imsi, uint16_t cellid, uint16_t rnti);
 
-    void ConnectSecondaryTracesUe(std::string context,
+    void ConnectSecondaryTracesUe(Ptr<LteUeRrc> ueRrc,
                                   uint64_t imsi,
                                   uint16_t cellId,
                                   uint16_t rnti);
-    void ConnectSecondaryTracesEnb(std::string context,
+    void ConnectSecondaryTracesEnb(Ptr<UeManager> ueManager,
                                    uint64_t imsi,
                                    uint16_t cellId,
                                    uint16_t rnti);
@@ -442,7 +462,7 @@ class MmWaveBearerStatsConnector : public Object
         m_imsiSeenEnbDrb; //!< stores all eNBs for which RLC and PDCP traces for DRBs were connected
 
     /**
-     * Struct used as key in m_ueManagerPathByCellIdRnti map
+     * Struct used as key in m_ueManagerByCellIdRnti map
      */
     struct CellIdRnti
     {
@@ -456,9 +476,9 @@ class MmWaveBearerStatsConnector : public Object
     friend bool operator<(const CellIdRnti& a, const CellIdRnti& b);
 
     /**
-     * List UE Manager Paths by CellIdRnti
+     * List UE Managers by CellIdRnti, until the random access of the UE succeeds
      */
-    std::map<CellIdRnti, std::string> m_ueManagerPathByCellIdRnti;
+    std::map<CellIdRnti, Ptr<UeManager>> m_ueManagerByCellIdRnti;
 
     std::string m_enbHandoverStartFilename;
     std::string m_enbHandoverEndFilename;
@@ -0,0 +1,171 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mmwave-enb-spatial-index.h"
+
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+#include <ns3/node.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+NS_LOG_COMPONENT_DEFINE("MmWaveEnbSpatialIndex");
+
+MmWaveEnbSpatialIndex::MmWaveEnbSpatialIndex(const NetDeviceContainer& enbDevices)
+{
+    NS_LOG_FUNCTION(this << enbDevices.GetN());
+    NS_ABORT_MSG_IF(enbDevices.GetN() == 0, "empty enb device container");
+
+    m_positions.reserve(enbDevices.GetN());
+    for (NetDeviceContainer::Iterator i = enbDevices.Begin(); i != enbDevices.End(); ++i)
+    {
+        Ptr<MobilityModel> mobility = (*i)->GetNode()->GetObject<MobilityModel>();
+        NS_ABORT_MSG_IF(!mobility, "eNB node " << (*i)->GetNode()->GetId() << " has no mobility");
+        m_positions.push_back(mobility->GetPosition());
+    }
+
+    double maxX = m_positions.front().x;
+    double maxY = m_positions.front().y;
+    m_minX = maxX;
+    m_minY = maxY;
+    for (const Vector& position : m_positions)
+    {
+        m_minX = std::min(m_minX, position.x);
+        m_minY = std::min(m_minY, position.y);
+        maxX = std::max(maxX, position.x);
+        maxY = std::max(maxY, position.y);
+    }
+
+    // about one eNB per cell, with at most about one row or column per eNB if the eNBs lie on
+    // a line
+    double width = maxX - m_minX;
+    double height = maxY - m_minY;
+    double numEnbs = m_positions.size();
+    m_cellSize =
+        std::max(std::sqrt(width * height / numEnbs), std::max(width, height) / numEnbs);
+    if (m_cellSize == 0)
+    {
+        m_cellSize = 1; // all the eNBs have the same horizontal position
+    }
+    m_numColumns = static_cast<int64_t>(std::floor(width / m_cellSize)) + 1;
+    m_numRows = static_cast<int64_t>(std::floor(height / m_cellSize)) + 1;
+    NS_LOG_DEBUG("Grid of " << m_numColumns << "x" << m_numRows << " cells of " << m_cellSize
+                            << " m for " << m_positions.size() << " eNBs");
+
+    m_grid.resize(m_numColumns * m_numRows);
+    for (uint32_t i = 0; i < m_positions.size(); ++i)
+    {
+        int64_t x;
+        int64_t y;
+        GetCell(m_positions[i], x, y);
+        m_grid[y * m_numColumns + x].push_back(i);
+    }
+}
+
+void
+MmWaveEnbSpatialIndex::GetCell(const Vector& position, int64_t& x, int64_t& y) const
+{
+    double column = std::floor((position.x - m_minX) / m_cellSize);
+    double row = std::floor((position.y - m_minY) / m_cellSize);
+    x = static_cast<int64_t>(std::min(std::max(column, 0.0), double(m_numColumns - 1)));
+    y = static_cast<int64_t>(std::min(std::max(row, 0.0), double(m_numRows - 1)));
+}
+
+uint32_t
+MmWaveEnbSpatialIndex::GetClosestEnb(const Vector& position) const
+{
+    return GetClosestEnbs(position, 1).front();
+}
+
+std::vector<uint32_t>
+MmWaveEnbSpatialIndex::GetClosestEnbs(const Vector& position, uint32_t k) const
+{
+    NS_LOG_FUNCTION(this << position << k);
+    k = std::min<uint32_t>(k, m_positions.size());
+
+    // the k best candidates found so far, the worst one on top. Candidates at the same distance
+    // are ranked by index, as in a linear scan
+    std::priority_queue<std::pair<double, uint32_t>> best;
+    auto visitCell = [&](int64_t x, int64_t y) {
+        if (x < 0 || x >= m_numColumns || y < 0 || y >= m_numRows)
+        {
+            return;
+        }
+        for (uint32_t i : m_grid[y * m_numColumns + x])
+        {
+            std::pair<double, uint32_t> candidate(CalculateDistance(position, m_positions[i]), i);
+            if (best.size() < k)
+            {
+                best.push(candidate);
+            }
+            else if (candidate < best.top())
+            {
+                best.pop();
+                best.push(candidate);
+            }
+        }
+    };
+
+    // visit the rings of cells around the cell of the position. The cells of ring r are at
+    // least (r - 1) cells away from the position, also when it is outside the grid
+    int64_t cx;
+    int64_t cy;
+    GetCell(position, cx, cy);
+    int64_t maxRing = std::max(m_numColumns, m_numRows);
+    for (int64_t r = 0; r <= maxRing; ++r)
+    {
+        if (best.size() == k && (r - 1) * m_cellSize > best.top().first)
+        {
+            break;
+        }
+        if (r == 0)
+        {
+            visitCell(cx, cy);
+            continue;
+        }
+        for (int64_t x = cx - r; x <= cx + r; ++x)
+        {
+            visitCell(x, cy - r);
+            visitCell(x, cy + r);
+        }
+        for (int64_t y = cy - r + 1; y <= cy + r - 1; ++y)
+        {
+            visitCell(cx - r, y);
+            visitCell(cx + r, y);
+        }
+    }
+
+    std::vector<uint32_t> closest(best.size());
+    for (auto it = closest.rbegin(); it != closest.rend(); ++it)
+    {
+        *it = best.top().second;
+        best.pop();
+    }
+    return closest;
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,97 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MMWAVE_ENB_SPATIAL_INDEX_H
+#define MMWAVE_ENB_SPATIAL_INDEX_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/vector.h>
+
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * \ingroup mmwave
+ *
+ * Spatial index of the positions of a set of eNB devices, used by the
+ * MmWaveHelper to attach many UEs to their closest eNB. The positions are
+ * read once, when the index is built, and stored in a uniform grid on the
+ * horizontal plane, sized so that each cell holds about one eNB. A query
+ * only visits the cells around the given position, until no unvisited cell
+ * can contain an eNB closer than the ones already found.
+ *
+ * Distances are three-dimensional, as in CalculateDistance. Among eNBs at
+ * the same distance, the one with the lowest index in the container is
+ * preferred, so that the result matches a linear scan of the container.
+ */
+class MmWaveEnbSpatialIndex
+{
+  public:
+    /**
+     * Build the index from the positions of the eNBs
+     *
+     * \param enbDevices the eNB devices, whose nodes must have a MobilityModel
+     */
+    MmWaveEnbSpatialIndex(const NetDeviceContainer& enbDevices);
+
+    /**
+     * Find the eNB closest to a position
+     *
+     * \param position the position
+     * \return the index, in the eNB container, of the closest eNB
+     */
+    uint32_t GetClosestEnb(const Vector& position) const;
+
+    /**
+     * Find the k eNBs closest to a position, for example to select the
+     * candidates of a path loss based or multi-connectivity attachment
+     *
+     * \param position the position
+     * \param k the number of eNBs to return
+     * \return the indices, in the eNB container, of the min(k, number of eNBs)
+     *         closest eNBs, sorted by increasing distance
+     */
+    std::vector<uint32_t> GetClosestEnbs(const Vector& position, uint32_t k) const;
+
+  private:
+    /**
+     * Get the grid cell of a position, clamped to the grid
+     *
+     * \param position the position
+     * \param [out] x the column of the cell
+     * \param [out] y the row of the cell
+     */
+    void GetCell(const Vector& position, int64_t& x, int64_t& y) const;
+
+    std::vector<Vector> m_positions;           //!< the position of each eNB
+    std::vector<std::vector<uint32_t>> m_grid; //!< eNB indices in each cell, row by row
+    double m_minX;                             //!< x coordinate of the grid origin
+    double m_minY;                             //!< y coordinate of the grid origin
+    double m_cellSize;                         //!< side of a grid cell
+    int64_t m_numColumns;                      //!< number of columns of the grid
+    int64_t m_numRows;                         //!< number of rows of the grid
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* MMWAVE_ENB_SPATIAL_INDEX_H */
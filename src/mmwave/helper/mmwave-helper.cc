@@ -57,6 +57,7 @@
 #include <ns3/object-map.h>
 #include <ns3/pointer.h>
 #include <ns3/string.h>
+#include <ns3/system-wall-clock-ms.h>
 #include <ns3/three-gpp-propagation-loss-model.h>
 #include <ns3/three-gpp-spectrum-propagation-loss-model.h>
 #include <ns3/uinteger.h>
@@ -277,6 +278,7 @@ MmWaveHelper::DoDispose(void)
 {
     NS_LOG_FUNCTION(this);
     m_channel.clear();
+    m_ccBfModelFactories.clear();
     m_componentCarrierPhyParams.clear();
     m_lteComponentCarrierPhyParams.clear();
     Object::DoDispose();
@@ -525,6 +527,7 @@ MmWaveHelper::SetBeamformingModelType(std::string type)
 {
     NS_LOG_FUNCTION(this << type);
     m_bfModelFactory = ObjectFactory(type);
+    m_ccBfModelFactories.clear();
 }
 
 void
@@ -619,6 +622,7 @@ MmWaveHelper::SetBeamformingModelAttribute(std::string name, const AttributeValu
 {
     NS_LOG_FUNCTION(this);
     m_bfModelFactory.Set(name, value);
+    m_ccBfModelFactories.clear();
 }
 
 void
@@ -753,83 +757,121 @@ MmWaveHelper::SetLteCcPhyParams(std::map<uint8_t, ComponentCarrier> ccMapParams)
 }
 
 NetDeviceContainer
-MmWaveHelper::InstallUeDevice(NodeContainer c)
+MmWaveHelper::InstallDevices(NodeContainer c,
+                             Ptr<NetDevice> (MmWaveHelper::*installSingleDevice)(Ptr<Node>))
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << c.GetN());
     Initialize(); // Run DoInitialize (), if necessary
+    SystemWallClockMs clock;
+    clock.Start();
     NetDeviceContainer devices;
     for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
     {
         Ptr<Node> node = *i;
-        Ptr<NetDevice> device = InstallSingleUeDevice(node);
+        Ptr<NetDevice> device = (this->*installSingleDevice)(node);
         device->SetAddress(Mac64Address::Allocate());
         devices.Add(device);
     }
+    NS_LOG_INFO("Installed " << devices.GetN() << " devices in " << clock.End() << " ms");
     return devices;
 }
 
+NetDeviceContainer
+MmWaveHelper::InstallUeDevice(NodeContainer c)
+{
+    NS_LOG_FUNCTION(this);
+    return InstallDevices(c, &MmWaveHelper::InstallSingleUeDevice);
+}
+
 NetDeviceContainer
 MmWaveHelper::InstallMcUeDevice(NodeContainer c)
 {
     NS_LOG_FUNCTION(this);
-    Initialize(); // Run DoInitialize (), if necessary
-    NetDeviceContainer devices;
-    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
-    {
-        Ptr<Node> node = *i;
-        Ptr<NetDevice> device = InstallSingleMcUeDevice(node);
-        device->SetAddress(Mac64Address::Allocate());
-        devices.Add(device);
-    }
-    return devices;
+    return InstallDevices(c, &MmWaveHelper::InstallSingleMcUeDevice);
 }
 
 NetDeviceContainer
 MmWaveHelper::InstallInterRatHoCapableUeDevice(NodeContainer c)
 {
     NS_LOG_FUNCTION(this);
-    Initialize(); // Run DoInitialize (), if necessary
-    NetDeviceContainer devices;
-    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
-    {
-        Ptr<Node> node = *i;
-        Ptr<NetDevice> device = InstallSingleInterRatHoCapableUeDevice(node);
-        device->SetAddress(Mac64Address::Allocate());
-        devices.Add(device);
-    }
-    return devices;
+    return InstallDevices(c, &MmWaveHelper::InstallSingleInterRatHoCapableUeDevice);
 }
 
 NetDeviceContainer
 MmWaveHelper::InstallEnbDevice(NodeContainer c)
 {
     NS_LOG_FUNCTION(this);
-    Initialize(); // Run DoInitialize (), if necessary
-    NetDeviceContainer devices;
-    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
-    {
-        Ptr<Node> node = *i;
-        Ptr<NetDevice> device = InstallSingleEnbDevice(node);
-        device->SetAddress(Mac64Address::Allocate());
-        devices.Add(device);
-    }
-    return devices;
+    return InstallDevices(c, &MmWaveHelper::InstallSingleEnbDevice);
 }
 
 NetDeviceContainer
 MmWaveHelper::InstallLteEnbDevice(NodeContainer c)
 {
     NS_LOG_FUNCTION(this);
-    Initialize(); // Run DoInitialize (), if necessary
-    NetDeviceContainer devices;
-    for (NodeContainer::Iterator i = c.Begin(); i != c.End(); ++i)
+    return InstallDevices(c, &MmWaveHelper::InstallSingleLteEnbDevice);
+}
+
+Ptr<MmWaveBeamformingModel>
+MmWaveHelper::CreateBeamformingModel(uint8_t ccId,
+                                     Ptr<NetDevice> device,
+                                     Ptr<PhasedArrayModel> antenna,
+                                     const ObjectFactory& codebookFactory)
+{
+    NS_LOG_FUNCTION(this << +ccId << device << antenna);
+
+    auto factoryIt = m_ccBfModelFactories.find(ccId);
+    if (factoryIt == m_ccBfModelFactories.end())
     {
-        Ptr<Node> node = *i;
-        Ptr<NetDevice> device = InstallSingleLteEnbDevice(node);
-        device->SetAddress(Mac64Address::Allocate());
-        devices.Add(device);
+        // set the attributes shared by all the devices of this carrier once, instead of
+        // looking them up by name for each device
+        Ptr<SpectrumPropagationLossModel> splm;
+        Ptr<PhasedArraySpectrumPropagationLossModel> pSplm;
+        Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm;
+        if (m_spectrumPropagationLossModelType == "ns3::ThreeGppSpectrumPropagationLossModel")
+        {
+            pSplm = m_channel.at(ccId)->GetPhasedArraySpectrumPropagationLossModel();
+            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(pSplm);
+        }
+        else
+        {
+            splm = m_channel.at(ccId)->GetSpectrumPropagationLossModel();
+            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(splm);
+        }
+
+        ObjectFactory factory = m_bfModelFactory;
+        TypeId tid = factory.GetTypeId();
+        TypeId::AttributeInformation info;
+        if (tid.LookupAttributeByName("ChannelModel", &info))
+        {
+            factory.Set("ChannelModel", PointerValue(threeGppSplm->GetChannelModel()));
+        }
+        if (pSplm && tid.LookupAttributeByName("PhasedArraySpectrumPropagationLossModel", &info))
+        {
+            factory.Set("PhasedArraySpectrumPropagationLossModel", PointerValue(pSplm));
+        }
+        else if (splm && tid.LookupAttributeByName("SpectrumPropagationLossModel", &info))
+        {
+            factory.Set("SpectrumPropagationLossModel", PointerValue(splm));
+        }
+        if (tid.LookupAttributeByName("MmWavePhyMacCommon", &info))
+        {
+            factory.Set(
+                "MmWavePhyMacCommon",
+                PointerValue(m_componentCarrierPhyParams.at(ccId).GetConfigurationParameters()));
+        }
+        factoryIt = m_ccBfModelFactories.emplace(ccId, factory).first;
     }
-    return devices;
+
+    Ptr<MmWaveBeamformingModel> bfModel = factoryIt->second.Create<MmWaveBeamformingModel>();
+    bfModel->SetDevice(device);
+    bfModel->SetAntenna(antenna);
+    Ptr<MmWaveCodebookBeamforming> codebookBf = DynamicCast<MmWaveCodebookBeamforming>(bfModel);
+    if (codebookBf)
+    {
+        codebookBf->SetBeamformingCodebookFactory(codebookFactory);
+    }
+    bfModel->Initialize();
+    return bfModel;
 }
 
 Ptr<NetDevice>
@@ -935,29 +977,8 @@ MmWaveHelper::InstallSingleMcUeDevice(Ptr<Node> n)
         Ptr<PhasedArrayModel> antenna = m_uePhasedArrayModelFactory.Create<PhasedArrayModel>();
         NS_ASSERT_MSG(antenna, "error in creating the AntennaModel object");
 
-        // initialize the 3GPP channel model
-
-        [[maybe_unused]] Ptr<SpectrumPropagationLossModel> splm;
-        [[maybe_unused]] Ptr<PhasedArraySpectrumPropagationLossModel> pSplm;
-
-        Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm;
-
-        if (m_spectrumPropagationLossModelType == "ns3::ThreeGppSpectrumPropagationLossModel")
-        {
-            pSplm = m_channel.at(it->first)->GetPhasedArraySpectrumPropagationLossModel();
-            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(pSplm);
-        }
-        else
-        {
-            splm = m_channel.at(it->first)->GetSpectrumPropagationLossModel();
-            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(splm);
-        }
-
-        auto channelModel = threeGppSplm->GetChannelModel();
-        Ptr<MmWaveBeamformingModel> bfModel = m_bfModelFactory.Create<MmWaveBeamformingModel>();
-        bfModel->SetAttributeFailSafe("Device", PointerValue(device));
-        bfModel->SetAttributeFailSafe("Antenna", PointerValue(antenna));
-        bfModel->SetAttributeFailSafe("ChannelModel", PointerValue(channelModel));
+        Ptr<MmWaveBeamformingModel> bfModel =
+            CreateBeamformingModel(it->first, device, antenna, m_ueBeamformingCodebookFactory);
         dlPhy->SetBeamformingModel(bfModel);
 
         it->second->SetPhy(phy);
@@ -1592,50 +1613,8 @@ MmWaveHelper::InstallSingleUeDevice(Ptr<Node> n)
         Ptr<PhasedArrayModel> antenna = m_uePhasedArrayModelFactory.Create<PhasedArrayModel>();
         NS_ASSERT_MSG(antenna, "error in creating the AntennaModel object");
 
-        // initialize the 3GPP channel model
-
-        [[maybe_unused]] Ptr<SpectrumPropagationLossModel> splm;
-        [[maybe_unused]] Ptr<PhasedArraySpectrumPropagationLossModel> pSplm;
-
-        Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm;
-
-        if (m_spectrumPropagationLossModelType == "ns3::ThreeGppSpectrumPropagationLossModel")
-        {
-            pSplm = m_channel.at(it->first)->GetPhasedArraySpectrumPropagationLossModel();
-            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(pSplm);
-        }
-        else
-        {
-            splm = m_channel.at(it->first)->GetSpectrumPropagationLossModel();
-            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(splm);
-        }
-
-        auto channelModel = threeGppSplm->GetChannelModel();
-
-        Ptr<MmWaveBeamformingModel> bfModel = m_bfModelFactory.Create<MmWaveBeamformingModel>();
-        bfModel->SetAttributeFailSafe("Device", PointerValue(device));
-        bfModel->SetAttributeFailSafe("Antenna", PointerValue(antenna));
-        bfModel->SetAttributeFailSafe("ChannelModel", PointerValue(channelModel));
-
-        if (pSplm)
-        {
-            bfModel->SetAttributeFailSafe("PhasedArraySpectrumPropagationLossModel",
-                                          PointerValue(pSplm));
-        }
-        else if (splm)
-        {
-            bfModel->SetAttributeFailSafe("SpectrumPropagationLossModel", PointerValue(splm));
-        }
-
-        bfModel->SetAttributeFailSafe("MmWavePhyMacCommon",
-                                      PointerValue(it->second->GetConfigurationParameters()));
-        if (m_bfModelFactory.GetTypeId() == MmWaveCodebookBeamforming::GetTypeId())
-        {
-            DynamicCast<MmWaveCodebookBeamforming>(bfModel)->SetBeamformingCodebookFactory(
-                m_ueBeamformingCodebookFactory);
-        }
-        bfModel->Initialize();
-
+        Ptr<MmWaveBeamformingModel> bfModel =
+            CreateBeamformingModel(it->first, device, antenna, m_ueBeamformingCodebookFactory);
         dlPhy->SetBeamformingModel(bfModel);
 
         DynamicCast<MmWaveComponentCarrierUe>(it->second)->SetPhy(phy);
@@ -1852,49 +1831,8 @@ MmWaveHelper::InstallSingleEnbDevice(Ptr<Node> n)
         Ptr<PhasedArrayModel> antenna = m_enbPhasedArrayModelFactory.Create<PhasedArrayModel>();
         NS_ASSERT_MSG(antenna, "error in creating the AntennaModel object");
 
-        // initialize the 3GPP channel model
-        [[maybe_unused]] Ptr<SpectrumPropagationLossModel> splm;
-        [[maybe_unused]] Ptr<PhasedArraySpectrumPropagationLossModel> pSplm;
-
-        Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm;
-
-        if (m_spectrumPropagationLossModelType == "ns3::ThreeGppSpectrumPropagationLossModel")
-        {
-            pSplm = m_channel.at(it->first)->GetPhasedArraySpectrumPropagationLossModel();
-            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(pSplm);
-        }
-        else
-        {
-            splm = m_channel.at(it->first)->GetSpectrumPropagationLossModel();
-            threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(splm);
-        }
-
-        auto channelModel = threeGppSplm->GetChannelModel();
-
-        Ptr<MmWaveBeamformingModel> bfModel = m_bfModelFactory.Create<MmWaveBeamformingModel>();
-        bfModel->SetAttributeFailSafe("Device", PointerValue(device));
-        bfModel->SetAttributeFailSafe("Antenna", PointerValue(antenna));
-        bfModel->SetAttributeFailSafe("ChannelModel", PointerValue(channelModel));
-
-        if (pSplm)
-        {
-            bfModel->SetAttributeFailSafe("PhasedArraySpectrumPropagationLossModel",
-                                          PointerValue(pSplm));
-        }
-        else if (splm)
-        {
-            bfModel->SetAttributeFailSafe("SpectrumPropagationLossModel", PointerValue(splm));
-        }
-
-        bfModel->SetAttributeFailSafe("MmWavePhyMacCommon",
-                                      PointerValue(it->second->GetConfigurationParameters()));
-        if (m_bfModelFactory.GetTypeId() == MmWaveCodebookBeamforming::GetTypeId())
-        {
-            DynamicCast<MmWaveCodebookBeamforming>(bfModel)->SetBeamformingCodebookFactory(
-                m_enbBeamformingCodebookFactory);
-        }
-        bfModel->Initialize();
-
+        Ptr<MmWaveBeamformingModel> bfModel =
+            CreateBeamformingModel(it->first, device, antenna, m_enbBeamformingCodebookFactory);
         dlPhy->SetBeamformingModel(bfModel);
 
         NS_LOG_DEBUG("Create the mac");
@@ -2450,10 +2388,13 @@ void
 MmWaveHelper::AttachToClosestEnb(NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(enbDevices.GetN() > 0, "empty enb device container");
 
+    // index the eNB positions once, instead of scanning all the eNBs for each UE
+    MmWaveEnbSpatialIndex enbIndex(enbDevices);
     for (NetDeviceContainer::Iterator i = ueDevices.Begin(); i != ueDevices.End(); i++)
     {
-        AttachToClosestEnb(*i, enbDevices);
+        AttachToClosestEnb(*i, enbDevices, enbIndex);
     }
 }
 
@@ -2464,10 +2405,13 @@ MmWaveHelper::AttachToClosestEnb(NetDeviceContainer ueDevices,
                                  NetDeviceContainer lteEnbDevices)
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(mmWaveEnbDevices.GetN() > 0 && lteEnbDevices.GetN() > 0,
+                  "empty lte or mmwave enb device container");
 
+    MmWaveEnbSpatialIndex lteEnbIndex(lteEnbDevices);
     for (NetDeviceContainer::Iterator i = ueDevices.Begin(); i != ueDevices.End(); i++)
     {
-        AttachMcToClosestEnb(*i, mmWaveEnbDevices, lteEnbDevices);
+        AttachMcToClosestEnb(*i, mmWaveEnbDevices, lteEnbDevices, lteEnbIndex);
     }
 }
 
@@ -2506,27 +2450,16 @@ MmWaveHelper::AttachIrToClosestEnb(NetDeviceContainer ueDevices,
 }
 
 void
-MmWaveHelper::AttachToClosestEnb(Ptr<NetDevice> ueDevice, NetDeviceContainer enbDevices)
+MmWaveHelper::AttachToClosestEnb(Ptr<NetDevice> ueDevice,
+                                 NetDeviceContainer enbDevices,
+                                 const MmWaveEnbSpatialIndex& enbIndex)
 {
     NS_LOG_FUNCTION(this << ueDevice << enbDevices.GetN());
-    NS_ASSERT_MSG(enbDevices.GetN() > 0, "empty enb device container");
     Vector uePos = ueDevice->GetNode()->GetObject<MobilityModel>()->GetPosition();
 
     // find the closest BS
-    double minDistance = std::numeric_limits<double>::infinity();
-    int closestEnbIndex = -1;
-    for (uint32_t i = 0; i < enbDevices.GetN(); ++i)
-    {
-        Vector enbPos = enbDevices.Get(i)->GetNode()->GetObject<MobilityModel>()->GetPosition();
-        double distance = CalculateDistance(uePos, enbPos);
-
-        if (distance < minDistance)
-        {
-            minDistance = distance;
-            closestEnbIndex = i;
-        }
-    }
-    NS_ASSERT_MSG(closestEnbIndex >= 0, "Closest eNB not found!");
+    uint32_t closestEnbIndex = enbIndex.GetClosestEnb(uePos);
+    NS_LOG_INFO("UE " << ueDevice << " closest eNB index " << closestEnbIndex);
 
     AttachToEnbWithIndex(ueDevice, enbDevices, closestEnbIndex);
 }
@@ -2534,29 +2467,15 @@ MmWaveHelper::AttachToClosestEnb(Ptr<NetDevice> ueDevice, NetDeviceContainer enb
 void
 MmWaveHelper::AttachMcToClosestEnb(Ptr<NetDevice> ueDevice,
                                    NetDeviceContainer mmWaveEnbDevices,
-                                   NetDeviceContainer lteEnbDevices)
+                                   NetDeviceContainer lteEnbDevices,
+                                   const MmWaveEnbSpatialIndex& lteEnbIndex)
 {
     NS_LOG_FUNCTION(this);
     Ptr<McUeNetDevice> mcDevice = ueDevice->GetObject<McUeNetDevice>();
 
-    NS_ASSERT_MSG(mmWaveEnbDevices.GetN() > 0 && lteEnbDevices.GetN() > 0,
-                  "empty lte or mmwave enb device container");
-
     // Find the closest LTE station
     Vector uepos = ueDevice->GetNode()->GetObject<MobilityModel>()->GetPosition();
-    double minDistance = std::numeric_limits<double>::infinity();
-    Ptr<NetDevice> lteClosestEnbDevice;
-    for (NetDeviceContainer::Iterator i = lteEnbDevices.Begin(); i != lteEnbDevices.End(); ++i)
-    {
-        Vector enbpos = (*i)->GetNode()->GetObject<MobilityModel>()->GetPosition();
-        double distance = CalculateDistance(uepos, enbpos);
-        if (distance < minDistance)
-        {
-            minDistance = distance;
-            lteClosestEnbDevice = *i;
-        }
-    }
-    NS_ASSERT(lteClosestEnbDevice);
+    Ptr<NetDevice> lteClosestEnbDevice = lteEnbDevices.Get(lteEnbIndex.GetClosestEnb(uepos));
     NS_ASSERT(lteClosestEnbDevice->GetObject<LteEnbNetDevice>()); // stop if it is not an LTE eNB
 
     // Necessary operation to connect MmWave UE to eNB at lower layers
@@ -35,6 +35,7 @@
 #ifndef MMWAVE_HELPER_H
 #define MMWAVE_HELPER_H
 
+#include "mmwave-enb-spatial-index.h"
 #include "mmwave-mac-trace.h"
 #include "mmwave-phy-trace.h"
 
@@ -372,16 +373,44 @@ class MmWaveHelper : public Object
     void MmWaveChannelModelInitialization();
     void LteChannelModelInitialization();
 
+    /**
+     * Install a device on each node of a container, and log the time it takes
+     * \param c the nodes
+     * \param installSingleDevice the method which installs the device on a node
+     * \return the installed devices
+     */
+    NetDeviceContainer InstallDevices(
+        NodeContainer c,
+        Ptr<NetDevice> (MmWaveHelper::*installSingleDevice)(Ptr<Node>));
+
+    /**
+     * Create and initialize the beamforming model of a device for a component carrier.
+     * The attributes shared by all the devices of the carrier are set in a factory
+     * built the first time the carrier is used.
+     * \param ccId the component carrier
+     * \param device the device
+     * \param antenna the antenna of the device for the component carrier
+     * \param codebookFactory the codebook factory, used by codebook-based models
+     * \return the beamforming model
+     */
+    Ptr<MmWaveBeamformingModel> CreateBeamformingModel(uint8_t ccId,
+                                                       Ptr<NetDevice> device,
+                                                       Ptr<PhasedArrayModel> antenna,
+                                                       const ObjectFactory& codebookFactory);
+
     Ptr<NetDevice> InstallSingleUeDevice(Ptr<Node> n);
     Ptr<NetDevice> InstallSingleMcUeDevice(Ptr<Node> n);
     Ptr<NetDevice> InstallSingleEnbDevice(Ptr<Node> n);
     Ptr<NetDevice> InstallSingleLteEnbDevice(Ptr<Node> n);
     Ptr<NetDevice> InstallSingleInterRatHoCapableUeDevice(Ptr<Node> n);
 
-    void AttachToClosestEnb(Ptr<NetDevice> ueDevice, NetDeviceContainer enbDevices);
+    void AttachToClosestEnb(Ptr<NetDevice> ueDevice,
+                            NetDeviceContainer enbDevices,
+                            const MmWaveEnbSpatialIndex& enbIndex);
     void AttachMcToClosestEnb(Ptr<NetDevice> ueDevice,
                               NetDeviceContainer mmWaveEnbDevices,
-                              NetDeviceContainer lteEnbDevices);
+                              NetDeviceContainer lteEnbDevices,
+                              const MmWaveEnbSpatialIndex& lteEnbIndex);
     void AttachIrToClosestEnb(Ptr<NetDevice> ueDevice,
                               NetDeviceContainer mmWaveEnbDevices,
                               NetDeviceContainer lteEnbDevices);
@@ -461,6 +490,8 @@ class MmWaveHelper : public Object
     ObjectFactory m_enbBeamformingCodebookFactory; /// Factory of beamforming codebooks for eNBs
 
     ObjectFactory m_bfModelFactory; //!< Factory for the beamforming model
+    std::map<uint8_t, ObjectFactory>
+        m_ccBfModelFactories; //!< m_bfModelFactory with the attributes of each CC already set
     /**
      * From lte-helper.h
      * The `UsePdschForCqiGeneration` attribute. If true, DL-CQI will be
@@ -20,7 +20,9 @@
 
 #include "mmwave-mac-trace.h"
 
+#include <ns3/boolean.h>
 #include <ns3/log.h>
+#include <ns3/uinteger.h>
 
 namespace ns3
 {
@@ -32,8 +34,10 @@ namespace mmwave
 
 NS_OBJECT_ENSURE_REGISTERED(MmWaveMacTrace);
 
-std::ofstream MmWaveMacTrace::m_schedAllocTraceFile{};
+MmWaveTraceSink MmWaveMacTrace::m_schedAllocTraceFile{};
 std::string MmWaveMacTrace::m_schedAllocTraceFilename{};
+bool MmWaveMacTrace::m_binaryOutput{false};
+uint32_t MmWaveMacTrace::m_outputBufferSize{1 << 20};
 
 MmWaveMacTrace::MmWaveMacTrace()
 {
@@ -41,24 +45,34 @@ MmWaveMacTrace::MmWaveMacTrace()
 
 MmWaveMacTrace::~MmWaveMacTrace()
 {
-    if (m_schedAllocTraceFile.is_open())
-    {
-        m_schedAllocTraceFile.close();
-    }
+    m_schedAllocTraceFile.Close();
 }
 
 TypeId
 MmWaveMacTrace::GetTypeId(void)
 {
-    static TypeId tid = TypeId("ns3::MmWaveMacTrace")
-                            .SetParent<Object>()
-                            .AddConstructor<MmWaveMacTrace>()
-                            .AddAttribute("SchedInfoOutputFilename",
-                                          "Name of the file where the allocation info provided by "
-                                          "the scheduler will be saved.",
-                                          StringValue("EnbSchedAllocTraces.txt"),
-                                          MakeStringAccessor(&MmWaveMacTrace::SetOutputFilename),
-                                          MakeStringChecker());
+    static TypeId tid =
+        TypeId("ns3::MmWaveMacTrace")
+            .SetParent<Object>()
+            .AddConstructor<MmWaveMacTrace>()
+            .AddAttribute("SchedInfoOutputFilename",
+                          "Name of the file where the allocation info provided by "
+                          "the scheduler will be saved.",
+                          StringValue("EnbSchedAllocTraces.txt"),
+                          MakeStringAccessor(&MmWaveMacTrace::SetOutputFilename),
+                          MakeStringChecker())
+            .AddAttribute("BinaryOutput",
+                          "If true, the allocation info is written as fixed-width binary "
+                          "records, which can be converted to text with "
+                          "MmWaveTraceSink::ConvertToText.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MmWaveMacTrace::SetBinaryOutput),
+                          MakeBooleanChecker())
+            .AddAttribute("OutputBufferSize",
+                          "Size in bytes of the output buffer of the trace file.",
+                          UintegerValue(1 << 20),
+                          MakeUintegerAccessor(&MmWaveMacTrace::SetOutputBufferSize),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
@@ -67,16 +81,12 @@ MmWaveMacTrace::ReportEnbSchedulingInfo(Ptr<MmWaveMacTrace> enbStats,
                                         MmWaveEnbMac::MmWaveSchedTraceInfo schedParams)
 {
     // Open the output file if it is not open yet
-    if (!m_schedAllocTraceFile.is_open())
+    if (!m_schedAllocTraceFile.IsOpen())
     {
-        m_schedAllocTraceFile.open(m_schedAllocTraceFilename.c_str());
-        if (!m_schedAllocTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-        m_schedAllocTraceFile
-            << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId"
-            << std::endl;
+        m_schedAllocTraceFile.Open(m_schedAllocTraceFilename,
+                                   MmWaveTraceSink::PHY_TRANSMISSION,
+                                   m_binaryOutput,
+                                   m_outputBufferSize);
     }
 
     SlotAllocInfo allocInfo = schedParams.m_indParam.m_slotAllocInfo;
@@ -86,11 +96,18 @@ MmWaveMacTrace::ReportEnbSchedulingInfo(Ptr<MmWaveMacTrace> enbStats,
     for (auto iTti : allocInfo.m_ttiAllocInfo)
     {
         // Trace the incoming alloc info
-        m_schedAllocTraceFile << +dlSfn.m_frameNum << "\t" << +dlSfn.m_sfNum << "\t"
-                              << +dlSfn.m_slotNum << "\t" << +iTti.m_dci.m_rnti << "\t"
-                              << +iTti.m_dci.m_symStart << "\t" << +iTti.m_dci.m_numSym << "\t"
-                              << iTti.m_ttiType << "\t" << iTti.m_tddMode << "\t"
-                              << +iTti.m_dci.m_rv << "\t" << +schedParams.m_ccId << std::endl;
+        PhyTransmissionTraceRecord record{};
+        record.m_frameNum = dlSfn.m_frameNum;
+        record.m_sfNum = dlSfn.m_sfNum;
+        record.m_slotNum = dlSfn.m_slotNum;
+        record.m_rnti = iTti.m_dci.m_rnti;
+        record.m_symStart = iTti.m_dci.m_symStart;
+        record.m_numSym = iTti.m_dci.m_numSym;
+        record.m_ttiType = iTti.m_ttiType;
+        record.m_tddMode = iTti.m_tddMode;
+        record.m_rv = iTti.m_dci.m_rv;
+        record.m_ccId = schedParams.m_ccId;
+        m_schedAllocTraceFile.Write(record);
     }
 }
 
@@ -101,6 +118,20 @@ MmWaveMacTrace::SetOutputFilename(std::string fileName)
     m_schedAllocTraceFilename = fileName;
 }
 
+void
+MmWaveMacTrace::SetBinaryOutput(bool binary)
+{
+    NS_LOG_INFO("Binary format: " << binary);
+    m_binaryOutput = binary;
+}
+
+void
+MmWaveMacTrace::SetOutputBufferSize(uint32_t bufferSize)
+{
+    NS_LOG_INFO("Output buffer size: " << bufferSize);
+    m_outputBufferSize = bufferSize;
+}
+
 } // namespace mmwave
 
 } /* namespace ns3 */
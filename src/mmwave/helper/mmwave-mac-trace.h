@@ -21,12 +21,12 @@
 #ifndef SRC_MMWAVE_HELPER_MMWAVE_MAC_TRACE_H_
 #define SRC_MMWAVE_HELPER_MMWAVE_MAC_TRACE_H_
 
+#include "mmwave-trace-sink.h"
+
 #include <ns3/mmwave-enb-mac.h>
 #include <ns3/mmwave-phy-mac-common.h>
 #include <ns3/object.h>
 
-#include <fstream>
-
 namespace ns3
 {
 
@@ -54,6 +54,20 @@ class MmWaveMacTrace : public Object
      */
     void SetOutputFilename(std::string fileName);
 
+    /**
+     * Sets the format of the MAC-related traces
+     *
+     * \param binary if true, write fixed-width binary records instead of text lines
+     */
+    void SetBinaryOutput(bool binary);
+
+    /**
+     * Sets the size of the output buffer of the MAC-related traces
+     *
+     * \param bufferSize the buffer size, in bytes
+     */
+    void SetOutputBufferSize(uint32_t bufferSize);
+
     /**
      * Callback used to trace the reception of a scheduling decision by the eNB and from the
      * scheduler itself.
@@ -65,10 +79,12 @@ class MmWaveMacTrace : public Object
                                         MmWaveEnbMac::MmWaveSchedTraceInfo schedParams);
 
   private:
-    static std::ofstream
-        m_schedAllocTraceFile; //!< Output stream for the scheduling allocations trace
+    static MmWaveTraceSink
+        m_schedAllocTraceFile; //!< Output sink for the scheduling allocations trace
     static std::string
-        m_schedAllocTraceFilename; //!< Output filename for the scheduling allocations trace
+        m_schedAllocTraceFilename;      //!< Output filename for the scheduling allocations trace
+    static bool m_binaryOutput;         //!< True if the traces are written in binary format
+    static uint32_t m_outputBufferSize; //!< Size of the output buffer of the trace file
 };
 
 } // namespace mmwave
@@ -34,8 +34,10 @@
 
 #include "mmwave-phy-trace.h"
 
+#include <ns3/boolean.h>
 #include <ns3/log.h>
 #include <ns3/simulator.h>
+#include <ns3/uinteger.h>
 
 #include <stdio.h>
 
@@ -49,25 +51,25 @@ namespace mmwave
 
 NS_OBJECT_ENSURE_REGISTERED(MmWavePhyTrace);
 
-std::ofstream MmWavePhyTrace::m_rxPacketTraceFile;
+MmWaveTraceSink MmWavePhyTrace::m_rxPacketTraceFile;
 std::string MmWavePhyTrace::m_rxPacketTraceFilename;
 
-std::ofstream MmWavePhyTrace::m_ulPhyTraceFile{};
+MmWaveTraceSink MmWavePhyTrace::m_ulPhyTraceFile{};
 std::string MmWavePhyTrace::m_ulPhyTraceFilename{};
 
-std::ofstream MmWavePhyTrace::m_dlPhyTraceFile{};
+MmWaveTraceSink MmWavePhyTrace::m_dlPhyTraceFile{};
 std::string MmWavePhyTrace::m_dlPhyTraceFilename{};
 
+bool MmWavePhyTrace::m_binaryOutput{false};
+uint32_t MmWavePhyTrace::m_outputBufferSize{1 << 20};
+
 MmWavePhyTrace::MmWavePhyTrace()
 {
 }
 
 MmWavePhyTrace::~MmWavePhyTrace()
 {
-    if (m_rxPacketTraceFile.is_open())
-    {
-        m_rxPacketTraceFile.close();
-    }
+    m_rxPacketTraceFile.Close();
 }
 
 TypeId
@@ -92,6 +94,19 @@ MmWavePhyTrace::GetTypeId(void)
                           StringValue("DlPhyTransmissionTrace.txt"),
                           MakeStringAccessor(&MmWavePhyTrace::SetDlPhyTxOutputFilename),
                           MakeStringChecker())
+            .AddAttribute("BinaryOutput",
+                          "If true, the PHY traces are written as fixed-width binary records, "
+                          "which can be converted to text with MmWaveTraceSink::ConvertToText. "
+                          "Otherwise, they are written as tab-separated text lines.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MmWavePhyTrace::SetBinaryOutput),
+                          MakeBooleanChecker())
+            .AddAttribute("OutputBufferSize",
+                          "Size in bytes of the output buffer of each PHY trace file. "
+                          "The records are written to disk only when the buffer is full.",
+                          UintegerValue(1 << 20),
+                          MakeUintegerAccessor(&MmWavePhyTrace::SetOutputBufferSize),
+                          MakeUintegerChecker<uint32_t>())
 
         ;
     return tid;
@@ -118,6 +133,20 @@ MmWavePhyTrace::SetDlPhyTxOutputFilename(std::string fileName)
     m_dlPhyTraceFilename = fileName;
 }
 
+void
+MmWavePhyTrace::SetBinaryOutput(bool binary)
+{
+    NS_LOG_INFO("PHY traces in binary format: " << binary);
+    m_binaryOutput = binary;
+}
+
+void
+MmWavePhyTrace::SetOutputBufferSize(uint32_t bufferSize)
+{
+    NS_LOG_INFO("PHY traces output buffer size: " << bufferSize);
+    m_outputBufferSize = bufferSize;
+}
+
 void
 MmWavePhyTrace::ReportCurrentCellRsrpSinrCallback(Ptr<MmWavePhyTrace> phyStats,
                                                   std::string path,
@@ -193,49 +222,74 @@ unsigned) tbSize); fflush(log_file); fclose(log_file);
 }
 */
 void
-MmWavePhyTrace::ReportUlPhyTransmissionCallback(Ptr<MmWavePhyTrace> phyStats,
-                                                PhyTransmissionTraceParams param)
+MmWavePhyTrace::WritePhyTransmissionTrace(MmWaveTraceSink& sink,
+                                          const std::string& fileName,
+                                          const PhyTransmissionTraceParams& param)
 {
-    if (!m_ulPhyTraceFile.is_open())
+    if (!sink.IsOpen())
     {
-        m_ulPhyTraceFile.open(m_ulPhyTraceFilename.c_str());
-        if (!m_ulPhyTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-        m_ulPhyTraceFile
-            << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId"
-            << std::endl;
+        sink.Open(fileName, MmWaveTraceSink::PHY_TRANSMISSION, m_binaryOutput, m_outputBufferSize);
     }
 
+    PhyTransmissionTraceRecord record{};
+    record.m_frameNum = param.m_frameNum;
+    record.m_sfNum = param.m_sfNum;
+    record.m_slotNum = param.m_slotNum;
+    record.m_rnti = param.m_rnti;
+    record.m_symStart = param.m_symStart;
+    record.m_numSym = param.m_numSym;
+    record.m_ttiType = param.m_ttiType;
+    record.m_tddMode = param.m_tddMode;
+    record.m_rv = param.m_rv;
+    record.m_ccId = param.m_ccId;
+    sink.Write(record);
+}
+
+void
+MmWavePhyTrace::ReportUlPhyTransmissionCallback(Ptr<MmWavePhyTrace> phyStats,
+                                                PhyTransmissionTraceParams param)
+{
     // Trace the UL PHY transmission info
-    m_ulPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t" << +param.m_slotNum
-                     << "\t" << +param.m_rnti << "\t" << +param.m_symStart << "\t"
-                     << +param.m_numSym << "\t" << +param.m_ttiType << "\t" << +param.m_tddMode
-                     << "\t" << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+    WritePhyTransmissionTrace(m_ulPhyTraceFile, m_ulPhyTraceFilename, param);
 }
 
 void
 MmWavePhyTrace::ReportDlPhyTransmissionCallback(Ptr<MmWavePhyTrace> phyStats,
                                                 PhyTransmissionTraceParams param)
 {
-    if (!m_dlPhyTraceFile.is_open())
+    // Trace the DL PHY transmission info
+    WritePhyTransmissionTrace(m_dlPhyTraceFile, m_dlPhyTraceFilename, param);
+}
+
+void
+MmWavePhyTrace::WriteRxPacketTrace(const RxPacketTraceParams& params, bool isDownlink)
+{
+    if (!m_rxPacketTraceFile.IsOpen())
     {
-        m_dlPhyTraceFile.open(m_dlPhyTraceFilename.c_str());
-        if (!m_dlPhyTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-        m_dlPhyTraceFile
-            << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId"
-            << std::endl;
+        m_rxPacketTraceFile.Open(m_rxPacketTraceFilename,
+                                 MmWaveTraceSink::RX_PACKET,
+                                 m_binaryOutput,
+                                 m_outputBufferSize);
     }
 
-    // Trace the DL PHY transmission info
-    m_dlPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t" << +param.m_slotNum
-                     << "\t" << +param.m_rnti << "\t" << +param.m_symStart << "\t"
-                     << +param.m_numSym << "\t" << +param.m_ttiType << "\t" << +param.m_tddMode
-                     << "\t" << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+    RxPacketTraceRecord record{};
+    record.m_isDownlink = isDownlink;
+    record.m_time = Simulator::Now().GetSeconds();
+    record.m_frameNum = params.m_frameNum;
+    record.m_sfNum = params.m_sfNum;
+    record.m_slotNum = params.m_slotNum;
+    record.m_symStart = params.m_symStart;
+    record.m_numSym = params.m_numSym;
+    record.m_cellId = params.m_cellId;
+    record.m_rnti = params.m_rnti;
+    record.m_ccId = params.m_ccId;
+    record.m_tbSize = params.m_tbSize;
+    record.m_mcs = params.m_mcs;
+    record.m_rv = params.m_rv;
+    record.m_sinrDb = 10 * std::log10(params.m_sinr);
+    record.m_corrupt = params.m_corrupt;
+    record.m_tbler = params.m_tbler;
+    m_rxPacketTraceFile.Write(record);
 }
 
 void
@@ -243,25 +297,7 @@ MmWavePhyTrace::RxPacketTraceUeCallback(Ptr<MmWavePhyTrace> phyStats,
                                         std::string path,
                                         RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-        m_rxPacketTraceFile << "DL/"
-                               "UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#"
-                               "\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler"
-                            << std::endl;
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-    m_rxPacketTraceFile << "DL\t" << Simulator::Now().GetSeconds() << "\t" << params.m_frameNum
-                        << "\t" << +params.m_sfNum << "\t" << +params.m_slotNum << "\t"
-                        << +params.m_symStart << "\t" << +params.m_numSym << "\t" << params.m_cellId
-                        << "\t" << params.m_rnti << "\t" << +params.m_ccId << "\t"
-                        << params.m_tbSize << "\t" << +params.m_mcs << "\t" << +params.m_rv << "\t"
-                        << 10 * std::log10(params.m_sinr) << "\t" << params.m_corrupt << "\t"
-                        << params.m_tbler << std::endl;
+    WriteRxPacketTrace(params, true);
 
     if (params.m_corrupt)
     {
@@ -280,25 +316,7 @@ MmWavePhyTrace::RxPacketTraceEnbCallback(Ptr<MmWavePhyTrace> phyStats,
                                          std::string path,
                                          RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-        m_rxPacketTraceFile << "DL/"
-                               "UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#"
-                               "\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler"
-                            << std::endl;
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-    m_rxPacketTraceFile << "UL\t" << Simulator::Now().GetSeconds() << "\t" << params.m_frameNum
-                        << "\t" << +params.m_sfNum << "\t" << +params.m_slotNum << "\t"
-                        << +params.m_symStart << "\t" << +params.m_numSym << "\t" << params.m_cellId
-                        << "\t" << params.m_rnti << "\t" << +params.m_ccId << "\t"
-                        << params.m_tbSize << "\t" << +params.m_mcs << "\t" << +params.m_rv << "\t"
-                        << 10 * std::log10(params.m_sinr) << " \t" << params.m_corrupt << "\t"
-                        << params.m_tbler << std::endl;
+    WriteRxPacketTrace(params, false);
 
     if (params.m_corrupt)
     {
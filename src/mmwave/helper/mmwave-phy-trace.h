@@ -32,11 +32,12 @@
 
 #ifndef SRC_MMWAVE_HELPER_MMWAVE_PHY_TRACE_H_
 #define SRC_MMWAVE_HELPER_MMWAVE_PHY_TRACE_H_
+#include "mmwave-trace-sink.h"
+
 #include <ns3/mmwave-phy-mac-common.h>
 #include <ns3/object.h>
 #include <ns3/spectrum-value.h>
 
-#include <fstream>
 #include <iostream>
 
 namespace ns3
@@ -97,17 +98,49 @@ class MmWavePhyTrace : public Object
      */
     void SetDlPhyTxOutputFilename(std::string fileName);
 
+    /**
+     * Sets the format of the PHY traces
+     * \param binary if true, write fixed-width binary records instead of text lines
+     */
+    void SetBinaryOutput(bool binary);
+
+    /**
+     * Sets the size of the output buffer of each PHY trace file
+     * \param bufferSize the buffer size, in bytes
+     */
+    void SetOutputBufferSize(uint32_t bufferSize);
+
   private:
     // void ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr);
     // void ReportDLTbSize (uint64_t imsi, uint64_t tbSize);
-    static std::ofstream m_rxPacketTraceFile;   //!< Output stream for the PHY reception trace
+    /**
+     * Fill a PHY reception record and write it to the reception trace
+     * \param params the reception info
+     * \param isDownlink true if the TB was received by a UE
+     */
+    static void WriteRxPacketTrace(const RxPacketTraceParams& params, bool isDownlink);
+
+    /**
+     * Fill a PHY transmission record and write it to a transmission trace
+     * \param sink the trace sink
+     * \param fileName the name of the trace file, used if the sink is not open yet
+     * \param param the transmission info
+     */
+    static void WritePhyTransmissionTrace(MmWaveTraceSink& sink,
+                                          const std::string& fileName,
+                                          const PhyTransmissionTraceParams& param);
+
+    static MmWaveTraceSink m_rxPacketTraceFile; //!< Output sink for the PHY reception trace
     static std::string m_rxPacketTraceFilename; //!< Output filename for the PHY reception trace
 
-    static std::ofstream m_ulPhyTraceFile;   //!< Output stream for the UL PHY transmission trace
+    static MmWaveTraceSink m_ulPhyTraceFile; //!< Output sink for the UL PHY transmission trace
     static std::string m_ulPhyTraceFilename; //!< Output filename for the UL PHY transmission trace
 
-    static std::ofstream m_dlPhyTraceFile;   //!< Output stream for the DL PHY transmission trace
+    static MmWaveTraceSink m_dlPhyTraceFile; //!< Output sink for the DL PHY transmission trace
     static std::string m_dlPhyTraceFilename; //!< Output filename for the DL PHY transmission trace
+
+    static bool m_binaryOutput;         //!< True if the traces are written in binary format
+    static uint32_t m_outputBufferSize; //!< Size of the output buffer of each trace file
 };
 
 } // namespace mmwave
@@ -0,0 +1,220 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mmwave-trace-sink.h"
+
+#include <ns3/assert.h>
+#include <ns3/fatal-error.h>
+#include <ns3/log.h>
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MmWaveTraceSink");
+
+namespace mmwave
+{
+
+static_assert(sizeof(RxPacketTraceRecord) == 56, "Unexpected padding in RxPacketTraceRecord");
+static_assert(sizeof(PhyTransmissionTraceRecord) == 16,
+              "Unexpected padding in PhyTransmissionTraceRecord");
+
+const char MmWaveTraceSink::m_magic[4] = {'M', 'M', 'W', 'T'};
+
+MmWaveTraceSink::MmWaveTraceSink()
+    : m_type(RX_PACKET),
+      m_binary(false)
+{
+}
+
+MmWaveTraceSink::~MmWaveTraceSink()
+{
+    Close();
+}
+
+void
+MmWaveTraceSink::Open(const std::string& fileName,
+                      RecordType type,
+                      bool binary,
+                      uint32_t bufferSize)
+{
+    NS_LOG_FUNCTION(this << fileName << +type << binary << bufferSize);
+    NS_ASSERT(!m_file.is_open());
+
+    m_type = type;
+    m_binary = binary;
+
+    // the buffer must be installed before opening the file
+    m_buffer.resize(bufferSize);
+    if (bufferSize > 0)
+    {
+        m_file.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+    }
+
+    m_file.open(fileName.c_str(), binary ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Could not open tracefile " << fileName);
+    }
+
+    if (m_binary)
+    {
+        // magic, version, record type, 2 bytes of padding
+        const char header[8] =
+            {m_magic[0], m_magic[1], m_magic[2], m_magic[3], 1, static_cast<char>(type), 0, 0};
+        m_file.write(header, sizeof(header));
+    }
+    else
+    {
+        PrintHeader(m_file, m_type);
+    }
+}
+
+bool
+MmWaveTraceSink::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+void
+MmWaveTraceSink::Write(const RxPacketTraceRecord& record)
+{
+    NS_ASSERT(m_type == RX_PACKET);
+    if (m_binary)
+    {
+        m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    else
+    {
+        Print(m_file, record);
+    }
+}
+
+void
+MmWaveTraceSink::Write(const PhyTransmissionTraceRecord& record)
+{
+    NS_ASSERT(m_type == PHY_TRANSMISSION);
+    if (m_binary)
+    {
+        m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    else
+    {
+        Print(m_file, record);
+    }
+}
+
+void
+MmWaveTraceSink::Close()
+{
+    if (m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+void
+MmWaveTraceSink::PrintHeader(std::ostream& os, RecordType type)
+{
+    if (type == RX_PACKET)
+    {
+        os << "DL/"
+              "UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#"
+              "\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler"
+           << "\n";
+    }
+    else
+    {
+        os << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId"
+           << "\n";
+    }
+}
+
+void
+MmWaveTraceSink::Print(std::ostream& os, const RxPacketTraceRecord& record)
+{
+    os << (record.m_isDownlink ? "DL\t" : "UL\t") << record.m_time << "\t" << record.m_frameNum
+       << "\t" << +record.m_sfNum << "\t" << +record.m_slotNum << "\t" << +record.m_symStart
+       << "\t" << +record.m_numSym << "\t" << record.m_cellId << "\t" << record.m_rnti << "\t"
+       << +record.m_ccId << "\t" << record.m_tbSize << "\t" << +record.m_mcs << "\t"
+       << +record.m_rv << "\t" << record.m_sinrDb << "\t" << +record.m_corrupt << "\t"
+       << record.m_tbler << "\n";
+}
+
+void
+MmWaveTraceSink::Print(std::ostream& os, const PhyTransmissionTraceRecord& record)
+{
+    os << record.m_frameNum << "\t" << +record.m_sfNum << "\t" << +record.m_slotNum << "\t"
+       << record.m_rnti << "\t" << +record.m_symStart << "\t" << +record.m_numSym << "\t"
+       << +record.m_ttiType << "\t" << +record.m_tddMode << "\t" << +record.m_rv << "\t"
+       << +record.m_ccId << "\n";
+}
+
+void
+MmWaveTraceSink::ConvertToText(const std::string& binaryFileName, const std::string& textFileName)
+{
+    NS_LOG_FUNCTION(binaryFileName << textFileName);
+
+    std::ifstream in(binaryFileName.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+    {
+        NS_FATAL_ERROR("Could not open binary trace " << binaryFileName);
+    }
+
+    char header[8];
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, m_magic, sizeof(m_magic)) != 0 ||
+        header[4] != 1)
+    {
+        NS_FATAL_ERROR(binaryFileName << " is not a binary mmWave trace");
+    }
+    RecordType type = static_cast<RecordType>(header[5]);
+
+    std::ofstream out(textFileName.c_str());
+    if (!out.is_open())
+    {
+        NS_FATAL_ERROR("Could not open tracefile " << textFileName);
+    }
+    PrintHeader(out, type);
+
+    if (type == RX_PACKET)
+    {
+        RxPacketTraceRecord record;
+        while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        {
+            Print(out, record);
+        }
+    }
+    else if (type == PHY_TRANSMISSION)
+    {
+        PhyTransmissionTraceRecord record;
+        while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        {
+            Print(out, record);
+        }
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unknown record type " << +type << " in " << binaryFileName);
+    }
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_TRACE_SINK_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_TRACE_SINK_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * Fixed-width record of the PHY reception trace
+ */
+struct RxPacketTraceRecord
+{
+    double m_time;        //!< reception time, in seconds
+    double m_sinrDb;      //!< the average SINR, in dB
+    double m_tbler;       //!< the transport block error rate
+    uint64_t m_cellId;    //!< the cell ID
+    uint32_t m_frameNum;  //!< frame index
+    uint32_t m_tbSize;    //!< transport block size
+    uint16_t m_rnti;      //!< the RNTI
+    uint8_t m_isDownlink; //!< 1 if the TB was received by a UE, 0 if received by an eNB
+    uint8_t m_sfNum;      //!< subframe index
+    uint8_t m_slotNum;    //!< slot index
+    uint8_t m_symStart;   //!< index of the first OFDM symbol
+    uint8_t m_numSym;     //!< number of OFDM symbols
+    uint8_t m_ccId;       //!< the component carrier ID
+    uint8_t m_mcs;        //!< the MCS
+    uint8_t m_rv;         //!< the number of retransmissions
+    uint8_t m_corrupt;    //!< 1 if the TB has failed
+    uint8_t m_pad[5];     //!< padding, always 0
+};
+
+/**
+ * Fixed-width record of the PHY transmission and of the scheduling allocation traces
+ */
+struct PhyTransmissionTraceRecord
+{
+    uint32_t m_frameNum; //!< frame number
+    uint16_t m_rnti;     //!< UE RNTI
+    uint8_t m_sfNum;     //!< subframe number
+    uint8_t m_slotNum;   //!< slot number
+    uint8_t m_symStart;  //!< starting OFDM symbol
+    uint8_t m_numSym;    //!< amount of OFDM symbols
+    uint8_t m_ttiType;   //!< TDD transmission type
+    uint8_t m_tddMode;   //!< TDD mode
+    uint8_t m_rv;        //!< (re)transmission number
+    uint8_t m_ccId;      //!< component carrier ID
+    uint8_t m_pad[2];    //!< padding, always 0
+};
+
+/**
+ * Buffered output file shared by the mmWave PHY and MAC traces
+ *
+ * The records are written through a large user-space buffer, which is flushed
+ * only when full or when the file is closed, instead of after every record.
+ * A file can store the records either as tab-separated text lines or as
+ * fixed-width binary records. Binary files start with a small header that
+ * identifies the record type, and can be converted to the text format
+ * with ConvertToText.
+ */
+class MmWaveTraceSink
+{
+  public:
+    /**
+     * Type of the records stored in a file
+     */
+    enum RecordType : uint8_t
+    {
+        RX_PACKET = 0,       //!< RxPacketTraceRecord
+        PHY_TRANSMISSION = 1 //!< PhyTransmissionTraceRecord
+    };
+
+    MmWaveTraceSink();
+    ~MmWaveTraceSink();
+
+    /**
+     * Open the output file, and write the header of the trace
+     *
+     * \param fileName the name of the file
+     * \param type the type of the records written to the file
+     * \param binary if true, write fixed-width binary records, otherwise text lines
+     * \param bufferSize the size of the output buffer, in bytes
+     */
+    void Open(const std::string& fileName, RecordType type, bool binary, uint32_t bufferSize);
+
+    /**
+     * \return true if the file is open
+     */
+    bool IsOpen() const;
+
+    /**
+     * Write a PHY reception record
+     * \param record the record
+     */
+    void Write(const RxPacketTraceRecord& record);
+
+    /**
+     * Write a PHY transmission or scheduling allocation record
+     * \param record the record
+     */
+    void Write(const PhyTransmissionTraceRecord& record);
+
+    /**
+     * Flush the buffered records and close the file
+     */
+    void Close();
+
+    /**
+     * Convert a binary trace file into the equivalent text trace
+     *
+     * \param binaryFileName the name of a file written in binary mode
+     * \param textFileName the name of the text file to create
+     */
+    static void ConvertToText(const std::string& binaryFileName, const std::string& textFileName);
+
+  private:
+    /**
+     * Write the column names of the text format
+     * \param os the output stream
+     * \param type the type of the records
+     */
+    static void PrintHeader(std::ostream& os, RecordType type);
+
+    /**
+     * Write a PHY reception record as a text line
+     * \param os the output stream
+     * \param record the record
+     */
+    static void Print(std::ostream& os, const RxPacketTraceRecord& record);
+
+    /**
+     * Write a PHY transmission record as a text line
+     * \param os the output stream
+     * \param record the record
+     */
+    static void Print(std::ostream& os, const PhyTransmissionTraceRecord& record);
+
+    static const char m_magic[4]; //!< first bytes of a binary trace file
+
+    std::ofstream m_file;       //!< the output file
+    std::vector<char> m_buffer; //!< the buffer of the output file
+    RecordType m_type;          //!< the type of the records of the file
+    bool m_binary;              //!< true if the records are written in binary format
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_TRACE_SINK_H_ */
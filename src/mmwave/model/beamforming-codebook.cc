@@ -48,6 +48,12 @@ BeamformingCodebook::~BeamformingCodebook()
 {
 }
 
+uint32_t
+BeamformingCodebook::GetCodebookColumns() const
+{
+    return 0;
+}
+
 void
 BeamformingCodebook::DoInitialize()
 {
@@ -51,6 +51,13 @@ class BeamformingCodebook : public Object
      */
     virtual uint32_t GetCodebookSize(void) const = 0;
 
+    /**
+     * Get the number of columns of the grid of beam directions, for the codebooks whose
+     * codewords are stored in row-major order over such a grid
+     * \return the number of codewords per row, or 0 if the codewords are not a 2D grid
+     */
+    virtual uint32_t GetCodebookColumns(void) const;
+
   protected:
     virtual void DoInitialize(void);
 
@@ -30,6 +30,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <mutex>
 
 namespace ns3
 {
@@ -83,40 +85,84 @@ MmWaveEesmErrorModel::SinrEff(const SpectrumValue& sinr,
     NS_ABORT_MSG_IF(map.size() == 0,
                     " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
 
-    double SINR = 0.0;
-    double SINRsum = 0.0;
-    SpectrumValue sinrCopy = sinr;
+    // Read the SINR values in place, without copying the SpectrumValue, and keep
+    // the loop free of bound checks and divisions so that it can be vectorized
+    const double* sinrLin = &(*sinr.ConstValuesBegin());
+    const int* rb = map.data();
+    const std::size_t numRbs = map.size();
+    NS_ASSERT(*std::max_element(map.begin(), map.end()) <
+              static_cast<int>(sinr.GetSpectrumModel()->GetNumBands()));
 
     double beta = GetBetaTable()->at(mcs);
+    double invBeta = 1.0 / beta;
+    double SINRsum = 0.0;
 
-    for (uint32_t i = 0; i < map.size(); i++)
+    for (std::size_t i = 0; i < numRbs; i++)
     {
-        double sinrLin = sinrCopy[map.at(i)];
-        SINR = exp(-sinrLin / beta);
-        SINRsum += SINR;
+        SINRsum += std::exp(-sinrLin[rb[i]] * invBeta);
     }
 
-    SINR = -beta * log(SINRsum / map.size());
+    double SINR = -beta * std::log(SINRsum / numRbs);
 
     NS_LOG_INFO(" Effective SINR = " << SINR);
 
     return SINR;
 }
 
-const std::vector<double>&
-MmWaveEesmErrorModel::GetSinrDbVectorFromSimulatedValues(MmWaveEesmErrorModel::GraphType graphType,
-                                                         uint8_t mcs,
-                                                         uint32_t cbSizeIndex) const
+const MmWaveEesmErrorModel::BlerTableIndex&
+MmWaveEesmErrorModel::GetBlerTableIndex()
 {
-    return std::get<0>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
-}
+    if (m_blerTableIndex != nullptr)
+    {
+        return *m_blerTableIndex;
+    }
 
-const std::vector<double>&
-MmWaveEesmErrorModel::GetBLERVectorFromSimulatedValues(MmWaveEesmErrorModel::GraphType graphType,
-                                                       uint8_t mcs,
-                                                       uint32_t cbSizeIndex) const
-{
-    return std::get<1>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
+    // The simulated tables are static, hence their index can be shared by all
+    // the instances that use the same table. The instances may be used from
+    // several simulator threads, so the shared indexes are built under a lock;
+    // the elements of a std::map are never moved, so they are then read
+    // without it through m_blerTableIndex
+    static std::map<const SimulatedBlerFromSINR*, BlerTableIndex> indexes;
+    static std::mutex indexesMutex;
+
+    const SimulatedBlerFromSINR* table = GetSimulatedBlerFromSINR();
+    NS_ASSERT(table != nullptr);
+    std::lock_guard<std::mutex> lock(indexesMutex);
+    auto it = indexes.find(table);
+    if (it == indexes.end())
+    {
+        BlerTableIndex index;
+        index.m_numMcs = table->at(FIRST).size();
+        for (const auto& bgTable : *table)
+        {
+            NS_ABORT_MSG_IF(bgTable.size() != index.m_numMcs,
+                            "All the base graphs must have the same number of MCSs");
+            for (const auto& cbMap : bgTable)
+            {
+                index.m_firstCurve.push_back(index.m_cbSize.size());
+                for (const auto& cbCurve : cbMap)
+                {
+                    const DoubleVector& sinrDb = std::get<0>(cbCurve.second);
+                    const DoubleVector& bler = std::get<1>(cbCurve.second);
+                    NS_ABORT_MSG_IF(sinrDb.empty() || sinrDb.size() != bler.size(),
+                                    "Malformed SINR-BLER curve for CBS " << cbCurve.first);
+                    index.m_cbSize.push_back(cbCurve.first);
+                    index.m_firstPoint.push_back(index.m_sinrDb.size());
+                    index.m_sinrDb.insert(index.m_sinrDb.end(), sinrDb.begin(), sinrDb.end());
+                    index.m_bler.insert(index.m_bler.end(), bler.begin(), bler.end());
+                }
+            }
+        }
+        index.m_firstCurve.push_back(index.m_cbSize.size());
+        index.m_firstPoint.push_back(index.m_sinrDb.size());
+        NS_LOG_INFO("Indexed " << index.m_cbSize.size() << " SINR-BLER curves with "
+                               << index.m_sinrDb.size() << " points");
+
+        it = indexes.emplace(table, std::move(index)).first;
+    }
+
+    m_blerTableIndex = &it->second;
+    return *m_blerTableIndex;
 }
 
 double
@@ -133,42 +179,46 @@ MmWaveEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeB
     double sinr_db = 10 * log10(sinr);
     GraphType bg_type = GetBaseGraphType(cbSizeBit, mcs);
 
-    // Get the index of CBSIZE in the map
     NS_LOG_INFO("For sinr " << sinr << " and mcs " << +mcs << " CbSizebit " << cbSizeBit
                             << " we got bg type " << m_bgTypeName[bg_type]);
-    const auto& cbMap = GetSimulatedBlerFromSINR()->at(bg_type).at(mcs);
-    auto cbIt = cbMap.upper_bound(cbSizeBit);
+    const BlerTableIndex& index = GetBlerTableIndex();
+    NS_ABORT_MSG_IF(mcs >= index.m_numMcs, "MCS " << +mcs << " is not in the SINR-BLER table");
+
+    // Get the index of CBSIZE among the curves of this (BG, MCS)
+    const uint32_t bgMcs = bg_type * index.m_numMcs + mcs;
+    auto cbBegin = index.m_cbSize.begin() + index.m_firstCurve[bgMcs];
+    auto cbEnd = index.m_cbSize.begin() + index.m_firstCurve[bgMcs + 1];
+    NS_ASSERT(cbBegin != cbEnd);
+    auto cbIt = std::upper_bound(cbBegin, cbEnd, cbSizeBit);
 
-    if (cbIt != cbMap.begin())
+    if (cbIt != cbBegin)
     {
         cbIt--;
     }
 
-    if (sinr_db < GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).front())
+    const uint32_t curve = std::distance(index.m_cbSize.begin(), cbIt);
+    auto sinrBegin = index.m_sinrDb.begin() + index.m_firstPoint[curve];
+    auto sinrEnd = index.m_sinrDb.begin() + index.m_firstPoint[curve + 1];
+
+    if (sinr_db < *sinrBegin)
     {
         bler = 1.0;
     }
-    else if (sinr_db > GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).back())
+    else if (sinr_db > *(sinrEnd - 1))
     {
         bler = 0.0;
     }
     else
     {
         // Get the index of SINR in the vector
-        auto sinrIt =
-            std::upper_bound(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                             GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).end(),
-                             sinr_db);
+        auto sinrIt = std::upper_bound(sinrBegin, sinrEnd, sinr_db);
 
-        if (sinrIt != GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin())
+        if (sinrIt != sinrBegin)
         {
             sinrIt--;
         }
 
-        auto sinr_index =
-            std::distance(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                          sinrIt);
-        bler = GetBLERVectorFromSimulatedValues(bg_type, mcs, cbIt->first).at(sinr_index);
+        bler = index.m_bler[std::distance(index.m_sinrDb.begin(), sinrIt)];
     }
 
     NS_LOG_LOGIC("SINR effective: " << sinr << " BLER:" << bler);
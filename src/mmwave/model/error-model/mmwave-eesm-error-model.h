@@ -256,6 +256,32 @@ class MmWaveEesmErrorModel : public MmWaveErrorModel
   private:
     static std::vector<std::string> m_bgTypeName; //!< Base graph name
 
+    /**
+     * \brief Compact index of a SimulatedBlerFromSINR table
+     *
+     * The nested maps and tuples of the simulated tables are flattened once into
+     * contiguous arrays, so that looking up a BLER curve does not need to walk
+     * the maps. The index is built the first time a table is used, and shared
+     * by all the error model instances using that table.
+     */
+    struct BlerTableIndex
+    {
+        uint32_t m_numMcs{0};                 //!< number of MCSs per base graph
+        std::vector<uint32_t> m_firstCurve;   //!< first curve of each (BG, MCS), plus sentinel
+        std::vector<uint32_t> m_cbSize;       //!< CB size of each curve
+        std::vector<uint32_t> m_firstPoint;   //!< first point of each curve, plus sentinel
+        std::vector<double> m_sinrDb;         //!< SINR (dB) of the points of all the curves
+        std::vector<double> m_bler;           //!< BLER of the points of all the curves
+    };
+
+    /**
+     * \brief Get the compact index of the table returned by GetSimulatedBlerFromSINR
+     * \return the index, built on first use
+     */
+    const BlerTableIndex& GetBlerTableIndex();
+
+    const BlerTableIndex* m_blerTableIndex{nullptr}; //!< cached pointer to the table index
+
     /**
      * \brief map the effective SINR into CBLER for the specified MCS and CB size,
      * according to the EESM method
@@ -317,27 +343,6 @@ class MmWaveEesmErrorModel : public MmWaveErrorModel
      * the number of code blocks
      */
     std::pair<uint32_t, uint32_t> CodeBlockSegmentation(uint32_t B, GraphType bg_type) const;
-
-    /**
-     * \brief Get SinrDb Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
-     */
-    const std::vector<double>& GetSinrDbVectorFromSimulatedValues(GraphType graphType,
-                                                                  uint8_t mcs,
-                                                                  uint32_t cbSizeIndex) const;
-    /**
-     * \brief Get BLER Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
-     */
-    const std::vector<double>& GetBLERVectorFromSimulatedValues(GraphType graphType,
-                                                                uint8_t mcs,
-                                                                uint32_t cbSizeIndex) const;
 };
 
 } // namespace mmwave
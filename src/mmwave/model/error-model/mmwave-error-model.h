@@ -145,6 +145,10 @@ class MmWaveErrorModel : public Object
      *
      * This method should not return a nullptr, ever.
      *
+     * Implementations must be stateless: the result has to depend only on the
+     * arguments, since the same instance is shared by all the TBs decoded by a
+     * MmWaveSpectrumPhy and by all the CQI reports computed by a MmWaveAmc.
+     *
      * \param sinr SINR vector
      * \param map RB map
      * \param size Transport block size
@@ -25,10 +25,20 @@
 #include <ns3/string.h>
 #include <ns3/uinteger.h>
 
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <stdlib.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MMWAVE_CODEBOOK_MMAP
+#endif
+
 namespace ns3
 {
 
@@ -39,6 +49,51 @@ NS_LOG_COMPONENT_DEFINE("FileBeamformingCodebook");
 
 NS_OBJECT_ENSURE_REGISTERED(FileBeamformingCodebook);
 
+namespace
+{
+
+/**
+ * Header of a binary codebook, followed by cbSize * cwSize std::complex<double>
+ * stored codeword after codeword, in the byte order of the host which wrote
+ * the file. Only UniformPlanarArray codebooks are supported.
+ */
+struct BinaryCodebookHeader
+{
+    char magic[4];       //!< "MWCB"
+    uint32_t version;    //!< format version
+    uint32_t numRows;    //!< NumRows of the array
+    uint32_t numColumns; //!< NumColumns of the array
+    double vSpacing;     //!< AntennaVerticalSpacing of the array
+    double hSpacing;     //!< AntennaHorizontalSpacing of the array
+    uint32_t cbSize;                                //!< number of codewords
+    uint32_t cwSize;                                //!< number of elements of each codeword
+};
+
+const char BINARY_CODEBOOK_MAGIC[4] = {'M', 'W', 'C', 'B'}; //!< binary codebook magic
+const uint32_t BINARY_CODEBOOK_VERSION = 1;                  //!< binary codebook version
+
+} // namespace
+
+struct FileBeamformingCodebook::CodebookData
+{
+    ~CodebookData()
+    {
+#ifdef MMWAVE_CODEBOOK_MMAP
+        if (mapping)
+        {
+            munmap(mapping, mappingSize);
+        }
+#endif
+    }
+
+    uint32_t cbSize{0};                             //!< number of codewords
+    uint32_t cwSize{0};                             //!< number of elements of each codeword
+    const std::complex<double>* codewords{nullptr}; //!< codewords, one after the other
+    std::vector<std::complex<double>> storage;      //!< owned codewords, if not mapped
+    void* mapping{nullptr};                         //!< mapped binary codebook, if any
+    size_t mappingSize{0};                          //!< size of the mapping
+};
+
 TypeId
 FileBeamformingCodebook::GetTypeId()
 {
@@ -50,11 +105,19 @@ FileBeamformingCodebook::GetTypeId()
                           "The filename for the codebook file",
                           StringValue(""),
                           MakeStringAccessor(&FileBeamformingCodebook::m_codebookFilename),
-                          MakeStringChecker());
+                          MakeStringChecker())
+            .AddAttribute("CodebookColumns",
+                          "If the codewords point to a 2D grid of directions and are stored "
+                          "in row-major order, the number of codewords per row. 0 if the "
+                          "codewords are not a 2D grid",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FileBeamformingCodebook::m_codebookColumns),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 FileBeamformingCodebook::FileBeamformingCodebook()
+    : m_codebookColumns{0}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -74,74 +137,154 @@ PhasedArrayModel::ComplexVector
 FileBeamformingCodebook::GetCodeword(uint32_t idx) const
 {
     NS_LOG_FUNCTION(this << idx);
-    return m_codewords[idx];
+    NS_ASSERT_MSG(idx < m_codebook->cbSize, "Codeword index out of range");
+
+    PhasedArrayModel::ComplexVector cw(m_codebook->cwSize);
+    const std::complex<double>* src = m_codebook->codewords + size_t(idx) * m_codebook->cwSize;
+    for (uint32_t i = 0; i < m_codebook->cwSize; i++)
+    {
+        cw[i] = src[i];
+    }
+    return cw;
 }
 
 uint32_t
 FileBeamformingCodebook::GetCodebookSize(void) const
 {
     NS_LOG_FUNCTION(this);
-    return m_codewords.size();
+    return m_codebook ? m_codebook->cbSize : 0;
 }
 
-void
-FileBeamformingCodebook::ImportCodebookFromFile(void)
+uint32_t
+FileBeamformingCodebook::GetCodebookColumns(void) const
 {
     NS_LOG_FUNCTION(this);
+    return m_codebookColumns;
+}
 
-    std::ifstream cbFile{m_codebookFilename.c_str()};
-    NS_ABORT_MSG_IF(!cbFile.good(), m_codebookFilename + " not found");
-
-    ValidateAntenna(cbFile);
-
-    std::string line{};
-
-    // read codebook size
-    std::getline(cbFile, line);
-    int tmp = atoi(line.c_str());
-    NS_ABORT_MSG_IF(tmp <= 0, "Codebook size must be strictly positive");
-    uint32_t cbSize = uint32_t(tmp);
+std::size_t
+FileBeamformingCodebook::GetNumCachedCodebooks(void)
+{
+    return GetCache().size();
+}
 
-    m_codewords.reserve(cbSize); // allocate memory
+std::map<std::string, std::weak_ptr<const FileBeamformingCodebook::CodebookData>>&
+FileBeamformingCodebook::GetCache(void)
+{
+    static std::map<std::string, std::weak_ptr<const CodebookData>> cache;
+    return cache;
+}
 
-    // read codewords size
-    std::getline(cbFile, line);
-    tmp = atoi(line.c_str());
-    NS_ABORT_MSG_IF(tmp <= 0, "Codeword size must be strictly positive");
-    uint32_t cwSize = uint32_t(tmp);
+void
+FileBeamformingCodebook::ImportCodebookFromFile(void)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!m_array, "Array was not set");
 
-    NS_LOG_DEBUG("A codeword with " << cbSize << " codewords of size " << cwSize);
+    ArrayGeometry arrayGeometry = GetArrayGeometry();
+    std::ostringstream key;
+    key << std::setprecision(17) << m_codebookFilename << '|' << arrayGeometry.arrayId << '|'
+        << arrayGeometry.numRows << 'x' << arrayGeometry.numColumns << '|'
+        << arrayGeometry.vSpacing << '|' << arrayGeometry.hSpacing;
 
-    while (std::getline(cbFile, line))
+    auto& cache = GetCache();
+    auto cached = cache.find(key.str());
+    if (cached != cache.end())
     {
-        // lines with CSV for each codeword
-        PhasedArrayModel::ComplexVector cw = ParseCodeword(line, cwSize);
-        m_codewords.push_back(cw);
+        m_codebook = cached->second.lock();
+        if (m_codebook)
+        {
+            NS_LOG_LOGIC("Codebook " << m_codebookFilename << " found in cache");
+            return;
+        }
     }
 
-    NS_ABORT_MSG_IF(m_codewords.size() != cbSize,
-                    "Codebook of unexpected size: m_codewords.size ()=" << m_codewords.size()
-                                                                        << ", cbSize=" << cbSize);
+    std::ifstream cbFile{m_codebookFilename.c_str(), std::ios::binary};
+    NS_ABORT_MSG_IF(!cbFile.good(), m_codebookFilename + " not found");
+    char magic[sizeof(BINARY_CODEBOOK_MAGIC)] = {};
+    cbFile.read(magic, sizeof(magic));
+    bool isBinary = cbFile.gcount() == sizeof(magic) &&
+                    std::memcmp(magic, BINARY_CODEBOOK_MAGIC, sizeof(magic)) == 0;
+    cbFile.close();
+
+    ArrayGeometry fileGeometry;
+    std::shared_ptr<CodebookData> codebook =
+        isBinary ? ReadBinaryCodebook(m_codebookFilename, fileGeometry)
+                 : ReadTextCodebook(m_codebookFilename, fileGeometry);
+    ValidateAntenna(fileGeometry);
+
+    NS_LOG_DEBUG("A codebook with " << codebook->cbSize << " codewords of size "
+                                    << codebook->cwSize);
+    m_codebook = codebook;
+
+    // drop the entries of the codebooks no longer used before adding the new one
+    for (auto entry = cache.begin(); entry != cache.end();)
+    {
+        if (entry->second.expired())
+        {
+            entry = cache.erase(entry);
+        }
+        else
+        {
+            ++entry;
+        }
+    }
+    cache[key.str()] = m_codebook;
     NS_LOG_LOGIC("Codebook successfully imported from " << m_codebookFilename);
 }
 
+FileBeamformingCodebook::ArrayGeometry
+FileBeamformingCodebook::GetArrayGeometry(void) const
+{
+    ArrayGeometry geometry{m_array->GetInstanceTypeId().GetName(), 0, 0, 0.0, 0.0};
+    if (geometry.arrayId == UniformPlanarArray::GetTypeId().GetName())
+    {
+        UintegerValue uintValue;
+        DoubleValue doubleValue;
+        m_array->GetAttribute("NumRows", uintValue);
+        geometry.numRows = uintValue.Get();
+        m_array->GetAttribute("NumColumns", uintValue);
+        geometry.numColumns = uintValue.Get();
+        m_array->GetAttribute("AntennaVerticalSpacing", doubleValue);
+        geometry.vSpacing = doubleValue.Get();
+        m_array->GetAttribute("AntennaHorizontalSpacing", doubleValue);
+        geometry.hSpacing = doubleValue.Get();
+    }
+    return geometry;
+}
+
 void
-FileBeamformingCodebook::ValidateAntenna(std::ifstream& cbFile) const
+FileBeamformingCodebook::ValidateAntenna(const ArrayGeometry& fileGeometry) const
+{
+    ArrayGeometry arrayGeometry = GetArrayGeometry();
+    NS_ABORT_MSG_IF(fileGeometry.arrayId != arrayGeometry.arrayId,
+                    fileGeometry.arrayId << " != " << arrayGeometry.arrayId);
+    NS_ABORT_MSG_IF(fileGeometry.vSpacing != arrayGeometry.vSpacing,
+                    "AntennaVerticalSpacing: " << fileGeometry.vSpacing
+                                               << " != " << arrayGeometry.vSpacing);
+    NS_ABORT_MSG_IF(fileGeometry.hSpacing != arrayGeometry.hSpacing,
+                    "AntennaHorizontalSpacing: " << fileGeometry.hSpacing
+                                                 << " != " << arrayGeometry.hSpacing);
+    NS_ABORT_MSG_IF(fileGeometry.numRows != arrayGeometry.numRows,
+                    "NumRows: " << fileGeometry.numRows << " != " << arrayGeometry.numRows);
+    NS_ABORT_MSG_IF(fileGeometry.numColumns != arrayGeometry.numColumns,
+                    "NumColumns: " << fileGeometry.numColumns
+                                   << " != " << arrayGeometry.numColumns);
+}
+
+FileBeamformingCodebook::ArrayGeometry
+FileBeamformingCodebook::ReadTextHeader(std::ifstream& cbFile)
 {
-    std::string arrayId;
+    ArrayGeometry geometry{"", 0, 0, 0.0, 0.0};
 
     // read PhasedArrayModel TypeId
-    std::getline(cbFile, arrayId);
-    // TODO find a way to do this check
-    NS_ABORT_MSG_IF(!m_array, "Array was not set");
-    NS_ABORT_MSG_IF(arrayId != m_array->GetInstanceTypeId().GetName(),
-                    arrayId << " != " << m_array->GetInstanceTypeId().GetName());
+    std::getline(cbFile, geometry.arrayId);
 
     std::string line{};
     std::string attribute{};
     std::string value{};
 
-    if (arrayId == UniformPlanarArray::GetTypeId().GetName())
+    if (geometry.arrayId == UniformPlanarArray::GetTypeId().GetName())
     {
         for (uint8_t i = 0; i < 5; i++)
         {
@@ -151,35 +294,25 @@ FileBeamformingCodebook::ValidateAntenna(std::ifstream& cbFile) const
             std::getline(ss, attribute, ',');
             std::getline(ss, value, ',');
 
-            if (attribute == "AntennaHorizontalSpacing" || attribute == "AntennaVerticalSpacing")
+            if (attribute == "AntennaVerticalSpacing")
             {
-                DoubleValue attributeValue;
-                m_array->GetAttribute(attribute, attributeValue);
-                double fileValue{std::atof(value.c_str())};
-
-                NS_ABORT_MSG_IF(fileValue != attributeValue.Get(),
-                                attribute << ": " << fileValue << " != " << attributeValue.Get());
+                geometry.vSpacing = std::atof(value.c_str());
             }
-            else if (attribute == "NumRows" || attribute == "NumColumns")
+            else if (attribute == "AntennaHorizontalSpacing")
             {
-                UintegerValue attributeValue;
-                m_array->GetAttribute(attribute, attributeValue);
-                uint64_t fileValue{std::stoul(value)};
-
-                NS_ABORT_MSG_IF(fileValue != attributeValue.Get(),
-                                attribute << ": " << fileValue << " != " << attributeValue.Get());
+                geometry.hSpacing = std::atof(value.c_str());
+            }
+            else if (attribute == "NumRows")
+            {
+                geometry.numRows = std::stoul(value);
+            }
+            else if (attribute == "NumColumns")
+            {
+                geometry.numColumns = std::stoul(value);
             }
             else if (attribute == "AntennaElement")
             {
-                PointerValue attributeValue;
-                m_array->GetAttribute(attribute, attributeValue);
-                std::string fileValue{value};
-
                 // Ignore antenna element for the moment
-                // NS_ABORT_MSG_IF (fileValue != attributeValue.GetObject ()->GetInstanceTypeId
-                // ().GetName (),
-                //                  attribute << ": " << fileValue << " != " <<
-                //                  attributeValue.GetObject ()->GetInstanceTypeId ().GetName ());
             }
             else
             {
@@ -189,21 +322,156 @@ FileBeamformingCodebook::ValidateAntenna(std::ifstream& cbFile) const
     }
     else
     {
-        NS_FATAL_ERROR("arrayId '" << arrayId << "' not recognized");
+        NS_FATAL_ERROR("arrayId '" << geometry.arrayId << "' not recognized");
     }
+    return geometry;
 }
 
-PhasedArrayModel::ComplexVector
-FileBeamformingCodebook::ParseCodeword(const std::string& line, uint32_t cwSize)
+std::shared_ptr<FileBeamformingCodebook::CodebookData>
+FileBeamformingCodebook::ReadTextCodebook(const std::string& filename, ArrayGeometry& geometry)
+{
+    NS_LOG_FUNCTION(filename);
+
+    std::ifstream cbFile{filename.c_str()};
+    NS_ABORT_MSG_IF(!cbFile.good(), filename + " not found");
+
+    geometry = ReadTextHeader(cbFile);
+
+    std::string line{};
+
+    // read codebook size
+    std::getline(cbFile, line);
+    int tmp = atoi(line.c_str());
+    NS_ABORT_MSG_IF(tmp <= 0, "Codebook size must be strictly positive");
+    uint32_t cbSize = uint32_t(tmp);
+
+    // read codewords size
+    std::getline(cbFile, line);
+    tmp = atoi(line.c_str());
+    NS_ABORT_MSG_IF(tmp <= 0, "Codeword size must be strictly positive");
+    uint32_t cwSize = uint32_t(tmp);
+
+    auto codebook = std::make_shared<CodebookData>();
+    codebook->cbSize = cbSize;
+    codebook->cwSize = cwSize;
+    codebook->storage.resize(size_t(cbSize) * cwSize); // allocate memory
+
+    uint32_t numCodewords = 0;
+    while (std::getline(cbFile, line))
+    {
+        // lines with CSV for each codeword
+        NS_ABORT_MSG_IF(numCodewords >= cbSize,
+                        "Codebook of unexpected size: more than cbSize=" << cbSize
+                                                                         << " codewords");
+        ParseCodeword(line, cwSize, codebook->storage.data() + size_t(numCodewords) * cwSize);
+        numCodewords++;
+    }
+
+    NS_ABORT_MSG_IF(numCodewords != cbSize,
+                    "Codebook of unexpected size: numCodewords=" << numCodewords
+                                                                 << ", cbSize=" << cbSize);
+    codebook->codewords = codebook->storage.data();
+    return codebook;
+}
+
+std::shared_ptr<FileBeamformingCodebook::CodebookData>
+FileBeamformingCodebook::ReadBinaryCodebook(const std::string& filename, ArrayGeometry& geometry)
+{
+    NS_LOG_FUNCTION(filename);
+
+    auto codebook = std::make_shared<CodebookData>();
+    BinaryCodebookHeader header;
+    size_t fileSize = 0;
+
+#ifdef MMWAVE_CODEBOOK_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, filename + " not found");
+    struct stat st;
+    NS_ABORT_MSG_IF(fstat(fd, &st) != 0, "Cannot stat " << filename);
+    fileSize = st.st_size;
+    NS_ABORT_MSG_IF(fileSize < sizeof(header), "Truncated binary codebook " << filename);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(mapping == MAP_FAILED, "Cannot map " << filename);
+    codebook->mapping = mapping;
+    codebook->mappingSize = fileSize;
+    std::memcpy(&header, mapping, sizeof(header));
+    codebook->codewords = reinterpret_cast<const std::complex<double>*>(
+        static_cast<const char*>(mapping) + sizeof(header));
+#else
+    std::ifstream cbFile{filename.c_str(), std::ios::binary | std::ios::ate};
+    NS_ABORT_MSG_IF(!cbFile.good(), filename + " not found");
+    fileSize = cbFile.tellg();
+    NS_ABORT_MSG_IF(fileSize < sizeof(header), "Truncated binary codebook " << filename);
+    cbFile.seekg(0);
+    cbFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+    codebook->storage.resize((fileSize - sizeof(header)) / sizeof(std::complex<double>));
+    cbFile.read(reinterpret_cast<char*>(codebook->storage.data()),
+                codebook->storage.size() * sizeof(std::complex<double>));
+    codebook->codewords = codebook->storage.data();
+#endif
+
+    NS_ABORT_MSG_IF(std::memcmp(header.magic, BINARY_CODEBOOK_MAGIC, sizeof(header.magic)) != 0,
+                    filename << " is not a binary codebook");
+    NS_ABORT_MSG_IF(header.version != BINARY_CODEBOOK_VERSION,
+                    "Unsupported binary codebook version " << header.version);
+    NS_ABORT_MSG_IF(header.cbSize == 0, "Codebook size must be strictly positive");
+    NS_ABORT_MSG_IF(header.cwSize == 0, "Codeword size must be strictly positive");
+    NS_ABORT_MSG_IF(fileSize != sizeof(header) + size_t(header.cbSize) * header.cwSize *
+                                                     sizeof(std::complex<double>),
+                    "Binary codebook " << filename << " of unexpected size " << fileSize);
+
+    codebook->cbSize = header.cbSize;
+    codebook->cwSize = header.cwSize;
+    geometry = ArrayGeometry{UniformPlanarArray::GetTypeId().GetName(),
+                             header.numRows,
+                             header.numColumns,
+                             header.vSpacing,
+                             header.hSpacing};
+    return codebook;
+}
+
+void
+FileBeamformingCodebook::ConvertToBinary(const std::string& textFilename,
+                                         const std::string& binaryFilename)
+{
+    NS_LOG_FUNCTION(textFilename << binaryFilename);
+
+    ArrayGeometry geometry;
+    std::shared_ptr<CodebookData> codebook = ReadTextCodebook(textFilename, geometry);
+
+    BinaryCodebookHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BINARY_CODEBOOK_MAGIC, sizeof(header.magic));
+    header.version = BINARY_CODEBOOK_VERSION;
+    header.numRows = geometry.numRows;
+    header.numColumns = geometry.numColumns;
+    header.vSpacing = geometry.vSpacing;
+    header.hSpacing = geometry.hSpacing;
+    header.cbSize = codebook->cbSize;
+    header.cwSize = codebook->cwSize;
+
+    std::ofstream binFile{binaryFilename.c_str(), std::ios::binary};
+    NS_ABORT_MSG_IF(!binFile.good(), "Cannot open " << binaryFilename);
+    binFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    binFile.write(reinterpret_cast<const char*>(codebook->codewords),
+                  codebook->storage.size() * sizeof(std::complex<double>));
+    NS_ABORT_MSG_IF(!binFile.good(), "Cannot write " << binaryFilename);
+}
+
+void
+FileBeamformingCodebook::ParseCodeword(const std::string& line,
+                                       uint32_t cwSize,
+                                       std::complex<double>* cw)
 {
     NS_LOG_FUNCTION(line << cwSize);
 
     std::stringstream ss(line);
-    PhasedArrayModel::ComplexVector cw(cwSize);
 
-    uint16_t index = 0;
+    uint32_t index = 0;
     for (std::complex<double> i; ss >> i;)
     {
+        NS_ABORT_MSG_IF(index >= cwSize, "Codeword longer than cwSize=" << cwSize);
         cw[index++] = i;
         if (ss.peek() == ';')
         {
@@ -211,10 +479,8 @@ FileBeamformingCodebook::ParseCodeword(const std::string& line, uint32_t cwSize)
         }
     }
 
-    NS_ABORT_MSG_IF(cw.GetSize() != cwSize,
-                    "Codeword of unexpected size: cw.size ()=" << cw.GetSize()
-                                                               << ", cwSize=" << cwSize);
-    return cw;
+    NS_ABORT_MSG_IF(index != cwSize,
+                    "Codeword of unexpected size: " << index << ", cwSize=" << cwSize);
 }
 
 } // namespace mmwave
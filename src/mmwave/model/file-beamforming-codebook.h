@@ -22,13 +22,27 @@
 #include "ns3/beamforming-codebook.h"
 #include "ns3/object.h"
 
+#include <map>
+#include <memory>
+
 namespace ns3
 {
 namespace mmwave
 {
 
 /**
+ * \brief Beamforming codebook imported from a file
+ *
+ * The file can either be in the text format of the codebooks provided in
+ * src/mmwave/model/Codebooks, or in the compact binary format produced by
+ * ConvertToBinary. Binary codebooks are memory-mapped when the platform
+ * supports it.
  *
+ * The codewords are stored in a process-wide cache keyed by file path and
+ * array geometry, so that all the instances using the same codebook with the
+ * same antenna array share a single read-only copy of the codewords. The
+ * cache does not keep the codewords alive: the entries of the codebooks no
+ * longer used are dropped whenever a new codebook is imported.
  */
 class FileBeamformingCodebook : public BeamformingCodebook
 {
@@ -42,6 +56,20 @@ class FileBeamformingCodebook : public BeamformingCodebook
      */
     static TypeId GetTypeId(void);
 
+    /**
+     * Convert a codebook from the text format to the binary format
+     * \param textFilename the text codebook to read
+     * \param binaryFilename the binary codebook to write
+     */
+    static void ConvertToBinary(const std::string& textFilename, const std::string& binaryFilename);
+
+    /**
+     * Get the number of entries of the cache of the imported codebooks. The entries of the
+     * codebooks no longer used are dropped at the next import of a codebook.
+     * \return the number of entries of the cache
+     */
+    static std::size_t GetNumCachedCodebooks(void);
+
     /**
      *
      */
@@ -52,29 +80,92 @@ class FileBeamformingCodebook : public BeamformingCodebook
      */
     uint32_t GetCodebookSize(void) const override;
 
+    /**
+     * \return the value of the CodebookColumns attribute
+     */
+    uint32_t GetCodebookColumns(void) const override;
+
   private:
+    /**
+     * Read-only codewords shared by all the instances using the same codebook
+     */
+    struct CodebookData;
+
+    /**
+     * Geometry of the antenna array a codebook was computed for
+     */
+    struct ArrayGeometry
+    {
+        std::string arrayId; //!< TypeId name of the PhasedArrayModel
+        uint64_t numRows;    //!< number of rows
+        uint64_t numColumns; //!< number of columns
+        double vSpacing;     //!< vertical spacing, in wavelengths
+        double hSpacing;     //!< horizontal spacing, in wavelengths
+    };
+
     /**
      *
      */
     virtual void DoInitialize(void) override;
 
     /**
-     *
+     * Import the codebook from m_codebookFilename, or reuse the cached copy
+     * already imported by another instance with the same array geometry
      */
     void ImportCodebookFromFile(void);
 
     /**
-     *
+     * \return the geometry of m_array
      */
-    void ValidateAntenna(std::ifstream& cbFile) const;
+    ArrayGeometry GetArrayGeometry(void) const;
 
     /**
-     *
+     * Abort if the geometry of a codebook does not match m_array
+     * \param fileGeometry the geometry read from the codebook file
+     */
+    void ValidateAntenna(const ArrayGeometry& fileGeometry) const;
+
+    /**
+     * Read the array type and attributes from the header of a text codebook
+     * \param cbFile the text codebook
+     * \return the array geometry
+     */
+    static ArrayGeometry ReadTextHeader(std::ifstream& cbFile);
+
+    /**
+     * Import a codebook in the text format
+     * \param filename the codebook file
+     * \param geometry filled with the array geometry read from the file
+     * \return the codewords
+     */
+    static std::shared_ptr<CodebookData> ReadTextCodebook(const std::string& filename,
+                                                          ArrayGeometry& geometry);
+
+    /**
+     * Import a codebook in the binary format
+     * \param filename the codebook file
+     * \param geometry filled with the array geometry read from the file
+     * \return the codewords
+     */
+    static std::shared_ptr<CodebookData> ReadBinaryCodebook(const std::string& filename,
+                                                            ArrayGeometry& geometry);
+
+    /**
+     * Parse a line of a text codebook
+     * \param line the semicolon-separated complex elements of the codeword
+     * \param cwSize the expected number of elements
+     * \param cw the buffer of cwSize elements to fill
+     */
+    static void ParseCodeword(const std::string& line, uint32_t cwSize, std::complex<double>* cw);
+
+    /**
+     * \return the codebooks currently in use, by file path and array geometry
      */
-    static PhasedArrayModel::ComplexVector ParseCodeword(const std::string& line, uint32_t cwSize);
+    static std::map<std::string, std::weak_ptr<const CodebookData>>& GetCache(void);
 
     std::string m_codebookFilename;
-    std::vector<PhasedArrayModel::ComplexVector> m_codewords;
+    uint32_t m_codebookColumns;                     //!< codewords per row of the beam grid
+    std::shared_ptr<const CodebookData> m_codebook; //!< the codewords
 };
 
 } // namespace mmwave
@@ -85,6 +85,18 @@ MmWaveAmc::GetTypeId(void)
                                           "ErrorModel",
                                           MmWaveAmc::ShannonModel,
                                           "ShannonModel"))
+            .AddAttribute("McsSearch",
+                          "Strategy used to search the highest MCS meeting the target TBLER "
+                          "when AmcModel is set to ErrorModel. BisectionSearch needs a number of "
+                          "error model evaluations logarithmic in the number of MCSs, but assumes "
+                          "the TBLER to increase with the MCS",
+                          EnumValue(MmWaveAmc::LinearSearch),
+                          MakeEnumAccessor<McsSearch>(&MmWaveAmc::SetMcsSearch,
+                                                      &MmWaveAmc::GetMcsSearch),
+                          MakeEnumChecker(MmWaveAmc::LinearSearch,
+                                          "LinearSearch",
+                                          MmWaveAmc::BisectionSearch,
+                                          "BisectionSearch"))
             .AddAttribute("Ber",
                           "The target BER, used for assigning the MCS"
                           "This parameter is used only by the ShannonModel",
@@ -260,29 +272,36 @@ MmWaveAmc::CreateCqiFeedbackWbTdma(const SpectrumValue& sinr, uint8_t& mcs) cons
             rbId += 1;
         }
 
-        mcs = 0;
-        Ptr<MmWaveErrorModelOutput> output;
-        while (mcs <= m_errorModel->GetMaxMcs())
+        // find the first MCS that does not meet the target TBLER
+        uint8_t maxMcs = m_errorModel->GetMaxMcs();
+        uint8_t firstFailing = 0;
+        if (m_mcsSearch == BisectionSearch)
         {
-            output =
-                m_errorModel->GetTbDecodificationStats(sinr,
-                                                       rbMap,
-                                                       CalculateTbSize(mcs, m_numSymForCqi),
-                                                       mcs,
-                                                       MmWaveErrorModel::MmWaveErrorModelHistory());
-            if (output->m_tbler > 0.1)
+            uint8_t high = maxMcs + 1;
+            while (firstFailing < high)
             {
-                break;
+                uint8_t mid = (firstFailing + high) / 2;
+                if (IsMcsDecodable(sinr, rbMap, mid))
+                {
+                    firstFailing = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
             }
-            mcs++;
         }
-
-        if (mcs > 0)
+        else
         {
-            mcs--;
+            while (firstFailing <= maxMcs && IsMcsDecodable(sinr, rbMap, firstFailing))
+            {
+                firstFailing++;
+            }
         }
 
-        if ((output->m_tbler > 0.1) && (mcs == 0))
+        mcs = firstFailing > 0 ? firstFailing - 1 : 0;
+
+        if ((firstFailing <= maxMcs) && (mcs == 0))
         {
             cqi = 0;
         }
@@ -304,6 +323,20 @@ MmWaveAmc::CreateCqiFeedbackWbTdma(const SpectrumValue& sinr, uint8_t& mcs) cons
     return cqi;
 }
 
+bool
+MmWaveAmc::IsMcsDecodable(const SpectrumValue& sinr,
+                          const std::vector<int>& rbMap,
+                          uint8_t mcs) const
+{
+    Ptr<MmWaveErrorModelOutput> output =
+        m_errorModel->GetTbDecodificationStats(sinr,
+                                               rbMap,
+                                               CalculateTbSize(mcs, m_numSymForCqi),
+                                               mcs,
+                                               MmWaveErrorModel::MmWaveErrorModelHistory());
+    return output->m_tbler <= m_targetTbler;
+}
+
 uint8_t
 MmWaveAmc::GetCqiFromSpectralEfficiency(double s) const
 {
@@ -354,6 +387,20 @@ MmWaveAmc::GetAmcModel() const
     return m_amcModel;
 }
 
+void
+MmWaveAmc::SetMcsSearch(MmWaveAmc::McsSearch search)
+{
+    NS_LOG_FUNCTION(this);
+    m_mcsSearch = search;
+}
+
+MmWaveAmc::McsSearch
+MmWaveAmc::GetMcsSearch() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_mcsSearch;
+}
+
 void
 MmWaveAmc::SetErrorModelType(const TypeId& type)
 {
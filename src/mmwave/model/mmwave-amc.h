@@ -117,6 +117,17 @@ class MmWaveAmc : public Object
         ErrorModel //!< Error Model version (can use different error models, see MmWaveErrorModel)
     };
 
+    /**
+     * \brief Strategies to search the highest MCS meeting the target TBLER
+     *
+     * \see CreateCqiFeedbackWbTdma
+     */
+    enum McsSearch
+    {
+        LinearSearch,   //!< Evaluate the MCSs in increasing order, until the first failure
+        BisectionSearch //!< Bisection over the MCSs, assuming the TBLER increases with the MCS
+    };
+
     /**
      * \brief Get the MCS value from a CQI value
      * \param cqi the CQI
@@ -168,6 +179,17 @@ class MmWaveAmc : public Object
      */
     AmcModel GetAmcModel() const;
 
+    /**
+     * \brief Set the strategy used to search the MCS with the ErrorModel AMC
+     * \param search the search strategy
+     */
+    void SetMcsSearch(McsSearch search);
+    /**
+     * \brief Get the strategy used to search the MCS with the ErrorModel AMC
+     * \return the search strategy
+     */
+    McsSearch GetMcsSearch() const;
+
     /**
      * \brief Set Error model type
      * \param type the Error model type
@@ -222,12 +244,23 @@ class MmWaveAmc : public Object
     uint32_t GetPayloadSize(uint8_t mcs, uint8_t nSym) const;
 
   private:
+    /**
+     * \brief Check if a TB with the given MCS meets the target TBLER
+     * \param sinr the sinr values
+     * \param rbMap the RBs used for the CQI reference resource
+     * \param mcs the MCS to evaluate
+     * \return true if the TBLER is not above the target
+     */
+    bool IsMcsDecodable(const SpectrumValue& sinr, const std::vector<int>& rbMap, uint8_t mcs) const;
+
     double m_ber;                       //!< The target BER. Used only by the ShannonModel AMC
     AmcModel m_amcModel;                //!< Type of the CQI feedback model
+    McsSearch m_mcsSearch;              //!< Search of the MCS with the ErrorModel AMC
     Ptr<MmWaveErrorModel> m_errorModel; //!< Pointer to an instance of ErrorModel
     TypeId m_errorModelType;            //!< Type of the error model
     MmWaveErrorModel::Mode m_emMode{MmWaveErrorModel::DL}; //!< Error model mode
     static const unsigned int m_crcLen = 24 / 8;           //!< CRC length (in bytes)
+    static constexpr double m_targetTbler = 0.1;           //!< Target TBLER for the ErrorModel AMC
     static const unsigned int m_numSymForCqi =
         12; //!< The number of PDSCH OFDM symbols to be used for CQI determination. See Sec. 5.2.2.5
             //!< of TS 38.214
@@ -36,8 +36,13 @@
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
 
+#ifdef HAVE_EIGEN3
+#include <Eigen/Dense>
+#endif
+
 #include <algorithm>
 #include <fstream>
+#include <numeric>
 
 namespace ns3
 {
@@ -203,12 +208,20 @@ MmWaveSvdBeamforming::GetTypeId()
                           "have very good reasons",
                           BooleanValue(true),
                           MakeBooleanAccessor(&MmWaveSvdBeamforming::m_useCache),
+                          MakeBooleanChecker())
+            .AddAttribute("WarmStart",
+                          "Start the power iterations from the BF vectors previously cached "
+                          "for the same device, instead of from the first row of the spatial "
+                          "correlation matrix. It has no effect if UseCache is false",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MmWaveSvdBeamforming::m_warmStart),
                           MakeBooleanChecker());
     return tid;
 }
 
 MmWaveSvdBeamforming::MmWaveSvdBeamforming()
-    : m_useCache{false}
+    : m_useCache{false},
+      m_warmStart{false}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -242,6 +255,7 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
     std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector> bfVectors;
 
     bool toCache{false};
+    auto prevBfVectors{m_cacheBfVectors.find(otherDevice)};
 
     if (m_useCache)
     {
@@ -274,9 +288,21 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
         }
         else
         {
-            bfVectors = ComputeBeamformingVectors(channelMatrix);
+            bool reverse = channelMatrix->IsReverse(m_antenna->GetId(), otherAntenna->GetId());
+
+            // the previous BF vectors, in the order used by ComputeBeamformingVectors
+            std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector> initial;
+            bool warmStart = m_warmStart && prevBfVectors != m_cacheBfVectors.end();
+            if (warmStart)
+            {
+                initial = reverse ? std::make_pair(std::get<1>(prevBfVectors->second),
+                                                   std::get<0>(prevBfVectors->second))
+                                  : prevBfVectors->second;
+            }
+
+            bfVectors = ComputeBeamformingVectors(channelMatrix, warmStart ? &initial : nullptr);
 
-            if (channelMatrix->IsReverse(m_antenna->GetId(), otherAntenna->GetId()))
+            if (reverse)
             {
                 // reverse BF vectors
                 bfVectors = std::make_pair(std::get<1>(bfVectors), std::get<0>(bfVectors));
@@ -298,87 +324,132 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
 
     if (toCache)
     {
-        auto entry{m_cacheChannelMap.find(otherDevice)};
-        if (entry != m_cacheChannelMap.end())
+        m_cacheChannelMap[otherDevice] = channelMatrix;
+        if (prevBfVectors != m_cacheBfVectors.end())
         {
-            entry->second = channelMatrix;
-            // this means there is also an entry for the bf vector
-            m_cacheBfVectors.find(otherDevice)->second = bfVectors;
+            prevBfVectors->second = bfVectors;
         }
         else
         {
-            m_cacheChannelMap.insert(std::make_pair(otherDevice, channelMatrix));
             m_cacheBfVectors.insert(std::make_pair(otherDevice, bfVectors));
         }
     }
 }
 
-std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>
-MmWaveSvdBeamforming::ComputeBeamformingVectors(
-    Ptr<const MatrixBasedChannelModel::ChannelMatrix> params) const
+/**
+ * Compute the narrowband channel, i.e., the sum of the pages of the channel matrix
+ * \param channel the channel matrix, with one page per cluster
+ * \return the narrowband channel
+ */
+static MatrixBasedChannelModel::Complex2DVector
+GetNarrowbandChannel(const MatrixBasedChannelModel::Complex3DVector& channel)
 {
-    // generate transmitter side spatial correlation matrix
-    uint16_t aSize = params->m_channel.GetNumRows();
-    uint16_t bSize = params->m_channel.GetNumCols();
-    uint16_t clusterSize = params->m_channel.GetNumPages();
-
-    // compute narrowband channel by summing over the cluster index
-    MatrixBasedChannelModel::Complex2DVector narrowbandChannel(aSize, bSize);
-
-    for (uint16_t aIndex = 0; aIndex < aSize; aIndex++)
+    size_t pageSize = channel.GetNumRows() * channel.GetNumCols();
+    MatrixBasedChannelModel::Complex2DVector res(channel.GetNumRows(), channel.GetNumCols());
+    std::complex<double>* out = res.GetPagePtr(0);
+    for (size_t page = 0; page < channel.GetNumPages(); page++)
     {
-        for (uint16_t bIndex = 0; bIndex < bSize; bIndex++)
+        const std::complex<double>* in = channel.GetPagePtr(page);
+        for (size_t i = 0; i < pageSize; i++)
         {
-            std::complex<double> cSum(0, 0);
-            for (uint16_t cIndex = 0; cIndex < clusterSize; cIndex++)
-            {
-                cSum += params->m_channel(aIndex, bIndex, cIndex);
-            }
-            narrowbandChannel(aIndex, bIndex) = cSum;
+            out[i] += in[i];
         }
     }
+    return res;
+}
 
-    // compute the transmitter side spatial correlation matrix bQ = H*H, where H is the sum of H_n
-    // over n clusters.
-    MatrixBasedChannelModel::Complex2DVector bQ(bSize, bSize);
-
-    for (uint16_t b1Index = 0; b1Index < bSize; b1Index++)
+/**
+ * Compute the spatial correlation matrices of both sides of a narrowband channel,
+ * i.e., aQ = HH* and bQ = conj(H^T H)
+ * \param h the narrowband channel H, with size aSize x bSize
+ * \param [out] aQ the aSize x aSize correlation matrix
+ * \param [out] bQ the bSize x bSize correlation matrix
+ */
+static void
+GetSpatialCorrelationMatrices(const MatrixBasedChannelModel::Complex2DVector& h,
+                              MatrixBasedChannelModel::Complex2DVector& aQ,
+                              MatrixBasedChannelModel::Complex2DVector& bQ)
+{
+    size_t aSize = h.GetNumRows();
+    size_t bSize = h.GetNumCols();
+    aQ = MatrixBasedChannelModel::Complex2DVector(aSize, aSize);
+    bQ = MatrixBasedChannelModel::Complex2DVector(bSize, bSize);
+
+#ifdef HAVE_EIGEN3
+    Eigen::Map<const Eigen::MatrixXcd> hMap(h.GetPagePtr(0), aSize, bSize);
+    Eigen::Map<Eigen::MatrixXcd> aQMap(aQ.GetPagePtr(0), aSize, aSize);
+    Eigen::Map<Eigen::MatrixXcd> bQMap(bQ.GetPagePtr(0), bSize, bSize);
+    aQMap.noalias() = hMap * hMap.adjoint();
+    bQMap.noalias() = (hMap.transpose() * hMap).conjugate();
+#else
+    // the matrices are stored by columns: every inner loop scans contiguous memory
+    const std::complex<double>* hPtr = h.GetPagePtr(0);
+    std::complex<double>* aQPtr = aQ.GetPagePtr(0);
+    std::complex<double>* bQPtr = bQ.GetPagePtr(0);
+    for (size_t b2 = 0; b2 < bSize; b2++)
     {
-        for (uint16_t b2Index = 0; b2Index < bSize; b2Index++)
+        const std::complex<double>* col2 = hPtr + b2 * aSize;
+        // bQ is symmetric, compute only its upper triangle
+        for (size_t b1 = 0; b1 <= b2; b1++)
         {
+            const std::complex<double>* col1 = hPtr + b1 * aSize;
             std::complex<double> aSum(0, 0);
-            for (uint16_t aIndex = 0; aIndex < aSize; aIndex++)
+            for (size_t a = 0; a < aSize; a++)
+            {
+                aSum += col1[a] * col2[a];
+            }
+            bQPtr[b1 + b2 * bSize] = std::conj(aSum);
+            bQPtr[b2 + b1 * bSize] = std::conj(aSum);
+        }
+        // add the contribution of the column b2 of H to aQ
+        for (size_t a2 = 0; a2 < aSize; a2++)
+        {
+            std::complex<double> c = std::conj(col2[a2]);
+            std::complex<double>* aQCol = aQPtr + a2 * aSize;
+            for (size_t a1 = 0; a1 < aSize; a1++)
             {
-                aSum += std::conj(narrowbandChannel(aIndex, b1Index) *
-                                  narrowbandChannel(aIndex, b2Index));
+                aQCol[a1] += col2[a1] * c;
             }
-            bQ(b1Index, b2Index) += aSum;
         }
     }
+#endif
+}
+
+std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>
+MmWaveSvdBeamforming::ComputeBeamformingVectors(
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
+    const std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>* initial)
+    const
+{
+    // compute narrowband channel by summing over the cluster index
+    MatrixBasedChannelModel::Complex2DVector narrowbandChannel =
+        GetNarrowbandChannel(params->m_channel);
 
-    // calculate beamforming vector from spatial correlation matrix
-    PhasedArrayModel::ComplexVector bW = GetFirstEigenvector(bQ);
+    // compute the transmitter side spatial correlation matrix bQ = H*H and the receiver side
+    // spatial correlation matrix aQ = HH*, where H is the sum of H_n over n clusters.
+    MatrixBasedChannelModel::Complex2DVector aQ;
+    MatrixBasedChannelModel::Complex2DVector bQ;
+    GetSpatialCorrelationMatrices(narrowbandChannel, aQ, bQ);
 
-    // compute the receiver side spatial correlation matrix aQ = HH*, where H is the sum of H_n over
-    // n clusters.
-    MatrixBasedChannelModel::Complex2DVector aQ(aSize, aSize);
+    // calculate beamforming vectors from spatial correlation matrices
+    PhasedArrayModel::ComplexVector bW =
+        GetFirstEigenvector(bQ, initial ? &std::get<0>(*initial) : nullptr);
 
-    for (uint16_t a1Index = 0; a1Index < aSize; a1Index++)
+    PhasedArrayModel::ComplexVector aW;
+    if (initial)
     {
-        for (uint16_t a2Index = 0; a2Index < aSize; a2Index++)
+        // the returned vector is conjugated
+        PhasedArrayModel::ComplexVector aInitial = std::get<1>(*initial);
+        for (size_t i = 0; i < aInitial.GetSize(); ++i)
         {
-            std::complex<double> bSum(0, 0);
-            for (uint16_t bIndex = 0; bIndex < bSize; bIndex++)
-            {
-                bSum += narrowbandChannel(a1Index, bIndex) *
-                        std::conj(narrowbandChannel(a2Index, bIndex));
-            }
-            aQ(a1Index, a2Index) += bSum;
+            aInitial[i] = std::conj(aInitial[i]);
         }
+        aW = GetFirstEigenvector(aQ, &aInitial);
+    }
+    else
+    {
+        aW = GetFirstEigenvector(aQ, nullptr);
     }
-
-    // calculate beamforming vector from spatial correlation matrix.
-    PhasedArrayModel::ComplexVector aW = GetFirstEigenvector(aQ);
 
     for (size_t i = 0; i < aW.GetSize(); ++i)
     {
@@ -389,50 +460,76 @@ MmWaveSvdBeamforming::ComputeBeamformingVectors(
 }
 
 PhasedArrayModel::ComplexVector
-MmWaveSvdBeamforming::GetFirstEigenvector(MatrixBasedChannelModel::Complex2DVector A) const
+MmWaveSvdBeamforming::GetFirstEigenvector(const MatrixBasedChannelModel::Complex2DVector& A,
+                                          const PhasedArrayModel::ComplexVector* initial) const
 {
-    uint16_t arraySize = A.GetNumCols();
+    size_t arraySize = A.GetNumCols();
     PhasedArrayModel::ComplexVector antennaWeights(arraySize);
+    PhasedArrayModel::ComplexVector antennaWeightsNew(arraySize);
 
-    for (uint16_t eIndex = 0; eIndex < arraySize; eIndex++)
+    bool warmStart = initial != nullptr && initial->GetSize() == arraySize;
+    if (warmStart)
     {
-        antennaWeights[eIndex] = A(0, eIndex);
+        antennaWeights = *initial;
+    }
+    else
+    {
+        for (size_t eIndex = 0; eIndex < arraySize; eIndex++)
+        {
+            antennaWeights[eIndex] = A(0, eIndex);
+        }
     }
 
     uint32_t iter = 0;
     double diff = 1;
     while (iter < m_maxIterations && diff > m_tolerance)
     {
-        PhasedArrayModel::ComplexVector antennaWeightsNew(arraySize);
-        unsigned int elemIdx = 0;
-
-        for (uint16_t row = 0; row < arraySize; row++)
+        const std::complex<double>* w = antennaWeights.GetPagePtr(0);
+        std::complex<double>* wNew = antennaWeightsNew.GetPagePtr(0);
+
+#ifdef HAVE_EIGEN3
+        Eigen::Map<const Eigen::MatrixXcd> aMap(A.GetPagePtr(0), arraySize, arraySize);
+        Eigen::Map<Eigen::VectorXcd>(wNew, arraySize).noalias() =
+            aMap * Eigen::Map<const Eigen::VectorXcd>(w, arraySize);
+#else
+        // A is stored by columns: accumulate wNew += A(:, col) * w[col]
+        const std::complex<double>* aCol = A.GetPagePtr(0);
+        std::fill(wNew, wNew + arraySize, std::complex<double>(0, 0));
+        for (size_t col = 0; col < arraySize; col++, aCol += arraySize)
         {
-            std::complex<double> sum(0, 0);
-            for (uint16_t col = 0; col < arraySize; col++)
+            for (size_t row = 0; row < arraySize; row++)
             {
-                sum += A(row, col) * antennaWeights[col];
+                wNew[row] += aCol[row] * w[col];
             }
-
-            antennaWeightsNew[elemIdx++] = sum;
         }
+#endif
+
         // normalize antennaWeights;
         double weighbSum = 0;
-        for (uint16_t i = 0; i < arraySize; i++)
+        for (size_t i = 0; i < arraySize; i++)
         {
-            weighbSum += norm(antennaWeightsNew[i]);
+            weighbSum += std::norm(wNew[i]);
         }
-        for (uint16_t i = 0; i < arraySize; i++)
+        if (weighbSum == 0 && warmStart)
         {
-            antennaWeightsNew[i] = antennaWeightsNew[i] / sqrt(weighbSum);
+            // the previous vector is orthogonal to the new channel, start again from A
+            NS_LOG_DEBUG("Warm start failed, using the first row of the correlation matrix");
+            warmStart = false;
+            for (size_t eIndex = 0; eIndex < arraySize; eIndex++)
+            {
+                antennaWeights[eIndex] = A(0, eIndex);
+            }
+            continue;
         }
+        double norm = std::sqrt(weighbSum);
         diff = 0;
-        for (uint16_t i = 0; i < arraySize; i++)
+        for (size_t i = 0; i < arraySize; i++)
         {
-            diff += std::norm(antennaWeightsNew[i] - antennaWeights[i]);
+            wNew[i] /= norm;
+            diff += std::norm(wNew[i] - w[i]);
         }
         iter++;
-        antennaWeights = antennaWeightsNew;
+        std::swap(antennaWeights, antennaWeightsNew);
     }
     NS_LOG_DEBUG("antennaWeigths stopped after " << iter << " iterations with diff=" << diff
                                                  << std::endl);
@@ -470,11 +567,39 @@ MmWaveCodebookBeamforming::GetTypeId()
                           "Specify the channel coherence time",
                           TimeValue(MilliSeconds(0.0)),
                           MakeTimeAccessor(&MmWaveCodebookBeamforming::m_updatePeriod),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("TrackingRadius",
+                          "When updating a beam pair, only the codewords within this distance "
+                          "from the previous ones are evaluated. The distance is the one "
+                          "between the indexes, or the largest of the row and column "
+                          "distances for codebooks with CodebookColumns set. "
+                          "If 0, all the codeword pairs are evaluated at every update",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MmWaveCodebookBeamforming::m_trackingRadius),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TrackingLossThreshold",
+                          "Loss (in dB) of the received power of the tracked beam pair, with "
+                          "respect to the one found by the last full sweep, which triggers a "
+                          "new full sweep",
+                          DoubleValue(3.0),
+                          MakeDoubleAccessor(&MmWaveCodebookBeamforming::m_trackingLossThreshold),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("FullSweepPeriod",
+                          "Maximum time between two full sweeps when tracking is enabled. "
+                          "If 0, full sweeps are triggered only by the loss of received power",
+                          TimeValue(MilliSeconds(0.0)),
+                          MakeTimeAccessor(&MmWaveCodebookBeamforming::m_fullSweepPeriod),
+                          MakeTimeChecker())
+            .AddTraceSource("BeamSearch",
+                            "Search of the beam pair for a device",
+                            MakeTraceSourceAccessor(&MmWaveCodebookBeamforming::m_beamSearchTrace),
+                            "ns3::MmWaveCodebookBeamforming::BeamSearchTracedCallback");
     return tid;
 }
 
 MmWaveCodebookBeamforming::MmWaveCodebookBeamforming()
+    : m_trackingRadius{0},
+      m_trackingLossThreshold{3.0}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -496,16 +621,9 @@ void
 MmWaveCodebookBeamforming::SetMmWavePhyMacCommon(Ptr<MmWavePhyMacCommon> mwpmc)
 {
     NS_LOG_FUNCTION(this << mwpmc);
-
-    std::vector<int> activeRbs;
-    for (uint32_t i = 0; i < mwpmc->GetNumRb(); i++)
-    {
-        activeRbs.push_back(i);
-    }
-    m_txPsd = MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity(
-        mwpmc,
-        0.0,
-        activeRbs); // TODO should i copy this?
+    // the PSD is created at the first beam search, see SetBeamformingVectorForDevice
+    m_phyMacConfig = mwpmc;
+    m_txPsd = nullptr;
 }
 
 void
@@ -516,18 +634,31 @@ MmWaveCodebookBeamforming::DoInitialize(void)
     NS_ASSERT_MSG(m_beamformingCodebookFactory.IsTypeIdSet(),
                   "The BeamformingCodebook factory is not initialized");
 
+    // the codebook is initialized, and thus imported, at the first beam search (see
+    // GetCodebook), so that installing many devices does not import the codebooks of the
+    // devices which never search a beam pair
     Ptr<BeamformingCodebook> cb = m_beamformingCodebookFactory.Create<BeamformingCodebook>();
     cb->SetAttribute("Array", PointerValue(m_antenna));
-    cb->Initialize();
-
-    NS_ASSERT_MSG(cb->GetCodebookSize() > 0, "Empty codebook");
-    NS_ASSERT_MSG(cb->GetCodeword(0).GetSize() == m_antenna->GetNumElems(),
-                  "Inappropriate codebook for the given PhasedArrayModel");
     m_antenna->AggregateObject(cb);
 
     // TODO what if SetAntenna is used?
 }
 
+Ptr<BeamformingCodebook>
+MmWaveCodebookBeamforming::GetCodebook(Ptr<PhasedArrayModel> antenna)
+{
+    Ptr<BeamformingCodebook> cb = antenna->GetObject<BeamformingCodebook>();
+    NS_ASSERT_MSG(cb, "No BeamformingCodebook aggregated to the antenna");
+    if (!cb->IsInitialized())
+    {
+        cb->Initialize();
+        NS_ASSERT_MSG(cb->GetCodebookSize() > 0, "Empty codebook");
+        NS_ASSERT_MSG(cb->GetCodeword(0).GetSize() == antenna->GetNumElems(),
+                      "Inappropriate codebook for the given PhasedArrayModel");
+    }
+    return cb;
+}
+
 void
 MmWaveCodebookBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
                                                          Ptr<PhasedArrayModel> otherAntenna)
@@ -562,32 +693,80 @@ MmWaveCodebookBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDev
 
     if (notFound || update)
     {
-        MmWaveCodebookBeamforming::Matrix2D powerMatrix =
-            ComputeBeamformingCodebookMatrix(otherDevice, otherAntenna);
+        if (!m_txPsd)
+        {
+            std::vector<int> activeRbs;
+            for (uint32_t i = 0; i < m_phyMacConfig->GetNumRb(); i++)
+            {
+                activeRbs.push_back(i);
+            }
+            m_txPsd =
+                MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity(m_phyMacConfig,
+                                                                        0.0,
+                                                                        activeRbs);
+        }
 
-        // find best beam couple
-        std::vector<double> maxPowers;
-        maxPowers.reserve(powerMatrix.size());
-        std::vector<uint32_t> argMaxPowers;
-        argMaxPowers.reserve(powerMatrix.size());
+        Ptr<BeamformingCodebook> thisCodebook = GetCodebook(m_antenna);
+        Ptr<BeamformingCodebook> otherCodebook = GetCodebook(otherAntenna);
+        uint32_t thisSize = thisCodebook->GetCodebookSize();
+        uint32_t otherSize = otherCodebook->GetCodebookSize();
 
-        for (uint32_t i = 0; i < powerMatrix.size(); i++)
+        uint32_t numEvaluations = 0;
+        bool fullSweep = notFound || m_trackingRadius == 0;
+        double power = 0;
+        if (!fullSweep)
         {
-            auto argMaxIt = std::max_element(powerMatrix[i].begin(), powerMatrix[i].end());
-            argMaxPowers.push_back(std::distance(powerMatrix[i].begin(), argMaxIt));
-            maxPowers.push_back(*argMaxIt);
+            // search the neighbourhood of the previous beam pair
+            std::vector<uint32_t> thisCandidates =
+                GetNeighbourhood(thisCodebook, thisCbIdx, m_trackingRadius);
+            std::vector<uint32_t> otherCandidates =
+                GetNeighbourhood(otherCodebook, otherCbIdx, m_trackingRadius);
+            power = SearchBeamPair(otherDevice,
+                                   otherAntenna,
+                                   thisCandidates,
+                                   otherCandidates,
+                                   thisCbIdx,
+                                   otherCbIdx);
+            numEvaluations += thisCandidates.size() * otherCandidates.size();
+
+            double lossDb = 10 * std::log10(it->second.sweepPower / power);
+            bool expired = !m_fullSweepPeriod.IsZero() &&
+                           Simulator::Now() - it->second.lastSweep >= m_fullSweepPeriod;
+            NS_LOG_DEBUG("Tracked beam pair: thisCbIdx=" << thisCbIdx << ", otherCbIdx="
+                                                         << otherCbIdx << " with loss " << lossDb
+                                                         << " dB, sweep expired? " << expired);
+            fullSweep = expired || !(lossDb <= m_trackingLossThreshold);
         }
 
-        auto argMaxIt = std::max_element(maxPowers.begin(), maxPowers.end());
-        thisCbIdx = std::distance(maxPowers.begin(), argMaxIt);
-        otherCbIdx = argMaxPowers[thisCbIdx];
+        Entry newEntry;
+        if (fullSweep)
+        {
+            std::vector<uint32_t> thisCandidates(thisSize);
+            std::iota(thisCandidates.begin(), thisCandidates.end(), 0);
+            std::vector<uint32_t> otherCandidates(otherSize);
+            std::iota(otherCandidates.begin(), otherCandidates.end(), 0);
+            power = SearchBeamPair(otherDevice,
+                                   otherAntenna,
+                                   thisCandidates,
+                                   otherCandidates,
+                                   thisCbIdx,
+                                   otherCbIdx);
+            numEvaluations += thisSize * otherSize;
+            newEntry.lastSweep = Simulator::Now();
+            newEntry.sweepPower = power;
+        }
+        else
+        {
+            newEntry.lastSweep = it->second.lastSweep;
+            newEntry.sweepPower = it->second.sweepPower;
+        }
 
         NS_LOG_DEBUG("Best beam pair: thisCbIdx=" << thisCbIdx << ", otherCbIdx=" << otherCbIdx
                                                   << " with power "
-                                                  << 10 * std::log10(*argMaxIt) + 30 << " dBm");
+                                                  << 10 * std::log10(power) + 30 << " dBm");
+        m_beamSearchTrace(fullSweep, numEvaluations);
 
         // insert the new entry in the map
-        Entry newEntry;
         newEntry.thisCbIdx = thisCbIdx;
         newEntry.otherCbIdx = otherCbIdx;
         newEntry.lastUpdate = Simulator::Now();
@@ -595,8 +774,8 @@ MmWaveCodebookBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDev
     }
 
     // set best BF codewords for both devices
-    Ptr<BeamformingCodebook> thisCodebook = m_antenna->GetObject<BeamformingCodebook>();
-    Ptr<BeamformingCodebook> otherCodebook = otherAntenna->GetObject<BeamformingCodebook>();
+    Ptr<BeamformingCodebook> thisCodebook = GetCodebook(m_antenna);
+    Ptr<BeamformingCodebook> otherCodebook = GetCodebook(otherAntenna);
 
     PhasedArrayModel::ComplexVector thisAntennaWeights = thisCodebook->GetCodeword(thisCbIdx);
     PhasedArrayModel::ComplexVector otherAntennaWeights = otherCodebook->GetCodeword(otherCbIdx);
@@ -605,12 +784,81 @@ MmWaveCodebookBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDev
     otherAntenna->SetBeamformingVector(otherAntennaWeights);
 }
 
+std::vector<uint32_t>
+MmWaveCodebookBeamforming::GetNeighbourhood(Ptr<BeamformingCodebook> codebook,
+                                            uint32_t idx,
+                                            uint32_t radius)
+{
+    uint32_t size = codebook->GetCodebookSize();
+    // a 1D codebook is a single row
+    uint32_t columns = codebook->GetCodebookColumns();
+    if (columns == 0)
+    {
+        columns = size;
+    }
+    uint32_t rows = (size + columns - 1) / columns;
+    uint32_t row = idx / columns;
+    uint32_t col = idx % columns;
+
+    std::vector<uint32_t> neighbourhood;
+    for (uint32_t r = row - std::min(row, radius); r < std::min(row + radius + 1, rows); r++)
+    {
+        for (uint32_t c = col - std::min(col, radius); c < std::min(col + radius + 1, columns);
+             c++)
+        {
+            uint32_t neighbour = r * columns + c;
+            if (neighbour < size) // the last row can be incomplete
+            {
+                neighbourhood.push_back(neighbour);
+            }
+        }
+    }
+    return neighbourhood;
+}
+
+double
+MmWaveCodebookBeamforming::SearchBeamPair(Ptr<NetDevice> otherDevice,
+                                          Ptr<PhasedArrayModel> otherAntenna,
+                                          const std::vector<uint32_t>& thisCandidates,
+                                          const std::vector<uint32_t>& otherCandidates,
+                                          uint32_t& thisCbIdx,
+                                          uint32_t& otherCbIdx) const
+{
+    MmWaveCodebookBeamforming::Matrix2D powerMatrix =
+        ComputeBeamformingCodebookMatrix(otherDevice,
+                                         otherAntenna,
+                                         thisCandidates,
+                                         otherCandidates);
+
+    // find best beam couple
+    std::vector<double> maxPowers;
+    maxPowers.reserve(powerMatrix.size());
+    std::vector<uint32_t> argMaxPowers;
+    argMaxPowers.reserve(powerMatrix.size());
+
+    for (uint32_t i = 0; i < powerMatrix.size(); i++)
+    {
+        auto argMaxIt = std::max_element(powerMatrix[i].begin(), powerMatrix[i].end());
+        argMaxPowers.push_back(std::distance(powerMatrix[i].begin(), argMaxIt));
+        maxPowers.push_back(*argMaxIt);
+    }
+
+    auto argMaxIt = std::max_element(maxPowers.begin(), maxPowers.end());
+    uint32_t thisOffset = std::distance(maxPowers.begin(), argMaxIt);
+    thisCbIdx = thisCandidates[thisOffset];
+    otherCbIdx = otherCandidates[argMaxPowers[thisOffset]];
+    return *argMaxIt;
+}
+
 MmWaveCodebookBeamforming::Matrix2D
 MmWaveCodebookBeamforming::ComputeBeamformingCodebookMatrix(
     Ptr<NetDevice> otherDevice,
-    Ptr<PhasedArrayModel> otherAntenna) const
+    Ptr<PhasedArrayModel> otherAntenna,
+    const std::vector<uint32_t>& thisCandidates,
+    const std::vector<uint32_t>& otherCandidates) const
 {
-    NS_LOG_FUNCTION(this << otherDevice << otherAntenna);
+    NS_LOG_FUNCTION(this << otherDevice << otherAntenna << thisCandidates.size()
+                         << otherCandidates.size());
 
     // check whether we are performing the initial configuration
     bool isInitialConf = m_codebookIdsCache.find(otherAntenna) == m_codebookIdsCache.end();
@@ -621,12 +869,14 @@ MmWaveCodebookBeamforming::ComputeBeamformingCodebookMatrix(
     Ptr<MobilityModel> thisMob = m_device->GetNode()->GetObject<MobilityModel>();
     Ptr<MobilityModel> otherMob = otherDevice->GetNode()->GetObject<MobilityModel>();
 
+    NS_ASSERT(!thisCandidates.empty() && !otherCandidates.empty());
+
     // init matrix
     MmWaveCodebookBeamforming::Matrix2D matrix{};
-    matrix.resize(thisCodebook->GetCodebookSize());
-    for (uint64_t i = 0; i < thisCodebook->GetCodebookSize(); i++)
+    matrix.resize(thisCandidates.size());
+    for (uint64_t i = 0; i < thisCandidates.size(); i++)
     {
-        matrix[i].reserve(otherCodebook->GetCodebookSize());
+        matrix[i].reserve(otherCandidates.size());
     }
 
     // save pre-existing bf vectors
@@ -639,11 +889,11 @@ MmWaveCodebookBeamforming::ComputeBeamformingCodebookMatrix(
     }
 
     // fill matrix
-    for (uint32_t thisIdx = 0; thisIdx < thisCodebook->GetCodebookSize(); thisIdx++)
+    for (uint32_t i = 0; i < thisCandidates.size(); i++)
     {
-        m_antenna->SetBeamformingVector(thisCodebook->GetCodeword(thisIdx));
+        m_antenna->SetBeamformingVector(thisCodebook->GetCodeword(thisCandidates[i]));
 
-        for (uint32_t otherIdx = 0; otherIdx < otherCodebook->GetCodebookSize(); otherIdx++)
+        for (uint32_t otherIdx : otherCandidates)
         {
             otherAntenna->SetBeamformingVector(otherCodebook->GetCodeword(otherIdx));
             double avgRxPsd = 0;          
@@ -668,7 +918,7 @@ MmWaveCodebookBeamforming::ComputeBeamformingCodebookMatrix(
                 avgRxPsd = Sum(*rxPsd) / (rxPsd->GetSpectrumModel()->GetNumBands());
             }
 
-            matrix[thisIdx].push_back(avgRxPsd);
+            matrix[i].push_back(avgRxPsd);
         }
     }
     NS_LOG_DEBUG("Matrix of size " << matrix.size() << "x" << matrix[0].size());
@@ -27,6 +27,7 @@
 #include "ns3/simulator.h"
 #include "ns3/spectrum-propagation-loss-model.h"
 #include "ns3/spectrum-value.h"
+#include "ns3/traced-callback.h"
 
 #include <map>
 
@@ -180,18 +181,27 @@ class MmWaveSvdBeamforming : public MmWaveBeamformingModel
     /**
      * Compute the beamforming vectors using SVD
      * \param params the channel matrix
+     * \param initial if not null, the previous beamforming vectors for the same pair of
+     *        devices, in the same order as the returned ones, used to initialize the
+     *        power iterations
      * \return a pair with the beamforming vectors
      */
     std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>
-    ComputeBeamformingVectors(Ptr<const MatrixBasedChannelModel::ChannelMatrix> params) const;
+    ComputeBeamformingVectors(
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
+        const std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>*
+            initial) const;
 
     /**
      * Compute eigenvector related to highest eigenvalue
      * \param A spatial correlation matrix (complex, hermitian)
+     * \param initial if not null, the starting point of the power iterations,
+     *        otherwise the first row of A is used
      * \return eigenvector
      */
     PhasedArrayModel::ComplexVector GetFirstEigenvector(
-        MatrixBasedChannelModel::Complex2DVector A) const;
+        const MatrixBasedChannelModel::Complex2DVector& A,
+        const PhasedArrayModel::ComplexVector* initial) const;
 
     Ptr<MatrixBasedChannelModel> m_channel; //!< pointer to the MatrixChannel, to retrieve the
                                             //!< matrix on which the SVD should be computed
@@ -206,6 +216,8 @@ class MmWaveSvdBeamforming : public MmWaveBeamformingModel
     double m_tolerance;       //!< Tolerance to numerically approximate the SVD decomposition
     bool m_useCache; //!< Cache the channel matrix whenever possible. NOTE: the SVD decomposition
                      //!< can be extremely computationally expensive, caching is suggested.
+    bool m_warmStart; //!< Start the power iterations from the cached BF vectors of the same
+                      //!< pair of devices
 };
 
 /**
@@ -263,18 +275,75 @@ class MmWaveCodebookBeamforming : public MmWaveBeamformingModel
     void SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
                                        Ptr<PhasedArrayModel> otherAntenna) override;
 
+    /**
+     * TracedCallback signature for the beam pair searches
+     * \param [in] fullSweep true if all the codeword pairs were evaluated, false if only the
+     *              neighbourhood of the previous beam pair was evaluated
+     * \param [in] numEvaluations the number of codeword pairs evaluated
+     */
+    typedef void (*BeamSearchTracedCallback)(bool fullSweep, uint32_t numEvaluations);
+
+    /**
+     * Get the codewords within a distance from a codeword. For the codebooks with
+     * BeamformingCodebook::GetCodebookColumns, the distance is the largest of the row and
+     * column distances in the grid of beam directions, otherwise the distance between the
+     * indexes.
+     * \param codebook the codebook
+     * \param idx the index of the codeword
+     * \param radius the distance
+     * \return the indexes of the codewords, in increasing order
+     */
+    static std::vector<uint32_t> GetNeighbourhood(Ptr<BeamformingCodebook> codebook,
+                                                  uint32_t idx,
+                                                  uint32_t radius);
+
   private:
     using Matrix2D = std::vector<std::vector<double>>;
     /**
-     *
+     * Compute the average received power for a set of codeword pairs
+     * \param otherDevice the target device
+     * \param otherAntenna the target antenna of otherDevice
+     * \param thisCandidates the codewords of this antenna
+     * \param otherCandidates the codewords of the other antenna
+     * \return the matrix of the received powers, indexed by the positions of the codewords
+     *         in thisCandidates and otherCandidates
      */
-    Matrix2D ComputeBeamformingCodebookMatrix(Ptr<NetDevice> otherDevice,
-                                              Ptr<PhasedArrayModel> otherAntenna) const;
+    Matrix2D ComputeBeamformingCodebookMatrix(
+        Ptr<NetDevice> otherDevice,
+        Ptr<PhasedArrayModel> otherAntenna,
+        const std::vector<uint32_t>& thisCandidates,
+        const std::vector<uint32_t>& otherCandidates) const;
+
+    /**
+     * Get the codebook aggregated to an antenna, initializing it if it is used for the
+     * first time
+     * \param antenna the antenna
+     * \return the codebook
+     */
+    static Ptr<BeamformingCodebook> GetCodebook(Ptr<PhasedArrayModel> antenna);
+
+    /**
+     * Find the best beam pair in a set of codeword pairs
+     * \param otherDevice the target device
+     * \param otherAntenna the target antenna of otherDevice
+     * \param thisCandidates the codewords of this antenna
+     * \param otherCandidates the codewords of the other antenna
+     * \param [out] thisCbIdx the selected codeword of this antenna
+     * \param [out] otherCbIdx the selected codeword of the other antenna
+     * \return the average received power of the selected pair
+     */
+    double SearchBeamPair(Ptr<NetDevice> otherDevice,
+                          Ptr<PhasedArrayModel> otherAntenna,
+                          const std::vector<uint32_t>& thisCandidates,
+                          const std::vector<uint32_t>& otherCandidates,
+                          uint32_t& thisCbIdx,
+                          uint32_t& otherCbIdx) const;
 
     ObjectFactory m_beamformingCodebookFactory;
     Ptr<SpectrumPropagationLossModel> m_splm;             //!<
     Ptr<PhasedArraySpectrumPropagationLossModel> m_pSplm; //!<
-    Ptr<SpectrumValue> m_txPsd;
+    Ptr<MmWavePhyMacCommon> m_phyMacConfig; //!< configuration used to create m_txPsd
+    Ptr<SpectrumValue> m_txPsd;             //!< tx PSD used in the beam search, created lazily
 
     /* struct used to store the selected beam pairs */
     struct Entry
@@ -282,10 +351,17 @@ class MmWaveCodebookBeamforming : public MmWaveBeamformingModel
         uint32_t thisCbIdx;  //!< index of the codeword for this antenna
         uint32_t otherCbIdx; //!< index of the codeword for the other antenna
         Time lastUpdate;     //!< time stamp
+        Time lastSweep;      //!< time stamp of the last full sweep
+        double sweepPower;   //!< received power of the pair selected by the last full sweep
     };
 
     std::map<Ptr<PhasedArrayModel>, Entry> m_codebookIdsCache; //!< stores the selected beam pairs
     Time m_updatePeriod; //!< defines the refresh period for updating the beam pairs
+    uint32_t m_trackingRadius; //!< codewords searched around the previous ones, 0 to disable
+    double m_trackingLossThreshold; //!< gain loss (dB) w.r.t. the last sweep forcing a new sweep
+    Time m_fullSweepPeriod;         //!< maximum time between two full sweeps when tracking
+
+    TracedCallback<bool, uint32_t> m_beamSearchTrace; //!< trace of the beam pair searches
 };
 
 } // namespace mmwave
@@ -52,6 +52,8 @@
 #include <ns3/pointer.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/simulator.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+#include <ns3/warnings.h>
 
 #include <algorithm>
 #include <array>
@@ -86,6 +88,8 @@ MmWaveEnbPhy::MmWaveEnbPhy(Ptr<MmWaveSpectrumPhy> dlPhy, Ptr<MmWaveSpectrumPhy>
 {
     m_enbCphySapProvider = new MemberLteEnbCphySapProvider<MmWaveEnbPhy>(this);
     m_roundFromLastUeSinrUpdate = 0;
+    m_incrementalSinrEstimate = false;
+    m_sinrEstimateMaxPathLoss = 0;
     Simulator::ScheduleNow(&MmWaveEnbPhy::StartSlot, this);
 }
 
@@ -122,6 +126,19 @@ MmWaveEnbPhy::GetTypeId(void)
                           DoubleValue(25.6),
                           MakeDoubleAccessor(&MmWaveEnbPhy::m_ueUpdateSinrPeriod),
                           MakeDoubleChecker<double>())
+            .AddAttribute("IncrementalSinrEstimate",
+                          "If true, the periodic SINR estimate of the attached UEs only recomputes "
+                          "the received PSD of the UEs whose position, TX power or channel "
+                          "changed since the last estimate",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MmWaveEnbPhy::m_incrementalSinrEstimate),
+                          MakeBooleanChecker())
+            .AddAttribute("SinrEstimateMaxPathLoss",
+                          "Path loss (in dB) beyond which the SINR of a UE is not estimated, "
+                          "but set to a negligible value. 0 to always estimate it",
+                          DoubleValue(0),
+                          MakeDoubleAccessor(&MmWaveEnbPhy::m_sinrEstimateMaxPathLoss),
+                          MakeDoubleChecker<double>(0))
             .AddAttribute("Transient",
                           "Transient period (in microseconds) in which just collect SINR values "
                           "without filtering the sample",
@@ -201,7 +218,7 @@ MmWaveEnbPhy::DoInitialize(void)
     {
         NS_ASSERT_MSG(
             (double)m_transient / m_updateSinrPeriod >= 16,
-            "Window too small to compute the variance according to the ApplyFilter method");
+            "Window too small to compute the variance according to the UpdateSinrFilter method");
     }
     Simulator::Schedule(MicroSeconds(0), &MmWaveEnbPhy::UpdateUeSinrEstimate, this);
     MmWavePhy::DoInitialize();
@@ -210,9 +227,34 @@ MmWaveEnbPhy::DoInitialize(void)
 void
 MmWaveEnbPhy::DoDispose(void)
 {
+    m_ueRxPsdEstimates.clear();
+    m_sinrFilterStates.clear();
 }
 
-// TODO remove these methods
+double
+MmWaveEnbPhy::AddGaussianNoise(double LastSinrValue)
+{
+    double N0 = 3.98107170e-12;
+    std::complex<double> gaussianNoise;
+    double signalEnergy;
+    double noisySample;
+
+    Ptr<NormalRandomVariable> randomVariable = CreateObject<NormalRandomVariable>();
+    double gaussianSampleRe = randomVariable->GetValue();
+    double gaussianSampleIm = randomVariable->GetValue();
+    gaussianNoise = std::complex<double>(sqrt(0.5) * sqrt(N0) * gaussianSampleRe,
+                                         sqrt(0.5) * sqrt(N0) * gaussianSampleIm);
+
+    signalEnergy = LastSinrValue * N0;
+
+    noisySample = (std::pow(std::abs(sqrt(signalEnergy) + gaussianNoise), 2) - N0) / N0;
+
+    return noisySample;
+}
+
+// the deprecated methods call each other
+NS_WARNING_PUSH_DEPRECATED;
+
 // Function for average
 double
 MmWaveEnbPhy::MakeAvg(std::vector<double> v)
@@ -250,26 +292,6 @@ MmWaveEnbPhy::MakeVar(std::vector<double> v, double mean)
 
 //****************End of variance funtion****************
 
-double
-MmWaveEnbPhy::AddGaussianNoise(double LastSinrValue)
-{
-    double N0 = 3.98107170e-12;
-    std::complex<double> gaussianNoise;
-    double signalEnergy;
-    double noisySample;
-
-    Ptr<NormalRandomVariable> randomVariable = CreateObject<NormalRandomVariable>();
-    double gaussianSampleRe = randomVariable->GetValue();
-    double gaussianSampleIm = randomVariable->GetValue();
-    gaussianNoise = std::complex<double>(sqrt(0.5) * sqrt(N0) * gaussianSampleRe,
-                                         sqrt(0.5) * sqrt(N0) * gaussianSampleIm);
-
-    signalEnergy = LastSinrValue * N0;
-
-    noisySample = (std::pow(std::abs(sqrt(signalEnergy) + gaussianNoise), 2) - N0) / N0;
-
-    return noisySample;
-}
 
 std::pair<uint64_t, uint64_t>
 MmWaveEnbPhy::ApplyFilter(std::vector<double> noisySinr)
@@ -511,6 +533,179 @@ MmWaveEnbPhy::MakeFilter(std::vector<double> noisySinr,
                        // where applied.
 }
 
+NS_WARNING_POP;
+
+void
+MmWaveEnbPhy::SinrWindow::Push(double sample)
+{
+    if (m_capacity == 0 || m_samples.size() < m_capacity)
+    {
+        m_samples.push_back(sample);
+    }
+    else
+    {
+        m_samples[m_oldest] = sample;
+        m_oldest = (m_oldest + 1) % m_capacity;
+    }
+}
+
+void
+MmWaveEnbPhy::SinrWindow::SetCapacity(std::size_t capacity)
+{
+    NS_ASSERT_MSG(m_capacity == 0, "The length of the window is already fixed");
+    NS_ASSERT_MSG(capacity >= m_samples.size(), "The window is longer than the new capacity");
+    m_capacity = capacity;
+    m_samples.reserve(capacity);
+}
+
+std::size_t
+MmWaveEnbPhy::SinrWindow::GetCapacity() const
+{
+    return m_capacity;
+}
+
+std::size_t
+MmWaveEnbPhy::SinrWindow::GetSize() const
+{
+    return m_samples.size();
+}
+
+bool
+MmWaveEnbPhy::SinrWindow::IsFull() const
+{
+    return m_capacity != 0 && m_samples.size() == m_capacity;
+}
+
+double
+MmWaveEnbPhy::SinrWindow::At(std::size_t i) const
+{
+    NS_ASSERT(i < m_samples.size());
+    std::size_t index = m_oldest + i;
+    return m_samples[index < m_samples.size() ? index : index - m_samples.size()];
+}
+
+double
+MmWaveEnbPhy::UpdateSinrFilter(SinrFilterState& state,
+                               double sinr,
+                               double sinrNoisy,
+                               bool afterTransient)
+{
+    // the filter looks for at least numberOfVarWindow samples out of the blockage
+    const uint32_t numberOfVarWindow = 16;
+
+    if (afterTransient && state.m_noisySinr.GetCapacity() == 0)
+    {
+        // the windows collected during the transient slide from now on. The windows of the pairs
+        // created at the end of the transient keep growing until they can hold a blockage end
+        std::size_t capacity =
+            std::max<std::size_t>(state.m_noisySinr.GetSize(), numberOfVarWindow + 2);
+        state.m_realSinr.SetCapacity(capacity);
+        state.m_noisySinr.SetCapacity(capacity);
+    }
+
+    state.m_realSinr.Push(sinr);
+    double sinrNoisyDb = 10 * std::log10(sinrNoisy);
+
+    // the filter can start at the current sample if the previous ones end a low variance or a
+    // high SINR run
+    if (state.m_numSamples > 0 && (state.m_lowVarianceRun >= numberOfVarWindow - 1 ||
+                                   state.m_highSinrRun >= numberOfVarWindow))
+    {
+        state.m_hasFilterStart = true;
+        state.m_filterStart = state.m_numSamples;
+    }
+
+    // variance of the last two noisy samples (dB)
+    bool highVariance = false;
+    if (state.m_numSamples > 0)
+    {
+        double meanValue = (state.m_lastNoisySinrDb + sinrNoisyDb) / 2;
+        double varValue = (std::pow(state.m_lastNoisySinrDb - meanValue, 2) +
+                           std::pow(sinrNoisyDb - meanValue, 2)) /
+                          2;
+        highVariance = varValue > 5 || std::isnan(varValue);
+        state.m_lowVarianceRun = varValue < 1 ? state.m_lowVarianceRun + 1 : 0;
+    }
+    state.m_highSinrRun = sinrNoisyDb > 10 ? state.m_highSinrRun + 1 : 0;
+
+    state.m_noisySinr.Push(sinrNoisy);
+    state.m_lastNoisySinrDb = sinrNoisyDb;
+    state.m_numSamples++;
+
+    // apply filter only when I have a sufficiently large set of SINR samples, and only where the
+    // SINR is too low and we are in a blockage situation
+    double sampleToForward = sinrNoisy;
+    bool blockage = highVariance || sinrNoisy < 10; // filter is applied only for low-SINR regimes
+    if (afterTransient && state.m_noisySinr.IsFull() && blockage)
+    {
+        std::size_t windowSize = state.m_noisySinr.GetSize();
+        uint64_t oldestSample = state.m_numSamples - windowSize;
+        std::size_t start = 0; // filter from the beginning of the window
+        if (state.m_hasFilterStart && state.m_filterStart > oldestSample + numberOfVarWindow)
+        {
+            start = state.m_filterStart - oldestSample;
+        }
+        NS_LOG_DEBUG("Filter the noisy SINR from sample " << start << " of " << windowSize);
+
+        // the last filtered sample refers to the sample before the current one, which is the
+        // last noisy sample if the blockage has just started
+        if (start == windowSize - 2)
+        {
+            sampleToForward = state.m_noisySinr.At(start);
+        }
+        else if (start < windowSize - 2)
+        {
+            sampleToForward = CalcFilteredSinr(state, start);
+        }
+    }
+
+    if (sampleToForward < 0) // this would be converted in NaN, in the log scale
+    {
+        sampleToForward = 1e-20;
+    }
+    return sampleToForward;
+}
+
+double
+MmWaveEnbPhy::CalcFilteredSinr(const SinrFilterState& state, std::size_t start)
+{
+    std::size_t end = state.m_noisySinr.GetSize() - 1;
+    NS_ASSERT(start + 1 < end);
+
+    /* find best alpha parameter for the Kalman estimation */
+    int rep = 0;
+    std::array<double, 100> meanError;
+    for (double alpha = 0; alpha < 1; alpha = alpha + 0.01)
+    {
+        double x = 0; // initialization of the estimate
+        double errorSum = 0.0;
+        for (std::size_t i = start; i < end; i++)
+        {
+            x = (1 - alpha) * x + alpha * state.m_noisySinr.At(i);
+            errorSum += std::abs(x - state.m_realSinr.At(i));
+        }
+        meanError.at(rep) = errorSum / (end - start);
+        rep++;
+    }
+
+    int posMinAlpha =
+        std::distance(meanError.begin(), std::min_element(meanError.begin(), meanError.end()));
+    double minAlpha = (posMinAlpha + 1) * 0.01;
+    if (minAlpha > 0.5)
+    {
+        minAlpha = 0.2;
+    }
+    NS_LOG_DEBUG("Filter with alpha " << minAlpha);
+
+    // the filtered trace lags the noisy one by one sample
+    double blockageSinr = 0;
+    for (std::size_t i = start; i + 1 < end; i++)
+    {
+        blockageSinr = (1 - minAlpha) * blockageSinr + minAlpha * state.m_noisySinr.At(i);
+    }
+    return blockageSinr;
+}
+
 void
 MmWaveEnbPhy::SetMmWaveEnbCphySapUser(LteEnbCphySapUser* s)
 {
@@ -580,6 +775,116 @@ MmWaveEnbPhy::GetUlSpectrumPhy() const
     return m_uplinkSpectrumPhy;
 }
 
+Ptr<MmWaveUePhy>
+MmWaveEnbPhy::GetUePhy(Ptr<NetDevice> ueDevice) const
+{
+    // distinguish between MC and MmWaveNetDevice
+    Ptr<mmwave::MmWaveUeNetDevice> ueNetDevice = DynamicCast<mmwave::MmWaveUeNetDevice>(ueDevice);
+    if (ueNetDevice)
+    {
+        return ueNetDevice->GetPhy();
+    }
+    Ptr<McUeNetDevice> mcUeDev = DynamicCast<McUeNetDevice>(ueDevice);
+    if (mcUeDev) // it may be a MC device
+    {
+        return mcUeDev->GetMmWavePhy();
+    }
+    NS_FATAL_ERROR("Unrecognized device");
+    return nullptr;
+}
+
+Ptr<SpectrumValue>
+MmWaveEnbPhy::CalcUeRxPsd(Ptr<NetDevice> ueDevice,
+                          Ptr<MmWaveUePhy> uePhy,
+                          Ptr<const SpectrumValue> txPsd,
+                          double propagationGainDb)
+{
+    NS_LOG_FUNCTION(this << ueDevice << propagationGainDb);
+
+    Ptr<MobilityModel> enbMob = m_netDevice->GetNode()->GetObject<MobilityModel>();
+    Ptr<MobilityModel> ueMob = ueDevice->GetNode()->GetObject<MobilityModel>();
+
+    // adjuts beamforming of antenna model wrt user
+    m_downlinkSpectrumPhy->ConfigureBeamforming(ueDevice);
+    uePhy->GetDlSpectrumPhy()->ConfigureBeamforming(m_netDevice);
+    // Dl, since the Ul is not actually used (TDD device)
+    double pathLossDb = -propagationGainDb;
+    NS_LOG_DEBUG("Total pathLoss = " << pathLossDb << " dB");
+
+    double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
+    Ptr<SpectrumValue> rxPsd = txPsd->Copy();
+    *(rxPsd) *= pathGainLinear;
+
+    // Not actually used for the gain, but needed for the call to CalcRxPowerSpectralDensity
+    // anyway
+    Ptr<PhasedArrayModel> rxPam = DynamicCast<PhasedArrayModel>(GetDlSpectrumPhy()->GetAntenna());
+    Ptr<PhasedArrayModel> txPam =
+        DynamicCast<PhasedArrayModel>(uePhy->GetDlSpectrumPhy()->GetAntenna());
+
+    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
+    rxParams->psd = rxPsd->Copy();
+
+    if (m_spectrumPropagationLossModel)
+    {
+        rxPsd = m_spectrumPropagationLossModel->CalcRxPowerSpectralDensity(rxParams, ueMob, enbMob);
+    }
+    else if (m_phasedArraySpectrumPropagationLossModel)
+    {
+        rxParams = m_phasedArraySpectrumPropagationLossModel->CalcRxPowerSpectralDensity(rxParams,
+                                                                                      ueMob,
+                                                                                      enbMob,
+                                                                                      txPam,
+                                                                                      rxPam);
+        rxPsd = rxParams->psd;
+    }
+
+    NS_LOG_LOGIC("RxPsd " << *rxPsd);
+    return rxPsd;
+}
+
+void
+MmWaveEnbPhy::RestoreUeBeamforming(Ptr<NetDevice> ueDevice, Ptr<MmWaveUePhy> uePhy)
+{
+    NS_LOG_FUNCTION(this << ueDevice);
+
+    // set back the bf vector to the main eNB
+    Ptr<NetDevice> targetEnb;
+    Ptr<mmwave::MmWaveUeNetDevice> ueNetDevice = DynamicCast<mmwave::MmWaveUeNetDevice>(ueDevice);
+    Ptr<McUeNetDevice> mcUeDev = DynamicCast<McUeNetDevice>(ueDevice);
+    if (ueNetDevice)
+    {
+        targetEnb = ueNetDevice->GetTargetEnb();
+    }
+    else if (mcUeDev) // it may be a MC device
+    {
+        targetEnb = mcUeDev->GetMmWaveTargetEnb();
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unrecognized device");
+    }
+
+    // target not set yet
+    if (targetEnb && targetEnb != m_netDevice)
+    {
+        uePhy->GetDlSpectrumPhy()->ConfigureBeamforming(targetEnb);
+    }
+}
+
+Ptr<const MatrixBasedChannelModel::ChannelParams>
+MmWaveEnbPhy::GetUeChannelParams(Ptr<const MobilityModel> ueMob,
+                                 Ptr<const MobilityModel> enbMob) const
+{
+    Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(
+            m_phasedArraySpectrumPropagationLossModel);
+    if (!threeGppSplm || !threeGppSplm->GetChannelModel())
+    {
+        return nullptr;
+    }
+    return threeGppSplm->GetChannelModel()->GetParams(ueMob, enbMob);
+}
+
 void
 MmWaveEnbPhy::UpdateUeSinrEstimate()
 {
@@ -593,299 +898,127 @@ MmWaveEnbPhy::UpdateUeSinrEstimate()
     Ptr<SpectrumValue> totalReceivedPsd =
         Create<SpectrumValue>(SpectrumValue(noisePsd->GetSpectrumModel()));
 
+    // get this node mobility
+    Ptr<MobilityModel> enbMob = m_netDevice->GetNode()->GetObject<MobilityModel>();
+    NS_LOG_LOGIC("eNB mobility " << enbMob->GetPosition());
+
+    // UEs whose beam was steered toward this eNB, to be pointed back to their target eNB
+    std::vector<std::pair<Ptr<NetDevice>, Ptr<MmWaveUePhy>>> steeredUes;
+
     for (std::map<uint64_t, Ptr<NetDevice>>::iterator ue = m_ueAttachedImsiMap.begin();
          ue != m_ueAttachedImsiMap.end();
          ++ue)
     {
-        // distinguish between MC and MmWaveNetDevice
-        Ptr<mmwave::MmWaveUeNetDevice> ueNetDevice =
-            DynamicCast<mmwave::MmWaveUeNetDevice>(ue->second);
-        Ptr<McUeNetDevice> mcUeDev = DynamicCast<McUeNetDevice>(ue->second);
-        Ptr<MmWaveUePhy> uePhy;
+        Ptr<MmWaveUePhy> uePhy = GetUePhy(ue->second);
         // get tx power
-        double ueTxPower = 0;
-        if (ueNetDevice)
-        {
-            uePhy = ueNetDevice->GetPhy();
-            ueTxPower = uePhy->GetTxPower();
-        }
-        else if (mcUeDev) // it may be a MC device
-        {
-            uePhy = mcUeDev->GetMmWavePhy();
-            ueTxPower = uePhy->GetTxPower();
-        }
-        else
-        {
-            NS_FATAL_ERROR("Unrecognized device");
-        }
+        double ueTxPower = uePhy->GetTxPower();
         NS_LOG_LOGIC("UE Tx power = " << ueTxPower);
-        double powerTxW = std::pow(10., (ueTxPower - 30) / 10);
-        double txPowerDensity = 0;
-        txPowerDensity = (powerTxW / (m_phyMacConfig->GetBandwidth()));
-        NS_LOG_LOGIC("Linear UE Tx power = " << powerTxW);
-        NS_LOG_LOGIC("System bandwidth = " << m_phyMacConfig->GetBandwidth());
-        NS_LOG_LOGIC("txPowerDensity = " << txPowerDensity);
-        // create tx psd
-        Ptr<SpectrumValue> txPsd = // it is the eNB that dictates the conf, m_listOfSubchannels
-                                   // contains all the subch
-            MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity(m_phyMacConfig,
-                                                                    ueTxPower,
-                                                                    m_listOfSubchannels);
-        NS_LOG_LOGIC("TxPsd " << *txPsd);
-
-        // get this node and remote node mobility
-        Ptr<MobilityModel> enbMob = m_netDevice->GetNode()->GetObject<MobilityModel>();
-        NS_LOG_LOGIC("eNB mobility " << enbMob->GetPosition());
+
+        // get remote node mobility
         Ptr<MobilityModel> ueMob = ue->second->GetNode()->GetObject<MobilityModel>();
         NS_LOG_DEBUG("UE mobility " << ueMob->GetPosition());
 
-        // compute rx psd
+        // in incremental mode, reuse the last estimate if the link has not changed since then
+        Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams;
+        if (m_incrementalSinrEstimate)
+        {
+            channelParams = GetUeChannelParams(ueMob, enbMob);
+            auto estimate = m_ueRxPsdEstimates.find(ue->first);
+            if (channelParams && estimate != m_ueRxPsdEstimates.end() &&
+                estimate->second.m_channelParams == channelParams &&
+                estimate->second.m_ueTxPower == ueTxPower &&
+                estimate->second.m_uePosition == ueMob->GetPosition() &&
+                estimate->second.m_enbPosition == enbMob->GetPosition())
+            {
+                NS_LOG_LOGIC("Reuse the RX PSD estimated for UE " << ue->first);
+                m_rxPsdMap[ue->first] = estimate->second.m_rxPsd;
+                if (estimate->second.m_rxPsd)
+                {
+                    *totalReceivedPsd += *(estimate->second.m_rxPsd);
+                }
+                continue;
+            }
+        }
 
-        // adjuts beamforming of antenna model wrt user
-        m_downlinkSpectrumPhy->ConfigureBeamforming(ue->second);
-        uePhy->GetDlSpectrumPhy()->ConfigureBeamforming(m_netDevice);
-        // Dl, since the Ul is not actually used (TDD device)
-        double pathLossDb = 0;
+        double propagationGainDb = 0;
         if (m_propagationLoss)
         {
-            double propagationGainDb = m_propagationLoss->CalcRxPower(0, ueMob, enbMob);
+            propagationGainDb = m_propagationLoss->CalcRxPower(0, ueMob, enbMob);
             NS_LOG_LOGIC("propagationGainDb = " << propagationGainDb << " dB");
-            pathLossDb -= propagationGainDb;
         }
 
-        NS_LOG_DEBUG("Total pathLoss = " << pathLossDb << " dB");
-
-        double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-        Ptr<SpectrumValue> rxPsd = txPsd->Copy();
-        *(rxPsd) *= pathGainLinear;
-
-        // Not actually used for the gain, but needed for the call to CalcRxPowerSpectralDensity
-        // anyway
-        Ptr<PhasedArrayModel> rxPam =
-            DynamicCast<PhasedArrayModel>(GetDlSpectrumPhy()->GetAntenna());
-        Ptr<PhasedArrayModel> txPam =
-            DynamicCast<PhasedArrayModel>(uePhy->GetDlSpectrumPhy()->GetAntenna());
-
-        Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
-        rxParams->psd = rxPsd->Copy();
-
-        if (m_spectrumPropagationLossModel)
+        // compute rx psd, unless the UE is too far to be received
+        Ptr<SpectrumValue> rxPsd;
+        if (m_sinrEstimateMaxPathLoss > 0 && -propagationGainDb > m_sinrEstimateMaxPathLoss)
         {
-            rxPsd =
-                m_spectrumPropagationLossModel->CalcRxPowerSpectralDensity(rxParams, ueMob, enbMob);
+            NS_LOG_LOGIC("UE " << ue->first << " beyond the path loss cutoff");
         }
-        else if (m_phasedArraySpectrumPropagationLossModel)
+        else
         {
-            rxParams = m_phasedArraySpectrumPropagationLossModel->CalcRxPowerSpectralDensity(rxParams,
-                                                                                          ueMob,
-                                                                                          enbMob,
-                                                                                          txPam,
-                                                                                          rxPam);
-            rxPsd = rxParams->psd;
+            // create tx psd: it is the eNB that dictates the conf, m_listOfSubchannels
+            // contains all the subch
+            Ptr<SpectrumValue> txPsd =
+                MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity(m_phyMacConfig,
+                                                                        ueTxPower,
+                                                                        m_listOfSubchannels);
+            NS_LOG_LOGIC("TxPsd " << *txPsd);
+
+            rxPsd = CalcUeRxPsd(ue->second, uePhy, txPsd, propagationGainDb);
+            steeredUes.emplace_back(ue->second, uePhy);
+            *totalReceivedPsd += *rxPsd;
         }
+        m_rxPsdMap[ue->first] = rxPsd;
 
-        NS_LOG_LOGIC("RxPsd " << *rxPsd);
-
-        m_rxPsdMap[ue->first] = txPsd->Copy();;
-        *totalReceivedPsd += *rxPsd;
-
-        // set back the bf vector to the main eNB
-        if (ueNetDevice)
-        { // target not set yet
-            if ((ueNetDevice->GetTargetEnb() != m_netDevice) && (ueNetDevice->GetTargetEnb()))
-            {
-                uePhy->GetDlSpectrumPhy()->ConfigureBeamforming(ueNetDevice->GetTargetEnb());
-            }
-        }
-        else if (mcUeDev) // it may be a MC device
-        {                 // target not set yet
-            if ((mcUeDev->GetMmWaveTargetEnb() != m_netDevice) && (mcUeDev->GetMmWaveTargetEnb()))
-            {
-                uePhy->GetDlSpectrumPhy()->ConfigureBeamforming(mcUeDev->GetMmWaveTargetEnb());
-            }
-        }
-        else
+        if (m_incrementalSinrEstimate)
         {
-            NS_FATAL_ERROR("Unrecognized device");
+            // the channel may have been generated or updated by CalcUeRxPsd
+            UeRxPsdEstimate& estimate = m_ueRxPsdEstimates[ue->first];
+            estimate.m_enbPosition = enbMob->GetPosition();
+            estimate.m_uePosition = ueMob->GetPosition();
+            estimate.m_ueTxPower = ueTxPower;
+            estimate.m_channelParams = GetUeChannelParams(ueMob, enbMob);
+            estimate.m_rxPsd = rxPsd;
         }
     }
 
+    // point the UE beams back to their target eNBs, once all the estimates are done
+    for (auto& steeredUe : steeredUes)
+    {
+        RestoreUeBeamforming(steeredUe.first, steeredUe.second);
+    }
+
     for (std::map<uint64_t, Ptr<SpectrumValue>>::iterator ue = m_rxPsdMap.begin();
          ue != m_rxPsdMap.end();
          ++ue)
     {
-        SpectrumValue interference = *totalReceivedPsd - *(ue->second);
-        NS_LOG_LOGIC("interference " << interference);
-        SpectrumValue sinr = *(ue->second) / (*noisePsd); // + interference);
-        // we consider the SNR only!
-        NS_LOG_LOGIC("sinr " << sinr);
-        double sinrAvg = Sum(sinr) / (sinr.GetSpectrumModel()->GetNumBands());
+        double sinrAvg = 1e-20; // UE beyond the path loss cutoff
+        if (ue->second)
+        {
+            SpectrumValue interference = *totalReceivedPsd - *(ue->second);
+            NS_LOG_LOGIC("interference " << interference);
+            SpectrumValue sinr = *(ue->second) / (*noisePsd); // + interference);
+            // we consider the SNR only!
+            NS_LOG_LOGIC("sinr " << sinr);
+            sinrAvg = Sum(sinr) / (sinr.GetSpectrumModel()->GetNumBands());
+        }
         NS_LOG_DEBUG("Time " << Simulator::Now().GetSeconds() << " CellId " << m_cellId << " UE "
                              << ue->first << "Average SINR " << 10 * std::log10(sinrAvg));
 
         if (m_noiseAndFilter)
         {
             pairDevices_t pairDevices =
-                std::make_pair(ue->first, m_cellId);            // this is the current pair (UE-eNB)
-            auto iteratorSinr = m_sinrVector.find(pairDevices); // pair [pairDevices,Sinrvalue]
-            if (iteratorSinr != m_sinrVector.end()) // this map has already been initialized, so I
-                                                    // can add a new element for the SINR collection
-            {
-                if (Now().GetMicroSeconds() <= m_transient)
-                {
-                    m_sinrVector.at(pairDevices)
-                        .push_back(sinrAvg); // before transient, so just collect SINR values
-                }
-                else
-                {
-                    m_sinrVector.at(pairDevices).erase(m_sinrVector.at(pairDevices).begin());
-                    m_sinrVector.at(pairDevices)
-                        .push_back(sinrAvg); // before transient, so just collect SINR values
-                }
-
-                NS_LOG_DEBUG("At time " << Now().GetMicroSeconds() << " push back the REAL SINR "
-                                        << 10 * std::log10(sinrAvg) << " for pair with CellId "
-                                        << m_cellId << " and UE " << ue->first);
-            }
-            else // vector is not initialized, so it means that we are still in the initial
-                 // transient phase, for that pair
-            {
-                m_sinrVector.insert(std::make_pair(pairDevices, std::vector<double>()));
-                m_sinrVector.at(pairDevices).push_back(sinrAvg); // push back a new SINR value
-                NS_LOG_DEBUG("At time " << Now().GetMicroSeconds()
-                                        << " first initializazion and push back the SINR "
-                                        << 10 * std::log10(sinrAvg) << " for pair with CellId "
-                                        << m_cellId << " and UE " << ue->first);
-            }
-
-            auto iteratorFinalTrace =
-                m_finalSinrVector.find(pairDevices); // pair [pairDevices,Sinrvalue]
-            if (iteratorFinalTrace == m_finalSinrVector.end())
-            {
-                m_samplesFilter.insert(
-                    std::make_pair(pairDevices, std::pair<uint64_t, uint64_t>()));
-                m_finalSinrVector.insert(std::make_pair(pairDevices, std::vector<double>()));
-            }
-
-            auto iteratorSinrToFilter =
-                m_sinrVectorToFilter.find(pairDevices); // pair [pairDevices,Sinrvalue]
-            if (iteratorSinrToFilter == m_sinrVectorToFilter.end())
-            {
-                m_sinrVectorToFilter.insert(std::make_pair(pairDevices, std::vector<double>()));
-                m_sinrVectorNoisy.insert(std::make_pair(pairDevices, std::vector<double>()));
-            }
-
+                std::make_pair(ue->first, m_cellId); // this is the current pair (UE-eNB)
             /* generate Gaussian noise for the last SINR value (that is the current one) */
-            double sinrNoisy = AddGaussianNoise(m_sinrVector.at(pairDevices).back());
-
-            /* UPDATE TRACE TO BE FILTERED */
-            if (Now().GetMicroSeconds() <= m_transient)
-            {
-                m_sinrVectorNoisy.at(pairDevices).push_back(sinrNoisy);
-
-                // if (sinrNoisy < 0)
-                // {
-                //        NS_LOG_DEBUG("Old SINR value was " << 10*std::log10(sinrNoisy) << " while
-                //        now is " << 10*std::log10(0.1)); sinrNoisy = 0.1;
-                // }
-                m_sinrVectorToFilter.at(pairDevices).push_back(sinrNoisy);
-            }
-            else
-            {
-                m_sinrVectorNoisy.at(pairDevices).erase(m_sinrVectorNoisy.at(pairDevices).begin());
-                m_sinrVectorNoisy.at(pairDevices).push_back(sinrNoisy);
-
-                // if (sinrNoisy < 0)
-                // {
-                //        NS_LOG_DEBUG("Old SINR value was " << 10*std::log10(sinrNoisy) << " while
-                //        now is " << 10*std::log10(0.1)); sinrNoisy = 0.1;
-                // }
-
-                double toPlot = *m_sinrVectorToFilter.at(pairDevices).begin();
-                double toPlotbis = sinrNoisy;
-                NS_LOG_DEBUG("(Remove SINR)  " << toPlot);
-                NS_LOG_DEBUG("(Add SINR)  " << toPlotbis);
-
-                m_sinrVectorToFilter.at(pairDevices)
-                    .erase(m_sinrVectorToFilter.at(pairDevices).begin());
-                m_sinrVectorToFilter.at(pairDevices).push_back(sinrNoisy);
-            }
-
-            if (Now().GetMicroSeconds() > m_transient) // apply filter only when I have a
-                                                       // sufficiently large set of SINR samples
-            {
-                std::vector<double> vectorNoisy = m_sinrVectorNoisy.at(pairDevices);
-                std::pair<uint64_t, uint64_t> pairFiltering = ApplyFilter(
-                    vectorNoisy); // find where to apply the filter, according to the variance
-                m_samplesFilter.at(pairDevices) = pairFiltering; // where to apply the linear filter
-                NS_LOG_DEBUG("Noisy vector start at sample " << std::get<0>(pairFiltering));
-                NS_LOG_DEBUG("Noisy vector end at sample " << std::get<1>(pairFiltering));
-
-                /* just apply filter where the SINR is too low and we are in a blockage situation */
-                if (std::get<0>(m_samplesFilter.at(pairDevices)) ==
-                    std::get<1>(m_samplesFilter.at(pairDevices))) // if start = end
-                {
-                    m_finalSinrVector.at(pairDevices) =
-                        m_sinrVectorToFilter.at(pairDevices); // no need to apply the filter
-                    NS_LOG_DEBUG("At time "
-                                 << Now().GetMicroSeconds()
-                                 << " there is no need to apply the Kalman filter for mmWave eNB "
-                                 << m_cellId << " and UE " << ue->first);
-                }
-                else
-                {
-                    std::vector<double> vectorToFilter = m_sinrVectorToFilter.at(pairDevices);
-                    std::vector<double> sinrVector = m_sinrVector.at(pairDevices);
-                    std::pair<uint64_t, uint64_t> filterPair = m_samplesFilter.at(pairDevices);
-                    m_finalSinrVector.at(pairDevices) =
-                        MakeFilter(vectorNoisy, sinrVector, filterPair);
-                    NS_LOG_DEBUG("finaltrace " << m_finalSinrVector.at(pairDevices).back());
-                }
-
-                /* the last sample in the filtered sequence is referred to the current time instant,
-                 * referred to the uplink reference signal that is used to build the RT in the
-                 * LteEnbRrc class */
-                double sampleToForward = m_finalSinrVector.at(pairDevices).back();
-                if (sampleToForward < 0) // this would be converted in NaN, in the log scale
-                {
-                    sampleToForward = 1e-20;
-                }
-                NS_LOG_DEBUG(" mmWave eNB " << m_cellId << " reports the SINR "
-                                            << 10 * std::log10(sampleToForward) << " for UE "
-                                            << ue->first);
-                m_sinrMap[ue->first] =
-                    sampleToForward; // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< in order to
-                                     // FORWARD to LteEnbRrc the value of SINR for the RT
-
-                // m_sinrVectorToFilter.at(pairDevices).erase(m_sinrVectorToFilter.at(pairDevices).begin());
-                // m_sinrVectorToFilter.at(pairDevices).push_back(m_finalSinrVector.at(pairDevices).back());
-                m_sinrVectorToFilter.at(pairDevices).pop_back();
-                m_sinrVectorToFilter.at(pairDevices)
-                    .push_back(m_finalSinrVector.at(pairDevices).back());
-            }
-            else // before the transient is over, just forwart the (last) noisy sample, without
-                 // having filtered
-            {
-                double sampleToForward = m_sinrVectorToFilter.at(pairDevices).back();
-                if (sampleToForward < 0) // this would be converted in NaN, in the log scale
-                {
-                    sampleToForward = 1e-20;
-                }
-                NS_LOG_DEBUG(" mmWave eNB " << m_cellId << " FIRST reports the SINR "
-                                            << 10 * std::log10(sampleToForward) << " for UE "
-                                            << ue->first);
-                m_sinrMap[ue->first] =
-                    sampleToForward; // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< in order to
-                                     // FORWARD to LteEnbRrc the value of SINR for the RT
-            }
-
-            /* after the SINR sample is forwarded, I need to REFRESH all the maps, so that
-             * a new SINR sequence can be created, to generate a new SINR sample
-             * for the next RT
-             */
-            m_finalSinrVector.erase(pairDevices);
-            m_samplesFilter.erase(pairDevices);
-            NS_LOG_DEBUG("ERASE MAPS FOR RT");
+            double sinrNoisy = AddGaussianNoise(sinrAvg);
+            double sampleToForward = UpdateSinrFilter(m_sinrFilterStates[pairDevices],
+                                                      sinrAvg,
+                                                      sinrNoisy,
+                                                      Now().GetMicroSeconds() > m_transient);
+            NS_LOG_DEBUG(" mmWave eNB " << m_cellId << " reports the SINR "
+                                        << 10 * std::log10(sampleToForward) << " for UE "
+                                        << ue->first);
+            m_sinrMap[ue->first] = sampleToForward; // in order to FORWARD to LteEnbRrc the value
+                                                    // of SINR for the RT
         }
         else // noise and filtering processes are not applied!
         {
@@ -898,19 +1031,7 @@ MmWaveEnbPhy::UpdateUeSinrEstimate()
         m_roundFromLastUeSinrUpdate = 0;
         for (auto ueIt = m_ueAttachedImsiMap.begin(); ueIt != m_ueAttachedImsiMap.end(); ++ueIt)
         {
-            // distinguish between MC and MmWaveNetDevice
-            Ptr<mmwave::MmWaveUeNetDevice> ueNetDevice =
-                DynamicCast<mmwave::MmWaveUeNetDevice>(ueIt->second);
-            Ptr<McUeNetDevice> mcUeDev = DynamicCast<McUeNetDevice>(ueIt->second);
-            Ptr<MmWaveUePhy> uePhy;
-            if (ueNetDevice)
-            {
-                uePhy = ueNetDevice->GetPhy();
-            }
-            else if (mcUeDev) // it may be a MC device
-            {
-                uePhy = mcUeDev->GetMmWavePhy();
-            }
+            Ptr<MmWaveUePhy> uePhy = GetUePhy(ueIt->second);
             uePhy->UpdateSinrEstimate(m_cellId, m_sinrMap.find(ueIt->first)->second);
         }
     }
@@ -39,9 +39,15 @@
 #include "mmwave-phy-mac-common.h"
 #include "mmwave-phy.h"
 
+#include <ns3/deprecated.h>
 #include <ns3/lte-enb-cphy-sap.h>
 #include <ns3/lte-enb-phy-sap.h>
+#include <ns3/matrix-based-channel-model.h>
 #include <ns3/mmwave-harq-phy.h>
+#include <ns3/vector.h>
+
+class MmWaveEnbPhySinrFilterTestCase;
+class MmWaveEnbPhySinrEstimateTestCase;
 
 namespace ns3
 {
@@ -60,6 +66,8 @@ class MmWaveEnbMac;
 class MmWaveEnbPhy : public MmWavePhy
 {
     friend class MemberLteEnbCphySapProvider<MmWaveEnbPhy>;
+    friend class ::MmWaveEnbPhySinrFilterTestCase;
+    friend class ::MmWaveEnbPhySinrEstimateTestCase;
 
   public:
     MmWaveEnbPhy();
@@ -166,12 +174,16 @@ class MmWaveEnbPhy : public MmWavePhy
 
     double AddGaussianNoise(double sample);
 
+    NS_DEPRECATED_3_42("The SINR filter is updated at each SINR estimate by UpdateUeSinrEstimate")
     std::pair<uint64_t, uint64_t> ApplyFilter(std::vector<double>);
 
+    NS_DEPRECATED_3_42("The SINR filter is updated at each SINR estimate by UpdateUeSinrEstimate")
     double MakeAvg(std::vector<double>);
 
+    NS_DEPRECATED_3_42("The SINR filter is updated at each SINR estimate by UpdateUeSinrEstimate")
     double MakeVar(std::vector<double>, double);
 
+    NS_DEPRECATED_3_42("The SINR filter is updated at each SINR estimate by UpdateUeSinrEstimate")
     std::vector<double> MakeFilter(std::vector<double>,
                                    std::vector<double>,
                                    std::pair<uint64_t, uint64_t>);
@@ -203,6 +215,154 @@ class MmWaveEnbPhy : public MmWavePhy
      */
     void TraceDlPhyTransmission(DciInfoElementTdma dciInfo, uint8_t tddType);
 
+    /**
+     * Get the mmWave PHY of an attached UE device
+     *
+     * \param ueDevice either a MmWaveUeNetDevice or a McUeNetDevice
+     * \return the mmWave PHY of the device
+     */
+    Ptr<MmWaveUePhy> GetUePhy(Ptr<NetDevice> ueDevice) const;
+
+    /**
+     * Estimate the PSD received from a UE, pointing the beams of this eNB and
+     * of the UE toward each other
+     *
+     * \param ueDevice the UE device
+     * \param uePhy the mmWave PHY of the UE
+     * \param txPsd the PSD transmitted by the UE
+     * \param propagationGainDb the propagation gain between the UE and this eNB (dB)
+     * \return the received PSD
+     */
+    Ptr<SpectrumValue> CalcUeRxPsd(Ptr<NetDevice> ueDevice,
+                                   Ptr<MmWaveUePhy> uePhy,
+                                   Ptr<const SpectrumValue> txPsd,
+                                   double propagationGainDb);
+
+    /**
+     * Point the beam of a UE back to its target eNB, after it was steered
+     * toward this eNB to estimate the SINR
+     *
+     * \param ueDevice the UE device
+     * \param uePhy the mmWave PHY of the UE
+     */
+    void RestoreUeBeamforming(Ptr<NetDevice> ueDevice, Ptr<MmWaveUePhy> uePhy);
+
+    /**
+     * Get the parameters of the channel between a UE and this eNB, if the
+     * propagation loss model is based on a MatrixBasedChannelModel
+     *
+     * \param ueMob the mobility model of the UE
+     * \param enbMob the mobility model of this eNB
+     * \return the channel parameters, or nullptr if not available
+     */
+    Ptr<const MatrixBasedChannelModel::ChannelParams> GetUeChannelParams(
+        Ptr<const MobilityModel> ueMob,
+        Ptr<const MobilityModel> enbMob) const;
+
+    /**
+     * PSD received from a UE in the last SINR estimate, with the state of the
+     * link it was computed for. Used by the incremental SINR estimation.
+     */
+    struct UeRxPsdEstimate
+    {
+        Vector m_enbPosition; //!< position of the eNB
+        Vector m_uePosition;  //!< position of the UE
+        double m_ueTxPower;   //!< TX power of the UE (dBm)
+        Ptr<const MatrixBasedChannelModel::ChannelParams>
+            m_channelParams;        //!< parameters of the channel between the UE and the eNB
+        Ptr<SpectrumValue> m_rxPsd; //!< received PSD, nullptr if beyond the path loss cutoff
+    };
+
+    /**
+     * Sliding window of SINR samples, stored in a ring buffer. The window
+     * grows until a capacity is set, then each new sample replaces the oldest.
+     */
+    class SinrWindow
+    {
+      public:
+        /**
+         * Add a sample to the window
+         * \param sample the SINR sample
+         */
+        void Push(double sample);
+
+        /**
+         * Fix the length of the window
+         * \param capacity the length of the window, at least the current size
+         */
+        void SetCapacity(std::size_t capacity);
+
+        /**
+         * \return the length of the window, 0 if not fixed yet
+         */
+        std::size_t GetCapacity() const;
+
+        /**
+         * \return the number of samples in the window
+         */
+        std::size_t GetSize() const;
+
+        /**
+         * \return true if the window length is fixed and the window is full
+         */
+        bool IsFull() const;
+
+        /**
+         * \param i the position in the window, 0 being the oldest sample
+         * \return the sample at position i
+         */
+        double At(std::size_t i) const;
+
+      private:
+        std::vector<double> m_samples; //!< the samples, m_oldest being the oldest one
+        std::size_t m_oldest{0};       //!< index of the oldest sample in m_samples
+        std::size_t m_capacity{0};     //!< length of the window, 0 if not fixed yet
+    };
+
+    /**
+     * State of the noisy and filtered SINR estimation of a UE-eNB pair. The
+     * variance of consecutive noisy samples and the runs of samples which
+     * mark the beginning and the end of a blockage are updated at each new
+     * sample, so that the filter does not need to scan the windows.
+     */
+    struct SinrFilterState
+    {
+        SinrWindow m_realSinr;        //!< the real SINR samples (linear)
+        SinrWindow m_noisySinr;       //!< the noisy SINR samples (linear)
+        uint64_t m_numSamples{0};     //!< number of samples pushed since the pair was created
+        double m_lastNoisySinrDb{0};  //!< the last noisy SINR sample (dB)
+        uint32_t m_lowVarianceRun{0}; //!< consecutive noisy sample pairs with variance below 1
+        uint32_t m_highSinrRun{0};    //!< consecutive noisy samples above 10 dB
+        bool m_hasFilterStart{false}; //!< whether m_filterStart is valid
+        uint64_t m_filterStart{0};    //!< last sample after which a blockage may have started
+    };
+
+    /**
+     * Add a new sample to the SINR estimation of a UE-eNB pair, and filter
+     * it if the pair is in a blockage
+     *
+     * \param state the state of the pair
+     * \param sinr the real SINR sample (linear)
+     * \param sinrNoisy the SINR sample with measurement noise (linear)
+     * \param afterTransient whether the initial transient is over
+     * \return the SINR to report (linear)
+     */
+    static double UpdateSinrFilter(SinrFilterState& state,
+                                   double sinr,
+                                   double sinrNoisy,
+                                   bool afterTransient);
+
+    /**
+     * Filter the noisy SINR samples of a pair from the beginning of a
+     * blockage, with the exponential smoothing factor that best matches the
+     * real SINR samples
+     *
+     * \param state the state of the pair
+     * \param start position, in the windows, of the beginning of the blockage
+     * \return the filtered SINR (linear)
+     */
+    static double CalcFilteredSinr(const SinrFilterState& state, std::size_t start);
+
     uint8_t m_currSlotNumTti; //!< The amount of TTIs scheduled in the current slot
 
     std::set<uint64_t> m_ueAttached;
@@ -224,17 +384,12 @@ class MmWaveEnbPhy : public MmWavePhy
     std::map<uint64_t, Ptr<NetDevice>> m_ueAttachedImsiMap;
     std::map<uint64_t, double> m_sinrMap;
     std::map<uint64_t, Ptr<SpectrumValue>> m_rxPsdMap;
-    std::map<pairDevices_t, std::vector<double>>
-        m_sinrVector; // array containing all SINR values for a specific pair (UE-eNB)
-    std::map<pairDevices_t, std::vector<double>>
-        m_sinrVectorToFilter; // array containing the  SINR values that must be filtered
-    std::map<pairDevices_t, std::vector<double>>
-        m_sinrVectorNoisy; // array containing the  noisy SINR values that must be filteredF
-    std::map<pairDevices_t, std::vector<double>>
-        m_finalSinrVector; // array containing all  SINR values after the filtering for a specific
-                           // pair (UE-eNB)
-    std::map<pairDevices_t, std::pair<uint64_t, uint64_t>>
-        m_samplesFilter; // array containing all noisy SINR values for a specific pair (UE-eNB)
+    std::map<uint64_t, UeRxPsdEstimate>
+        m_ueRxPsdEstimates;         //!< last RX PSD estimate of each UE, indexed by IMSI
+    bool m_incrementalSinrEstimate; //!< only recompute the RX PSD of the UEs whose link changed
+    double m_sinrEstimateMaxPathLoss; //!< path loss (dB) beyond which the UE SINR is not computed
+    std::map<pairDevices_t, SinrFilterState>
+        m_sinrFilterStates; //!< noisy and filtered SINR estimation of each pair (UE-eNB)
 
     int m_updateSinrPeriod;               // the period of SINR update for eNBs
     double m_ueUpdateSinrPeriod;          // the period of SINR reporting to the UEs
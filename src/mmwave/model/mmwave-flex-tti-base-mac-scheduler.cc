@@ -0,0 +1,1683 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *   Author: Sourjya Dutta <sdutta@nyu.edu>
+ *           Russell Ford <russell.ford@nyu.edu>
+ */
+
+#include "mmwave-flex-tti-base-mac-scheduler.h"
+
+#include "mmwave-spectrum-value-helper.h"
+
+#include <ns3/boolean.h>
+#include <ns3/eps-bearer.h>
+#include <ns3/log.h>
+#include <ns3/lte-common.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MmWaveFlexTtiBaseMacScheduler");
+
+namespace mmwave
+{
+
+NS_OBJECT_ENSURE_REGISTERED(MmWaveFlexTtiBaseMacScheduler);
+
+class MmWaveFlexTtiBaseMacCschedSapProvider : public MmWaveMacCschedSapProvider
+{
+  public:
+    MmWaveFlexTtiBaseMacCschedSapProvider(MmWaveFlexTtiBaseMacScheduler* scheduler);
+
+    // inherited from MmWaveMacCschedSapProvider
+    virtual void CschedCellConfigReq(
+        const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params);
+    virtual void CschedUeConfigReq(
+        const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params);
+    virtual void CschedLcConfigReq(
+        const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+    virtual void CschedLcReleaseReq(
+        const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+    virtual void CschedUeReleaseReq(
+        const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params);
+
+  private:
+    MmWaveFlexTtiBaseMacCschedSapProvider();
+    MmWaveFlexTtiBaseMacScheduler* m_scheduler;
+};
+
+MmWaveFlexTtiBaseMacCschedSapProvider::MmWaveFlexTtiBaseMacCschedSapProvider()
+{
+}
+
+MmWaveFlexTtiBaseMacCschedSapProvider::MmWaveFlexTtiBaseMacCschedSapProvider(
+    MmWaveFlexTtiBaseMacScheduler* scheduler)
+    : m_scheduler(scheduler)
+{
+}
+
+void
+MmWaveFlexTtiBaseMacCschedSapProvider::CschedCellConfigReq(
+    const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
+{
+    m_scheduler->DoCschedCellConfigReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacCschedSapProvider::CschedUeConfigReq(
+    const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
+{
+    m_scheduler->DoCschedUeConfigReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacCschedSapProvider::CschedLcConfigReq(
+    const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+    m_scheduler->DoCschedLcConfigReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacCschedSapProvider::CschedLcReleaseReq(
+    const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+{
+    m_scheduler->DoCschedLcReleaseReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacCschedSapProvider::CschedUeReleaseReq(
+    const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
+{
+    m_scheduler->DoCschedUeReleaseReq(params);
+}
+
+class MmWaveFlexTtiBaseMacSchedSapProvider : public MmWaveMacSchedSapProvider
+{
+  public:
+    MmWaveFlexTtiBaseMacSchedSapProvider(MmWaveFlexTtiBaseMacScheduler* sched);
+
+    virtual void SchedDlRlcBufferReq(
+        const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+    virtual void SchedTriggerReq(
+        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
+    virtual void SchedDlCqiInfoReq(
+        const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+    virtual void SchedUlCqiInfoReq(
+        const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+    virtual void SchedUlMacCtrlInfoReq(
+        const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+    virtual void SchedSetMcs(int mcs);
+
+  private:
+    MmWaveFlexTtiBaseMacSchedSapProvider();
+    MmWaveFlexTtiBaseMacScheduler* m_scheduler;
+};
+
+MmWaveFlexTtiBaseMacSchedSapProvider::MmWaveFlexTtiBaseMacSchedSapProvider()
+{
+}
+
+MmWaveFlexTtiBaseMacSchedSapProvider::MmWaveFlexTtiBaseMacSchedSapProvider(
+    MmWaveFlexTtiBaseMacScheduler* sched)
+    : m_scheduler(sched)
+{
+}
+
+void
+MmWaveFlexTtiBaseMacSchedSapProvider::SchedDlRlcBufferReq(
+    const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+    m_scheduler->DoSchedDlRlcBufferReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacSchedSapProvider::SchedTriggerReq(
+    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+    m_scheduler->DoSchedTriggerReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacSchedSapProvider::SchedDlCqiInfoReq(
+    const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
+{
+    m_scheduler->DoSchedDlCqiInfoReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacSchedSapProvider::SchedUlCqiInfoReq(
+    const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+{
+    m_scheduler->DoSchedUlCqiInfoReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacSchedSapProvider::SchedUlMacCtrlInfoReq(
+    const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+{
+    m_scheduler->DoSchedUlMacCtrlInfoReq(params);
+}
+
+void
+MmWaveFlexTtiBaseMacSchedSapProvider::SchedSetMcs(int mcs)
+{
+    m_scheduler->DoSchedSetMcs(mcs);
+}
+
+const unsigned MmWaveFlexTtiBaseMacScheduler::m_subHdrSize = 4;
+const unsigned MmWaveFlexTtiBaseMacScheduler::m_rlcHdrSize = 3;
+
+MmWaveFlexTtiBaseMacScheduler::UeStateTable::UeStateTable()
+    : m_numHarq(0),
+      m_numRb(0)
+{
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::UeStateTable::Configure(uint32_t numHarq, uint32_t numRb)
+{
+    m_numHarq = numHarq;
+    m_numRb = numRb;
+    m_slotOfRnti.clear();
+    m_rnti.clear();
+    m_configured.clear();
+    m_dlCqi.clear();
+    m_dlCqiValid.clear();
+    m_dlCqiTimer.clear();
+    m_ulSinr.clear();
+    m_ulCqiValid.clear();
+    m_ulCqiTimer.clear();
+    m_ulBufferSize.clear();
+    m_dlHarqStatus.clear();
+    m_dlHarqTimer.clear();
+    m_dlHarqDci.clear();
+    m_dlHarqRlcPdu.clear();
+    m_ulHarqStatus.clear();
+    m_ulHarqTimer.clear();
+    m_ulHarqDci.clear();
+}
+
+uint32_t
+MmWaveFlexTtiBaseMacScheduler::UeStateTable::FindOrAdd(uint16_t rnti)
+{
+    uint32_t slot = Find(rnti);
+    if (slot != NO_SLOT)
+    {
+        return slot;
+    }
+    if (rnti >= m_slotOfRnti.size())
+    {
+        m_slotOfRnti.resize(rnti + 1, NO_SLOT);
+    }
+    slot = m_rnti.size();
+    m_slotOfRnti[rnti] = slot;
+    m_rnti.push_back(rnti);
+    m_configured.push_back(0);
+    m_dlCqi.push_back(0);
+    m_dlCqiValid.push_back(0);
+    m_dlCqiTimer.push_back(0);
+    m_ulSinr.resize(m_ulSinr.size() + m_numRb, 0.0);
+    m_ulCqiValid.push_back(0);
+    m_ulCqiTimer.push_back(0);
+    m_ulBufferSize.push_back(0);
+    m_dlHarqStatus.resize(m_dlHarqStatus.size() + m_numHarq, 0);
+    m_dlHarqTimer.resize(m_dlHarqTimer.size() + m_numHarq, 0);
+    m_dlHarqDci.resize(m_dlHarqDci.size() + m_numHarq);
+    m_dlHarqRlcPdu.resize(m_dlHarqRlcPdu.size() + m_numHarq);
+    m_ulHarqStatus.resize(m_ulHarqStatus.size() + m_numHarq, 0);
+    m_ulHarqTimer.resize(m_ulHarqTimer.size() + m_numHarq, 0);
+    m_ulHarqDci.resize(m_ulHarqDci.size() + m_numHarq);
+    return slot;
+}
+
+/**
+ * Move the block of the last slot of a per-UE array into another slot,
+ * and drop the last block
+ * \param v the array, holding blockSize entries per slot
+ * \param slot the destination slot
+ * \param last the last slot
+ * \param blockSize the number of entries per slot
+ */
+template <class T>
+static void
+MoveLastBlock(std::vector<T>& v, uint32_t slot, uint32_t last, uint32_t blockSize)
+{
+    if (slot != last)
+    {
+        std::move(v.begin() + last * blockSize,
+                  v.begin() + (last + 1) * blockSize,
+                  v.begin() + slot * blockSize);
+    }
+    v.resize(last * blockSize);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::UeStateTable::AddHarqProcesses(uint16_t rnti)
+{
+    uint32_t slot = FindOrAdd(rnti);
+    if (m_configured[slot])
+    {
+        return;
+    }
+    m_configured[slot] = 1;
+    uint32_t first = slot * m_numHarq;
+    std::fill_n(m_dlHarqStatus.begin() + first, m_numHarq, 0);
+    std::fill_n(m_dlHarqTimer.begin() + first, m_numHarq, 0);
+    std::fill_n(m_dlHarqDci.begin() + first, m_numHarq, DciInfoElementTdma());
+    std::fill_n(m_dlHarqRlcPdu.begin() + first, m_numHarq, std::vector<RlcPduInfo>());
+    std::fill_n(m_ulHarqStatus.begin() + first, m_numHarq, 0);
+    std::fill_n(m_ulHarqTimer.begin() + first, m_numHarq, 0);
+    std::fill_n(m_ulHarqDci.begin() + first, m_numHarq, DciInfoElementTdma());
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::UeStateTable::RemoveHarqProcesses(uint16_t rnti)
+{
+    uint32_t slot = Find(rnti);
+    if (slot == NO_SLOT)
+    {
+        return;
+    }
+    m_configured[slot] = 0;
+    m_ulBufferSize[slot] = 0;
+    RemoveIfUnused(slot);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::UeStateTable::RemoveIfUnused(uint32_t slot)
+{
+    if (m_configured[slot] || m_dlCqiValid[slot] || m_ulCqiValid[slot] || m_ulBufferSize[slot])
+    {
+        return;
+    }
+    uint32_t last = m_rnti.size() - 1;
+    m_slotOfRnti[m_rnti[last]] = slot;
+    m_slotOfRnti[m_rnti[slot]] = NO_SLOT;
+    MoveLastBlock(m_rnti, slot, last, 1);
+    MoveLastBlock(m_configured, slot, last, 1);
+    MoveLastBlock(m_dlCqi, slot, last, 1);
+    MoveLastBlock(m_dlCqiValid, slot, last, 1);
+    MoveLastBlock(m_dlCqiTimer, slot, last, 1);
+    MoveLastBlock(m_ulSinr, slot, last, m_numRb);
+    MoveLastBlock(m_ulCqiValid, slot, last, 1);
+    MoveLastBlock(m_ulCqiTimer, slot, last, 1);
+    MoveLastBlock(m_ulBufferSize, slot, last, 1);
+    MoveLastBlock(m_dlHarqStatus, slot, last, m_numHarq);
+    MoveLastBlock(m_dlHarqTimer, slot, last, m_numHarq);
+    MoveLastBlock(m_dlHarqDci, slot, last, m_numHarq);
+    MoveLastBlock(m_dlHarqRlcPdu, slot, last, m_numHarq);
+    MoveLastBlock(m_ulHarqStatus, slot, last, m_numHarq);
+    MoveLastBlock(m_ulHarqTimer, slot, last, m_numHarq);
+    MoveLastBlock(m_ulHarqDci, slot, last, m_numHarq);
+}
+
+MmWaveFlexTtiBaseMacScheduler::MmWaveFlexTtiBaseMacScheduler()
+    : m_macSchedSapUser(0),
+      m_timeWindow(99.0),
+      m_tbUid(0),
+      m_macCschedSapUser(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_macSchedSapProvider = new MmWaveFlexTtiBaseMacSchedSapProvider(this);
+    m_macCschedSapProvider = new MmWaveFlexTtiBaseMacCschedSapProvider(this);
+}
+
+MmWaveFlexTtiBaseMacScheduler::~MmWaveFlexTtiBaseMacScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoDispose(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_ueState.Configure(0, 0);
+    m_dlHarqInfoList.clear();
+    m_ulHarqInfoList.clear();
+    m_ueSchedInfoMap.clear();
+    delete m_macCschedSapProvider;
+    delete m_macSchedSapProvider;
+    MmWaveMacScheduler::DoDispose();
+}
+
+TypeId
+MmWaveFlexTtiBaseMacScheduler::GetTypeId(void)
+{
+    static TypeId tid =
+        TypeId("ns3::MmWaveFlexTtiBaseMacScheduler").SetParent<MmWaveMacScheduler>();
+
+    return tid;
+}
+
+TypeId
+MmWaveFlexTtiBaseMacScheduler::AddCommonAttributes(TypeId tid, bool harqEnabled)
+{
+    return tid
+        .AddAttribute("CqiTimerThreshold",
+                      "The number of TTIs a CQI is valid (default 1000 - 1 sec.)",
+                      UintegerValue(100),
+                      MakeUintegerAccessor(&MmWaveFlexTtiBaseMacScheduler::m_cqiTimersThreshold),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("HarqEnabled",
+                      "Activate/Deactivate the HARQ [by default is active].",
+                      BooleanValue(harqEnabled),
+                      MakeBooleanAccessor(&MmWaveFlexTtiBaseMacScheduler::m_harqOn),
+                      MakeBooleanChecker())
+        .AddAttribute("FixedMcsDl",
+                      "Fix MCS to value set in McsDlDefault",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiBaseMacScheduler::m_fixedMcsDl),
+                      MakeBooleanChecker())
+        .AddAttribute("McsDefaultDl",
+                      "Fixed DL MCS",
+                      UintegerValue(1),
+                      MakeUintegerAccessor(&MmWaveFlexTtiBaseMacScheduler::m_mcsDefaultDl),
+                      MakeUintegerChecker<uint8_t>())
+        .AddAttribute("FixedMcsUl",
+                      "Fix MCS to value set in McsUlDefault (for testing)",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiBaseMacScheduler::m_fixedMcsUl),
+                      MakeBooleanChecker())
+        .AddAttribute("McsDefaultUl",
+                      "Fixed UL MCS (for testing)",
+                      UintegerValue(1),
+                      MakeUintegerAccessor(&MmWaveFlexTtiBaseMacScheduler::m_mcsDefaultUl),
+                      MakeUintegerChecker<uint8_t>())
+        .AddAttribute("DlSchedOnly",
+                      "Only schedule downlink traffic (for testing)",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiBaseMacScheduler::m_dlOnly),
+                      MakeBooleanChecker())
+        .AddAttribute("UlSchedOnly",
+                      "Only schedule uplink traffic (for testing)",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiBaseMacScheduler::m_ulOnly),
+                      MakeBooleanChecker())
+        .AddAttribute("FixedTti",
+                      "Fix slot size",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiBaseMacScheduler::m_fixedTti),
+                      MakeBooleanChecker())
+        .AddAttribute("SymPerSlot",
+                      "Number of symbols per slot in Fixed TTI mode",
+                      UintegerValue(6),
+                      MakeUintegerAccessor(&MmWaveFlexTtiBaseMacScheduler::m_symPerSlot),
+                      MakeUintegerChecker<uint8_t>());
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::SetMacSchedSapUser(MmWaveMacSchedSapUser* sap)
+{
+    m_macSchedSapUser = sap;
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::SetMacCschedSapUser(MmWaveMacCschedSapUser* sap)
+{
+    m_macCschedSapUser = sap;
+}
+
+MmWaveMacSchedSapProvider*
+MmWaveFlexTtiBaseMacScheduler::GetMacSchedSapProvider()
+{
+    return m_macSchedSapProvider;
+}
+
+MmWaveMacCschedSapProvider*
+MmWaveFlexTtiBaseMacScheduler::GetMacCschedSapProvider()
+{
+    return m_macCschedSapProvider;
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::ConfigureCommonParameters(Ptr<MmWavePhyMacCommon> config)
+{
+    m_phyMacConfig = config;
+    m_amc = CreateObject<MmWaveAmc>(m_phyMacConfig);
+    m_ueState.Configure(m_phyMacConfig->GetNumHarqProcess(), m_phyMacConfig->GetNumRb());
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoSchedDlRlcBufferReq(
+    const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+    NS_LOG_FUNCTION(this << params.m_rnti << (uint32_t)params.m_logicalChannelIdentity);
+    std::map<uint16_t, struct UeSchedInfo>::iterator itUe = m_ueSchedInfoMap.find(params.m_rnti);
+    if (itUe == m_ueSchedInfoMap.end())
+    {
+        NS_LOG_ERROR("UE entry not found in sched info map");
+        return;
+    }
+
+    uint8_t lcid = params.m_logicalChannelIdentity;
+    if ((unsigned)lcid >= itUe->second.m_flowStatsDl.size())
+    {
+        NS_LOG_ERROR("LC not registered");
+        return;
+    }
+
+    FlowStats& flow = itUe->second.m_flowStatsDl[lcid];
+    if (params.m_txPacketSizes.size() > 0)
+    {
+        flow.m_txPacketSizes.clear();
+        flow.m_txPacketDelays.clear();
+        // add the new DL PDCP packet sizes and their delays
+        uint32_t totalSize = 0;
+        double maxDelay = 0.0;
+        std::list<uint32_t>::const_iterator itSize = params.m_txPacketSizes.begin();
+        std::list<double>::const_iterator itDelay = params.m_txPacketDelays.begin();
+        while (itSize != params.m_txPacketSizes.end() && itDelay != params.m_txPacketDelays.end())
+        {
+            totalSize += *itSize;
+            if (totalSize > flow.m_totalSchedSize)
+            {
+                flow.m_totalBufSize = params.m_rlcTransmissionQueueSize;
+                flow.m_txPacketSizes.push_back(*itSize);
+                flow.m_txPacketDelays.push_back(*itDelay);
+                if (*itDelay > maxDelay)
+                {
+                    maxDelay = *itDelay;
+                }
+            }
+            itSize++;
+            itDelay++;
+        }
+        flow.m_txQueueHolDelay = maxDelay;
+    }
+    else if (params.m_rlcTransmissionQueueSize > 0) // case for RlcSm
+    {
+        flow.m_totalBufSize = params.m_rlcTransmissionQueueSize;
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoSchedUlMacCtrlInfoReq(
+    const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+{
+    NS_LOG_FUNCTION(this);
+
+    for (unsigned int i = 0; i < params.m_macCeList.size(); i++)
+    {
+        if (params.m_macCeList.at(i).m_macCeType == MacCeElement::BSR)
+        {
+            // buffer status report
+            // the BSR of each LCG is mapped to the UL flow with the same index
+            uint16_t rnti = params.m_macCeList.at(i).m_rnti;
+            std::map<uint16_t, struct UeSchedInfo>::iterator itUe = m_ueSchedInfoMap.find(rnti);
+
+            for (uint8_t lcg = 1; lcg <= 3; ++lcg)
+            {
+                uint8_t bsrId = params.m_macCeList.at(i).m_macCeValue.m_bufferStatus.at(lcg - 1);
+                uint32_t bufSize = BsrId2BufferSize(bsrId);
+                if (bufSize == 0)
+                {
+                    continue;
+                }
+                if (itUe == m_ueSchedInfoMap.end())
+                {
+                    NS_LOG_ERROR("UE entry not found in sched info map");
+                    continue;
+                }
+
+                FlowStats& flow = itUe->second.m_flowStatsUl[lcg];
+                int diff = bufSize - (flow.m_totalBufSize + flow.m_totalSchedSize);
+                if (diff > 0)
+                { // estimate additional packet sizes
+                    flow.m_totalBufSize += diff;
+                    flow.m_txPacketSizes.push_back(diff);
+                    // since we expect the BSR to be generated following a packet arrival
+                    // and sent at least by the end of the prev. subframe, the maximum delay
+                    // is one SF (in microseconds)
+                    flow.m_txPacketDelays.push_back(GetBsrPacketDelay());
+                    if (flow.m_txQueueHolDelay == 0)
+                    {
+                        flow.m_txQueueHolDelay = GetBsrPacketDelay();
+                    }
+                }
+            }
+        }
+    }
+}
+
+double
+MmWaveFlexTtiBaseMacScheduler::GetBsrPacketDelay(void) const
+{
+    return m_phyMacConfig->GetSlotPeriod().GetMicroSeconds();
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoSchedDlCqiInfoReq(
+    const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
+{
+    NS_LOG_FUNCTION(this);
+
+    for (unsigned int i = 0; i < params.m_cqiList.size(); i++)
+    {
+        if (params.m_cqiList.at(i).m_cqiType == DlCqiInfo::WB)
+        {
+            // wideband CQI reporting, only codeword 0 at this stage (SISO)
+            uint32_t slot = m_ueState.FindOrAdd(params.m_cqiList.at(i).m_rnti);
+            m_ueState.m_dlCqi[slot] = params.m_cqiList.at(i).m_wbCqi;
+            m_ueState.m_dlCqiValid[slot] = 1;
+            // generate or update the correspondent timer
+            m_ueState.m_dlCqiTimer[slot] = m_cqiTimersThreshold;
+        }
+        else if (params.m_cqiList.at(i).m_cqiType == DlCqiInfo::SB)
+        {
+            // subband CQI reporting high layer configured
+            // Not used by the Flex-TTI schedulers
+        }
+        else
+        {
+            NS_LOG_ERROR(this << " CQI type unknown");
+        }
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoSchedUlCqiInfoReq(
+    const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+{
+    NS_LOG_FUNCTION(this);
+
+    uint16_t frameNum = params.m_sfnSf.m_frameNum;
+    uint8_t subframeNum = params.m_sfnSf.m_sfNum;
+    uint8_t slotNum = params.m_sfnSf.m_slotNum;
+    uint8_t symNum = params.m_sfnSf.m_symStart;
+
+    switch (params.m_ulCqi.m_type)
+    {
+    case UlCqiInfo::PUSCH: {
+        std::map<uint32_t, struct AllocMapElem>::iterator itMap;
+        itMap = m_ulAllocationMap.find(params.m_sfnSf.Encode());
+        if (itMap == m_ulAllocationMap.end())
+        {
+            NS_LOG_INFO(this << " Does not find info on allocation, size : "
+                             << m_ulAllocationMap.size());
+            return;
+        }
+        NS_ASSERT_MSG(itMap->second.m_rntiPerChunk.size() == m_phyMacConfig->GetNumRb(),
+                      "SINR chunk map must cover full BW in TDMA mode");
+        for (unsigned i = 0; i < itMap->second.m_rntiPerChunk.size(); i++)
+        {
+            uint32_t slot = m_ueState.FindOrAdd(itMap->second.m_rntiPerChunk.at(i));
+            double* sinr = &m_ueState.m_ulSinr[slot * m_ueState.m_numRb];
+            if (!m_ueState.m_ulCqiValid[slot])
+            {
+                // create a new entry, initialized with NO_SINR value
+                std::fill(sinr, sinr + m_ueState.m_numRb, 30.0);
+                m_ueState.m_ulCqiValid[slot] = 1;
+            }
+            // update the value and the correspondent timer
+            sinr[i] = params.m_ulCqi.m_sinr.at(i);
+            m_ueState.m_ulCqiTimer[slot] = m_cqiTimersThreshold;
+
+            NS_LOG_INFO("UL CQI report for RNTI "
+                        << itMap->second.m_rntiPerChunk.at(i) << " chunk " << i << " SINR "
+                        << params.m_ulCqi.m_sinr.at(i) << " frame " << frameNum << " subframe "
+                        << +subframeNum << " slot " << +slotNum << " startSym " << +symNum);
+        }
+        // remove obsolete info on allocation
+        m_ulAllocationMap.erase(itMap);
+    }
+    break;
+    default:
+        NS_FATAL_ERROR("Unknown type of UL-CQI");
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoSchedSetMcs(int mcs)
+{
+    if (mcs >= 0 && mcs <= 28)
+    {
+        m_mcsDefaultDl = mcs;
+        m_mcsDefaultUl = mcs;
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::RefreshHarqProcesses()
+{
+    NS_LOG_FUNCTION(this);
+
+    // the status and timer arrays hold m_numHarq entries per UE, in the same order
+    const uint8_t harqTimeout = m_phyMacConfig->GetHarqTimeout();
+    for (uint32_t j = 0; j < m_ueState.m_dlHarqTimer.size(); j++)
+    {
+        if (!m_ueState.m_configured[j / m_ueState.m_numHarq])
+        {
+            continue;
+        }
+        if (m_ueState.m_dlHarqTimer[j] == harqTimeout)
+        { // reset HARQ process
+            NS_LOG_INFO(this << " Reset HARQ proc " << j % m_ueState.m_numHarq << " for RNTI "
+                             << m_ueState.m_rnti[j / m_ueState.m_numHarq]);
+            m_ueState.m_dlHarqStatus[j] = 0;
+            m_ueState.m_dlHarqTimer[j] = 0;
+        }
+        else
+        {
+            m_ueState.m_dlHarqTimer[j]++;
+        }
+    }
+
+    for (uint32_t j = 0; j < m_ueState.m_ulHarqTimer.size(); j++)
+    {
+        if (!m_ueState.m_configured[j / m_ueState.m_numHarq])
+        {
+            continue;
+        }
+        if (m_ueState.m_ulHarqTimer[j] == harqTimeout)
+        { // reset HARQ process
+            NS_LOG_INFO(this << " Reset HARQ proc " << j % m_ueState.m_numHarq << " for RNTI "
+                             << m_ueState.m_rnti[j / m_ueState.m_numHarq]);
+            m_ueState.m_ulHarqStatus[j] = 0;
+            m_ueState.m_ulHarqTimer[j] = 0;
+        }
+        else
+        {
+            m_ueState.m_ulHarqTimer[j]++;
+        }
+    }
+}
+
+uint8_t
+MmWaveFlexTtiBaseMacScheduler::UpdateDlHarqProcessId(uint16_t rnti)
+{
+    NS_LOG_FUNCTION(this << rnti);
+
+    if (m_harqOn == false)
+    {
+        uint8_t tbUid = m_tbUid;
+        m_tbUid = (m_tbUid + 1) % m_phyMacConfig->GetNumHarqProcess();
+        return tbUid;
+    }
+
+    uint32_t slot = m_ueState.FindConfigured(rnti);
+    if (slot == UeStateTable::NO_SLOT)
+    {
+        NS_FATAL_ERROR("No Process Id Statusfound for this RNTI " << rnti);
+    }
+    uint8_t* status = &m_ueState.m_dlHarqStatus[slot * m_ueState.m_numHarq];
+
+    // search for available process ID, if none available return numHarqProcess
+    uint8_t harqId = m_phyMacConfig->GetNumHarqProcess();
+    for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess(); i++)
+    {
+        if (status[i] == 0)
+        {
+            status[i] = 1;
+            harqId = i;
+            break;
+        }
+    }
+    return harqId;
+}
+
+uint8_t
+MmWaveFlexTtiBaseMacScheduler::UpdateUlHarqProcessId(uint16_t rnti)
+{
+    NS_LOG_FUNCTION(this << rnti);
+
+    if (m_harqOn == false)
+    {
+        uint8_t tbUid = m_tbUid;
+        m_tbUid = (m_tbUid + 1) % m_phyMacConfig->GetNumHarqProcess();
+        return tbUid;
+    }
+
+    uint32_t slot = m_ueState.FindConfigured(rnti);
+    if (slot == UeStateTable::NO_SLOT)
+    {
+        NS_FATAL_ERROR("No Process Id Statusfound for this RNTI " << rnti);
+    }
+    uint8_t* status = &m_ueState.m_ulHarqStatus[slot * m_ueState.m_numHarq];
+
+    // search for available process ID, if none available return numHarqProcess
+    uint8_t harqId = m_phyMacConfig->GetNumHarqProcess();
+    for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess(); i++)
+    {
+        if (status[i] == 0)
+        {
+            status[i] = 1;
+            harqId = i;
+            break;
+        }
+    }
+    return harqId;
+}
+
+std::vector<RlcPduInfo>*
+MmWaveFlexTtiBaseMacScheduler::SaveDlHarqDci(const DciInfoElementTdma& dci)
+{
+    if (m_harqOn == false)
+    {
+        return nullptr;
+    }
+    uint32_t slot = m_ueState.FindConfigured(dci.m_rnti);
+    if (slot == UeStateTable::NO_SLOT)
+    {
+        NS_FATAL_ERROR("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << dci.m_rnti);
+    }
+    NS_ASSERT(dci.m_harqProcess < m_ueState.m_numHarq);
+    uint32_t harqIdx = slot * m_ueState.m_numHarq + dci.m_harqProcess;
+    m_ueState.m_dlHarqDci[harqIdx] = dci;
+    // refresh timer
+    m_ueState.m_dlHarqTimer[harqIdx] = 0;
+    return &m_ueState.m_dlHarqRlcPdu[harqIdx];
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::SaveUlHarqDci(const DciInfoElementTdma& dci)
+{
+    if (m_harqOn == false)
+    {
+        return;
+    }
+    uint32_t slot = m_ueState.FindConfigured(dci.m_rnti);
+    if (slot == UeStateTable::NO_SLOT)
+    {
+        NS_FATAL_ERROR("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << dci.m_rnti);
+    }
+    NS_ASSERT(dci.m_harqProcess < m_ueState.m_numHarq);
+    uint32_t harqIdx = slot * m_ueState.m_numHarq + dci.m_harqProcess;
+    m_ueState.m_ulHarqDci[harqIdx] = dci;
+    // Update HARQ process status (RV 0)
+    NS_ASSERT(m_ueState.m_ulHarqStatus[harqIdx] > 0);
+    // refresh timer
+    m_ueState.m_ulHarqTimer[harqIdx] = 0;
+}
+
+uint8_t
+MmWaveFlexTtiBaseMacScheduler::GetDlCqi(uint16_t rnti) const
+{
+    uint32_t slot = m_ueState.Find(rnti);
+    if (slot != UeStateTable::NO_SLOT && m_ueState.m_dlCqiValid[slot])
+    {
+        return m_ueState.m_dlCqi[slot];
+    }
+    NS_LOG_INFO(this << " UE " << rnti << " does not have DL-CQI");
+    return 1; // lowest value for trying a transmission
+}
+
+uint8_t
+MmWaveFlexTtiBaseMacScheduler::GetUlCqi(uint16_t rnti, uint8_t& mcs) const
+{
+    mcs = 0;
+    uint32_t slot = m_ueState.Find(rnti);
+    if (slot == UeStateTable::NO_SLOT || !m_ueState.m_ulCqiValid[slot])
+    {
+        NS_LOG_INFO(this << " UE " << rnti << " does not have UL-CQI");
+        return 1;
+    }
+    // translate vector of doubles to SpectrumValue's
+    SpectrumValue specVals(MmWaveSpectrumValueHelper::GetSpectrumModel(m_phyMacConfig));
+    NS_ASSERT(specVals.GetValuesN() == m_ueState.m_numRb);
+    const double* sinr = &m_ueState.m_ulSinr[slot * m_ueState.m_numRb];
+    std::copy(sinr, sinr + m_ueState.m_numRb, specVals.ValuesBegin()); // sinrLin
+    // for UL CQI, we need to know the TB size previously allocated to accurately compute
+    // CQI/MCS
+    return m_amc->CreateCqiFeedbackWbTdma(specVals, mcs);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::UpdateDlCqi(UeSchedInfo* ueInfo)
+{
+    ueInfo->m_dlCqi = GetDlCqi(ueInfo->m_rnti);
+    if (ueInfo->m_dlCqi != 0)
+    {
+        ueInfo->m_dlMcs = m_amc->GetMcsFromCqi(ueInfo->m_dlCqi);
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::UpdateUlCqi(UeSchedInfo* ueInfo)
+{
+    uint8_t mcs = 0;
+    ueInfo->m_ulCqi = GetUlCqi(ueInfo->m_rnti, mcs);
+    if (ueInfo->m_ulCqi != 0)
+    {
+        ueInfo->m_ulMcs = mcs;
+    }
+}
+
+bool
+MmWaveFlexTtiBaseMacScheduler::UpdateUeBuffers(UeSchedInfo* ueInfo,
+                                               uint32_t hdrSize,
+                                               std::map<uint16_t, UeSchedInfo*>& ueAllocMap)
+{
+    NS_LOG_FUNCTION(this << ueInfo->m_rnti);
+
+    double slotPeriod = m_phyMacConfig->GetSlotPeriod().GetSeconds();
+    bool added = false;
+
+    // get DL-CQI and compute DL rate per symbol
+    UpdateDlCqi(ueInfo);
+    if (ueInfo->m_dlCqi != 0)
+    {
+        for (unsigned iflow = 0; iflow < ueInfo->m_flowStatsDl.size(); iflow++)
+        {
+            if (ueInfo->m_flowStatsDl[iflow].m_totalBufSize > 0)
+            {
+                RlcPduInfo newRlcEl;
+                newRlcEl.m_lcid = ueInfo->m_flowStatsDl[iflow].m_lcid;
+                newRlcEl.m_size = ueInfo->m_flowStatsDl[iflow].m_totalBufSize + hdrSize;
+                ueInfo->m_rlcPduInfo.push_back(newRlcEl);
+                ueInfo->m_totBufDl += newRlcEl.m_size;
+            }
+        }
+        if (ueInfo->m_totBufDl > 0)
+        {
+            uint32_t tbSizeMax = m_amc->CalculateTbSize(ueInfo->m_dlMcs, 1) * 8; // Bytes -> Bits
+            ueInfo->m_currTputDl = std::min(ueInfo->m_totBufDl, tbSizeMax) / slotPeriod;
+            added = true;
+        }
+    }
+
+    // get UL-CQI and compute UL rate per symbol, only if the UE has UL data
+    uint32_t ulBuf = 0;
+    for (unsigned iflow = 0; iflow < ueInfo->m_flowStatsUl.size(); iflow++)
+    {
+        if (ueInfo->m_flowStatsUl[iflow].m_totalBufSize > 0)
+        {
+            ulBuf += ueInfo->m_flowStatsUl[iflow].m_totalBufSize + hdrSize;
+        }
+    }
+    if (ulBuf > 0)
+    {
+        UpdateUlCqi(ueInfo);
+        if (ueInfo->m_ulCqi != 0)
+        {
+            ueInfo->m_totBufUl += ulBuf;
+            uint32_t tbSizeMax = m_amc->CalculateTbSize(ueInfo->m_ulMcs, 1) * 8; // Bytes -> Bits
+            ueInfo->m_currTputUl = std::min(ueInfo->m_totBufUl, tbSizeMax) / slotPeriod;
+            added = true;
+        }
+    }
+
+    if (added)
+    {
+        ueAllocMap.insert(std::pair<uint16_t, UeSchedInfo*>(ueInfo->m_rnti, ueInfo));
+    }
+    return added;
+}
+
+bool
+MmWaveFlexTtiBaseMacScheduler::AllocateSymbol(UeSchedInfo* ueInfo)
+{
+    if (ueInfo->m_totBufDl == 0)
+    {
+        ueInfo->m_dlAllocDone = true;
+    }
+    if (ueInfo->m_totBufUl == 0)
+    {
+        ueInfo->m_ulAllocDone = true;
+    }
+
+    // evenly distribute symbols between DL and UL flows of same UE
+    double slotPeriod = m_phyMacConfig->GetSlotPeriod().GetSeconds();
+    if ((ueInfo->m_allocUlLast || ueInfo->m_dlAllocDone) && !ueInfo->m_ulAllocDone)
+    {
+        ueInfo->m_ulSymbols++;
+        ueInfo->m_ulTbSize = m_amc->CalculateTbSize(ueInfo->m_ulMcs, ueInfo->m_ulSymbols);
+        if (ueInfo->m_ulTbSize >= ueInfo->m_totBufUl)
+        {
+            ueInfo->m_ulAllocDone = true;
+            ueInfo->m_lastAvgTputUl = ueInfo->m_avgTputUl;
+        }
+        ueInfo->m_allocUlLast = true;
+
+        uint32_t tbSize = ueInfo->m_ulTbSize * 8; // Bytes -> Bits
+        ueInfo->m_currTputUl = std::min(ueInfo->m_totBufUl, tbSize) / slotPeriod;
+        ueInfo->m_avgTputUl = ((1.0 - (1.0 / m_timeWindow)) * ueInfo->m_lastAvgTputUl) +
+                              ((1.0 / m_timeWindow) * ((double)ueInfo->m_ulTbSize / slotPeriod));
+        return true;
+    }
+    else if (!ueInfo->m_dlAllocDone)
+    {
+        ueInfo->m_dlSymbols++;
+        ueInfo->m_dlTbSize = m_amc->CalculateTbSize(ueInfo->m_dlMcs, ueInfo->m_dlSymbols);
+        if (ueInfo->m_dlTbSize >= ueInfo->m_totBufDl)
+        {
+            ueInfo->m_dlAllocDone = true;
+            ueInfo->m_lastAvgTputDl = ueInfo->m_avgTputDl;
+        }
+        ueInfo->m_allocUlLast = false;
+
+        uint32_t tbSize = ueInfo->m_dlTbSize * 8; // Bytes -> Bits
+        ueInfo->m_currTputDl = std::min(ueInfo->m_totBufDl, tbSize) / slotPeriod;
+        ueInfo->m_avgTputDl = ((1.0 - (1.0 / m_timeWindow)) * ueInfo->m_lastAvgTputDl) +
+                              ((1.0 / m_timeWindow) * ((double)ueInfo->m_dlTbSize / slotPeriod));
+        return true;
+    }
+    return false;
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoAllocateSymbols(int& symAvail,
+                                                 std::map<uint16_t, UeSchedInfo*>& ueAllocMap)
+{
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DistributeDlTbSize(UeSchedInfo* ueInfo, uint32_t tbSize)
+{
+    // distribute bytes between active RLC queues
+    unsigned numLc = ueInfo->m_rlcPduInfo.size();
+    NS_ASSERT(numLc > 0);
+    unsigned bytesRem = tbSize;
+    unsigned numFulfilled = 0;
+    uint16_t avgPduSize = bytesRem / numLc;
+    // first for loop computes extra to add to average if some flows are less than average
+    for (unsigned i = 0; i < numLc; i++)
+    {
+        if (ueInfo->m_rlcPduInfo[i].m_size < avgPduSize)
+        {
+            bytesRem -= ueInfo->m_rlcPduInfo[i].m_size;
+            numFulfilled++;
+        }
+    }
+
+    if (numFulfilled < numLc)
+    {
+        avgPduSize = bytesRem / (numLc - numFulfilled);
+    }
+
+    for (unsigned i = 0; i < numLc; i++)
+    {
+        if (ueInfo->m_rlcPduInfo[i].m_size > avgPduSize)
+        {
+            ueInfo->m_rlcPduInfo[i].m_size = avgPduSize;
+        }
+        // else tbSize equals RLC queue size
+        NS_ASSERT(ueInfo->m_rlcPduInfo[i].m_size > 0);
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::SendSlotAllocation(
+    MmWaveMacSchedSapUser::SchedConfigIndParameters& ret)
+{
+    // add slot for UL control
+    TtiAllocInfo ulCtrlSlot(0xFF, TtiAllocInfo::UL_slotAllocInfo, TtiAllocInfo::CTRL, 0);
+    ulCtrlSlot.m_dci.m_numSym = 1;
+    ulCtrlSlot.m_dci.m_symStart = m_phyMacConfig->GetSymbPerSlot() - 1;
+    ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ulCtrlSlot);
+    m_macSchedSapUser->SchedConfigInd(ret);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::ResetUeAllocation(std::map<uint16_t, UeSchedInfo*>& ueAllocMap)
+{
+    for (std::map<uint16_t, UeSchedInfo*>::iterator it = ueAllocMap.begin();
+         it != ueAllocMap.end();
+         it++)
+    {
+        UeSchedInfo* ueInfo = it->second;
+        ueInfo->m_dlSymbols = 0;
+        ueInfo->m_ulSymbols = 0;
+        ueInfo->m_dlTbSize = 0;
+        ueInfo->m_ulTbSize = 0;
+        ueInfo->m_dlSymbolsRetx = 0;
+        ueInfo->m_ulSymbolsRetx = 0;
+        ueInfo->m_currTputDl = 0;
+        ueInfo->m_currTputUl = 0;
+        ueInfo->m_avgTputDl = 0;
+        ueInfo->m_avgTputUl = 0;
+        ueInfo->m_totBufDl = 0;
+        ueInfo->m_totBufUl = 0;
+        ueInfo->m_dlAllocDone = false;
+        ueInfo->m_ulAllocDone = false;
+        ueInfo->m_rlcPduInfo.clear();
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::ScheduleHarqRetx(
+    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
+    MmWaveMacSchedSapUser::SchedConfigIndParameters& ret,
+    int& symAvail,
+    uint8_t& symIdx,
+    uint8_t& ttiIdx,
+    std::map<uint16_t, std::pair<uint8_t, uint8_t>>& retxSymbols)
+{
+    NS_LOG_FUNCTION(this);
+
+    // retrieve past HARQ retx buffered
+    if (m_dlHarqInfoList.size() > 0 && params.m_dlHarqInfoList.size() > 0)
+    {
+        m_dlHarqInfoList.insert(m_dlHarqInfoList.end(),
+                                params.m_dlHarqInfoList.begin(),
+                                params.m_dlHarqInfoList.end());
+    }
+    else if (params.m_dlHarqInfoList.size() > 0)
+    {
+        m_dlHarqInfoList = params.m_dlHarqInfoList;
+    }
+    if (m_ulHarqInfoList.size() > 0 && params.m_ulHarqInfoList.size() > 0)
+    {
+        m_ulHarqInfoList.insert(m_ulHarqInfoList.end(),
+                                params.m_ulHarqInfoList.begin(),
+                                params.m_ulHarqInfoList.end());
+    }
+    else if (params.m_ulHarqInfoList.size() > 0)
+    {
+        m_ulHarqInfoList = params.m_ulHarqInfoList;
+    }
+
+    if (m_harqOn == false) // Ignore HARQ feedback
+    {
+        m_dlHarqInfoList.clear();
+        return;
+    }
+
+    // Process DL HARQ feedback and assign slots for RETX if resources available
+    std::vector<struct DlHarqInfo> dlInfoListUntxed; // TBs not able to be retransmitted in this sf
+    std::vector<struct UlHarqInfo> ulInfoListUntxed;
+
+    for (unsigned i = 0; i < m_dlHarqInfoList.size(); i++)
+    {
+        if (symAvail == 0)
+        {
+            break; // no symbols left to allocate
+        }
+        uint8_t harqId = m_dlHarqInfoList.at(i).m_harqProcessId;
+        uint16_t rnti = m_dlHarqInfoList.at(i).m_rnti;
+        uint32_t slot = m_ueState.FindConfigured(rnti);
+        if (slot == UeStateTable::NO_SLOT)
+        {
+            NS_LOG_INFO("UE " << rnti << " released, drop its DL HARQ feedback");
+            continue;
+        }
+        NS_ASSERT(harqId < m_ueState.m_numHarq);
+        uint32_t harqIdx = slot * m_ueState.m_numHarq + harqId;
+        uint8_t& harqStatus = m_ueState.m_dlHarqStatus[harqIdx];
+        std::vector<RlcPduInfo>& harqRlcPdu = m_ueState.m_dlHarqRlcPdu[harqIdx];
+        if (m_dlHarqInfoList.at(i).m_harqStatus == DlHarqInfo::ACK || harqStatus == 0)
+        { // acknowledgment or process timeout, reset process
+            harqStatus = 0;     // release process ID
+            harqRlcPdu.clear(); // clear RLC buffers
+            continue;
+        }
+        else if (m_dlHarqInfoList.at(i).m_harqStatus == DlHarqInfo::NACK)
+        {
+            DciInfoElementTdma dciInfoReTx = m_ueState.m_dlHarqDci[harqIdx];
+            NS_ASSERT(harqId == dciInfoReTx.m_harqProcess);
+            NS_ASSERT(harqStatus - 1 == dciInfoReTx.m_rv);
+            if (dciInfoReTx.m_rv == 3) // maximum number of retx reached -> drop process
+            {
+                NS_LOG_INFO("Max number of retransmissions reached -> drop process");
+                harqStatus = 0;
+                harqRlcPdu.clear();
+                continue;
+            }
+            // allocate retx if enough symbols are available
+            if (symAvail >= dciInfoReTx.m_numSym)
+            {
+                symAvail -= dciInfoReTx.m_numSym;
+                dciInfoReTx.m_symStart = symIdx;
+                symIdx += dciInfoReTx.m_numSym;
+                NS_ASSERT(symIdx <=
+                          m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetUlCtrlSymbols());
+                dciInfoReTx.m_rv++;
+                dciInfoReTx.m_ndi = 0;
+                m_ueState.m_dlHarqDci[harqIdx] = dciInfoReTx;
+                harqStatus = harqStatus + 1;
+                TtiAllocInfo ttiInfo(ttiIdx++,
+                                     TtiAllocInfo::DL_slotAllocInfo,
+                                     TtiAllocInfo::CTRL_DATA,
+                                     rnti);
+                ttiInfo.m_dci = dciInfoReTx;
+                NS_LOG_DEBUG("UE" << dciInfoReTx.m_rnti << " gets DL symbols "
+                                  << +dciInfoReTx.m_symStart << "-"
+                                  << +(dciInfoReTx.m_symStart + dciInfoReTx.m_numSym - 1)
+                                  << " tbs " << dciInfoReTx.m_tbSize << " harqId "
+                                  << +dciInfoReTx.m_harqProcess << " rv " << +dciInfoReTx.m_rv
+                                  << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
+                                  << +ret.m_sfnSf.m_sfNum << " RETX");
+                for (uint16_t k = 0; k < harqRlcPdu.size(); k++)
+                {
+                    ttiInfo.m_rlcPduInfo.push_back(harqRlcPdu.at(k));
+                }
+                ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
+                ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
+                retxSymbols[rnti].first = dciInfoReTx.m_numSym;
+            }
+            else
+            {
+                NS_LOG_INFO("No resource for this retx -> buffer it");
+                dlInfoListUntxed.push_back(m_dlHarqInfoList.at(i));
+            }
+        }
+    }
+
+    m_dlHarqInfoList.clear();
+    m_dlHarqInfoList = dlInfoListUntxed;
+
+    // Process UL HARQ feedback
+    for (uint16_t i = 0; i < m_ulHarqInfoList.size(); i++)
+    {
+        if (symAvail == 0)
+        {
+            break; // no symbols left to allocate
+        }
+        UlHarqInfo harqInfo = m_ulHarqInfoList.at(i);
+        uint8_t harqId = harqInfo.m_harqProcessId;
+        uint16_t rnti = harqInfo.m_rnti;
+        uint32_t slot = m_ueState.FindConfigured(rnti);
+        if (slot == UeStateTable::NO_SLOT)
+        {
+            NS_LOG_INFO("UE " << rnti << " released, drop its UL HARQ feedback");
+            continue;
+        }
+        NS_ASSERT(harqId < m_ueState.m_numHarq);
+        uint32_t harqIdx = slot * m_ueState.m_numHarq + harqId;
+        uint8_t& harqStatus = m_ueState.m_ulHarqStatus[harqIdx];
+        if (harqInfo.m_receptionStatus == UlHarqInfo::Ok || harqStatus == 0)
+        {
+            harqStatus = 0; // release process ID
+        }
+        else if (harqInfo.m_receptionStatus == UlHarqInfo::NotOk)
+        {
+            // retx correspondent block: retrieve the UL-DCI
+            DciInfoElementTdma dciInfoReTx = m_ueState.m_ulHarqDci[harqIdx];
+            NS_ASSERT(harqId == dciInfoReTx.m_harqProcess);
+            NS_ASSERT(harqStatus > 0);
+            NS_ASSERT(harqStatus - 1 == dciInfoReTx.m_rv);
+            if (dciInfoReTx.m_rv == 3)
+            {
+                NS_LOG_INFO("Max number of retransmissions reached (UL)-> drop process");
+                harqStatus = 0;
+                continue;
+            }
+
+            if (symAvail >= dciInfoReTx.m_numSym)
+            {
+                symAvail -= dciInfoReTx.m_numSym;
+                dciInfoReTx.m_symStart = symIdx;
+                symIdx += dciInfoReTx.m_numSym;
+                NS_ASSERT(symIdx <=
+                          m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetUlCtrlSymbols());
+                dciInfoReTx.m_rv++;
+                dciInfoReTx.m_ndi = 0;
+                harqStatus = harqStatus + 1;
+                m_ueState.m_ulHarqDci[harqIdx] = dciInfoReTx;
+                TtiAllocInfo ttiInfo(ttiIdx++,
+                                     TtiAllocInfo::UL_slotAllocInfo,
+                                     TtiAllocInfo::CTRL_DATA,
+                                     rnti);
+                ttiInfo.m_dci = dciInfoReTx;
+                NS_LOG_DEBUG("UE" << dciInfoReTx.m_rnti << " gets UL symbols "
+                                  << +dciInfoReTx.m_symStart << "-"
+                                  << +(dciInfoReTx.m_symStart + dciInfoReTx.m_numSym - 1)
+                                  << " tbs " << dciInfoReTx.m_tbSize << " harqId "
+                                  << +dciInfoReTx.m_harqProcess << " rv " << +dciInfoReTx.m_rv
+                                  << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
+                                  << +ret.m_sfnSf.m_sfNum << " slot " << +ret.m_sfnSf.m_slotNum
+                                  << " RETX");
+                ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
+                ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
+                retxSymbols[rnti].second = dciInfoReTx.m_numSym;
+            }
+            else
+            {
+                ulInfoListUntxed.push_back(m_ulHarqInfoList.at(i));
+            }
+        }
+    }
+
+    m_ulHarqInfoList.clear();
+    m_ulHarqInfoList = ulInfoListUntxed;
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoSchedTriggerReq(
+    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+    uint32_t frameNum = params.m_snfSf.m_frameNum;
+    uint8_t sfNum = params.m_snfSf.m_sfNum;
+    uint8_t slotNum = params.m_snfSf.m_slotNum;
+
+    MmWaveMacSchedSapUser::SchedConfigIndParameters ret;
+    ret.m_sfnSf = params.m_snfSf;
+    ret.m_slotAllocInfo.m_sfnSf = ret.m_sfnSf;
+
+    NS_LOG_DEBUG("Creating scheduling allocation info for: frame "
+                 << frameNum << " subframe " << +sfNum << " slot " << +slotNum);
+
+    // Add TTI for DL control at the beginning of the slot
+    TtiAllocInfo dlCtrlSlot(0, TtiAllocInfo::DL_slotAllocInfo, TtiAllocInfo::CTRL, 0);
+    dlCtrlSlot.m_dci.m_numSym = 1;
+    dlCtrlSlot.m_dci.m_symStart = 0;
+    ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(dlCtrlSlot);
+    int resvCtrl = m_phyMacConfig->GetDlCtrlSymbols() + m_phyMacConfig->GetUlCtrlSymbols();
+    int symAvail = m_phyMacConfig->GetSymbPerSlot() - resvCtrl;
+    uint8_t ttiIdx = 1;
+    uint8_t symIdx =
+        m_phyMacConfig->GetDlCtrlSymbols(); // symbols reserved for control at beginning of subframe
+
+    // process received CQIs
+    RefreshDlCqiMaps();
+    RefreshUlCqiMaps();
+
+    // Process DL HARQ feedback
+    RefreshHarqProcesses();
+
+    std::map<uint16_t, UeSchedInfo*> ueAllocMap; // map of allocated users for this SF
+    std::map<uint16_t, UeSchedInfo*>::iterator itUeAllocMap;
+
+    std::map<uint16_t, std::pair<uint8_t, uint8_t>> retxSymbols;
+    ScheduleHarqRetx(params, ret, symAvail, symIdx, ttiIdx, retxSymbols);
+    for (std::map<uint16_t, std::pair<uint8_t, uint8_t>>::iterator itRetx = retxSymbols.begin();
+         itRetx != retxSymbols.end();
+         itRetx++)
+    {
+        std::map<uint16_t, UeSchedInfo>::iterator itUeSchedInfoMap =
+            m_ueSchedInfoMap.find(itRetx->first);
+        NS_ASSERT(itUeSchedInfoMap != m_ueSchedInfoMap.end());
+        itUeSchedInfoMap->second.m_dlSymbolsRetx = itRetx->second.first;
+        itUeSchedInfoMap->second.m_ulSymbolsRetx = itRetx->second.second;
+        ueAllocMap.insert(
+            std::pair<uint16_t, UeSchedInfo*>(itRetx->first, &itUeSchedInfoMap->second));
+    }
+
+    // no further allocations
+    if (symAvail == 0)
+    {
+        SendSlotAllocation(ret);
+        // only the retransmissions were allocated
+        for (itUeAllocMap = ueAllocMap.begin(); itUeAllocMap != ueAllocMap.end(); itUeAllocMap++)
+        {
+            itUeAllocMap->second->m_dlSymbolsRetx = 0;
+            itUeAllocMap->second->m_ulSymbolsRetx = 0;
+        }
+        return;
+    }
+
+    // ********************* END OF HARQ SECTION, START OF NEW DATA SCHEDULING *********************
+    // //
+
+    DoAllocateSymbols(symAvail, ueAllocMap);
+
+    // no further allocations
+    if (ueAllocMap.size() == 0)
+    {
+        SendSlotAllocation(ret);
+        return;
+    }
+
+    // iterate through map of allocated UEs, assign TDMA symbol indices and create DCIs
+    for (itUeAllocMap = ueAllocMap.begin(); itUeAllocMap != ueAllocMap.end(); itUeAllocMap++)
+    {
+        UeSchedInfo* ueInfo = itUeAllocMap->second;
+        if (ueInfo->m_dlSymbols > 0)
+        {
+            DciInfoElementTdma dci;
+            dci.m_rnti = ueInfo->m_rnti;
+            dci.m_format = 0;
+            dci.m_symStart = symIdx;
+            dci.m_numSym = ueInfo->m_dlSymbols;
+            symIdx += ueInfo->m_dlSymbols;
+            NS_ASSERT(symIdx <=
+                      m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetUlCtrlSymbols());
+            dci.m_mcs = ueInfo->m_dlMcs;
+            dci.m_rv = 0;
+            dci.m_ndi = 1;
+            dci.m_tbSize = m_amc->CalculateTbSize(dci.m_mcs, dci.m_numSym);
+            dci.m_harqProcess = UpdateDlHarqProcessId(ueInfo->m_rnti);
+            NS_ASSERT(dci.m_harqProcess < m_phyMacConfig->GetNumHarqProcess());
+            TtiAllocInfo ttiInfo(ttiIdx++,
+                                 TtiAllocInfo::DL_slotAllocInfo,
+                                 TtiAllocInfo::CTRL_DATA,
+                                 ueInfo->m_rnti);
+            ttiInfo.m_dci = dci;
+            NS_LOG_DEBUG("UE" << dci.m_rnti << " gets DL symbols " << +dci.m_symStart << "-"
+                              << +(dci.m_symStart + dci.m_numSym - 1) << " tbs " << dci.m_tbSize
+                              << " mcs " << +dci.m_mcs << " harqId " << +dci.m_harqProcess << " rv "
+                              << +dci.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
+                              << +ret.m_sfnSf.m_sfNum);
+
+            // store DCI for HARQ buffer
+            std::vector<RlcPduInfo>* harqRlcPdu = SaveDlHarqDci(dci);
+
+            DistributeDlTbSize(ueInfo, dci.m_tbSize);
+            for (unsigned i = 0; i < ueInfo->m_rlcPduInfo.size(); i++)
+            {
+                ttiInfo.m_rlcPduInfo.push_back(ueInfo->m_rlcPduInfo[i]);
+                if (harqRlcPdu)
+                {
+                    // store RLC PDU list for HARQ
+                    harqRlcPdu->push_back(ueInfo->m_rlcPduInfo[i]);
+                }
+            }
+
+            if (m_harqOn == true)
+            {
+                // reorder/reindex slots to maintain DL before UL slot order
+                bool reordered = false;
+                std::deque<TtiAllocInfo>::iterator itTti =
+                    ret.m_slotAllocInfo.m_ttiAllocInfo.begin();
+                for (unsigned iTti = 0; iTti < ret.m_slotAllocInfo.m_ttiAllocInfo.size(); iTti++)
+                {
+                    if (ret.m_slotAllocInfo.m_ttiAllocInfo[iTti].m_tddMode ==
+                        TtiAllocInfo::UL_slotAllocInfo)
+                    {
+                        ttiInfo.m_ttiIdx = ret.m_slotAllocInfo.m_ttiAllocInfo[iTti].m_ttiIdx;
+                        ttiInfo.m_dci.m_symStart =
+                            ret.m_slotAllocInfo.m_ttiAllocInfo[iTti].m_dci.m_symStart;
+                        ret.m_slotAllocInfo.m_ttiAllocInfo.insert(itTti, ttiInfo);
+                        for (unsigned jTti = iTti + 1;
+                             jTti < ret.m_slotAllocInfo.m_ttiAllocInfo.size();
+                             jTti++)
+                        {
+                            ret.m_slotAllocInfo.m_ttiAllocInfo[jTti]
+                                .m_ttiIdx++; // increase indices of UL slots
+                            ret.m_slotAllocInfo.m_ttiAllocInfo[jTti].m_dci.m_symStart =
+                                ret.m_slotAllocInfo.m_ttiAllocInfo[jTti - 1].m_dci.m_symStart +
+                                ret.m_slotAllocInfo.m_ttiAllocInfo[jTti - 1].m_dci.m_numSym;
+                        }
+                        reordered = true;
+                        break;
+                    }
+                    itTti++;
+                }
+                if (!reordered)
+                {
+                    ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
+                }
+            }
+            else
+            {
+                ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
+            }
+            ret.m_slotAllocInfo.m_numSymAlloc += dci.m_numSym;
+        }
+    }
+    ttiIdx = ret.m_slotAllocInfo.m_ttiAllocInfo.back().m_ttiIdx + 1;
+    symIdx = ret.m_slotAllocInfo.m_ttiAllocInfo.back().m_dci.m_symStart +
+             ret.m_slotAllocInfo.m_ttiAllocInfo.back().m_dci.m_numSym;
+
+    for (itUeAllocMap = ueAllocMap.begin(); itUeAllocMap != ueAllocMap.end(); itUeAllocMap++)
+    {
+        UeSchedInfo* ueInfo = itUeAllocMap->second;
+        // Note: UL-DCI applies to subframe i+Tsched
+        if (ueInfo->m_ulSymbols > 0)
+        {
+            DciInfoElementTdma dci;
+            dci.m_rnti = ueInfo->m_rnti;
+            dci.m_format = 1;
+            dci.m_symStart = symIdx;
+            dci.m_numSym = ueInfo->m_ulSymbols;
+            symIdx += ueInfo->m_ulSymbols;
+            NS_ASSERT(symIdx <=
+                      m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetUlCtrlSymbols());
+            dci.m_mcs = ueInfo->m_ulMcs;
+            dci.m_ndi = 1;
+            dci.m_tbSize = m_amc->CalculateTbSize(dci.m_mcs, dci.m_numSym);
+            dci.m_harqProcess = UpdateUlHarqProcessId(ueInfo->m_rnti);
+            NS_ASSERT(dci.m_harqProcess < m_phyMacConfig->GetNumHarqProcess());
+            TtiAllocInfo ttiInfo(ttiIdx++,
+                                 TtiAllocInfo::UL_slotAllocInfo,
+                                 TtiAllocInfo::CTRL_DATA,
+                                 ueInfo->m_rnti);
+            ttiInfo.m_dci = dci;
+            NS_LOG_DEBUG("UE" << dci.m_rnti << " gets UL symbols " << +dci.m_symStart << "-"
+                              << +(dci.m_symStart + dci.m_numSym - 1) << " tbs " << dci.m_tbSize
+                              << " mcs " << +dci.m_mcs << " harqId " << +dci.m_harqProcess << " rv "
+                              << +dci.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
+                              << +ret.m_sfnSf.m_sfNum);
+            ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
+            ret.m_slotAllocInfo.m_numSymAlloc += dci.m_numSym;
+            std::vector<uint16_t> ueChunkMap(m_phyMacConfig->GetNumRb(), dci.m_rnti);
+            SfnSf slotSfn = ret.m_slotAllocInfo.m_sfnSf;
+            slotSfn.m_slotNum =
+                dci.m_symStart; // use the start symbol index of the slot because the absolute UL
+                                // slot index depends on the future DL allocation
+            // insert into allocation map to recall previous allocations upon receiving UL-CQI
+            m_ulAllocationMap.insert(std::pair<uint32_t, struct AllocMapElem>(
+                slotSfn.Encode(),
+                AllocMapElem(ueChunkMap, dci.m_numSym, dci.m_tbSize)));
+
+            SaveUlHarqDci(dci);
+        }
+    }
+
+    ResetUeAllocation(ueAllocMap);
+    SendSlotAllocation(ret);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::RefreshDlCqiMaps(void)
+{
+    NS_LOG_FUNCTION(this << m_ueState.GetSize());
+    // refresh DL CQI P01 Map
+    // backwards, since freeing a slot moves the last one into it
+    for (uint32_t slot = m_ueState.GetSize(); slot-- > 0;)
+    {
+        if (!m_ueState.m_dlCqiValid[slot])
+        {
+            continue;
+        }
+        NS_LOG_INFO(this << " P10-CQI for user " << m_ueState.m_rnti[slot] << " is "
+                         << m_ueState.m_dlCqiTimer[slot] << " thr "
+                         << (uint32_t)m_cqiTimersThreshold);
+        if (m_ueState.m_dlCqiTimer[slot] == 0)
+        {
+            // invalidate correspondent entries
+            NS_LOG_INFO(this << " P10-CQI exired for user " << m_ueState.m_rnti[slot]);
+            m_ueState.m_dlCqiValid[slot] = 0;
+            m_ueState.RemoveIfUnused(slot);
+        }
+        else
+        {
+            m_ueState.m_dlCqiTimer[slot]--;
+        }
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::RefreshUlCqiMaps(void)
+{
+    // refresh UL CQI  Map
+    // backwards, since freeing a slot moves the last one into it
+    for (uint32_t slot = m_ueState.GetSize(); slot-- > 0;)
+    {
+        if (!m_ueState.m_ulCqiValid[slot])
+        {
+            continue;
+        }
+        NS_LOG_INFO(this << " UL-CQI for user " << m_ueState.m_rnti[slot] << " is "
+                         << m_ueState.m_ulCqiTimer[slot] << " thr "
+                         << (uint32_t)m_cqiTimersThreshold);
+        if (m_ueState.m_ulCqiTimer[slot] == 0)
+        {
+            // invalidate correspondent entries
+            NS_LOG_INFO(this << " UL-CQI expired for user " << m_ueState.m_rnti[slot]);
+            m_ueState.m_ulCqiValid[slot] = 0;
+            m_ueState.RemoveIfUnused(slot);
+        }
+        else
+        {
+            m_ueState.m_ulCqiTimer[slot]--;
+        }
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoCschedCellConfigReq(
+    const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
+{
+    NS_LOG_FUNCTION(this);
+    // Read the subset of parameters used
+    m_cschedCellConfig = params;
+    MmWaveMacCschedSapUser::CschedUeConfigCnfParameters cnf;
+    cnf.m_result = SUCCESS;
+    m_macCschedSapUser->CschedUeConfigCnf(cnf);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoCschedUeConfigReq(
+    const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
+{
+    NS_LOG_FUNCTION(this << " RNTI " << params.m_rnti << " txMode "
+                         << (uint16_t)params.m_transmissionMode);
+
+    std::map<uint16_t, struct UeSchedInfo>::iterator itUe = m_ueSchedInfoMap.find(params.m_rnti);
+    if (itUe == m_ueSchedInfoMap.end())
+    {
+        itUe = m_ueSchedInfoMap
+                   .insert(std::pair<uint16_t, struct UeSchedInfo>(params.m_rnti,
+                                                                   UeSchedInfo(params.m_rnti)))
+                   .first;
+        for (unsigned i = 0; i <= 3; i++)
+        {
+            itUe->second.m_flowStatsDl.push_back(FlowStats(false, &(itUe->second), i));
+            itUe->second.m_flowStatsUl.push_back(FlowStats(true, &(itUe->second), i));
+        }
+    }
+
+    // create the HARQ processes of the UE, if not already present
+    m_ueState.AddHarqProcesses(params.m_rnti);
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoCschedLcConfigReq(
+    const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+    NS_LOG_FUNCTION(this);
+    std::map<uint16_t, struct UeSchedInfo>::iterator itUe = m_ueSchedInfoMap.find(params.m_rnti);
+    if (itUe == m_ueSchedInfoMap.end())
+    {
+        NS_LOG_ERROR("Cannot find UE info entry");
+        return;
+    }
+
+    EpsBearer lowLatBearer(EpsBearer::NGBR_LOW_LAT_EMBB_AR);
+    for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size(); i++)
+    {
+        const LogicalChannelConfigListElement_s& lcConfig = params.m_logicalChannelConfigList[i];
+        if (lcConfig.m_direction == LogicalChannelConfigListElement_s::DIR_DL)
+        {
+            uint8_t lcid = lcConfig.m_logicalChannelIdentity;
+            for (unsigned j = itUe->second.m_flowStatsDl.size(); j <= lcid; j++)
+            {
+                itUe->second.m_flowStatsDl.push_back(FlowStats(false, &(itUe->second), j));
+            }
+            itUe->second.m_flowStatsDl[lcid].m_qci = lcConfig.m_qci;
+            if (lcConfig.m_qci == EpsBearer::NGBR_LOW_LAT_EMBB_AR)
+            {
+                itUe->second.m_flowStatsDl[lcid].m_deadlineUs =
+                    lowLatBearer.GetPacketDelayBudgetMs() * 1000;
+            }
+        }
+        else if (lcConfig.m_direction == LogicalChannelConfigListElement_s::DIR_UL)
+        {
+            uint8_t lcid = lcConfig.m_logicalChannelGroup; // use LCG ID instead of LCID
+            for (unsigned j = itUe->second.m_flowStatsUl.size(); j <= lcid; j++)
+            {
+                itUe->second.m_flowStatsUl.push_back(FlowStats(true, &(itUe->second), j));
+            }
+            itUe->second.m_flowStatsUl[lcid].m_qci = lcConfig.m_qci;
+            if (lcConfig.m_qci == EpsBearer::NGBR_LOW_LAT_EMBB_AR)
+            {
+                itUe->second.m_flowStatsUl[lcid].m_deadlineUs =
+                    lowLatBearer.GetPacketDelayBudgetMs() * 1000;
+            }
+        }
+        else if (lcConfig.m_direction == LogicalChannelConfigListElement_s::DIR_BOTH)
+        {
+            uint8_t lcid = lcConfig.m_logicalChannelIdentity;
+            for (unsigned j = itUe->second.m_flowStatsDl.size(); j <= lcid; j++)
+            {
+                itUe->second.m_flowStatsDl.push_back(FlowStats(false, &(itUe->second), j));
+                itUe->second.m_flowStatsUl.push_back(FlowStats(true, &(itUe->second), j));
+            }
+            itUe->second.m_flowStatsDl[lcid].m_qci = lcConfig.m_qci;
+            itUe->second.m_flowStatsUl[lcid].m_qci = lcConfig.m_qci;
+            // bidirectional bearers always get the budget of the low latency bearer
+            itUe->second.m_flowStatsDl[lcid].m_deadlineUs =
+                lowLatBearer.GetPacketDelayBudgetMs() * 1000;
+            itUe->second.m_flowStatsUl[lcid].m_deadlineUs =
+                lowLatBearer.GetPacketDelayBudgetMs() * 1000;
+        }
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoCschedLcReleaseReq(
+    const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+{
+    NS_LOG_FUNCTION(this);
+    std::map<uint16_t, struct UeSchedInfo>::iterator itUe = m_ueSchedInfoMap.find(params.m_rnti);
+    if (itUe == m_ueSchedInfoMap.end())
+    {
+        return;
+    }
+    // drop the buffered data of the DL flows
+    for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size(); i++)
+    {
+        uint8_t lcid = params.m_logicalChannelIdentity.at(i);
+        if (lcid < itUe->second.m_flowStatsDl.size())
+        {
+            itUe->second.m_flowStatsDl[lcid] = FlowStats(false, &itUe->second, lcid);
+        }
+    }
+}
+
+void
+MmWaveFlexTtiBaseMacScheduler::DoCschedUeReleaseReq(
+    const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
+{
+    NS_LOG_FUNCTION(this << " Release RNTI " << params.m_rnti);
+
+    m_ueState.RemoveHarqProcesses(params.m_rnti);
+    m_ueSchedInfoMap.erase(params.m_rnti);
+
+    // drop the pending HARQ feedback of the UE
+    std::vector<struct DlHarqInfo>::iterator itDlHarq = m_dlHarqInfoList.begin();
+    while (itDlHarq != m_dlHarqInfoList.end())
+    {
+        if (itDlHarq->m_rnti == params.m_rnti)
+        {
+            itDlHarq = m_dlHarqInfoList.erase(itDlHarq);
+        }
+        else
+        {
+            itDlHarq++;
+        }
+    }
+    std::vector<struct UlHarqInfo>::iterator itUlHarq = m_ulHarqInfoList.begin();
+    while (itUlHarq != m_ulHarqInfoList.end())
+    {
+        if (itUlHarq->m_rnti == params.m_rnti)
+        {
+            itUlHarq = m_ulHarqInfoList.erase(itUlHarq);
+        }
+        else
+        {
+            itUlHarq++;
+        }
+    }
+}
+
+} // namespace mmwave
+
+} // namespace ns3
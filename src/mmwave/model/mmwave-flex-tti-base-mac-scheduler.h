@@ -0,0 +1,574 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *   Author: Sourjya Dutta <sdutta@nyu.edu>
+ *           Russell Ford <russell.ford@nyu.edu>
+ */
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_BASE_MAC_SCHEDULER_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_BASE_MAC_SCHEDULER_H_
+
+#include "mmwave-amc.h"
+#include "mmwave-mac-csched-sap.h"
+#include "mmwave-mac-sched-sap.h"
+#include "mmwave-mac-scheduler.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * \ingroup mmwave
+ * \brief Common engine of the Flex-TTI schedulers
+ *
+ * This class implements everything the Flex-TTI schedulers have in common: the
+ * CSCHED/SCHED SAPs, the CQI reports, the HARQ processes and retransmissions, and
+ * the bookkeeping of the DL RLC buffer reports and UL BSRs in per-flow statistics.
+ *
+ * The MaxRate, PF and MaxWeight schedulers only decide how the symbols left after
+ * the HARQ retransmissions are shared among the UEs, by implementing
+ * DoAllocateSymbols; the DCIs are then created by DoSchedTriggerReq. Schedulers
+ * which share the symbols among the UEs rather than among the flows can rely on
+ * UpdateUeBuffers, to collect the buffered data of a UE, and on AllocateSymbol, to
+ * give one more symbol to a UE.
+ *
+ * The round robin scheduler, which builds the whole slot by itself, overrides
+ * DoSchedTriggerReq and the buffer reports instead, and reuses ScheduleHarqRetx,
+ * the CQI getters and the HARQ process management.
+ */
+class MmWaveFlexTtiBaseMacScheduler : public MmWaveMacScheduler
+{
+  public:
+    MmWaveFlexTtiBaseMacScheduler();
+
+    virtual ~MmWaveFlexTtiBaseMacScheduler();
+    virtual void DoDispose(void) override;
+    static TypeId GetTypeId(void);
+
+    virtual void SetMacSchedSapUser(MmWaveMacSchedSapUser* sap) override;
+    virtual void SetMacCschedSapUser(MmWaveMacCschedSapUser* s) override;
+
+    virtual MmWaveMacSchedSapProvider* GetMacSchedSapProvider() override;
+    virtual MmWaveMacCschedSapProvider* GetMacCschedSapProvider() override;
+
+    virtual void ConfigureCommonParameters(Ptr<MmWavePhyMacCommon> config) override;
+
+    void RefreshDlCqiMaps(void);
+    void RefreshUlCqiMaps(void);
+
+    friend class MmWaveFlexTtiBaseMacSchedSapProvider;
+    friend class MmWaveFlexTtiBaseMacCschedSapProvider;
+
+  protected:
+    struct UeSchedInfo;
+
+    struct FlowStats
+    {
+        FlowStats(bool uplink, UeSchedInfo* ueSchedInfo, uint8_t lcid)
+            : m_isUplink(uplink),
+              m_ueSchedInfo(ueSchedInfo),
+              m_lcid(lcid),
+              m_arrivalRate(0.0),
+              m_grantedRate(0.0),
+              m_qci(0),
+              m_txQueueHolDelay(0),
+              m_reTxQueueHolDelay(0),
+              m_probErr(0.0),
+              m_deadlineUs(0),
+              m_totalBufSize(0),
+              m_totalSchedSize(0)
+        {
+            NS_ASSERT(ueSchedInfo != 0);
+        }
+
+        bool m_isUplink;            // is uplink?
+        UeSchedInfo* m_ueSchedInfo; // pointer to parent UE Info
+        uint8_t m_lcid;             // LCID (for DL) or LC Group ID (for UL)
+        double m_arrivalRate;       // Mbps
+        double m_grantedRate;       // Mbps
+        uint8_t m_qci;              // We interpret QCI 69 as delay critical
+        double m_txQueueHolDelay;
+        uint32_t m_reTxQueueHolDelay;
+        double m_probErr; // expected probability of each HARQ TX/reTX failure (i.e. 1/E[num TX to
+                          // success])
+        double m_deadlineUs;                 // relative deadline
+        std::list<uint32_t> m_txPacketSizes; // estimated packet sizes from consecutive BSRs
+        uint32_t m_totalBufSize;
+        std::list<uint32_t> m_retxPacketSizes;
+        std::list<double> m_txPacketDelays; // estimated delays for each packet
+        std::list<double> m_retxPacketDelays;
+
+        // We maintain a queue of PDU sizes scheduled in the last M subframes.
+        // M = delay between scheduling and transmission (default DL = 1, UL = 2)
+        // The sum of these M elements is subtracted from the BSR to account for
+        // data that has been scheduled but not yet extracted from the DL or UL queue.
+        std::list<uint32_t> m_schedPacketSizes;
+        uint32_t m_totalSchedSize; // total of last M elements in list
+    };
+
+    struct UeSchedInfo
+    {
+        UeSchedInfo(uint16_t rnti = 0)
+            : m_rnti(rnti),
+              m_dlMcs(0),
+              m_ulMcs(0),
+              m_dlCqi(0),
+              m_ulCqi(0),
+              m_dlSymbols(0),
+              m_ulSymbols(0),
+              m_dlSymbolsRetx(0),
+              m_ulSymbolsRetx(0),
+              m_dlTbSize(0),
+              m_ulTbSize(0),
+              m_dlAllocDone(false),
+              m_ulAllocDone(false),
+              m_avgTputDl(0.0),
+              m_avgTputUl(0.0),
+              m_lastAvgTputDl(0.0),
+              m_lastAvgTputUl(0.0),
+              m_currTputDl(0.0),
+              m_currTputUl(0.0),
+              m_totBufDl(0),
+              m_totBufUl(0),
+              m_allocUlLast(false)
+        {
+        }
+
+        uint16_t m_rnti;
+        uint8_t m_dlMcs;
+        uint8_t m_ulMcs;
+        uint8_t m_dlCqi; // DL wideband CQI of the current slot, 0 if out of range
+        uint8_t m_ulCqi; // UL wideband CQI of the current slot, 0 if out of range
+        uint8_t m_dlSymbols;
+        uint8_t m_ulSymbols;
+        uint8_t m_dlSymbolsRetx;
+        uint8_t m_ulSymbolsRetx;
+        uint32_t m_dlTbSize;
+        uint32_t m_ulTbSize;
+        std::vector<struct RlcPduInfo> m_rlcPduInfo;
+        bool m_dlAllocDone;
+        bool m_ulAllocDone;
+        std::vector<FlowStats> m_flowStatsDl; // for each LC
+        std::vector<FlowStats> m_flowStatsUl;
+        double m_avgTputDl;
+        double m_avgTputUl;
+        double m_lastAvgTputDl;
+        double m_lastAvgTputUl;
+        double m_currTputDl;
+        double m_currTputUl;
+        uint32_t m_totBufDl;
+        uint32_t m_totBufUl;
+        bool m_allocUlLast;
+    };
+
+    /**
+     * Per-UE CQI, BSR and HARQ state, stored as one array per field
+     *
+     * Each UE owns a slot of the arrays, found through the RNTI-indexed
+     * vector m_slotOfRnti. The HARQ arrays hold m_numHarq consecutive entries
+     * per UE and the UL SINR array m_numRb entries per UE, so that the
+     * refresh of the timers at every slot is a linear scan.
+     *
+     * A slot is created by the first CQI, BSR or configuration of the UE,
+     * but the HARQ processes of the UE are only used once the UE is
+     * configured. When the UE is released, its HARQ processes and BSR are
+     * dropped, while its CQIs are kept until they expire. A slot with no
+     * configured UE, no valid CQI and no buffered UL data is freed by moving
+     * the last slot into it.
+     */
+    struct UeStateTable
+    {
+        static constexpr uint32_t NO_SLOT = 0xFFFFFFFF; //!< RNTI without a slot
+
+        UeStateTable();
+
+        /**
+         * Set the number of HARQ processes and of RBs, and remove all the UEs
+         * \param numHarq the number of HARQ processes per UE
+         * \param numRb the number of RBs of the UL SINR reports
+         */
+        void Configure(uint32_t numHarq, uint32_t numRb);
+
+        /**
+         * \param rnti the RNTI
+         * \return the slot of the UE, or NO_SLOT
+         */
+        uint32_t Find(uint16_t rnti) const
+        {
+            return rnti < m_slotOfRnti.size() ? m_slotOfRnti[rnti] : NO_SLOT;
+        }
+
+        /**
+         * \param rnti the RNTI
+         * \return the slot of the UE, or NO_SLOT if the UE is not configured
+         */
+        uint32_t FindConfigured(uint16_t rnti) const
+        {
+            uint32_t slot = Find(rnti);
+            return slot != NO_SLOT && m_configured[slot] ? slot : NO_SLOT;
+        }
+
+        /**
+         * \param rnti the RNTI
+         * \return the slot of the UE, which is created if needed
+         */
+        uint32_t FindOrAdd(uint16_t rnti);
+
+        /**
+         * Configure a UE, creating its HARQ processes if not already present
+         * \param rnti the RNTI
+         */
+        void AddHarqProcesses(uint16_t rnti);
+
+        /**
+         * Release a UE: drop its HARQ processes and BSR, and free its slot
+         * unless it still has a valid CQI
+         * \param rnti the RNTI
+         */
+        void RemoveHarqProcesses(uint16_t rnti);
+
+        /**
+         * Free a slot if its UE is not configured, has no valid CQI and no
+         * buffered UL data
+         * \param slot the slot
+         */
+        void RemoveIfUnused(uint32_t slot);
+
+        /// \return the number of UEs
+        uint32_t GetSize() const
+        {
+            return m_rnti.size();
+        }
+
+        uint32_t m_numHarq;                 //!< HARQ processes per UE
+        uint32_t m_numRb;                   //!< RBs per UL SINR report
+        std::vector<uint32_t> m_slotOfRnti; //!< slot of each RNTI
+
+        std::vector<uint16_t> m_rnti;         //!< RNTI of each slot
+        std::vector<uint8_t> m_configured;    //!< 1 if the UE has HARQ processes
+        std::vector<uint8_t> m_dlCqi;         //!< DL wideband CQI
+        std::vector<uint8_t> m_dlCqiValid;    //!< 1 if a DL CQI was received
+        std::vector<uint32_t> m_dlCqiTimer;   //!< remaining validity of the DL CQI
+        std::vector<double> m_ulSinr;         //!< UL SINR per RB, m_numRb per UE
+        std::vector<uint8_t> m_ulCqiValid;    //!< 1 if a UL SINR report was received
+        std::vector<uint32_t> m_ulCqiTimer;   //!< remaining validity of the UL SINR
+        std::vector<uint32_t> m_ulBufferSize; //!< UL buffer size from the last BSR
+
+        // HARQ status
+        //  0: process Id available
+        //  x>0: process Id equal to `x` trasmission count
+        std::vector<uint8_t> m_dlHarqStatus;                 //!< m_numHarq per UE
+        std::vector<uint8_t> m_dlHarqTimer;                  //!< m_numHarq per UE
+        std::vector<DciInfoElementTdma> m_dlHarqDci;         //!< m_numHarq per UE
+        std::vector<std::vector<RlcPduInfo>> m_dlHarqRlcPdu; //!< m_numHarq per UE
+        std::vector<uint8_t> m_ulHarqStatus;                 //!< m_numHarq per UE
+        std::vector<uint8_t> m_ulHarqTimer;                  //!< m_numHarq per UE
+        std::vector<DciInfoElementTdma> m_ulHarqDci;         //!< m_numHarq per UE
+    };
+
+    struct AllocMapElem
+    {
+        AllocMapElem(std::vector<uint16_t> rntiMap, uint8_t nSym, uint32_t tbs)
+            : m_rntiPerChunk(rntiMap),
+              m_numSym(nSym),
+              m_tbSize(tbs)
+        {
+        }
+
+        std::vector<uint16_t> m_rntiPerChunk;
+        uint8_t m_numSym;
+        uint32_t m_tbSize;
+    };
+
+    /**
+     * Register the attributes shared by all the Flex-TTI schedulers
+     *
+     * The attributes are added to the TypeId of each concrete scheduler, so that
+     * they can be set with Config::SetDefault through the name of the subclass.
+     *
+     * \param tid the TypeId of the subclass
+     * \param harqEnabled the default value of the HarqEnabled attribute
+     * \return the TypeId with the common attributes
+     */
+    static TypeId AddCommonAttributes(TypeId tid, bool harqEnabled = false);
+
+    /**
+     * Assign the data symbols left after the HARQ retransmissions to new transmissions
+     *
+     * The implementation sets the DL/UL symbols, MCS and TB size of each UE in the
+     * UeSchedInfo entries, and adds the UEs that received symbols to ueAllocMap.
+     * The default implementation, for the schedulers that override
+     * DoSchedTriggerReq, allocates nothing.
+     *
+     * \param symAvail the number of available symbols, decreased by the allocated symbols
+     * \param ueAllocMap the UEs with an allocation in the current slot
+     */
+    virtual void DoAllocateSymbols(int& symAvail, std::map<uint16_t, UeSchedInfo*>& ueAllocMap);
+
+    /**
+     * Split a new DL transport block among the RLC PDUs listed for the UE
+     *
+     * By default, the TB is split evenly among the active logical channels,
+     * without assigning to an LC more than its buffered data.
+     *
+     * \param ueInfo the UE
+     * \param tbSize the size of the TB, in bytes
+     */
+    virtual void DistributeDlTbSize(UeSchedInfo* ueInfo, uint32_t tbSize);
+
+    /**
+     * \param rnti the RNTI of the UE
+     * \return the last DL wideband CQI reported by the UE, or 1 (the lowest value
+     *         for trying a transmission) if the UE has no valid CQI
+     */
+    uint8_t GetDlCqi(uint16_t rnti) const;
+
+    /**
+     * Compute the UL wideband CQI and MCS of a UE from its last SINR report
+     * \param rnti the RNTI of the UE
+     * \param mcs the UL MCS, 0 if the UE has no valid SINR report
+     * \return the UL CQI, or 1 if the UE has no valid SINR report
+     */
+    uint8_t GetUlCqi(uint16_t rnti, uint8_t& mcs) const;
+
+    /**
+     * Update the DL CQI and MCS of a UE for the current slot
+     * \param ueInfo the UE
+     */
+    void UpdateDlCqi(UeSchedInfo* ueInfo);
+
+    /**
+     * Update the UL CQI and MCS of a UE for the current slot
+     * \param ueInfo the UE
+     */
+    void UpdateUlCqi(UeSchedInfo* ueInfo);
+
+    /**
+     * Collect the buffered DL and UL data of a UE
+     *
+     * The DL CQI of the UE is updated, and so is the UL CQI if the UE has UL
+     * data. For each direction with a CQI in range, the buffer size, RLC PDU list
+     * and instantaneous rate of the UE are updated, and the UE is added to
+     * ueAllocMap if it has data to transmit.
+     *
+     * \param ueInfo the UE
+     * \param hdrSize the MAC and RLC header overhead counted for each flow with
+     *        data, in bytes
+     * \param ueAllocMap the UEs with an allocation in the current slot
+     * \return true if the UE has data to transmit in a direction with a CQI in range
+     */
+    bool UpdateUeBuffers(UeSchedInfo* ueInfo,
+                         uint32_t hdrSize,
+                         std::map<uint16_t, UeSchedInfo*>& ueAllocMap);
+
+    /**
+     * Give one more symbol to a UE, alternating between UL and DL
+     * \param ueInfo the UE
+     * \return false if the UE has no more data to transmit
+     */
+    bool AllocateSymbol(UeSchedInfo* ueInfo);
+
+    /**
+     * \return the delay of the UL packets estimated from a new BSR, in microseconds
+     */
+    virtual double GetBsrPacketDelay(void) const;
+
+    /**
+     * Schedule the HARQ retransmissions at the beginning of a slot
+     *
+     * The HARQ feedback of the trigger is appended to the feedback buffered in
+     * the previous slots. The processes which were acknowledged, timed out or
+     * reached the maximum number of retransmissions are released, and the NACKed
+     * TBs are retransmitted with their previous DCI while enough symbols are
+     * left; the others are buffered for the next slot.
+     *
+     * \param params the parameters of the trigger
+     * \param ret the allocation of the slot, to which the retransmissions are added
+     * \param symAvail the number of available symbols, decreased by the retransmissions
+     * \param symIdx the index of the next free symbol
+     * \param ttiIdx the index of the next TTI
+     * \param retxSymbols the DL (first) and UL (second) symbols retransmitted to each UE
+     */
+    void ScheduleHarqRetx(const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
+                          MmWaveMacSchedSapUser::SchedConfigIndParameters& ret,
+                          int& symAvail,
+                          uint8_t& symIdx,
+                          uint8_t& ttiIdx,
+                          std::map<uint16_t, std::pair<uint8_t, uint8_t>>& retxSymbols);
+
+    /**
+     * \param rnti the RNTI of the UE
+     * \return the first free DL HARQ process of the UE, which is marked as used, or
+     *         the number of HARQ processes if none is free
+     */
+    uint8_t UpdateDlHarqProcessId(uint16_t rnti);
+
+    /**
+     * \param rnti the RNTI of the UE
+     * \return the first free UL HARQ process of the UE, which is marked as used, or
+     *         the number of HARQ processes if none is free
+     */
+    uint8_t UpdateUlHarqProcessId(uint16_t rnti);
+
+    /**
+     * Store the DCI of a new DL TB in its HARQ process and restart the timer of
+     * the process, when the HARQ is enabled
+     * \param dci the DCI of the TB
+     * \return the list where the RLC PDUs of the TB are stored for the
+     *         retransmissions, or nullptr if the HARQ is disabled
+     */
+    std::vector<RlcPduInfo>* SaveDlHarqDci(const DciInfoElementTdma& dci);
+
+    /**
+     * Store the DCI of a new UL TB in its HARQ process and restart the timer of
+     * the process, when the HARQ is enabled
+     * \param dci the DCI of the TB
+     */
+    void SaveUlHarqDci(const DciInfoElementTdma& dci);
+
+    /**
+     * \brief Refresh HARQ processes according to the timers
+     *
+     */
+    void RefreshHarqProcesses();
+
+    //
+    // Implementation of the CSCHED API primitives
+    // (See 4.1 for description of the primitives)
+    //
+
+    virtual void DoCschedUeConfigReq(
+        const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params);
+
+    virtual void DoCschedLcConfigReq(
+        const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+
+    virtual void DoCschedLcReleaseReq(
+        const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+
+    virtual void DoCschedUeReleaseReq(
+        const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params);
+
+    //
+    // Implementation of the SCHED API primitives
+    // (See 4.2 for description of the primitives)
+    //
+
+    virtual void DoSchedDlRlcBufferReq(
+        const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+
+    virtual void DoSchedUlMacCtrlInfoReq(
+        const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+
+    virtual void DoSchedTriggerReq(
+        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
+
+    uint32_t BsrId2BufferSize(uint8_t val)
+    {
+        NS_ABORT_MSG_UNLESS(val < 64, "val = " << val << " is out of range");
+        return BufferSizeLevelBsrTable[val];
+    }
+
+    Ptr<MmWaveAmc> m_amc;
+
+    MmWaveMacSchedSapUser* m_macSchedSapUser;
+
+    uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI can be considered valid
+
+    bool m_harqOn; // when false, inhibit the HARQ mechanisms
+    bool m_fixedTti;      // one slot per TTI
+    uint8_t m_symPerSlot; // symbols per slot
+
+    double m_timeWindow; // time window of the average throughput, in slots
+
+    std::map<uint16_t, UeSchedInfo> m_ueSchedInfoMap;
+
+    UeStateTable m_ueState; //!< CQI, BSR and HARQ state of the UEs
+
+    /*
+     * Map of previous allocated UE per RBG
+     * (used to retrieve info from UL-CQI)
+     */
+    std::map<uint32_t, struct AllocMapElem> m_ulAllocationMap;
+
+    static const unsigned m_subHdrSize;
+    static const unsigned m_rlcHdrSize;
+
+    // for testing
+    bool m_fixedMcsDl;
+    bool m_fixedMcsUl;
+    uint8_t m_mcsDefaultDl;
+    uint8_t m_mcsDefaultUl;
+    bool m_dlOnly;
+    bool m_ulOnly;
+
+  private:
+    /**
+     * Close the slot with the UL control symbol and send the allocation to the MAC
+     * \param ret the allocation of the slot
+     */
+    void SendSlotAllocation(MmWaveMacSchedSapUser::SchedConfigIndParameters& ret);
+
+    /**
+     * Clear the per-slot allocation of the UEs, for the next scheduler call
+     * \param ueAllocMap the UEs with an allocation in the current slot
+     */
+    void ResetUeAllocation(std::map<uint16_t, UeSchedInfo*>& ueAllocMap);
+
+    //
+    // Implementation of the CSCHED API primitives
+    // (See 4.1 for description of the primitives)
+    //
+
+    void DoCschedCellConfigReq(
+        const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params);
+
+    //
+    // Implementation of the SCHED API primitives
+    // (See 4.2 for description of the primitives)
+    //
+
+    void DoSchedDlCqiInfoReq(const MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+
+    void DoSchedUlCqiInfoReq(
+        const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+
+    void DoSchedSetMcs(int mcs);
+
+    uint8_t m_tbUid;
+
+    MmWaveMacSchedSapProvider* m_macSchedSapProvider;
+    MmWaveMacCschedSapUser* m_macCschedSapUser;
+    MmWaveMacCschedSapProvider* m_macCschedSapProvider;
+
+    MmWaveMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig;
+
+    std::vector<DlHarqInfo> m_dlHarqInfoList; // HARQ retx buffered
+    std::vector<UlHarqInfo> m_ulHarqInfoList; // HARQ retx buffered
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_BASE_MAC_SCHEDULER_H_ */
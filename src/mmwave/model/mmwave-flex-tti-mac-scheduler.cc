@@ -36,6 +36,7 @@
 #include <ns3/log.h>
 #include <ns3/lte-common.h>
 
+#include <algorithm>
 #include <cmath>
 #include <stdlib.h> /* abs */
 
@@ -49,160 +50,16 @@ NS_LOG_COMPONENT_DEFINE("MmWaveFlexTtiMacScheduler");
 
 NS_OBJECT_ENSURE_REGISTERED(MmWaveFlexTtiMacScheduler);
 
-class MmWaveFlexTtiMacCschedSapProvider : public MmWaveMacCschedSapProvider
-{
-  public:
-    MmWaveFlexTtiMacCschedSapProvider(MmWaveFlexTtiMacScheduler* scheduler);
-
-    // inherited from MmWaveMacCschedSapProvider
-    virtual void CschedCellConfigReq(
-        const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params);
-    virtual void CschedUeConfigReq(
-        const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params);
-    virtual void CschedLcConfigReq(
-        const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
-    virtual void CschedLcReleaseReq(
-        const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
-    virtual void CschedUeReleaseReq(
-        const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params);
-
-  private:
-    MmWaveFlexTtiMacCschedSapProvider();
-    MmWaveFlexTtiMacScheduler* m_scheduler;
-};
-
-MmWaveFlexTtiMacCschedSapProvider::MmWaveFlexTtiMacCschedSapProvider()
-{
-}
-
-MmWaveFlexTtiMacCschedSapProvider::MmWaveFlexTtiMacCschedSapProvider(
-    MmWaveFlexTtiMacScheduler* scheduler)
-    : m_scheduler(scheduler)
-{
-}
-
-void
-MmWaveFlexTtiMacCschedSapProvider::CschedCellConfigReq(
-    const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
-{
-    m_scheduler->DoCschedCellConfigReq(params);
-}
-
-void
-MmWaveFlexTtiMacCschedSapProvider::CschedUeConfigReq(
-    const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
-{
-    m_scheduler->DoCschedUeConfigReq(params);
-}
-
-void
-MmWaveFlexTtiMacCschedSapProvider::CschedLcConfigReq(
-    const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
-{
-    m_scheduler->DoCschedLcConfigReq(params);
-}
-
-void
-MmWaveFlexTtiMacCschedSapProvider::CschedLcReleaseReq(
-    const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
-{
-    m_scheduler->DoCschedLcReleaseReq(params);
-}
-
-void
-MmWaveFlexTtiMacCschedSapProvider::CschedUeReleaseReq(
-    const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
-{
-    m_scheduler->DoCschedUeReleaseReq(params);
-}
-
-class MmWaveFlexTtiMacSchedSapProvider : public MmWaveMacSchedSapProvider
-{
-  public:
-    MmWaveFlexTtiMacSchedSapProvider(MmWaveFlexTtiMacScheduler* sched);
-
-    virtual void SchedDlRlcBufferReq(
-        const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
-    virtual void SchedTriggerReq(
-        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
-    virtual void SchedDlCqiInfoReq(
-        const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
-    virtual void SchedUlCqiInfoReq(
-        const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
-    virtual void SchedUlMacCtrlInfoReq(
-        const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
-    virtual void SchedSetMcs(int mcs);
-
-  private:
-    MmWaveFlexTtiMacSchedSapProvider();
-    MmWaveFlexTtiMacScheduler* m_scheduler;
-};
-
-MmWaveFlexTtiMacSchedSapProvider::MmWaveFlexTtiMacSchedSapProvider()
-{
-}
-
-MmWaveFlexTtiMacSchedSapProvider::MmWaveFlexTtiMacSchedSapProvider(MmWaveFlexTtiMacScheduler* sched)
-    : m_scheduler(sched)
-{
-}
-
-void
-MmWaveFlexTtiMacSchedSapProvider::SchedDlRlcBufferReq(
-    const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
-{
-    m_scheduler->DoSchedDlRlcBufferReq(params);
-}
-
-void
-MmWaveFlexTtiMacSchedSapProvider::SchedTriggerReq(
-    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
-{
-    m_scheduler->DoSchedTriggerReq(params);
-}
-
-void
-MmWaveFlexTtiMacSchedSapProvider::SchedDlCqiInfoReq(
-    const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
-{
-    m_scheduler->DoSchedDlCqiInfoReq(params);
-}
-
-void
-MmWaveFlexTtiMacSchedSapProvider::SchedUlCqiInfoReq(
-    const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
-{
-    m_scheduler->DoSchedUlCqiInfoReq(params);
-}
-
-void
-MmWaveFlexTtiMacSchedSapProvider::SchedUlMacCtrlInfoReq(
-    const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
-{
-    m_scheduler->DoSchedUlMacCtrlInfoReq(params);
-}
-
-void
-MmWaveFlexTtiMacSchedSapProvider::SchedSetMcs(int mcs)
-{
-    m_scheduler->DoSchedSetMcs(mcs);
-}
-
 const unsigned MmWaveFlexTtiMacScheduler::m_macHdrSize = 0;
-const unsigned MmWaveFlexTtiMacScheduler::m_subHdrSize = 4;
-const unsigned MmWaveFlexTtiMacScheduler::m_rlcHdrSize = 3;
 
 const double MmWaveFlexTtiMacScheduler::m_berDl = 0.001;
 
 MmWaveFlexTtiMacScheduler::MmWaveFlexTtiMacScheduler()
     : m_nextRnti(0),
-      m_tbUid(0),
-      m_macSchedSapUser(0),
-      m_macCschedSapUser(0)
+      m_nextRntiDl(0),
+      m_nextRntiUl(0)
 {
     NS_LOG_FUNCTION(this);
-    m_macSchedSapProvider = new MmWaveFlexTtiMacSchedSapProvider(this);
-    m_macCschedSapProvider = new MmWaveFlexTtiMacCschedSapProvider(this);
 }
 
 MmWaveFlexTtiMacScheduler::~MmWaveFlexTtiMacScheduler()
@@ -214,115 +71,20 @@ void
 MmWaveFlexTtiMacScheduler::DoDispose(void)
 {
     NS_LOG_FUNCTION(this);
-    m_wbCqiRxed.clear();
-    m_dlHarqProcessesDciInfoMap.clear();
-    m_dlHarqProcessesTimer.clear();
-    m_dlHarqProcessesRlcPduMap.clear();
-    m_dlHarqInfoList.clear();
-    m_ulHarqCurrentProcessId.clear();
-    m_ulHarqProcessesStatus.clear();
-    m_ulHarqProcessesTimer.clear();
-    m_ulHarqProcessesDciInfoMap.clear();
-    delete m_macCschedSapProvider;
-    delete m_macSchedSapProvider;
+    m_rlcBufferReq.clear();
+    MmWaveFlexTtiBaseMacScheduler::DoDispose();
 }
 
 TypeId
 MmWaveFlexTtiMacScheduler::GetTypeId(void)
 {
-    static TypeId tid =
-        TypeId("ns3::MmWaveFlexTtiMacScheduler")
-            .SetParent<MmWaveMacScheduler>()
-            .AddConstructor<MmWaveFlexTtiMacScheduler>()
-            .AddAttribute("CqiTimerThreshold",
-                          "The number of TTIs a CQI is valid (default 1000 - 1 sec.)",
-                          UintegerValue(100),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_cqiTimersThreshold),
-                          MakeUintegerChecker<uint32_t>())
-            .AddAttribute("HarqEnabled",
-                          "Activate/Deactivate the HARQ [by default is active].",
-                          BooleanValue(true),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_harqOn),
-                          MakeBooleanChecker())
-            .AddAttribute("FixedMcsDl",
-                          "Fix MCS to value set in McsDlDefault (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_fixedMcsDl),
-                          MakeBooleanChecker())
-            .AddAttribute("McsDefaultDl",
-                          "Fixed DL MCS (for testing)",
-                          UintegerValue(1),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_mcsDefaultDl),
-                          MakeUintegerChecker<uint8_t>())
-            .AddAttribute("FixedMcsUl",
-                          "Fix MCS to value set in McsUlDefault (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_fixedMcsUl),
-                          MakeBooleanChecker())
-            .AddAttribute("McsDefaultUl",
-                          "Fixed UL MCS (for testing)",
-                          UintegerValue(1),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_mcsDefaultUl),
-                          MakeUintegerChecker<uint8_t>())
-            .AddAttribute("DlSchedOnly",
-                          "Only schedule downlink traffic (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_dlOnly),
-                          MakeBooleanChecker())
-            .AddAttribute("UlSchedOnly",
-                          "Only schedule uplink traffic (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_ulOnly),
-                          MakeBooleanChecker())
-            .AddAttribute("FixedTti",
-                          "Fix slot size",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_fixedTti),
-                          MakeBooleanChecker())
-            .AddAttribute("SymPerSlot",
-                          "Number of symbols per slot in Fixed TTI mode",
-                          UintegerValue(6),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_symPerSlot),
-                          MakeUintegerChecker<uint8_t>());
-
+    static TypeId tid = AddCommonAttributes(TypeId("ns3::MmWaveFlexTtiMacScheduler")
+                                                .SetParent<MmWaveFlexTtiBaseMacScheduler>()
+                                                .AddConstructor<MmWaveFlexTtiMacScheduler>(),
+                                            true);
     return tid;
 }
 
-void
-MmWaveFlexTtiMacScheduler::SetMacSchedSapUser(MmWaveMacSchedSapUser* sap)
-{
-    m_macSchedSapUser = sap;
-}
-
-void
-MmWaveFlexTtiMacScheduler::SetMacCschedSapUser(MmWaveMacCschedSapUser* sap)
-{
-    m_macCschedSapUser = sap;
-}
-
-MmWaveMacSchedSapProvider*
-MmWaveFlexTtiMacScheduler::GetMacSchedSapProvider()
-{
-    return m_macSchedSapProvider;
-}
-
-MmWaveMacCschedSapProvider*
-MmWaveFlexTtiMacScheduler::GetMacCschedSapProvider()
-{
-    return m_macCschedSapProvider;
-}
-
-void
-MmWaveFlexTtiMacScheduler::ConfigureCommonParameters(Ptr<MmWavePhyMacCommon> config)
-{
-    m_phyMacConfig = config;
-    m_amc = CreateObject<MmWaveAmc>(m_phyMacConfig);
-    m_numHarqProcess = m_phyMacConfig->GetNumHarqProcess();
-    m_harqTimeout = m_phyMacConfig->GetHarqTimeout();
-    m_numDataSymbols = m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetDlCtrlSymbols() -
-                       m_phyMacConfig->GetUlCtrlSymbols();
-}
-
 void
 MmWaveFlexTtiMacScheduler::DoSchedDlRlcBufferReq(
     const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
@@ -356,296 +118,16 @@ MmWaveFlexTtiMacScheduler::DoSchedDlRlcBufferReq(
     // initialize statistics of the flow in case of new flows
     if (newLc == true)
     {
-        m_wbCqiRxed.insert(
-            std::pair<uint16_t, uint8_t>(params.m_rnti, 1)); // only codeword 0 at this stage (SISO)
-        // initialized to 1 (i.e., the lowest value for transmitting a signal)
-        m_wbCqiTimers.insert(std::pair<uint16_t, uint32_t>(params.m_rnti, m_cqiTimersThreshold));
-    }
-}
-
-void
-MmWaveFlexTtiMacScheduler::DoSchedDlCqiInfoReq(
-    const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
-{
-    NS_LOG_FUNCTION(this);
-
-    std::map<uint16_t, uint8_t>::iterator it;
-    for (unsigned int i = 0; i < params.m_cqiList.size(); i++)
-    {
-        if (params.m_cqiList.at(i).m_cqiType == DlCqiInfo::WB)
-        {
-            // wideband CQI reporting
-            std::map<uint16_t, uint8_t>::iterator it;
-            uint16_t rnti = params.m_cqiList.at(i).m_rnti;
-            it = m_wbCqiRxed.find(rnti);
-            if (it == m_wbCqiRxed.end())
-            {
-                // create the new entry
-                m_wbCqiRxed.insert(std::pair<uint16_t, uint8_t>(
-                    rnti,
-                    params.m_cqiList.at(i).m_wbCqi)); // only codeword 0 at this stage (SISO)
-                // generate correspondent timer
-                m_wbCqiTimers.insert(std::pair<uint16_t, uint32_t>(rnti, m_cqiTimersThreshold));
-            }
-            else
-            {
-                // update the CQI value
-                (*it).second = params.m_cqiList.at(i).m_wbCqi;
-                // update correspondent timer
-                std::map<uint16_t, uint32_t>::iterator itTimers;
-                itTimers = m_wbCqiTimers.find(rnti);
-                (*itTimers).second = m_cqiTimersThreshold;
-            }
-        }
-        else if (params.m_cqiList.at(i).m_cqiType == DlCqiInfo::SB)
-        {
-            // subband CQI reporting high layer configured
-            // Not used by RR Scheduler
-        }
-        else
-        {
-            NS_LOG_ERROR(this << " CQI type unknown");
-        }
-    }
-}
-
-void
-MmWaveFlexTtiMacScheduler::DoSchedUlCqiInfoReq(
-    const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
-{
-    NS_LOG_FUNCTION(this);
-
-    uint32_t frameNum = params.m_sfnSf.m_frameNum;
-    uint8_t subframeNum = params.m_sfnSf.m_sfNum;
-    uint8_t slotNum = params.m_sfnSf.m_slotNum;
-    uint8_t symNum = params.m_sfnSf.m_symStart;
-
-    switch (params.m_ulCqi.m_type)
-    {
-    case UlCqiInfo::PUSCH: {
-        std::map<uint32_t, struct AllocMapElem>::iterator itMap;
-        std::map<uint16_t, struct UlCqiMapElem>::iterator itCqi;
-        itMap = m_ulAllocationMap.find(params.m_sfnSf.Encode());
-        if (itMap == m_ulAllocationMap.end())
-        {
-            NS_LOG_INFO(this << " Does not find info on allocation, size : "
-                             << m_ulAllocationMap.size());
-            return;
-        }
-        NS_ASSERT_MSG(itMap->second.m_rntiPerChunk.size() == m_phyMacConfig->GetNumRb(),
-                      "SINR chunk map must cover full BW in TDMA mode");
-        for (unsigned i = 0; i < itMap->second.m_rntiPerChunk.size(); i++)
-        {
-            // convert from fixed point notation Sxxxxxxxxxxx.xxx to double
-            // double sinr = LteFfConverter::fpS11dot3toDouble (params.m_ulCqi.m_sinr.at (i));
-            itCqi = m_ueUlCqi.find(itMap->second.m_rntiPerChunk.at(i));
-            if (itCqi == m_ueUlCqi.end())
-            {
-                // create a new entry
-                std::vector<double> newCqi;
-                for (uint32_t j = 0; j < m_phyMacConfig->GetNumRb(); j++)
-                {
-                    unsigned chunkInd = i;
-                    if (chunkInd == j)
-                    {
-                        newCqi.push_back(params.m_ulCqi.m_sinr.at(i));
-                        NS_LOG_INFO("UL CQI report for RNTI "
-                                    << itMap->second.m_rntiPerChunk.at(i) << " chunk " << i
-                                    << " SINR " << params.m_ulCqi.m_sinr.at(i) << " frame "
-                                    << frameNum << " subframe " << +subframeNum << " slot "
-                                    << +slotNum << " startSym " << +symNum);
-                    }
-                    else
-                    {
-                        // initialize with NO_SINR value.
-                        newCqi.push_back(30.0);
-                    }
-                }
-                m_ueUlCqi.insert(std::pair<uint16_t, struct UlCqiMapElem>(
-                    itMap->second.m_rntiPerChunk.at(i),
-                    UlCqiMapElem(newCqi, itMap->second.m_numSym, itMap->second.m_tbSize)));
-                // generate correspondent timer
-                m_ueCqiTimers.insert(
-                    std::pair<uint16_t, uint32_t>(itMap->second.m_rntiPerChunk.at(i),
-                                                  m_cqiTimersThreshold));
-            }
-            else
-            {
-                // update the value
-                (*itCqi).second.m_ueUlCqi.at(i) = params.m_ulCqi.m_sinr.at(i);
-                (*itCqi).second.m_numSym = itMap->second.m_numSym;
-                (*itCqi).second.m_tbSize = itMap->second.m_tbSize;
-                // update correspondent timer
-                std::map<uint16_t, uint32_t>::iterator itTimers;
-                itTimers = m_ueCqiTimers.find(itMap->second.m_rntiPerChunk.at(i));
-                (*itTimers).second = m_cqiTimersThreshold;
-
-                NS_LOG_INFO("UL CQI report for RNTI "
-                            << itMap->second.m_rntiPerChunk.at(i) << " chunk " << i << " SINR "
-                            << params.m_ulCqi.m_sinr.at(i) << " frame " << frameNum << " subframe "
-                            << +subframeNum << " slot " << +slotNum << " startSym " << +symNum);
-            }
-        }
-        // remove obsolete info on allocation
-        m_ulAllocationMap.erase(itMap);
-    }
-    break;
-    default:
-        NS_FATAL_ERROR("Unknown type of UL-CQI");
-    }
-    return;
-}
-
-void
-MmWaveFlexTtiMacScheduler::RefreshHarqProcesses()
-{
-    NS_LOG_FUNCTION(this);
-
-    std::map<uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
-    for (itTimers = m_dlHarqProcessesTimer.begin(); itTimers != m_dlHarqProcessesTimer.end();
-         itTimers++)
-    {
-        for (uint16_t i = 0; i < m_phyMacConfig->GetNumHarqProcess(); i++)
-        {
-            if ((*itTimers).second.at(i) == m_phyMacConfig->GetHarqTimeout())
-            { // reset HARQ process
-                NS_LOG_INFO(this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-                std::map<uint16_t, DlHarqProcessesStatus_t>::iterator itStat =
-                    m_dlHarqProcessesStatus.find((*itTimers).first);
-                if (itStat == m_dlHarqProcessesStatus.end())
-                {
-                    NS_FATAL_ERROR("No Process Id Status found for this RNTI "
-                                   << (*itTimers).first);
-                }
-                (*itStat).second.at(i) = 0;
-                (*itTimers).second.at(i) = 0;
-            }
-            else
-            {
-                (*itTimers).second.at(i)++;
-            }
-        }
-    }
-
-    std::map<uint16_t, UlHarqProcessesTimer_t>::iterator itTimers2;
-    for (itTimers2 = m_ulHarqProcessesTimer.begin(); itTimers2 != m_ulHarqProcessesTimer.end();
-         itTimers2++)
-    {
-        for (uint16_t i = 0; i < m_phyMacConfig->GetNumHarqProcess(); i++)
-        {
-            if ((*itTimers2).second.at(i) == m_phyMacConfig->GetHarqTimeout())
-            { // reset HARQ process
-                NS_LOG_INFO(this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers2).first);
-                std::map<uint16_t, UlHarqProcessesStatus_t>::iterator itStat =
-                    m_ulHarqProcessesStatus.find((*itTimers2).first);
-                if (itStat == m_ulHarqProcessesStatus.end())
-                {
-                    NS_FATAL_ERROR("No Process Id Status found for this RNTI "
-                                   << (*itTimers2).first);
-                }
-                (*itStat).second.at(i) = 0;
-                (*itTimers2).second.at(i) = 0;
-            }
-            else
-            {
-                (*itTimers2).second.at(i)++;
-            }
-        }
-    }
-}
-
-uint8_t
-MmWaveFlexTtiMacScheduler::UpdateDlHarqProcessId(uint16_t rnti)
-{
-    NS_LOG_FUNCTION(this << rnti);
-
-    if (m_harqOn == false)
-    {
-        uint8_t tbUid = m_tbUid;
-        m_tbUid = (m_tbUid + 1) % m_phyMacConfig->GetNumHarqProcess();
-        return tbUid;
-    }
-
-    //  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-    //  if (it == m_dlHarqCurrentProcessId.end ())
-    //  {
-    //      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    //  }
-    std::map<uint16_t, DlHarqProcessesStatus_t>::iterator itStat =
-        m_dlHarqProcessesStatus.find(rnti);
-    if (itStat == m_dlHarqProcessesStatus.end())
-    {
-        NS_FATAL_ERROR("No Process Id Statusfound for this RNTI " << rnti);
-    }
-
-    // search for available process ID, if none available return numHarqProcess
-    uint8_t harqId = m_phyMacConfig->GetNumHarqProcess();
-    for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess(); i++)
-    {
-        if (itStat->second[i] == 0)
-        {
-            itStat->second[i] = 1;
-            harqId = i;
-            break;
-        }
-    }
-    return harqId;
-
-    //  uint8_t i = (*it).second;
-    //  do
-    //  {
-    //      i = (i + 1) % m_phyMacConfig->GetNumHarqProcess ();
-    //  }
-    //  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-    //  if ((*itStat).second.at (i) == 0)
-    //  {
-    //      (*it).second = i;
-    //      (*itStat).second.at (i) = 1;
-    //  }
-    //  else
-    //  {
-    //      return (m_phyMacConfig->GetNumHarqProcess () + 1); // return a not valid harq proc id
-    //  }
-    //
-    //  return ((*it).second);
-}
-
-uint8_t
-MmWaveFlexTtiMacScheduler::UpdateUlHarqProcessId(uint16_t rnti)
-{
-    NS_LOG_FUNCTION(this << rnti);
-
-    if (m_harqOn == false)
-    {
-        uint8_t tbUid = m_tbUid;
-        m_tbUid = (m_tbUid + 1) % m_phyMacConfig->GetNumHarqProcess();
-        return tbUid;
-    }
-
-    //  std::map <uint16_t, uint8_t>::iterator it = m_ulHarqCurrentProcessId.find (rnti);
-    //  if (it == m_ulHarqCurrentProcessId.end ())
-    //  {
-    //      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    //  }
-    std::map<uint16_t, UlHarqProcessesStatus_t>::iterator itStat =
-        m_ulHarqProcessesStatus.find(rnti);
-    if (itStat == m_ulHarqProcessesStatus.end())
-    {
-        NS_FATAL_ERROR("No Process Id Statusfound for this RNTI " << rnti);
-    }
-
-    // search for available process ID, if none available return numHarqProcess+1
-    uint8_t harqId = m_phyMacConfig->GetNumHarqProcess();
-    for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess(); i++)
-    {
-        if (itStat->second[i] == 0)
+        uint32_t slot = m_ueState.FindOrAdd(params.m_rnti);
+        if (!m_ueState.m_dlCqiValid[slot])
         {
-            itStat->second[i] = 1;
-            harqId = i;
-            break;
+            // only codeword 0 at this stage (SISO)
+            // initialized to 1 (i.e., the lowest value for transmitting a signal)
+            m_ueState.m_dlCqi[slot] = 1;
+            m_ueState.m_dlCqiValid[slot] = 1;
+            m_ueState.m_dlCqiTimer[slot] = m_cqiTimersThreshold;
         }
     }
-    return harqId;
 }
 
 unsigned
@@ -739,322 +221,21 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
     //  number of DL/UL flows for new transmissions (not HARQ RETX)
     int nFlowsDl = 0;
     int nFlowsUl = 0;
-    std::map<uint16_t, struct UeSchedInfo> ueInfo;
-    std::map<uint16_t, struct UeSchedInfo>::iterator itUeInfo;
+    std::map<uint16_t, struct UeAllocInfo> ueInfo;
+    std::map<uint16_t, struct UeAllocInfo>::iterator itUeInfo;
     std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlcBuf;
 
-    // retrieve past HARQ retx buffered
-    if (m_dlHarqInfoList.size() > 0 && params.m_dlHarqInfoList.size() > 0)
+    std::map<uint16_t, std::pair<uint8_t, uint8_t>> retxSymbols;
+    ScheduleHarqRetx(params, ret, symAvail, symIdx, ttiIdx, retxSymbols);
+    for (std::map<uint16_t, std::pair<uint8_t, uint8_t>>::iterator itRetx = retxSymbols.begin();
+         itRetx != retxSymbols.end();
+         itRetx++)
     {
-        m_dlHarqInfoList.insert(m_dlHarqInfoList.end(),
-                                params.m_dlHarqInfoList.begin(),
-                                params.m_dlHarqInfoList.end());
-    }
-    else if (params.m_dlHarqInfoList.size() > 0)
-    {
-        m_dlHarqInfoList = params.m_dlHarqInfoList;
-    }
-    if (m_ulHarqInfoList.size() > 0 && params.m_ulHarqInfoList.size() > 0)
-    {
-        m_ulHarqInfoList.insert(m_ulHarqInfoList.end(),
-                                params.m_ulHarqInfoList.begin(),
-                                params.m_ulHarqInfoList.end());
-    }
-    else if (params.m_ulHarqInfoList.size() > 0)
-    {
-        m_ulHarqInfoList = params.m_ulHarqInfoList;
-    }
-
-    if (m_harqOn == false) // Ignore HARQ feedback
-    {
-        m_dlHarqInfoList.clear();
-    }
-    else
-    {
-        // Process DL HARQ feedback and assign slots for RETX if resources available
-        std::vector<struct DlHarqInfo>
-            dlInfoListUntxed; // TBs not able to be retransmitted in this sf
-        std::vector<struct UlHarqInfo> ulInfoListUntxed;
-
-        for (unsigned i = 0; i < m_dlHarqInfoList.size(); i++)
-        {
-            if (symAvail == 0)
-            {
-                break; // no symbols left to allocate
-            }
-            uint8_t harqId = m_dlHarqInfoList.at(i).m_harqProcessId;
-            uint16_t rnti = m_dlHarqInfoList.at(i).m_rnti;
-            itUeInfo = ueInfo.find(rnti);
-            std::map<uint16_t, UlHarqProcessesStatus_t>::iterator itStat =
-                m_dlHarqProcessesStatus.find(rnti);
-            if (itStat == m_dlHarqProcessesStatus.end())
-            {
-                NS_FATAL_ERROR("No HARQ status info found for UE " << rnti);
-            }
-            std::map<uint16_t, DlHarqRlcPduList_t>::iterator itRlcPdu =
-                m_dlHarqProcessesRlcPduMap.find(rnti);
-            if (itRlcPdu == m_dlHarqProcessesRlcPduMap.end())
-            {
-                NS_FATAL_ERROR("Unable to find RlcPdcList in HARQ buffer for RNTI "
-                               << m_dlHarqInfoList.at(i).m_rnti);
-            }
-            if (m_dlHarqInfoList.at(i).m_harqStatus == DlHarqInfo::ACK ||
-                itStat->second.at(harqId) == 0)
-            { // acknowledgment or process timeout, reset process
-                // NS_LOG_DEBUG ("UE" << rnti << " DL harqId " << +harqId << " HARQ-ACK received");
-                itStat->second.at(harqId) = 0;                         // release process ID
-                for (uint16_t k = 0; k < itRlcPdu->second.size(); k++) // clear RLC buffers
-                {
-                    itRlcPdu->second.at(harqId).clear();
-                }
-                continue;
-            }
-            else if (m_dlHarqInfoList.at(i).m_harqStatus == DlHarqInfo::NACK)
-            {
-                std::map<uint16_t, DlHarqProcessesDciInfoList_t>::iterator itHarq =
-                    m_dlHarqProcessesDciInfoMap.find(rnti);
-                if (itHarq == m_dlHarqProcessesDciInfoMap.end())
-                {
-                    NS_FATAL_ERROR("No DCI/HARQ buffer entry found for UE " << rnti);
-                }
-                DciInfoElementTdma dciInfoReTx = itHarq->second.at(harqId);
-                // NS_LOG_DEBUG ("UE" << rnti << " DL harqId " << +harqId << " HARQ-NACK received,
-                // rv " << +dciInfoReTx.m_rv);
-                NS_ASSERT(harqId == dciInfoReTx.m_harqProcess);
-                // NS_ASSERT(itStat->second.at (harqId) > 0);
-                NS_ASSERT(itStat->second.at(harqId) - 1 == dciInfoReTx.m_rv);
-                if (dciInfoReTx.m_rv == 3) // maximum number of retx reached -> drop process
-                {
-                    NS_LOG_INFO("Max number of retransmissions reached -> drop process");
-                    itStat->second.at(harqId) = 0;
-                    for (uint16_t k = 0; k < (*itRlcPdu).second.size(); k++)
-                    {
-                        itRlcPdu->second.at(harqId).clear();
-                    }
-                    continue;
-                }
-
-                // (1) Check if the CQI has decreased. If no updated value available, use the same
-                // MCS minus 1.
-                //                        If CQI is below min threshold, drop process.
-                // (2) Calculate new number of symbols it will take to encode at lower MCS.
-                //          If this exceeds the total number of symbols, reTX with original
-                //parameters.
-                //                        If exceeds remaining symbols available in this subframe
-                //                        (but not total symbols in SF),
-                //          update DCI info and try scheduling in next SF.
-
-                /*std::map <uint16_t,uint8_t>::iterator itCqi = m_wbCqiRxed.find (itRlcBuf->m_rnti);
-                int cqi;
-                int mcsNew;
-                if (itCqi != m_wbCqiRxed.end ())
-                {
-                        cqi = itCqi->second;
-                        if (cqi == 0)
-                        {
-                                NS_LOG_INFO ("CQI for reTX is below threshhold. Drop process");
-                                itStat->second.at (harqId) = 0;
-                                for (uint16_t k = 0; k < (*itRlcPdu).second.size (); k++)
-                                {
-                                        itRlcPdu->second.at (harqId).clear ();
-                                }
-                                continue;
-                        }
-                        else
-                        {
-                                mcsNew = m_amc->GetMcsFromCqi (cqi);  // get MCS
-                        }
-                }
-                else
-                {
-                        if(dciInfoReTx.m_mcs > 0)
-                        {
-                                mcsNew = dciInfoReTx.m_mcs - 1;
-                        }
-                        else
-                        {
-                                mcsNew = dciInfoReTx.m_mcs;
-                        }
-                }
-                // compute number of symbols required
-                unsigned numSymReq;
-                if (mcsNew < dciInfoReTx.m_mcs)
-                {
-                        numSymReq = m_amc->GetNumSymbolsFromTbsMcs (dciInfoReTx.m_tbSize, mcsNew);
-                        while (numSymReq < symAvail && mcsNew < dciInfoReTx.m_mcs);
-                        {
-                                mcsNew++;
-                                numSymReq = m_amc->GetNumSymbolsFromTbsMcs (dciInfoReTx.m_tbSize,
-                mcsNew);
-                        }
-                        mcsNew--;
-                        numSymReq = m_amc->GetNumSymbolsFromTbsMcs (dciInfoReTx.m_tbSize, mcsNew);
-                }
-                if (numSymReq <= (m_phyMacConfig->GetSymbolsPerSubframe () - resvCtrl))
-                {   // not enough symbols to encode TB at required MCS, attempt in later SF
-                        dlInfoListUntxed.push_back (m_dlHarqInfoList.at (i));
-                        continue;
-                }*/
-
-                // allocate retx if enough symbols are available
-                if (symAvail >= dciInfoReTx.m_numSym)
-                {
-                    symAvail -= dciInfoReTx.m_numSym;
-                    dciInfoReTx.m_symStart = symIdx;
-                    symIdx += dciInfoReTx.m_numSym;
-                    NS_ASSERT(symIdx <= m_phyMacConfig->GetSymbPerSlot() -
-                                            m_phyMacConfig->GetUlCtrlSymbols());
-                    dciInfoReTx.m_rv++;
-                    dciInfoReTx.m_ndi = 0;
-                    itHarq->second.at(harqId) = dciInfoReTx;
-                    itStat->second.at(harqId) = itStat->second.at(harqId) + 1;
-                    TtiAllocInfo ttiInfo(ttiIdx++,
-                                         TtiAllocInfo::DL_slotAllocInfo,
-                                         TtiAllocInfo::CTRL_DATA,
-                                         itUeInfo->first);
-                    ttiInfo.m_dci = dciInfoReTx;
-                    NS_LOG_DEBUG("UE" << dciInfoReTx.m_rnti << " gets DL OFDM symbols "
-                                      << +dciInfoReTx.m_symStart << "-"
-                                      << +(dciInfoReTx.m_symStart + dciInfoReTx.m_numSym - 1)
-                                      << " tbs " << dciInfoReTx.m_tbSize << " harqId "
-                                      << +dciInfoReTx.m_harqProcess << " harqId "
-                                      << +dciInfoReTx.m_harqProcess << " rv " << +dciInfoReTx.m_rv
-                                      << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
-                                      << +ret.m_sfnSf.m_sfNum << " slot " << +ret.m_sfnSf.m_slotNum
-                                      << " RETX");
-
-                    std::map<uint16_t, DlHarqRlcPduList_t>::iterator itRlcList =
-                        m_dlHarqProcessesRlcPduMap.find(rnti);
-                    if (itRlcList == m_dlHarqProcessesRlcPduMap.end())
-                    {
-                        NS_FATAL_ERROR("Unable to find RlcPdcList in HARQ buffer for RNTI "
-                                       << rnti);
-                    }
-                    for (uint16_t k = 0;
-                         k < (*itRlcList).second.at(dciInfoReTx.m_harqProcess).size();
-                         k++)
-                    {
-                        ttiInfo.m_rlcPduInfo.push_back(
-                            (*itRlcList).second.at(dciInfoReTx.m_harqProcess).at(k));
-                    }
-                    ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
-                    ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
-                    if (itUeInfo == ueInfo.end())
-                    {
-                        itUeInfo =
-                            ueInfo
-                                .insert(
-                                    std::pair<uint16_t, struct UeSchedInfo>(rnti, UeSchedInfo()))
-                                .first;
-                    }
-                    itUeInfo->second.m_dlSymbolsRetx = dciInfoReTx.m_numSym;
-                }
-                else
-                {
-                    NS_LOG_INFO("No resource for this retx -> buffer it");
-                    dlInfoListUntxed.push_back(m_dlHarqInfoList.at(i));
-                }
-            }
-        }
-
-        m_dlHarqInfoList.clear();
-        m_dlHarqInfoList = dlInfoListUntxed;
-
-        // Process UL HARQ feedback
-        for (uint16_t i = 0; i < m_ulHarqInfoList.size(); i++)
-        {
-            if (symAvail == 0)
-            {
-                break; // no symbols left to allocate
-            }
-            UlHarqInfo harqInfo = m_ulHarqInfoList.at(i);
-            uint8_t harqId = harqInfo.m_harqProcessId;
-            uint16_t rnti = harqInfo.m_rnti;
-            itUeInfo = ueInfo.find(rnti);
-            std::map<uint16_t, UlHarqProcessesStatus_t>::iterator itStat =
-                m_ulHarqProcessesStatus.find(rnti);
-            if (itStat == m_ulHarqProcessesStatus.end())
-            {
-                NS_LOG_ERROR("No info found in HARQ buffer for UE (might have changed eNB) "
-                             << rnti);
-            }
-            if (harqInfo.m_receptionStatus == UlHarqInfo::Ok || itStat->second.at(harqId) == 0)
-            {
-                // NS_LOG_DEBUG ("UE" << rnti << " UL harqId " << +harqInfo.m_harqProcessId << "
-                // HARQ-ACK received");
-                if (itStat != m_ulHarqProcessesStatus.end())
-                {
-                    itStat->second.at(harqId) = 0; // release process ID
-                }
-            }
-            else if (harqInfo.m_receptionStatus == UlHarqInfo::NotOk)
-            {
-                std::map<uint16_t, UlHarqProcessesDciInfoList_t>::iterator itHarq =
-                    m_ulHarqProcessesDciInfoMap.find(rnti);
-                if (itHarq == m_ulHarqProcessesDciInfoMap.end())
-                {
-                    NS_LOG_ERROR("No info found in UL-HARQ buffer for UE (might have changed eNB) "
-                                 << rnti);
-                }
-                // retx correspondent block: retrieve the UL-DCI
-                DciInfoElementTdma dciInfoReTx = itHarq->second.at(harqId);
-                // NS_LOG_DEBUG ("UE" << rnti << " UL harqId " << +harqInfo.m_harqProcessId << "
-                // HARQ-NACK received, rv " << +dciInfoReTx.m_rv);
-                NS_ASSERT(harqId == dciInfoReTx.m_harqProcess);
-                NS_ASSERT(itStat->second.at(harqId) > 0);
-                NS_ASSERT(itStat->second.at(harqId) - 1 == dciInfoReTx.m_rv);
-                if (dciInfoReTx.m_rv == 3)
-                {
-                    NS_LOG_INFO("Max number of retransmissions reached (UL)-> drop process");
-                    itStat->second.at(harqId) = 0;
-                    continue;
-                }
-
-                if (symAvail >= dciInfoReTx.m_numSym)
-                {
-                    symAvail -= dciInfoReTx.m_numSym;
-                    dciInfoReTx.m_symStart = symIdx;
-                    symIdx += dciInfoReTx.m_numSym;
-                    NS_ASSERT(symIdx <= m_phyMacConfig->GetSymbPerSlot() -
-                                            m_phyMacConfig->GetUlCtrlSymbols());
-                    dciInfoReTx.m_rv++;
-                    dciInfoReTx.m_ndi = 0;
-                    itStat->second.at(harqId) = itStat->second.at(harqId) + 1;
-                    itHarq->second.at(harqId) = dciInfoReTx;
-                    TtiAllocInfo ttiInfo(ttiIdx++,
-                                         TtiAllocInfo::UL_slotAllocInfo,
-                                         TtiAllocInfo::CTRL_DATA,
-                                         rnti);
-                    ttiInfo.m_dci = dciInfoReTx;
-                    NS_LOG_DEBUG("UE" << dciInfoReTx.m_rnti << " gets UL OFDM symbols "
-                                      << +dciInfoReTx.m_symStart << "-"
-                                      << +(dciInfoReTx.m_symStart + dciInfoReTx.m_numSym - 1)
-                                      << " tbs " << dciInfoReTx.m_tbSize << " harqId "
-                                      << +dciInfoReTx.m_harqProcess << " rv " << +dciInfoReTx.m_rv
-                                      << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
-                                      << +ret.m_sfnSf.m_sfNum << " slot " << +ret.m_sfnSf.m_slotNum
-                                      << " RETX");
-                    ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
-                    ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
-                    if (itUeInfo == ueInfo.end())
-                    {
-                        itUeInfo =
-                            ueInfo
-                                .insert(
-                                    std::pair<uint16_t, struct UeSchedInfo>(rnti, UeSchedInfo()))
-                                .first;
-                    }
-                    itUeInfo->second.m_ulSymbolsRetx = dciInfoReTx.m_numSym;
-                }
-                else
-                {
-                    ulInfoListUntxed.push_back(m_ulHarqInfoList.at(i));
-                }
-            }
-        }
-
-        m_ulHarqInfoList.clear();
-        m_ulHarqInfoList = ulInfoListUntxed;
+        itUeInfo =
+            ueInfo.insert(std::pair<uint16_t, struct UeAllocInfo>(itRetx->first, UeAllocInfo()))
+                .first;
+        itUeInfo->second.m_dlSymbolsRetx = itRetx->second.first;
+        itUeInfo->second.m_ulSymbolsRetx = itRetx->second.second;
     }
 
     // ********************* END OF HARQ SECTION, START OF NEW DATA SCHEDULING *********************
@@ -1080,17 +261,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                                  << " is active, status  " << (*itRlcBuf).m_rlcStatusPduSize
                                  << " retx " << (*itRlcBuf).m_rlcRetransmissionQueueSize << " tx "
                                  << (*itRlcBuf).m_rlcTransmissionQueueSize);
-                std::map<uint16_t, uint8_t>::iterator itCqi = m_wbCqiRxed.find(itRlcBuf->m_rnti);
-                uint8_t cqi = 0;
-                if (itCqi != m_wbCqiRxed.end())
-                {
-                    cqi = itCqi->second;
-                }
-                else // no CQI available
-                {
-                    NS_LOG_INFO(this << " UE " << itRlcBuf->m_rnti << " does not have DL-CQI");
-                    cqi = 1; // lowest value for trying a transmission
-                }
+                uint8_t cqi = GetDlCqi(itRlcBuf->m_rnti);
                 if (cqi != 0 ||
                     m_fixedMcsDl) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                 {
@@ -1099,8 +270,8 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                         nFlowsDl++; // for simplicity, all RLC LCs are considered as a single flow
                         itUeInfo =
                             ueInfo
-                                .insert(std::pair<uint16_t, struct UeSchedInfo>(itRlcBuf->m_rnti,
-                                                                                UeSchedInfo()))
+                                .insert(std::pair<uint16_t, struct UeAllocInfo>(itRlcBuf->m_rnti,
+                                                                                UeAllocInfo()))
                                 .first;
                     }
                     else if (itUeInfo->second.m_maxDlBufSize == 0)
@@ -1163,51 +334,28 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
     // get info on active UL flows
     if (symAvail > 0 && !m_dlOnly) // remaining symbols in future UL subframe after HARQ retx sched
     {
-        std::map<uint16_t, uint32_t>::iterator ceBsrIt;
-        for (ceBsrIt = m_ceBsrRxed.begin(); ceBsrIt != m_ceBsrRxed.end(); ceBsrIt++)
+        // visit the BSRs in RNTI order
+        for (uint32_t i = 0; i < m_ueState.m_slotOfRnti.size(); i++)
         {
-            if (ceBsrIt->second > 0) // UL buffer size > 0
+            uint32_t slot = m_ueState.m_slotOfRnti[i];
+            if (slot != UeStateTable::NO_SLOT &&
+                m_ueState.m_ulBufferSize[slot] > 0) // UL buffer size > 0
             {
-                std::map<uint16_t, struct UlCqiMapElem>::iterator itCqi =
-                    m_ueUlCqi.find(ceBsrIt->first);
-                int cqi = 0;
-                uint8_t mcs{0};
-                if (itCqi == m_ueUlCqi.end()) // no cqi info for this UE
-                {
-                    NS_LOG_INFO(this << " UE " << ceBsrIt->first << " does not have UL-CQI");
-                    cqi = 1;
-                    mcs = 0;
-                }
-                else
+                uint16_t rnti = m_ueState.m_rnti[slot];
+                uint8_t mcs = 0;
+                uint8_t cqi = GetUlCqi(rnti, mcs);
+                if (cqi == 0 && !m_fixedMcsUl) // out of range (SINR too low)
                 {
-                    cqi = 0;
-                    SpectrumValue specVals(
-                        MmWaveSpectrumValueHelper::GetSpectrumModel(m_phyMacConfig));
-                    Values::iterator specIt = specVals.ValuesBegin();
-                    for (uint32_t ichunk = 0; ichunk < m_phyMacConfig->GetNumRb(); ichunk++)
-                    {
-                        NS_ASSERT(specIt != specVals.ValuesEnd());
-                        *specIt = itCqi->second.m_ueUlCqi.at(ichunk); // sinrLin;
-                        specIt++;
-                    }
-
-                    cqi = m_amc->CreateCqiFeedbackWbTdma(specVals, mcs);
-
-                    if (cqi == 0 && !m_fixedMcsUl) // out of range (SINR too low)
-                    {
-                        NS_LOG_INFO("*** RNTI "
-                                    << ceBsrIt->first
-                                    << " UL-CQI out of range, skipping allocation in UL");
-                        continue; // do not allocate UE in uplink
-                    }
+                    NS_LOG_INFO("*** RNTI " << rnti
+                                            << " UL-CQI out of range, skipping allocation in UL");
+                    continue; // do not allocate UE in uplink
                 }
-                itUeInfo = ueInfo.find(ceBsrIt->first);
+                itUeInfo = ueInfo.find(rnti);
                 if (itUeInfo == ueInfo.end())
                 {
-                    itUeInfo = ueInfo
-                                   .insert(std::pair<uint16_t, struct UeSchedInfo>(ceBsrIt->first,
-                                                                                   UeSchedInfo()))
-                                   .first;
+                    itUeInfo =
+                        ueInfo.insert(std::pair<uint16_t, struct UeAllocInfo>(rnti, UeAllocInfo()))
+                            .first;
                     nFlowsUl++;
                 }
                 else if (itUeInfo->second.m_maxUlBufSize == 0)
@@ -1222,7 +370,8 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                 {
                     itUeInfo->second.m_ulMcs = mcs; // m_amc->GetMcsFromCqi (cqi);  // get MCS
                 }
-                itUeInfo->second.m_maxUlBufSize = ceBsrIt->second + m_rlcHdrSize + m_macHdrSize + 8;
+                itUeInfo->second.m_maxUlBufSize =
+                    m_ueState.m_ulBufferSize[slot] + m_rlcHdrSize + m_macHdrSize + 8;
             }
         }
     }
@@ -1279,7 +428,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
         }
     }
 
-    std::map<uint16_t, struct UeSchedInfo>::iterator itUeInfoStart;
+    std::map<uint16_t, struct UeAllocInfo>::iterator itUeInfoStart;
     if (m_nextRnti != 0) // start with RNTI at which the scheduler left off
     {
         itUeInfoStart = ueInfo.find(m_nextRnti);
@@ -1452,7 +601,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                            // should have been scheduled already
     do
     {
-        UeSchedInfo& ueSchedInfo = itUeInfo->second;
+        UeAllocInfo& ueSchedInfo = itUeInfo->second;
         if (ueSchedInfo.m_dlSymbols > 0)
         {
             DciInfoElementTdma dci;
@@ -1487,25 +636,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                               << +dci.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
                               << +ret.m_sfnSf.m_sfNum << " slot " << +ret.m_sfnSf.m_slotNum);
 
-            if (m_harqOn == true)
-            { // store DCI for HARQ buffer
-                std::map<uint16_t, DlHarqProcessesDciInfoList_t>::iterator itDciInfo =
-                    m_dlHarqProcessesDciInfoMap.find(dci.m_rnti);
-                if (itDciInfo == m_dlHarqProcessesDciInfoMap.end())
-                {
-                    NS_FATAL_ERROR("Unable to find RNTI entry in DCI HARQ buffer for RNTI "
-                                   << dci.m_rnti);
-                }
-                (*itDciInfo).second.at(dci.m_harqProcess) = dci;
-                // refresh timer
-                std::map<uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =
-                    m_dlHarqProcessesTimer.find(dci.m_rnti);
-                if (itHarqTimer == m_dlHarqProcessesTimer.end())
-                {
-                    NS_FATAL_ERROR("Unable to find HARQ timer for RNTI " << (uint16_t)dci.m_rnti);
-                }
-                (*itHarqTimer).second.at(dci.m_harqProcess) = 0;
-            }
+            std::vector<RlcPduInfo>* harqRlcPdu = SaveDlHarqDci(dci);
 
             // distribute bytes between active RLC queues
             unsigned numLc = ueSchedInfo.m_rlcPduInfo.size();
@@ -1551,17 +682,10 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                                       ueSchedInfo.m_rlcPduInfo[i].m_lcid,
                                       ueSchedInfo.m_rlcPduInfo[i].m_size - m_subHdrSize);
                 ttiInfo.m_rlcPduInfo.push_back(ueSchedInfo.m_rlcPduInfo[i]);
-                if (m_harqOn == true)
+                if (harqRlcPdu)
                 {
                     // store RLC PDU list for HARQ
-                    std::map<uint16_t, DlHarqRlcPduList_t>::iterator itRlcPdu =
-                        m_dlHarqProcessesRlcPduMap.find(dci.m_rnti);
-                    if (itRlcPdu == m_dlHarqProcessesRlcPduMap.end())
-                    {
-                        NS_FATAL_ERROR("Unable to find RlcPdcList in HARQ buffer for RNTI "
-                                       << dci.m_rnti);
-                    }
-                    (*itRlcPdu).second.at(dci.m_harqProcess).push_back(ueSchedInfo.m_rlcPduInfo[i]);
+                    harqRlcPdu->push_back(ueSchedInfo.m_rlcPduInfo[i]);
                 }
             }
             // reorder/reindex slots to maintain DL before UL slot order
@@ -1645,30 +769,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                 slotSfn.Encode(),
                 AllocMapElem(ueChunkMap, dci.m_numSym, dci.m_tbSize)));
 
-            if (m_harqOn == true)
-            {
-                uint8_t harqId = dci.m_harqProcess;
-                std::map<uint16_t, UlHarqProcessesDciInfoList_t>::iterator itHarqTbInfo =
-                    m_ulHarqProcessesDciInfoMap.find(dci.m_rnti);
-                if (itHarqTbInfo == m_ulHarqProcessesDciInfoMap.end())
-                {
-                    NS_FATAL_ERROR("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI "
-                                   << dci.m_rnti);
-                }
-                (*itHarqTbInfo).second.at(harqId) = dci;
-                // Update HARQ process status (RV 0)
-                std::map<uint16_t, UlHarqProcessesStatus_t>::iterator itStat =
-                    m_ulHarqProcessesStatus.find(dci.m_rnti);
-                NS_ASSERT(itStat->second[dci.m_harqProcess] > 0);
-                // refresh timer
-                std::map<uint16_t, UlHarqProcessesTimer_t>::iterator itHarqTimer =
-                    m_ulHarqProcessesTimer.find(dci.m_rnti);
-                if (itHarqTimer == m_ulHarqProcessesTimer.end())
-                {
-                    NS_FATAL_ERROR("Unable to find HARQ timer for RNTI " << (uint16_t)dci.m_rnti);
-                }
-                (*itHarqTimer).second.at(dci.m_harqProcess) = 0;
-            }
+            SaveUlHarqDci(dci);
         }
         itUeInfo++;
         if (itUeInfo == ueInfo.end())
@@ -1693,8 +794,6 @@ MmWaveFlexTtiMacScheduler::DoSchedUlMacCtrlInfoReq(
 {
     NS_LOG_FUNCTION(this);
 
-    std::map<uint16_t, uint32_t>::iterator it;
-
     for (unsigned int i = 0; i < params.m_macCeList.size(); i++)
     {
         if (params.m_macCeList.at(i).m_macCeType == MacCeElement::BSR)
@@ -1714,35 +813,14 @@ MmWaveFlexTtiMacScheduler::DoSchedUlMacCtrlInfoReq(
             }
 
             uint16_t rnti = params.m_macCeList.at(i).m_rnti;
-            it = m_ceBsrRxed.find(rnti);
-            if (it == m_ceBsrRxed.end())
-            {
-                // create the new entry
-                m_ceBsrRxed.insert(std::pair<uint16_t, uint32_t>(rnti, buffer));
-                NS_LOG_INFO(this << " Insert RNTI " << rnti << " queue " << buffer);
-            }
-            else
-            {
-                // update the buffer size value
-                (*it).second = buffer;
-                NS_LOG_INFO(this << " Update RNTI " << rnti << " queue " << buffer);
-            }
+            m_ueState.m_ulBufferSize[m_ueState.FindOrAdd(rnti)] = buffer;
+            NS_LOG_INFO(this << " Update RNTI " << rnti << " queue " << buffer);
         }
     }
 
     return;
 }
 
-void
-MmWaveFlexTtiMacScheduler::DoSchedSetMcs(int mcs)
-{
-    if (mcs >= 0 && mcs <= 28)
-    {
-        m_mcsDefaultDl = mcs;
-        m_mcsDefaultUl = mcs;
-    }
-}
-
 bool
 MmWaveFlexTtiMacScheduler::SortRlcBufferReq(
     MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters i,
@@ -1751,70 +829,6 @@ MmWaveFlexTtiMacScheduler::SortRlcBufferReq(
     return (i.m_rnti < j.m_rnti);
 }
 
-void
-MmWaveFlexTtiMacScheduler::RefreshDlCqiMaps(void)
-{
-    NS_LOG_FUNCTION(this << m_wbCqiTimers.size());
-    // refresh DL CQI P01 Map
-    std::map<uint16_t, uint32_t>::iterator itP10 = m_wbCqiTimers.begin();
-    while (itP10 != m_wbCqiTimers.end())
-    {
-        NS_LOG_INFO(this << " P10-CQI for user " << (*itP10).first << " is "
-                         << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
-        if ((*itP10).second == 0)
-        {
-            // delete correspondent entries
-            std::map<uint16_t, uint8_t>::iterator itMap = m_wbCqiRxed.find((*itP10).first);
-            NS_ASSERT_MSG(itMap != m_wbCqiRxed.end(),
-                          " Does not find CQI report for user " << (*itP10).first);
-            NS_LOG_INFO(this << " P10-CQI exired for user " << (*itP10).first);
-            m_wbCqiRxed.erase(itMap);
-            std::map<uint16_t, uint32_t>::iterator temp = itP10;
-            itP10++;
-            m_wbCqiTimers.erase(temp);
-        }
-        else
-        {
-            (*itP10).second--;
-            itP10++;
-        }
-    }
-
-    return;
-}
-
-void
-MmWaveFlexTtiMacScheduler::RefreshUlCqiMaps(void)
-{
-    // refresh UL CQI  Map
-    std::map<uint16_t, uint32_t>::iterator itUl = m_ueCqiTimers.begin();
-    while (itUl != m_ueCqiTimers.end())
-    {
-        NS_LOG_INFO(this << " UL-CQI for user " << (*itUl).first << " is "
-                         << (uint32_t)(*itUl).second << " thr " << (uint32_t)m_cqiTimersThreshold);
-        if ((*itUl).second == 0)
-        {
-            // delete correspondent entries
-            std::map<uint16_t, struct UlCqiMapElem>::iterator itMap = m_ueUlCqi.find((*itUl).first);
-            NS_ASSERT_MSG(itMap != m_ueUlCqi.end(),
-                          " Does not find CQI report for user " << (*itUl).first);
-            NS_LOG_INFO(this << " UL-CQI expired for user " << (*itUl).first);
-            itMap->second.m_ueUlCqi.clear();
-            m_ueUlCqi.erase(itMap);
-            std::map<uint16_t, uint32_t>::iterator temp = itUl;
-            itUl++;
-            m_ueCqiTimers.erase(temp);
-        }
-        else
-        {
-            (*itUl).second--;
-            itUl++;
-        }
-    }
-
-    return;
-}
-
 void
 MmWaveFlexTtiMacScheduler::UpdateDlRlcBufferInfo(uint16_t rnti, uint8_t lcid, uint16_t size)
 {
@@ -1884,18 +898,19 @@ void
 MmWaveFlexTtiMacScheduler::UpdateUlRlcBufferInfo(uint16_t rnti, uint16_t size)
 {
     size = size - 2; // remove the minimum RLC overhead
-    std::map<uint16_t, uint32_t>::iterator it = m_ceBsrRxed.find(rnti);
-    if (it != m_ceBsrRxed.end())
+    uint32_t slot = m_ueState.Find(rnti);
+    if (slot != UeStateTable::NO_SLOT)
     {
+        uint32_t& bufferSize = m_ueState.m_ulBufferSize[slot];
         NS_LOG_INFO(this << " Update RLC BSR UE " << rnti << " size " << size << " BSR "
-                         << (*it).second);
-        if ((*it).second >= size)
+                         << bufferSize);
+        if (bufferSize >= size)
         {
-            (*it).second -= size;
+            bufferSize -= size;
         }
         else
         {
-            (*it).second = 0;
+            bufferSize = 0;
         }
     }
     else
@@ -1904,66 +919,6 @@ MmWaveFlexTtiMacScheduler::UpdateUlRlcBufferInfo(uint16_t rnti, uint16_t size)
     }
 }
 
-void
-MmWaveFlexTtiMacScheduler::DoCschedCellConfigReq(
-    const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
-{
-    NS_LOG_FUNCTION(this);
-    // Read the subset of parameters used
-    m_cschedCellConfig = params;
-    // m_rachAllocationMap.resize (m_cschedCellConfig.m_ulBandwidth, 0);
-    MmWaveMacCschedSapUser::CschedUeConfigCnfParameters cnf;
-    cnf.m_result = SUCCESS;
-    m_macCschedSapUser->CschedUeConfigCnf(cnf);
-    return;
-}
-
-void
-MmWaveFlexTtiMacScheduler::DoCschedUeConfigReq(
-    const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
-{
-    NS_LOG_FUNCTION(this << " RNTI " << params.m_rnti << " txMode "
-                         << (uint16_t)params.m_transmissionMode);
-
-    if (m_dlHarqProcessesStatus.find(params.m_rnti) == m_dlHarqProcessesStatus.end())
-    {
-        // m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-        DlHarqProcessesStatus_t dlHarqPrcStatus;
-        dlHarqPrcStatus.resize(m_phyMacConfig->GetNumHarqProcess(), 0);
-        m_dlHarqProcessesStatus.insert(
-            std::pair<uint16_t, DlHarqProcessesStatus_t>(params.m_rnti, dlHarqPrcStatus));
-        DlHarqProcessesTimer_t dlHarqProcessesTimer;
-        dlHarqProcessesTimer.resize(m_phyMacConfig->GetNumHarqProcess(), 0);
-        m_dlHarqProcessesTimer.insert(
-            std::pair<uint16_t, DlHarqProcessesTimer_t>(params.m_rnti, dlHarqProcessesTimer));
-        DlHarqProcessesDciInfoList_t dlHarqTbInfoList;
-        dlHarqTbInfoList.resize(m_phyMacConfig->GetNumHarqProcess());
-        m_dlHarqProcessesDciInfoMap.insert(
-            std::pair<uint16_t, DlHarqProcessesDciInfoList_t>(params.m_rnti, dlHarqTbInfoList));
-        DlHarqRlcPduList_t dlHarqRlcPduList;
-        dlHarqRlcPduList.resize(m_phyMacConfig->GetNumHarqProcess());
-        m_dlHarqProcessesRlcPduMap.insert(
-            std::pair<uint16_t, DlHarqRlcPduList_t>(params.m_rnti, dlHarqRlcPduList));
-    }
-
-    if (m_ulHarqProcessesStatus.find(params.m_rnti) == m_ulHarqProcessesStatus.end())
-    {
-        //              m_ulHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (rnti, 0));
-        UlHarqProcessesStatus_t ulHarqPrcStatus;
-        ulHarqPrcStatus.resize(m_phyMacConfig->GetNumHarqProcess(), 0);
-        m_ulHarqProcessesStatus.insert(
-            std::pair<uint16_t, UlHarqProcessesStatus_t>(params.m_rnti, ulHarqPrcStatus));
-        UlHarqProcessesTimer_t ulHarqProcessesTimer;
-        ulHarqProcessesTimer.resize(m_phyMacConfig->GetNumHarqProcess(), 0);
-        m_ulHarqProcessesTimer.insert(
-            std::pair<uint16_t, UlHarqProcessesTimer_t>(params.m_rnti, ulHarqProcessesTimer));
-        UlHarqProcessesDciInfoList_t ulHarqTbInfoList;
-        ulHarqTbInfoList.resize(m_phyMacConfig->GetNumHarqProcess());
-        m_ulHarqProcessesDciInfoMap.insert(
-            std::pair<uint16_t, UlHarqProcessesDciInfoList_t>(params.m_rnti, ulHarqTbInfoList));
-    }
-}
-
 void
 MmWaveFlexTtiMacScheduler::DoCschedLcConfigReq(
     const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
@@ -2004,16 +959,8 @@ MmWaveFlexTtiMacScheduler::DoCschedUeReleaseReq(
 {
     NS_LOG_FUNCTION(this << " Release RNTI " << params.m_rnti);
 
-    // m_dlHarqCurrentProcessId.erase (params.m_rnti);
-    m_dlHarqProcessesStatus.erase(params.m_rnti);
-    m_dlHarqProcessesTimer.erase(params.m_rnti);
-    m_dlHarqProcessesDciInfoMap.erase(params.m_rnti);
-    m_dlHarqProcessesRlcPduMap.erase(params.m_rnti);
-    // m_ulHarqCurrentProcessId.erase  (params.m_rnti);
-    m_ulHarqProcessesTimer.erase(params.m_rnti);
-    m_ulHarqProcessesStatus.erase(params.m_rnti);
-    m_ulHarqProcessesDciInfoMap.erase(params.m_rnti);
-    m_ceBsrRxed.erase(params.m_rnti);
+    MmWaveFlexTtiBaseMacScheduler::DoCschedUeReleaseReq(params);
+
     std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it =
         m_rlcBufferReq.begin();
     while (it != m_rlcBufferReq.end())
@@ -64,6 +64,7 @@ mmWaveInterference::DoDispose()
     m_rxSignal = 0;
     m_allSignals = 0;
     m_noise = 0;
+    m_sinr = 0;
     Object::DoDispose();
 }
 
@@ -194,8 +195,7 @@ mmWaveInterference::ConditionallyEvaluateChunk()
     {
         NS_LOG_LOGIC(this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals
                           << " noise = " << *m_noise);
-        SpectrumValue interf = (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-        SpectrumValue sinr = (*m_rxSignal) / interf;
+        m_sinr->SetSinr(*m_rxSignal, *m_allSignals, *m_noise);
         Time duration = Now() - m_lastChangeTime;
         for (std::list<Ptr<mmWaveChunkProcessor>>::const_iterator it =
                  m_PowerChunkProcessorList.begin();
@@ -209,7 +209,7 @@ mmWaveInterference::ConditionallyEvaluateChunk()
              it != m_sinrChunkProcessorList.end();
              ++it)
         {
-            (*it)->EvaluateChunk(sinr, duration);
+            (*it)->EvaluateChunk(*m_sinr, duration);
         }
         m_lastChangeTime = Now();
     }
@@ -222,6 +222,7 @@ mmWaveInterference::SetNoisePowerSpectralDensity(Ptr<const SpectrumValue> noiseP
     ConditionallyEvaluateChunk();
     m_noise = noisePsd;
     m_allSignals = Create<SpectrumValue>(noisePsd->GetSpectrumModel());
+    m_sinr = Create<SpectrumValue>(noisePsd->GetSpectrumModel());
     if (m_receiving == true)
     {
         // abort rx
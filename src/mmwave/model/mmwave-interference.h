@@ -68,6 +68,7 @@ class mmWaveInterference : public Object
     Ptr<SpectrumValue> m_rxSignal;
     Ptr<SpectrumValue> m_allSignals;
     Ptr<const SpectrumValue> m_noise;
+    Ptr<SpectrumValue> m_sinr; //!< SINR buffer reused by every chunk evaluation
 
     Time m_lastChangeTime;
 
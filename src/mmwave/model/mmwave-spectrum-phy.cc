@@ -92,6 +92,7 @@ MmWaveSpectrumPhy::~MmWaveSpectrumPhy()
     m_channel = 0;
     m_device = 0;
     m_mobility = 0;
+    m_errorModel = 0;
 }
 
 TypeId
@@ -211,7 +212,17 @@ MmWaveSpectrumPhy::GetRxSpectrumModel() const
 void
 MmWaveSpectrumPhy::SetErrorModelType(TypeId errorModelType)
 {
+    NS_LOG_FUNCTION(this << errorModelType);
+    NS_ABORT_MSG_IF(!errorModelType.IsChildOf(MmWaveErrorModel::GetTypeId()),
+                    "The error model must be a subclass of MmWaveErrorModel!");
     m_errorModelType = errorModelType;
+
+    // Error models do not keep any state between calls to GetTbDecodificationStats,
+    // hence a single instance can be shared by all the TBs received by this PHY
+    ObjectFactory emFactory;
+    emFactory.SetTypeId(m_errorModelType);
+    m_errorModel = DynamicCast<MmWaveErrorModel>(emFactory.Create());
+    NS_ASSERT(m_errorModel != nullptr);
 }
 
 Ptr<Object>
@@ -607,20 +618,15 @@ MmWaveSpectrumPhy::EndRxData()
             const MmWaveErrorModel::MmWaveErrorModelHistory& harqInfoList =
                 RetrieveHistory(itTb->first, itTb->second.m_expected.m_harqProcessId);
 
-            // Obtain pointer to the specific error model used
-            NS_ABORT_MSG_IF(!m_errorModelType.IsChildOf(MmWaveErrorModel::GetTypeId()),
-                            "The error model must be a subclass of MmWaveErrorModel!");
-            ObjectFactory emFactory;
-            emFactory.SetTypeId(m_errorModelType);
-            Ptr<MmWaveErrorModel> em = DynamicCast<MmWaveErrorModel>(emFactory.Create());
-
             // Check whether the TB is corrupted or not, update TB info accordingly
+            NS_ASSERT_MSG(m_errorModel != nullptr,
+                          "The error model was not set, see the ErrorModelType attribute");
             itTb->second.m_outputOfEM =
-                em->GetTbDecodificationStats(m_sinrPerceived,
-                                             itTb->second.m_expected.m_rbBitmap,
-                                             itTb->second.m_expected.m_tbSize,
-                                             itTb->second.m_expected.m_mcs,
-                                             harqInfoList);
+                m_errorModel->GetTbDecodificationStats(m_sinrPerceived,
+                                                       itTb->second.m_expected.m_rbBitmap,
+                                                       itTb->second.m_expected.m_tbSize,
+                                                       itTb->second.m_expected.m_mcs,
+                                                       harqInfoList);
             itTb->second.m_isCorrupted =
                 m_random->GetValue() > itTb->second.m_outputOfEM->m_tbler ? false : true;
 
@@ -178,6 +178,10 @@ class MmWaveSpectrumPhy : public SpectrumPhy
 
     /**
      * \brief Set Error model type
+     *
+     * The error model is instantiated once here and reused for every TB
+     * received by this PHY.
+     *
      * \param type the Error model type
      */
     void SetErrorModelType(TypeId errorModelType);
@@ -332,6 +336,7 @@ class MmWaveSpectrumPhy : public SpectrumPhy
                                   // frame
     TypeId m_errorModelType{
         Object::GetTypeId()}; //!< Error model type by default is MmWaveLteMiErrorModel
+    Ptr<MmWaveErrorModel> m_errorModel; //!< Error model instance, created in SetErrorModelType
 
     Ptr<MmWaveHarqPhy> m_harqPhyModule;
 
@@ -15,11 +15,17 @@
  *
  */
 
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/mmwave-enb-spatial-index.h"
 #include "ns3/mmwave-helper.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/node-container.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device.h"
 #include "ns3/test.h"
 
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE("MmWaveAttachmentTest");
 
 using namespace ns3;
@@ -152,7 +158,118 @@ MmWaveAttachmentTestCase::DoRun(void)
 }
 
 /**
- * This suite tests if the beamforming module works properly
+ * This test case checks that the MmWaveEnbSpatialIndex used to attach the UEs
+ * returns the same eNBs as a linear scan of the eNB container
+ */
+class MmWaveEnbSpatialIndexTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param name the name of the eNB layout
+     * \param enbPositions the positions of the eNBs
+     */
+    MmWaveEnbSpatialIndexTestCase(std::string name, std::vector<Vector> enbPositions);
+    /**
+     * Constructor of a random layout
+     *
+     * \param numEnbs the number of eNBs, placed at random in a 1 km square
+     */
+    MmWaveEnbSpatialIndexTestCase(uint32_t numEnbs);
+
+  private:
+    /**
+     * Run the test
+     */
+    void DoRun(void) override;
+
+    std::vector<Vector> m_enbPositions; //!< the positions of the eNBs
+    uint32_t m_numRandomEnbs;           //!< the number of eNBs of a random layout, or 0
+};
+
+MmWaveEnbSpatialIndexTestCase::MmWaveEnbSpatialIndexTestCase(std::string name,
+                                                             std::vector<Vector> enbPositions)
+    : TestCase("Checks the closest eNBs found by the spatial index, " + name),
+      m_enbPositions(enbPositions),
+      m_numRandomEnbs(0)
+{
+}
+
+MmWaveEnbSpatialIndexTestCase::MmWaveEnbSpatialIndexTestCase(uint32_t numEnbs)
+    : TestCase("Checks the closest eNBs found by the spatial index, random layout"),
+      m_numRandomEnbs(numEnbs)
+{
+}
+
+void
+MmWaveEnbSpatialIndexTestCase::DoRun(void)
+{
+    if (m_numRandomEnbs > 0)
+    {
+        // drawn here, since a random variable created with the suite would shift the streams
+        // of all the other suites of the test runner
+        Ptr<UniformRandomVariable> layout = CreateObject<UniformRandomVariable>();
+        layout->SetStream(2);
+        m_enbPositions.clear();
+        for (uint32_t i = 0; i < m_numRandomEnbs; i++)
+        {
+            m_enbPositions.emplace_back(layout->GetValue(0, 1000), layout->GetValue(0, 1000), 10);
+        }
+    }
+
+    NetDeviceContainer enbDevices;
+    for (const Vector& position : m_enbPositions)
+    {
+        Ptr<Node> node = CreateObject<Node>();
+        Ptr<ConstantPositionMobilityModel> mobility =
+            CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(position);
+        node->AggregateObject(mobility);
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        node->AddDevice(device);
+        enbDevices.Add(device);
+    }
+    MmWaveEnbSpatialIndex enbIndex(enbDevices);
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+    uint32_t k = 3;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        // also pick positions outside the area of the eNBs
+        Vector uePos(rv->GetValue(-200, 1200), rv->GetValue(-200, 1200), 1.6);
+        if (i % 10 == 0)
+        {
+            uePos = m_enbPositions[i % m_enbPositions.size()];
+        }
+
+        // linear scan, ties are broken by the index
+        std::vector<std::pair<double, uint32_t>> distances;
+        for (uint32_t j = 0; j < m_enbPositions.size(); j++)
+        {
+            distances.emplace_back(CalculateDistance(uePos, m_enbPositions[j]), j);
+        }
+        std::sort(distances.begin(), distances.end());
+
+        NS_TEST_ASSERT_MSG_EQ(enbIndex.GetClosestEnb(uePos),
+                              distances[0].second,
+                              "Wrong closest eNB for the position " << uePos);
+        std::vector<uint32_t> closest = enbIndex.GetClosestEnbs(uePos, k);
+        NS_TEST_ASSERT_MSG_EQ(closest.size(),
+                              std::min<size_t>(k, m_enbPositions.size()),
+                              "Wrong number of closest eNBs");
+        for (uint32_t j = 0; j < closest.size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(closest[j],
+                                  distances[j].second,
+                                  "Wrong closest eNB " << j << " for the position " << uePos);
+        }
+    }
+}
+
+/**
+ * This suite tests if the attachment of the UEs works properly
  */
 class MmWaveAttachmentTest : public TestSuite
 {
@@ -164,6 +281,27 @@ MmWaveAttachmentTest::MmWaveAttachmentTest()
     : TestSuite("mmwave-attachment-test", Type::UNIT)
 {
     AddTestCase(new MmWaveAttachmentTestCase, Duration::QUICK);
+
+    AddTestCase(new MmWaveEnbSpatialIndexTestCase(200), Duration::QUICK);
+
+    // a grid of eNBs has many UEs at the same distance from different eNBs
+    std::vector<Vector> gridLayout;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        gridLayout.emplace_back(100.0 * (i % 10), 100.0 * (i / 10), 10 + 5 * (i % 3));
+    }
+    AddTestCase(new MmWaveEnbSpatialIndexTestCase("grid layout", gridLayout), Duration::QUICK);
+
+    std::vector<Vector> lineLayout;
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        lineLayout.emplace_back(20.0 * i, 500, 25);
+    }
+    AddTestCase(new MmWaveEnbSpatialIndexTestCase("line layout", lineLayout), Duration::QUICK);
+
+    AddTestCase(new MmWaveEnbSpatialIndexTestCase("co-located eNBs",
+                                                  std::vector<Vector>(2, Vector(0, 0, 10))),
+                Duration::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -17,6 +17,7 @@
 
 #include "simple-matrix-based-channel-model.h"
 
+#include "ns3/beamforming-codebook.h"
 #include "ns3/boolean.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/double.h"
@@ -366,6 +367,118 @@ MmWaveSvdBeamformingTestCase::DoRun(void)
     }
 }
 
+/**
+ * Codebook of empty codewords, whose codewords form a grid with a given number of columns
+ */
+class GridCodebook : public BeamformingCodebook
+{
+  public:
+    /**
+     * Constructor
+     * \param size the number of codewords
+     * \param columns the number of codewords per row, 0 for a 1D codebook
+     */
+    GridCodebook(uint32_t size, uint32_t columns)
+        : m_size(size),
+          m_columns(columns)
+    {
+    }
+
+    PhasedArrayModel::ComplexVector GetCodeword(uint32_t idx) const override
+    {
+        return PhasedArrayModel::ComplexVector();
+    }
+
+    uint32_t GetCodebookSize(void) const override
+    {
+        return m_size;
+    }
+
+    uint32_t GetCodebookColumns(void) const override
+    {
+        return m_columns;
+    }
+
+  private:
+    uint32_t m_size;    //!< the number of codewords
+    uint32_t m_columns; //!< the number of codewords per row
+};
+
+/**
+ * This test case checks the codewords searched around a beam pair by
+ * MmWaveCodebookBeamforming when tracking is enabled
+ */
+class MmWaveCodebookNeighbourhoodTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    MmWaveCodebookNeighbourhoodTestCase();
+
+  private:
+    /**
+     * Check the neighbourhood of a codeword
+     * \param codebook the codebook
+     * \param idx the index of the codeword
+     * \param radius the distance
+     * \param expected the expected neighbourhood
+     */
+    void CheckNeighbourhood(Ptr<BeamformingCodebook> codebook,
+                            uint32_t idx,
+                            uint32_t radius,
+                            std::vector<uint32_t> expected);
+
+    /**
+     * Run the test
+     */
+    void DoRun(void) override;
+};
+
+MmWaveCodebookNeighbourhoodTestCase::MmWaveCodebookNeighbourhoodTestCase()
+    : TestCase("Checks the neighbourhood of the codewords of 1D and 2D codebooks")
+{
+}
+
+void
+MmWaveCodebookNeighbourhoodTestCase::CheckNeighbourhood(Ptr<BeamformingCodebook> codebook,
+                                                        uint32_t idx,
+                                                        uint32_t radius,
+                                                        std::vector<uint32_t> expected)
+{
+    std::vector<uint32_t> neighbourhood =
+        MmWaveCodebookBeamforming::GetNeighbourhood(codebook, idx, radius);
+    NS_TEST_ASSERT_MSG_EQ(neighbourhood.size(),
+                          expected.size(),
+                          "Wrong neighbourhood size for codeword " << idx);
+    for (uint32_t i = 0; i < std::min(neighbourhood.size(), expected.size()); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(neighbourhood[i],
+                              expected[i],
+                              "Wrong neighbour of codeword " << idx);
+    }
+}
+
+void
+MmWaveCodebookNeighbourhoodTestCase::DoRun(void)
+{
+    // 1D codebook: distance between the indexes
+    Ptr<BeamformingCodebook> linear = CreateObject<GridCodebook>(23, 0);
+    CheckNeighbourhood(linear, 7, 2, {5, 6, 7, 8, 9});
+    CheckNeighbourhood(linear, 1, 2, {0, 1, 2, 3});
+    CheckNeighbourhood(linear, 22, 1, {21, 22});
+
+    // 2D codebook of 5 columns, the last row has 3 codewords
+    Ptr<BeamformingCodebook> grid = CreateObject<GridCodebook>(23, 5);
+    CheckNeighbourhood(grid, 7, 1, {1, 2, 3, 6, 7, 8, 11, 12, 13});
+    CheckNeighbourhood(grid, 0, 1, {0, 1, 5, 6});
+    // the neighbours in the row above, not the next codeword
+    CheckNeighbourhood(grid, 4, 1, {3, 4, 8, 9});
+    CheckNeighbourhood(grid, 19, 1, {13, 14, 18, 19});
+    CheckNeighbourhood(grid, 21, 1, {15, 16, 17, 20, 21, 22});
+    CheckNeighbourhood(grid, 12, 0, {12});
+}
+
 /**
  * This suite tests if the beamforming module works properly
  */
@@ -380,6 +493,7 @@ MmWaveBeamformingTest::MmWaveBeamformingTest()
 {
     AddTestCase(new MmWaveDftBeamformingTestCase, Duration::QUICK);
     AddTestCase(new MmWaveSvdBeamformingTestCase, Duration::QUICK);
+    AddTestCase(new MmWaveCodebookNeighbourhoodTestCase, Duration::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,280 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/mmwave-enb-net-device.h"
+#include "ns3/mmwave-enb-phy.h"
+#include "ns3/mmwave-helper.h"
+#include "ns3/mmwave-spectrum-value-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <map>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-enb-phy-sinr-estimate-test.cc
+ * \ingroup test
+ *
+ * \brief Check the periodic SINR estimate of MmWaveEnbPhy: the SINR reported
+ * for each UE must be the one of a full recomputation of the received PSD,
+ * also when the incremental mode reuses the previous estimates, and it must
+ * be negligible for the UEs beyond the path loss cutoff.
+ */
+
+/**
+ * \brief Compare the SINR estimated by the eNBs with a full recomputation,
+ * just after each periodic estimate
+ */
+class MmWaveEnbPhySinrEstimateTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param incremental the value of the IncrementalSinrEstimate attribute
+     * \param maxPathLoss the value of the SinrEstimateMaxPathLoss attribute (dB)
+     */
+    MmWaveEnbPhySinrEstimateTestCase(bool incremental, double maxPathLoss)
+        : TestCase(std::string(incremental ? "Incremental" : "Full") +
+                   " SINR estimate with path loss cutoff " + std::to_string(maxPathLoss) + " dB"),
+          m_incremental(incremental),
+          m_maxPathLoss(maxPathLoss),
+          m_numEstimated(0),
+          m_numCutOff(0),
+          m_numReused(0)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    /**
+     * \brief Check the estimate of each eNB, and schedule the check of the next estimate
+     * \param enbDevices the eNB devices
+     * \param period the period of the estimates
+     * \param numChecks the number of estimates still to check
+     */
+    void CheckSinrEstimates(NetDeviceContainer enbDevices, Time period, uint32_t numChecks);
+
+    bool m_incremental;      //!< whether the incremental mode is enabled
+    double m_maxPathLoss;    //!< the path loss cutoff (dB), or 0
+    uint32_t m_numEstimated; //!< number of UE-eNB pairs whose SINR was estimated
+    uint32_t m_numCutOff;    //!< number of UE-eNB pairs beyond the path loss cutoff
+    uint32_t m_numReused;    //!< number of UE-eNB pairs whose last received PSD was reused
+    /// received PSD of the last estimate of each UE-eNB pair
+    std::map<std::pair<uint64_t, uint16_t>, Ptr<SpectrumValue>> m_lastRxPsd;
+};
+
+void
+MmWaveEnbPhySinrEstimateTestCase::CheckSinrEstimates(NetDeviceContainer enbDevices,
+                                                     Time period,
+                                                     uint32_t numChecks)
+{
+    for (auto enbDev = enbDevices.Begin(); enbDev != enbDevices.End(); ++enbDev)
+    {
+        Ptr<MmWaveEnbPhy> phy = DynamicCast<MmWaveEnbNetDevice>(*enbDev)->GetPhy();
+        Ptr<MobilityModel> enbMob = (*enbDev)->GetNode()->GetObject<MobilityModel>();
+        Ptr<SpectrumValue> noisePsd =
+            MmWaveSpectrumValueHelper::CreateNoisePowerSpectralDensity(phy->m_phyMacConfig,
+                                                                       phy->GetNoiseFigure());
+
+        for (const auto& ue : phy->m_ueAttachedImsiMap)
+        {
+            Ptr<MmWaveUePhy> uePhy = phy->GetUePhy(ue.second);
+            Ptr<MobilityModel> ueMob = ue.second->GetNode()->GetObject<MobilityModel>();
+            auto pair = std::make_pair(ue.first, phy->m_cellId);
+            Ptr<SpectrumValue> estimatedRxPsd = phy->m_rxPsdMap.at(ue.first);
+            double estimatedSinr = phy->m_sinrMap.at(ue.first);
+
+            double propagationGainDb = phy->m_propagationLoss->CalcRxPower(0, ueMob, enbMob);
+            if (m_maxPathLoss > 0 && -propagationGainDb > m_maxPathLoss)
+            {
+                NS_TEST_ASSERT_MSG_EQ(estimatedRxPsd,
+                                      nullptr,
+                                      "PSD estimated for UE " << ue.first << " beyond the cutoff");
+                NS_TEST_ASSERT_MSG_EQ(estimatedSinr,
+                                      1e-20,
+                                      "SINR estimated for UE " << ue.first << " beyond the cutoff");
+                m_numCutOff++;
+                continue;
+            }
+
+            // recompute the received PSD from scratch, as done by the full estimate
+            Ptr<SpectrumValue> txPsd =
+                MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity(phy->m_phyMacConfig,
+                                                                        uePhy->GetTxPower(),
+                                                                        phy->m_listOfSubchannels);
+            Ptr<SpectrumValue> rxPsd =
+                phy->CalcUeRxPsd(ue.second, uePhy, txPsd, propagationGainDb);
+            phy->RestoreUeBeamforming(ue.second, uePhy);
+
+            NS_TEST_ASSERT_MSG_NE(estimatedRxPsd,
+                                  nullptr,
+                                  "No PSD estimated for UE " << ue.first << " in cell "
+                                                             << phy->m_cellId);
+            for (uint32_t band = 0; band < rxPsd->GetValuesN(); band++)
+            {
+                NS_TEST_ASSERT_MSG_EQ_TOL((*estimatedRxPsd)[band],
+                                          (*rxPsd)[band],
+                                          1e-9 * (*rxPsd)[band],
+                                          "Wrong PSD estimated for UE " << ue.first << " in cell "
+                                                                        << phy->m_cellId);
+            }
+            SpectrumValue sinr = *rxPsd / *noisePsd;
+            double expectedSinr = Sum(sinr) / sinr.GetSpectrumModel()->GetNumBands();
+            NS_TEST_ASSERT_MSG_EQ_TOL(estimatedSinr,
+                                      expectedSinr,
+                                      1e-9 * expectedSinr,
+                                      "Wrong SINR estimated for UE " << ue.first << " in cell "
+                                                                     << phy->m_cellId);
+            m_numEstimated++;
+
+            // the incremental mode keeps the PSD of the links which did not change
+            m_numReused += m_lastRxPsd[pair] == estimatedRxPsd;
+            m_lastRxPsd[pair] = estimatedRxPsd;
+        }
+    }
+
+    // the next estimate is already scheduled, so that this check runs just after it
+    if (numChecks > 1)
+    {
+        Simulator::Schedule(period,
+                            &MmWaveEnbPhySinrEstimateTestCase::CheckSinrEstimates,
+                            this,
+                            enbDevices,
+                            period,
+                            numChecks - 1);
+    }
+}
+
+void
+MmWaveEnbPhySinrEstimateTestCase::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    // deterministic path loss, so that the pairs beyond the cutoff are known
+    Config::SetDefault("ns3::ThreeGppPropagationLossModel::ShadowingEnabled",
+                       BooleanValue(false));
+    Config::SetDefault("ns3::MmWaveEnbPhy::IncrementalSinrEstimate", BooleanValue(m_incremental));
+    Config::SetDefault("ns3::MmWaveEnbPhy::SinrEstimateMaxPathLoss", DoubleValue(m_maxPathLoss));
+
+    Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper>();
+    helper->SetPathlossModelType("ns3::ThreeGppUmaPropagationLossModel");
+    helper->SetChannelConditionModelType("ns3::AlwaysLosChannelConditionModel");
+    helper->SetChannelModelType("ns3::ThreeGppSpectrumPropagationLossModel");
+
+    // (0,20)                 (100,20) ->
+    //  UE1                     UE2                                UE3 (400,0)
+    //  BS1 --------------------BS2
+    // (0,0)                  (100,0)
+    NodeContainer enbNodes;
+    enbNodes.Create(2);
+    Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator>();
+    enbPositionAlloc->Add(Vector(0.0, 0.0, 25.0));
+    enbPositionAlloc->Add(Vector(100.0, 0.0, 25.0));
+    MobilityHelper enbMobility;
+    enbMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    enbMobility.SetPositionAllocator(enbPositionAlloc);
+    enbMobility.Install(enbNodes);
+    NetDeviceContainer enbDevices = helper->InstallEnbDevice(enbNodes);
+
+    // UE2 moves, so that its PSD is recomputed at each estimate also in the incremental mode
+    NodeContainer ueNodes;
+    ueNodes.Create(3);
+    Ptr<ListPositionAllocator> uePositionAlloc = CreateObject<ListPositionAllocator>();
+    uePositionAlloc->Add(Vector(0.0, 20.0, 1.6));
+    uePositionAlloc->Add(Vector(100.0, 20.0, 1.6));
+    uePositionAlloc->Add(Vector(400.0, 0.0, 1.6));
+    MobilityHelper ueMobility;
+    ueMobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
+    ueMobility.SetPositionAllocator(uePositionAlloc);
+    ueMobility.Install(ueNodes);
+    ueNodes.Get(1)->GetObject<ConstantVelocityMobilityModel>()->SetVelocity(
+        Vector(20.0, 0.0, 0.0));
+    NetDeviceContainer ueDevices = helper->InstallUeDevice(ueNodes);
+
+    helper->AttachToClosestEnb(ueDevices, enbDevices);
+
+    // the estimates start when the eNB PHYs are initialized, at time 0: the first check is
+    // scheduled after the first estimate, in the same time step as the second one, so that it
+    // runs just after it
+    IntegerValue periodUs;
+    DynamicCast<MmWaveEnbNetDevice>(enbDevices.Get(0))
+        ->GetPhy()
+        ->GetAttribute("UpdateSinrEstimatePeriod", periodUs);
+    Time period = MicroSeconds(periodUs.Get());
+    const uint32_t numChecks = 10;
+    Simulator::Schedule(MicroSeconds(1), [this, enbDevices, period, numChecks]() {
+        Simulator::Schedule(period - MicroSeconds(1),
+                            &MmWaveEnbPhySinrEstimateTestCase::CheckSinrEstimates,
+                            this,
+                            enbDevices,
+                            period,
+                            numChecks);
+    });
+    Simulator::Stop(MilliSeconds(20));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_GT(m_numEstimated, 0, "No SINR estimated");
+    if (m_maxPathLoss > 0)
+    {
+        NS_TEST_ASSERT_MSG_GT(m_numCutOff, 0, "No UE beyond the path loss cutoff");
+    }
+    if (m_incremental)
+    {
+        NS_TEST_ASSERT_MSG_GT(m_numReused, 0, "No PSD reused by the incremental estimate");
+        NS_TEST_ASSERT_MSG_LT(m_numReused,
+                              m_numEstimated,
+                              "All the PSDs reused by the incremental estimate");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_numReused, 0, "PSD reused by the full estimate");
+    }
+}
+
+/**
+ * \brief Test suite for the SINR estimate of MmWaveEnbPhy
+ */
+class MmWaveEnbPhySinrEstimateTestSuite : public TestSuite
+{
+  public:
+    MmWaveEnbPhySinrEstimateTestSuite()
+        : TestSuite("mmwave-enb-phy-sinr-estimate", Type::UNIT)
+    {
+        AddTestCase(new MmWaveEnbPhySinrEstimateTestCase(false, 0), Duration::QUICK);
+        AddTestCase(new MmWaveEnbPhySinrEstimateTestCase(true, 0), Duration::QUICK);
+        AddTestCase(new MmWaveEnbPhySinrEstimateTestCase(false, 105), Duration::QUICK);
+        AddTestCase(new MmWaveEnbPhySinrEstimateTestCase(true, 105), Duration::QUICK);
+    }
+};
+
+static MmWaveEnbPhySinrEstimateTestSuite
+    mmwaveEnbPhySinrEstimateTestSuite; //!< SINR estimate test suite
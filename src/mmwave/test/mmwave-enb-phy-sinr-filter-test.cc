@@ -0,0 +1,203 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/mmwave-enb-phy.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/warnings.h"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-enb-phy-sinr-filter-test.cc
+ * \ingroup test
+ *
+ * \brief Check that the SINR filter of MmWaveEnbPhy, which keeps the SINR
+ * samples in ring buffers and updates the blockage detection at each sample,
+ * reports exactly the same samples as the filter on whole vectors of
+ * ApplyFilter and MakeFilter.
+ */
+
+/**
+ * \brief Compare the streaming SINR filter with the vector filter on random
+ * noisy traces with blockages
+ */
+class MmWaveEnbPhySinrFilterTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param seed the seed of the random traces
+     * \param blockageProbability the probability that a blockage starts or ends at each sample
+     */
+    MmWaveEnbPhySinrFilterTestCase(uint32_t seed, double blockageProbability)
+        : TestCase("SINR filter with blockage probability " +
+                   std::to_string(blockageProbability)),
+          m_seed(seed),
+          m_blockageProbability(blockageProbability)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    /**
+     * The SINR samples of a UE-eNB pair, as stored by the vector filter
+     */
+    struct VectorFilter
+    {
+        std::vector<double> realSinr;     //!< the real SINR samples
+        std::vector<double> noisySinr;    //!< the noisy SINR samples
+        std::vector<double> sinrToFilter; //!< the noisy SINR samples, last one filtered
+    };
+
+    /**
+     * \brief Add a sample to the vector filter
+     * \param phy the PHY providing ApplyFilter and MakeFilter
+     * \param filter the samples of the pair
+     * \param sinr the real SINR sample (linear)
+     * \param sinrNoisy the noisy SINR sample (linear)
+     * \param afterTransient whether the initial transient is over
+     * \return the SINR to report (linear)
+     */
+    static double UpdateVectorFilter(Ptr<MmWaveEnbPhy> phy,
+                                     VectorFilter& filter,
+                                     double sinr,
+                                     double sinrNoisy,
+                                     bool afterTransient);
+
+    uint32_t m_seed;              //!< seed of the random traces
+    double m_blockageProbability; //!< probability that a blockage starts or ends at each sample
+};
+
+double
+MmWaveEnbPhySinrFilterTestCase::UpdateVectorFilter(Ptr<MmWaveEnbPhy> phy,
+                                                   VectorFilter& filter,
+                                                   double sinr,
+                                                   double sinrNoisy,
+                                                   bool afterTransient)
+{
+    // the windows slide once the transient is over
+    if (afterTransient)
+    {
+        filter.realSinr.erase(filter.realSinr.begin());
+        filter.noisySinr.erase(filter.noisySinr.begin());
+        filter.sinrToFilter.erase(filter.sinrToFilter.begin());
+    }
+    filter.realSinr.push_back(sinr);
+    filter.noisySinr.push_back(sinrNoisy);
+    filter.sinrToFilter.push_back(sinrNoisy);
+
+    double sampleToForward = filter.sinrToFilter.back();
+    if (afterTransient)
+    {
+        NS_WARNING_PUSH_DEPRECATED;
+        std::pair<uint64_t, uint64_t> pairFiltering = phy->ApplyFilter(filter.noisySinr);
+        std::vector<double> finalSinr =
+            pairFiltering.first == pairFiltering.second
+                ? filter.sinrToFilter
+                : phy->MakeFilter(filter.noisySinr, filter.realSinr, pairFiltering);
+        NS_WARNING_POP;
+        sampleToForward = finalSinr.back();
+        filter.sinrToFilter.back() = finalSinr.back();
+    }
+    if (sampleToForward < 0)
+    {
+        sampleToForward = 1e-20;
+    }
+    return sampleToForward;
+}
+
+void
+MmWaveEnbPhySinrFilterTestCase::DoRun()
+{
+    const uint32_t numTraces = 10;
+    const uint32_t numSamples = 600;
+    const uint32_t transientSamples = 50;
+
+    // the filter methods do not use the spectrum PHYs
+    Ptr<MmWaveEnbPhy> phy =
+        CreateObject<MmWaveEnbPhy>(Ptr<MmWaveSpectrumPhy>(), Ptr<MmWaveSpectrumPhy>());
+
+    std::mt19937 generator(m_seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    uint32_t numFiltered = 0;
+    for (uint32_t trace = 0; trace < numTraces; trace++)
+    {
+        VectorFilter vectorFilter;
+        MmWaveEnbPhy::SinrFilterState streamingFilter;
+        bool blockage = false;
+        for (uint32_t sample = 0; sample < numSamples; sample++)
+        {
+            if (uniform(generator) < m_blockageProbability)
+            {
+                blockage = !blockage;
+            }
+            double sinrDb = blockage ? -8 + 14 * uniform(generator) : 22 + 6 * uniform(generator);
+            double sinr = std::pow(10, sinrDb / 10);
+            // same noise as MmWaveEnbPhy::AddGaussianNoise, normalized to the noise power
+            std::complex<double> noise(std::sqrt(0.5) * normal(generator),
+                                       std::sqrt(0.5) * normal(generator));
+            double sinrNoisy = std::pow(std::abs(std::sqrt(sinr) + noise), 2) - 1;
+
+            bool afterTransient = sample > transientSamples;
+            double expected =
+                UpdateVectorFilter(phy, vectorFilter, sinr, sinrNoisy, afterTransient);
+            double reported =
+                MmWaveEnbPhy::UpdateSinrFilter(streamingFilter, sinr, sinrNoisy, afterTransient);
+            NS_TEST_ASSERT_MSG_EQ(reported,
+                                  expected,
+                                  "Different SINR reported at sample " << sample << " of trace "
+                                                                       << trace);
+            numFiltered += expected != std::max(sinrNoisy, 1e-20);
+        }
+    }
+    if (m_blockageProbability > 0)
+    {
+        NS_TEST_ASSERT_MSG_GT(numFiltered, 0, "The traces did not trigger the filter");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Test suite for the SINR filter of MmWaveEnbPhy
+ */
+class MmWaveEnbPhySinrFilterTestSuite : public TestSuite
+{
+  public:
+    MmWaveEnbPhySinrFilterTestSuite()
+        : TestSuite("mmwave-enb-phy-sinr-filter", Type::UNIT)
+    {
+        AddTestCase(new MmWaveEnbPhySinrFilterTestCase(1, 0.0), Duration::QUICK);
+        AddTestCase(new MmWaveEnbPhySinrFilterTestCase(2, 0.02), Duration::QUICK);
+        AddTestCase(new MmWaveEnbPhySinrFilterTestCase(3, 0.1), Duration::QUICK);
+        AddTestCase(new MmWaveEnbPhySinrFilterTestCase(4, 0.5), Duration::QUICK);
+    }
+};
+
+static MmWaveEnbPhySinrFilterTestSuite
+    mmwaveEnbPhySinrFilterTestSuite; //!< SINR filter test suite
@@ -0,0 +1,147 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/file-beamforming-codebook.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+#include "ns3/uniform-planar-array.h"
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-file-codebook-test.cc
+ * \ingroup test
+ *
+ * \brief Check that a codebook converted to the binary format is imported
+ * with the same codewords as the original text codebook, and that the cache
+ * of the imported codebooks drops the ones no longer used.
+ */
+
+/**
+ * \brief Compare the text and binary versions of a codebook
+ */
+class MmWaveFileCodebookTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param numRows the number of rows of the array
+     * \param numColumns the number of columns of the array
+     */
+    MmWaveFileCodebookTestCase(uint32_t numRows, uint32_t numColumns)
+        : TestCase("Binary codebook for a " + std::to_string(numRows) + "x" +
+                   std::to_string(numColumns) + " array"),
+          m_numRows(numRows),
+          m_numColumns(numColumns)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    /**
+     * \brief Create and initialize a codebook
+     * \param filename the codebook file
+     * \return the codebook
+     */
+    Ptr<FileBeamformingCodebook> CreateCodebook(const std::string& filename) const;
+
+    uint32_t m_numRows;    //!< number of rows of the array
+    uint32_t m_numColumns; //!< number of columns of the array
+};
+
+Ptr<FileBeamformingCodebook>
+MmWaveFileCodebookTestCase::CreateCodebook(const std::string& filename) const
+{
+    Ptr<UniformPlanarArray> array = CreateObject<UniformPlanarArray>();
+    array->SetAttribute("NumRows", UintegerValue(m_numRows));
+    array->SetAttribute("NumColumns", UintegerValue(m_numColumns));
+
+    Ptr<FileBeamformingCodebook> codebook = CreateObject<FileBeamformingCodebook>();
+    codebook->SetAttribute("Array", PointerValue(array));
+    codebook->SetAttribute("CodebookFilename", StringValue(filename));
+    codebook->Initialize();
+    return codebook;
+}
+
+void
+MmWaveFileCodebookTestCase::DoRun()
+{
+    std::string textFilename = std::string(NS_TEST_SOURCEDIR) + "/../model/Codebooks/" +
+                               std::to_string(m_numRows) + "x" + std::to_string(m_numColumns) +
+                               ".txt";
+    std::string binaryFilename = CreateTempDirFilename("codebook.bin");
+    FileBeamformingCodebook::ConvertToBinary(textFilename, binaryFilename);
+
+    Ptr<FileBeamformingCodebook> text = CreateCodebook(textFilename);
+    Ptr<FileBeamformingCodebook> cached = CreateCodebook(textFilename);
+    Ptr<FileBeamformingCodebook> binary = CreateCodebook(binaryFilename);
+
+    NS_TEST_ASSERT_MSG_GT(text->GetCodebookSize(), 0, "Empty codebook");
+    NS_TEST_ASSERT_MSG_EQ(cached->GetCodebookSize(),
+                          text->GetCodebookSize(),
+                          "Cached codebook of different size");
+    NS_TEST_ASSERT_MSG_EQ(binary->GetCodebookSize(),
+                          text->GetCodebookSize(),
+                          "Binary codebook of different size");
+
+    for (uint32_t i = 0; i < text->GetCodebookSize(); i++)
+    {
+        PhasedArrayModel::ComplexVector textCw = text->GetCodeword(i);
+        PhasedArrayModel::ComplexVector cachedCw = cached->GetCodeword(i);
+        PhasedArrayModel::ComplexVector binaryCw = binary->GetCodeword(i);
+        NS_TEST_ASSERT_MSG_EQ(textCw.GetSize(), m_numRows * m_numColumns, "Wrong codeword size");
+        NS_TEST_ASSERT_MSG_EQ(binaryCw.GetSize(), textCw.GetSize(), "Wrong codeword size");
+        for (size_t j = 0; j < textCw.GetSize(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(cachedCw[j], textCw[j], "Cached codeword " << i << " differs");
+            NS_TEST_ASSERT_MSG_EQ(binaryCw[j], textCw[j], "Binary codeword " << i << " differs");
+        }
+    }
+
+    // once released, the text and binary codebooks are dropped from the cache at the next
+    // import, which adds the text codebook again
+    std::size_t numCached = FileBeamformingCodebook::GetNumCachedCodebooks();
+    text = nullptr;
+    cached = nullptr;
+    binary = nullptr;
+    Ptr<FileBeamformingCodebook> reimported = CreateCodebook(textFilename);
+    NS_TEST_ASSERT_MSG_EQ(FileBeamformingCodebook::GetNumCachedCodebooks(),
+                          numCached - 1,
+                          "The cache keeps the codebooks no longer used");
+}
+
+/**
+ * \brief Test suite for FileBeamformingCodebook
+ */
+class MmWaveFileCodebookTestSuite : public TestSuite
+{
+  public:
+    MmWaveFileCodebookTestSuite()
+        : TestSuite("mmwave-file-codebook", Type::UNIT)
+    {
+        AddTestCase(new MmWaveFileCodebookTestCase(1, 2), Duration::QUICK);
+        AddTestCase(new MmWaveFileCodebookTestCase(4, 4), Duration::QUICK);
+        AddTestCase(new MmWaveFileCodebookTestCase(8, 8), Duration::QUICK);
+    }
+};
+
+static MmWaveFileCodebookTestSuite mmwaveFileCodebookTestSuite; //!< file codebook test suite
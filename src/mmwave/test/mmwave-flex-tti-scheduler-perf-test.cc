@@ -0,0 +1,200 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/mmwave-flex-tti-mac-scheduler.h"
+#include "ns3/mmwave-phy-mac-common.h"
+#include "ns3/test.h"
+
+#include <ctime>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-flex-tti-scheduler-perf-test.cc
+ * \ingroup test
+ *
+ * \brief Measure the time spent by MmWaveFlexTtiMacScheduler to schedule a
+ * slot of a cell with many attached UEs.
+ */
+
+/**
+ * \brief Sched SAP user which drops the scheduling decisions
+ */
+class PerfSchedSapUser : public MmWaveMacSchedSapUser
+{
+  public:
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override
+    {
+        m_numInd++;
+    }
+
+    uint32_t m_numInd{0}; //!< number of SCHED_CONFIG_IND received
+};
+
+/**
+ * \brief Csched SAP user which ignores all the confirmations
+ */
+class PerfCschedSapUser : public MmWaveMacCschedSapUser
+{
+  public:
+    void CschedCellConfigCnf(const struct CschedCellConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigCnf(const struct CschedUeConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcConfigCnf(const struct CschedLcConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcReleaseCnf(const struct CschedLcReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeReleaseCnf(const struct CschedUeReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(const struct CschedUeConfigUpdateIndParameters& params) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        const struct CschedCellConfigUpdateIndParameters& params) override
+    {
+    }
+};
+
+/**
+ * \brief Measure the cost of DoSchedTriggerReq with many backlogged UEs
+ *
+ * All the UEs report a DL wideband CQI, a DL RLC buffer and a UL BSR, then
+ * the scheduler is triggered for m_numSlots consecutive slots. No HARQ
+ * feedback is sent, so the HARQ processes are released by their timers.
+ */
+class MmWaveFlexTtiSchedulerPerfTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param numUes the number of UEs attached to the cell
+     */
+    MmWaveFlexTtiSchedulerPerfTestCase(uint16_t numUes)
+        : TestCase("Flex-TTI scheduler trigger time with " + std::to_string(numUes) + " UEs"),
+          m_numUes(numUes)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    uint16_t m_numUes;                       //!< UEs attached to the cell
+    static const uint32_t m_numSlots = 2000; //!< number of scheduled slots
+};
+
+void
+MmWaveFlexTtiSchedulerPerfTestCase::DoRun()
+{
+    Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon>();
+    Ptr<MmWaveFlexTtiMacScheduler> sched = CreateObject<MmWaveFlexTtiMacScheduler>();
+    PerfSchedSapUser schedUser;
+    PerfCschedSapUser cschedUser;
+    sched->ConfigureCommonParameters(config);
+    sched->SetMacSchedSapUser(&schedUser);
+    sched->SetMacCschedSapUser(&cschedUser);
+    MmWaveMacSchedSapProvider* schedSap = sched->GetMacSchedSapProvider();
+    MmWaveMacCschedSapProvider* cschedSap = sched->GetMacCschedSapProvider();
+
+    MmWaveMacCschedSapProvider::CschedCellConfigReqParameters cellConfig;
+    cschedSap->CschedCellConfigReq(cellConfig);
+
+    MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiReq;
+    MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrReq;
+    for (uint16_t rnti = 1; rnti <= m_numUes; rnti++)
+    {
+        MmWaveMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+        ueConfig.m_rnti = rnti;
+        ueConfig.m_transmissionMode = 0;
+        cschedSap->CschedUeConfigReq(ueConfig);
+
+        MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcReq;
+        rlcReq.m_rnti = rnti;
+        rlcReq.m_logicalChannelIdentity = 3;
+        rlcReq.m_rlcTransmissionQueueSize = 100000000;
+        rlcReq.m_rlcTransmissionQueueHolDelay = 0;
+        rlcReq.m_rlcRetransmissionQueueSize = 0;
+        rlcReq.m_rlcRetransmissionHolDelay = 0;
+        rlcReq.m_rlcStatusPduSize = 0;
+        schedSap->SchedDlRlcBufferReq(rlcReq);
+
+        DlCqiInfo cqi{};
+        cqi.m_rnti = rnti;
+        cqi.m_cqiType = DlCqiInfo::WB;
+        cqi.m_wbCqi = 1 + rnti % 15;
+        cqiReq.m_cqiList.push_back(cqi);
+
+        MacCeElement bsr;
+        bsr.m_rnti = rnti;
+        bsr.m_macCeType = MacCeElement::BSR;
+        bsr.m_macCeValue.m_bufferStatus.resize(4, 63);
+        bsrReq.m_macCeList.push_back(bsr);
+    }
+    schedSap->SchedDlCqiInfoReq(cqiReq);
+    schedSap->SchedUlMacCtrlInfoReq(bsrReq);
+
+    uint32_t slotsPerSf = config->GetSlotsPerSubframe();
+    uint32_t slotsPerFrame = slotsPerSf * config->GetSubframesPerFrame();
+    MmWaveMacSchedSapProvider::SchedTriggerReqParameters trigger;
+    clock_t start = clock();
+    for (uint32_t slot = 0; slot < m_numSlots; slot++)
+    {
+        trigger.m_snfSf = SfnSf(slot / slotsPerFrame,
+                                (slot % slotsPerFrame) / slotsPerSf,
+                                slot % slotsPerSf,
+                                0);
+        schedSap->SchedTriggerReq(trigger);
+    }
+    clock_t elapsed = clock() - start;
+
+    NS_TEST_ASSERT_MSG_EQ(schedUser.m_numInd, m_numSlots, "One SCHED_CONFIG_IND per slot");
+    std::cout << GetName() << ": " << 1e9 * elapsed / (double(CLOCKS_PER_SEC) * m_numSlots)
+              << " ns per SchedTriggerReq" << std::endl;
+
+    sched->Dispose();
+}
+
+/**
+ * \brief Performance suite for the Flex-TTI MAC scheduler
+ */
+class MmWaveFlexTtiSchedulerPerfTestSuite : public TestSuite
+{
+  public:
+    MmWaveFlexTtiSchedulerPerfTestSuite()
+        : TestSuite("mmwave-flex-tti-scheduler-perf", Type::PERFORMANCE)
+    {
+        AddTestCase(new MmWaveFlexTtiSchedulerPerfTestCase(64), Duration::QUICK);
+        AddTestCase(new MmWaveFlexTtiSchedulerPerfTestCase(512), Duration::QUICK);
+    }
+};
+
+static MmWaveFlexTtiSchedulerPerfTestSuite
+    mmwaveFlexTtiSchedulerPerfTestSuite; //!< Flex-TTI scheduler perf suite
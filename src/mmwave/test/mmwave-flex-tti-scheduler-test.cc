@@ -0,0 +1,829 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2020, University of Padova, Dep. of Information Engineering, SIGNET lab
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/eps-bearer.h"
+#include "ns3/mmwave-amc.h"
+#include "ns3/mmwave-mac-scheduler.h"
+#include "ns3/mmwave-phy-mac-common.h"
+#include "ns3/object-factory.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-flex-tti-scheduler-test.cc
+ * \ingroup test
+ *
+ * \brief Check the allocations of the Flex-TTI MAC schedulers, driven
+ * through their SAPs without the MAC and PHY layers.
+ */
+
+/**
+ * \brief Drive a Flex-TTI scheduler through its SAPs and collect the DCIs
+ * of the data TTIs that it allocates
+ */
+class FlexTtiSchedulerTester : public MmWaveMacSchedSapUser, public MmWaveMacCschedSapUser
+{
+  public:
+    /**
+     * \brief Create the scheduler and configure the cell
+     * \param schedulerType the TypeId name of the scheduler
+     * \param harqEnabled whether the scheduler keeps the HARQ processes busy
+     *        until their feedback
+     */
+    FlexTtiSchedulerTester(std::string schedulerType, bool harqEnabled = true);
+
+    ~FlexTtiSchedulerTester() override;
+
+    /**
+     * \brief Configure a UE, with CSCHED_UE_CONFIG_REQ
+     * \param rnti the RNTI of the UE
+     */
+    void ConfigureUe(uint16_t rnti);
+
+    /**
+     * \brief Release a UE, with CSCHED_UE_RELEASE_REQ
+     * \param rnti the RNTI of the UE
+     */
+    void ReleaseUe(uint16_t rnti);
+
+    /**
+     * \brief Configure a DL logical channel of a UE, with CSCHED_LC_CONFIG_REQ
+     * \param rnti the RNTI of the UE
+     * \param lcid the logical channel
+     */
+    void ConfigureDlLc(uint16_t rnti, uint8_t lcid);
+
+    /**
+     * \brief Release a logical channel of a UE, with CSCHED_LC_RELEASE_REQ
+     * \param rnti the RNTI of the UE
+     * \param lcid the logical channel
+     */
+    void ReleaseLc(uint16_t rnti, uint8_t lcid);
+
+    /**
+     * \brief Report a DL RLC buffer of a UE
+     * \param rnti the RNTI of the UE
+     * \param lcid the logical channel
+     * \param txQueueSize the size of the RLC TX queue, in bytes
+     */
+    void ReportDlBuffer(uint16_t rnti, uint8_t lcid, uint32_t txQueueSize);
+
+    /**
+     * \brief Report a DL RLC buffer of a UE, made of a single packet
+     * \param rnti the RNTI of the UE
+     * \param lcid the logical channel
+     * \param packetSize the size of the packet, in bytes
+     */
+    void ReportDlPacket(uint16_t rnti, uint8_t lcid, uint32_t packetSize);
+
+    /**
+     * \brief Report the DL HARQ feedback of a UE with the next trigger
+     * \param rnti the RNTI of the UE
+     * \param harqId the HARQ process
+     * \param ack true for an ACK, false for a NACK
+     */
+    void ReportDlHarq(uint16_t rnti, uint8_t harqId, bool ack);
+
+    /**
+     * \brief Report the DL wideband CQIs of some UEs
+     * \param cqis the pairs of RNTI and CQI
+     */
+    void ReportDlCqi(std::vector<std::pair<uint16_t, uint8_t>> cqis);
+
+    /**
+     * \brief Report the UL BSRs of some UEs, with the same buffer for the 4 LCGs
+     * \param bsrs the pairs of RNTI and BSR index
+     */
+    void ReportBsr(std::vector<std::pair<uint16_t, uint8_t>> bsrs);
+
+    /**
+     * \brief Schedule the next slot
+     * \return the DCIs of the data TTIs of the slot
+     */
+    std::vector<DciInfoElementTdma> Trigger();
+
+    /**
+     * \return the data TTIs of the last slot
+     */
+    const std::vector<TtiAllocInfo>& GetLastTtis() const
+    {
+        return m_lastTti;
+    }
+
+    /**
+     * \return the configuration of the cell
+     */
+    Ptr<MmWavePhyMacCommon> GetConfig() const
+    {
+        return m_config;
+    }
+
+    // inherited from MmWaveMacSchedSapUser
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override;
+
+    // inherited from MmWaveMacCschedSapUser
+    void CschedCellConfigCnf(const struct CschedCellConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigCnf(const struct CschedUeConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcConfigCnf(const struct CschedLcConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcReleaseCnf(const struct CschedLcReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeReleaseCnf(const struct CschedUeReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(const struct CschedUeConfigUpdateIndParameters& params) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        const struct CschedCellConfigUpdateIndParameters& params) override
+    {
+    }
+
+  private:
+    Ptr<MmWavePhyMacCommon> m_config;          //!< configuration of the cell
+    Ptr<MmWaveMacScheduler> m_scheduler;       //!< the scheduler under test
+    uint32_t m_slot;                           //!< index of the next slot
+    std::vector<DciInfoElementTdma> m_lastDci; //!< DCIs of the last SCHED_CONFIG_IND
+    std::vector<TtiAllocInfo> m_lastTti;       //!< data TTIs of the last SCHED_CONFIG_IND
+    std::vector<DlHarqInfo> m_dlHarqInfo;      //!< DL HARQ feedback of the next trigger
+};
+
+FlexTtiSchedulerTester::FlexTtiSchedulerTester(std::string schedulerType, bool harqEnabled)
+    : m_slot(0)
+{
+    m_config = CreateObject<MmWavePhyMacCommon>();
+    ObjectFactory factory;
+    factory.SetTypeId(schedulerType);
+    factory.Set("HarqEnabled", BooleanValue(harqEnabled));
+    m_scheduler = factory.Create<MmWaveMacScheduler>();
+    m_scheduler->ConfigureCommonParameters(m_config);
+    m_scheduler->SetMacSchedSapUser(this);
+    m_scheduler->SetMacCschedSapUser(this);
+
+    MmWaveMacCschedSapProvider::CschedCellConfigReqParameters cellConfig;
+    m_scheduler->GetMacCschedSapProvider()->CschedCellConfigReq(cellConfig);
+}
+
+FlexTtiSchedulerTester::~FlexTtiSchedulerTester()
+{
+    m_scheduler->Dispose();
+}
+
+void
+FlexTtiSchedulerTester::ConfigureUe(uint16_t rnti)
+{
+    MmWaveMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+    ueConfig.m_rnti = rnti;
+    ueConfig.m_transmissionMode = 0;
+    m_scheduler->GetMacCschedSapProvider()->CschedUeConfigReq(ueConfig);
+}
+
+void
+FlexTtiSchedulerTester::ReleaseUe(uint16_t rnti)
+{
+    MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters ueRelease;
+    ueRelease.m_rnti = rnti;
+    m_scheduler->GetMacCschedSapProvider()->CschedUeReleaseReq(ueRelease);
+}
+
+void
+FlexTtiSchedulerTester::ConfigureDlLc(uint16_t rnti, uint8_t lcid)
+{
+    MmWaveMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+    lcConfig.m_rnti = rnti;
+    lcConfig.m_reconfigureFlag = false;
+    LogicalChannelConfigListElement_s lc;
+    lc.m_logicalChannelIdentity = lcid;
+    lc.m_logicalChannelGroup = 0;
+    lc.m_direction = LogicalChannelConfigListElement_s::DIR_DL;
+    lc.m_qci = EpsBearer::NGBR_VIDEO_TCP_DEFAULT;
+    lcConfig.m_logicalChannelConfigList.push_back(lc);
+    m_scheduler->GetMacCschedSapProvider()->CschedLcConfigReq(lcConfig);
+}
+
+void
+FlexTtiSchedulerTester::ReleaseLc(uint16_t rnti, uint8_t lcid)
+{
+    MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters lcRelease;
+    lcRelease.m_rnti = rnti;
+    lcRelease.m_logicalChannelIdentity.push_back(lcid);
+    m_scheduler->GetMacCschedSapProvider()->CschedLcReleaseReq(lcRelease);
+}
+
+void
+FlexTtiSchedulerTester::ReportDlBuffer(uint16_t rnti, uint8_t lcid, uint32_t txQueueSize)
+{
+    MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcReq;
+    rlcReq.m_rnti = rnti;
+    rlcReq.m_logicalChannelIdentity = lcid;
+    rlcReq.m_rlcTransmissionQueueSize = txQueueSize;
+    rlcReq.m_rlcTransmissionQueueHolDelay = 0;
+    rlcReq.m_rlcRetransmissionQueueSize = 0;
+    rlcReq.m_rlcRetransmissionHolDelay = 0;
+    rlcReq.m_rlcStatusPduSize = 0;
+    m_scheduler->GetMacSchedSapProvider()->SchedDlRlcBufferReq(rlcReq);
+}
+
+void
+FlexTtiSchedulerTester::ReportDlPacket(uint16_t rnti, uint8_t lcid, uint32_t packetSize)
+{
+    MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcReq;
+    rlcReq.m_rnti = rnti;
+    rlcReq.m_logicalChannelIdentity = lcid;
+    rlcReq.m_rlcTransmissionQueueSize = packetSize;
+    rlcReq.m_rlcTransmissionQueueHolDelay = 0;
+    rlcReq.m_rlcRetransmissionQueueSize = 0;
+    rlcReq.m_rlcRetransmissionHolDelay = 0;
+    rlcReq.m_rlcStatusPduSize = 0;
+    rlcReq.m_txPacketSizes.push_back(packetSize);
+    rlcReq.m_txPacketDelays.push_back(0);
+    m_scheduler->GetMacSchedSapProvider()->SchedDlRlcBufferReq(rlcReq);
+}
+
+void
+FlexTtiSchedulerTester::ReportDlHarq(uint16_t rnti, uint8_t harqId, bool ack)
+{
+    DlHarqInfo harqInfo;
+    harqInfo.m_rnti = rnti;
+    harqInfo.m_harqProcessId = harqId;
+    harqInfo.m_harqStatus = ack ? DlHarqInfo::ACK : DlHarqInfo::NACK;
+    harqInfo.m_numRetx = 0;
+    m_dlHarqInfo.push_back(harqInfo);
+}
+
+void
+FlexTtiSchedulerTester::ReportDlCqi(std::vector<std::pair<uint16_t, uint8_t>> cqis)
+{
+    MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiReq;
+    for (const auto& rntiCqi : cqis)
+    {
+        DlCqiInfo cqi{};
+        cqi.m_rnti = rntiCqi.first;
+        cqi.m_cqiType = DlCqiInfo::WB;
+        cqi.m_wbCqi = rntiCqi.second;
+        cqiReq.m_cqiList.push_back(cqi);
+    }
+    m_scheduler->GetMacSchedSapProvider()->SchedDlCqiInfoReq(cqiReq);
+}
+
+void
+FlexTtiSchedulerTester::ReportBsr(std::vector<std::pair<uint16_t, uint8_t>> bsrs)
+{
+    MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrReq;
+    for (const auto& rntiBsr : bsrs)
+    {
+        MacCeElement bsr;
+        bsr.m_rnti = rntiBsr.first;
+        bsr.m_macCeType = MacCeElement::BSR;
+        bsr.m_macCeValue.m_bufferStatus.resize(4, rntiBsr.second);
+        bsrReq.m_macCeList.push_back(bsr);
+    }
+    m_scheduler->GetMacSchedSapProvider()->SchedUlMacCtrlInfoReq(bsrReq);
+}
+
+std::vector<DciInfoElementTdma>
+FlexTtiSchedulerTester::Trigger()
+{
+    uint32_t slotsPerSf = m_config->GetSlotsPerSubframe();
+    uint32_t slotsPerFrame = slotsPerSf * m_config->GetSubframesPerFrame();
+    MmWaveMacSchedSapProvider::SchedTriggerReqParameters trigger;
+    trigger.m_snfSf = SfnSf(m_slot / slotsPerFrame,
+                            (m_slot % slotsPerFrame) / slotsPerSf,
+                            m_slot % slotsPerSf,
+                            0);
+    trigger.m_dlHarqInfoList = m_dlHarqInfo;
+    m_dlHarqInfo.clear();
+    m_slot++;
+    m_lastDci.clear();
+    m_lastTti.clear();
+    m_scheduler->GetMacSchedSapProvider()->SchedTriggerReq(trigger);
+    return m_lastDci;
+}
+
+void
+FlexTtiSchedulerTester::SchedConfigInd(const struct SchedConfigIndParameters& params)
+{
+    for (const auto& tti : params.m_slotAllocInfo.m_ttiAllocInfo)
+    {
+        if (tti.m_ttiType != TtiAllocInfo::CTRL)
+        {
+            m_lastDci.push_back(tti.m_dci);
+            m_lastTti.push_back(tti);
+        }
+    }
+}
+
+/**
+ * \brief Check that a released UE keeps its DL CQI, but not its HARQ
+ * processes, when its RNTI is configured again
+ */
+class FlexTtiSchedulerReleaseTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param schedulerType the TypeId name of the scheduler
+     */
+    FlexTtiSchedulerReleaseTestCase(std::string schedulerType)
+        : TestCase(schedulerType + ": release of a UE"),
+          m_schedulerType(schedulerType)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    std::string m_schedulerType; //!< the TypeId name of the scheduler
+};
+
+void
+FlexTtiSchedulerReleaseTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester(m_schedulerType);
+    Ptr<MmWaveAmc> amc = CreateObject<MmWaveAmc>(tester.GetConfig());
+
+    tester.ConfigureUe(1);
+    tester.ReportDlCqi({{1, 15}});
+    tester.ReportDlBuffer(1, 3, 1000);
+    std::vector<DciInfoElementTdma> dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_EQ(dcis.size(), 1, "One DL DCI expected");
+    NS_TEST_ASSERT_MSG_EQ(+dcis[0].m_mcs, +amc->GetMcsFromCqi(15), "DL MCS of the CQI expected");
+    NS_TEST_ASSERT_MSG_EQ(+dcis[0].m_harqProcess, 0, "First HARQ process expected");
+
+    // the RNTI is reused before the CQI expires: the CQI is still used, while the
+    // HARQ process of the first transmission was released with the UE
+    tester.ReleaseUe(1);
+    tester.ConfigureUe(1);
+    tester.ReportDlBuffer(1, 3, 1000);
+    dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_EQ(dcis.size(), 1, "One DL DCI expected after the release");
+    NS_TEST_ASSERT_MSG_EQ(+dcis[0].m_mcs,
+                          +amc->GetMcsFromCqi(15),
+                          "DL MCS of the CQI reported before the release expected");
+    NS_TEST_ASSERT_MSG_EQ(+dcis[0].m_harqProcess, 0, "HARQ processes not released");
+}
+
+/**
+ * \brief Check that the UL grants follow the RNTI order, whatever the order
+ * of the BSRs and of the configuration of the UEs
+ */
+class FlexTtiSchedulerBsrOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param schedulerType the TypeId name of the scheduler
+     */
+    FlexTtiSchedulerBsrOrderTestCase(std::string schedulerType)
+        : TestCase(schedulerType + ": order of the BSRs"),
+          m_schedulerType(schedulerType)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    std::string m_schedulerType; //!< the TypeId name of the scheduler
+};
+
+void
+FlexTtiSchedulerBsrOrderTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester(m_schedulerType);
+    const std::vector<uint16_t> rntis{3, 1, 2};
+    for (uint16_t rnti : rntis)
+    {
+        tester.ConfigureUe(rnti);
+    }
+    tester.ReportBsr({{3, 10}, {1, 10}, {2, 10}});
+
+    std::vector<DciInfoElementTdma> dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_EQ(dcis.size(), rntis.size(), "One UL DCI per UE expected");
+    for (uint16_t i = 0; i < dcis.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(+dcis[i].m_format, +DciInfoElementTdma::UL_dci, "UL DCI expected");
+        NS_TEST_ASSERT_MSG_EQ(dcis[i].m_rnti, i + 1, "UL DCIs not in RNTI order");
+    }
+}
+
+/**
+ * \brief Check that the PF scheduler counts the UL throughput of a UE in its
+ * average throughput, so that a UE with a full UL buffer does not take all the
+ * symbols of a slot from a UE with DL data
+ */
+class FlexTtiSchedulerPfUlAverageTestCase : public TestCase
+{
+  public:
+    FlexTtiSchedulerPfUlAverageTestCase()
+        : TestCase("ns3::MmWaveFlexTtiPfMacScheduler: UL in the average throughput")
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+};
+
+void
+FlexTtiSchedulerPfUlAverageTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester("ns3::MmWaveFlexTtiPfMacScheduler");
+    tester.ConfigureUe(1);
+    tester.ConfigureUe(2);
+    // both buffers exceed what a slot can carry, at the same MCS
+    tester.ReportBsr({{1, 63}});
+    tester.ReportDlCqi({{2, 1}});
+    tester.ReportDlBuffer(2, 3, 100000);
+
+    bool ulAlloc = false;
+    bool dlAlloc = false;
+    for (const auto& dci : tester.Trigger())
+    {
+        ulAlloc |= (dci.m_rnti == 1 && dci.m_format == DciInfoElementTdma::UL_dci);
+        dlAlloc |= (dci.m_rnti == 2 && dci.m_format == DciInfoElementTdma::DL_dci);
+    }
+    NS_TEST_ASSERT_MSG_EQ(ulAlloc, true, "UL DCI expected for the UE with UL data");
+    NS_TEST_ASSERT_MSG_EQ(dlAlloc, true, "DL DCI expected for the UE with DL data");
+}
+
+/**
+ * \brief Check that a DL TTI carries one RLC PDU per logical channel with
+ * data, and that the PDUs fit in the TB
+ */
+class FlexTtiSchedulerDlRlcPduTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param schedulerType the TypeId name of the scheduler
+     */
+    FlexTtiSchedulerDlRlcPduTestCase(std::string schedulerType)
+        : TestCase(schedulerType + ": RLC PDUs of a DL TTI"),
+          m_schedulerType(schedulerType)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    std::string m_schedulerType; //!< the TypeId name of the scheduler
+};
+
+void
+FlexTtiSchedulerDlRlcPduTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester(m_schedulerType);
+    tester.ConfigureUe(1);
+    tester.ReportDlCqi({{1, 15}});
+    tester.ReportDlBuffer(1, 2, 500);
+    tester.ReportDlBuffer(1, 3, 1000);
+    tester.Trigger();
+
+    uint32_t dlTtis = 0;
+    for (const auto& tti : tester.GetLastTtis())
+    {
+        if (tti.m_dci.m_format != DciInfoElementTdma::DL_dci)
+        {
+            continue;
+        }
+        dlTtis++;
+        NS_TEST_ASSERT_MSG_EQ(tti.m_rlcPduInfo.size(), 2, "One RLC PDU per LC expected");
+        uint32_t pduBytes = 0;
+        for (const auto& pdu : tti.m_rlcPduInfo)
+        {
+            pduBytes += pdu.m_size;
+        }
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(pduBytes, tti.m_dci.m_tbSize, "RLC PDUs exceed the TB");
+    }
+    NS_TEST_ASSERT_MSG_EQ(dlTtis, 1, "One DL TTI expected");
+}
+
+/**
+ * \brief Check that a UE without UL data gets no UL grant
+ */
+class FlexTtiSchedulerIdleUlTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param schedulerType the TypeId name of the scheduler
+     */
+    FlexTtiSchedulerIdleUlTestCase(std::string schedulerType)
+        : TestCase(schedulerType + ": no UL grant without UL data"),
+          m_schedulerType(schedulerType)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    std::string m_schedulerType; //!< the TypeId name of the scheduler
+};
+
+void
+FlexTtiSchedulerIdleUlTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester(m_schedulerType);
+    tester.ConfigureUe(1);
+    tester.ConfigureUe(2);
+    tester.ReportDlCqi({{1, 15}});
+    tester.ReportDlBuffer(1, 3, 1000);
+
+    std::vector<DciInfoElementTdma> dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_EQ(dcis.size(), 1, "Only the DL DCI of the UE with data expected");
+    NS_TEST_ASSERT_MSG_EQ(+dcis[0].m_format, +DciInfoElementTdma::DL_dci, "DL DCI expected");
+    NS_TEST_ASSERT_MSG_EQ(dcis[0].m_rnti, 1, "DCI of the UE with DL data expected");
+}
+
+/**
+ * \brief Check that the PF scheduler breaks the ties of its metric by RNTI,
+ * in every slot
+ */
+class FlexTtiSchedulerPfTieTestCase : public TestCase
+{
+  public:
+    FlexTtiSchedulerPfTieTestCase()
+        : TestCase("ns3::MmWaveFlexTtiPfMacScheduler: ties of the PF metric")
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+};
+
+void
+FlexTtiSchedulerPfTieTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester("ns3::MmWaveFlexTtiPfMacScheduler", false);
+    const uint16_t numUes = 8;
+    for (uint16_t rnti = 1; rnti <= numUes; rnti++)
+    {
+        tester.ConfigureUe(rnti);
+        tester.ReportDlCqi({{rnti, 15}});
+        tester.ReportDlBuffer(rnti, 3, 1000000);
+    }
+
+    // all the UEs have the same metric: each gets one symbol, then the ties
+    // go to the lowest RNTI
+    for (uint32_t slot = 0; slot < 20; slot++)
+    {
+        std::vector<DciInfoElementTdma> dcis = tester.Trigger();
+        NS_TEST_ASSERT_MSG_EQ(dcis.size(), numUes, "One DL DCI per UE expected");
+        for (uint16_t i = 1; i < dcis.size(); i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(dcis[i].m_rnti, i + 1, "DCIs not in RNTI order");
+            NS_TEST_ASSERT_MSG_EQ(+dcis[i].m_numSym, 1, "One symbol per UE expected");
+        }
+        NS_TEST_ASSERT_MSG_GT(+dcis[0].m_numSym, 1, "Remaining symbols to the first UE expected");
+    }
+}
+
+/**
+ * \brief Check that the buffered data and the HARQ feedback of a UE are
+ * dropped with the UE, and the buffered data of a logical channel with the
+ * logical channel
+ */
+class FlexTtiSchedulerReleaseDataTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param schedulerType the TypeId name of the scheduler
+     */
+    FlexTtiSchedulerReleaseDataTestCase(std::string schedulerType)
+        : TestCase(schedulerType + ": release of buffered data"),
+          m_schedulerType(schedulerType)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    std::string m_schedulerType; //!< the TypeId name of the scheduler
+};
+
+void
+FlexTtiSchedulerReleaseDataTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester(m_schedulerType);
+    for (uint16_t rnti = 1; rnti <= 3; rnti++)
+    {
+        tester.ConfigureUe(rnti);
+        tester.ConfigureDlLc(rnti, 3);
+        tester.ReportDlCqi({{rnti, 15}});
+        tester.ReportDlPacket(rnti, 3, 100);
+    }
+
+    // UE 1 leaves and the LC of UE 2 is released before their data is scheduled
+    tester.ReleaseUe(1);
+    tester.ReleaseLc(2, 3);
+    std::vector<DciInfoElementTdma> dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_EQ(dcis.size(), 1, "Only the DCI of UE 3 expected");
+    NS_TEST_ASSERT_MSG_EQ(dcis[0].m_rnti, 3, "DCI of UE 3 expected");
+
+    // UE 3 leaves before the feedback of its TB arrives, and UE 1 comes back
+    tester.ReportDlHarq(3, dcis[0].m_harqProcess, false);
+    tester.ReleaseUe(3);
+    tester.ConfigureUe(1);
+    tester.ConfigureDlLc(1, 3);
+    dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_EQ(dcis.size(), 0, "No DCI expected after the releases");
+}
+
+/**
+ * \brief Check that the MaxRate scheduler ranks a UE by the MCS of the
+ * direction in which it has data
+ */
+class FlexTtiSchedulerMaxRateMcsTestCase : public TestCase
+{
+  public:
+    FlexTtiSchedulerMaxRateMcsTestCase()
+        : TestCase("ns3::MmWaveFlexTtiMaxRateMacScheduler: MCS of the direction with data")
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+};
+
+void
+FlexTtiSchedulerMaxRateMcsTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester("ns3::MmWaveFlexTtiMaxRateMacScheduler");
+    tester.ConfigureUe(1);
+    tester.ConfigureUe(2);
+    // UE 1 has a high DL CQI, but only UL data at the lowest MCS, while the DL
+    // data of UE 2 fills the slot at a higher MCS
+    tester.ReportDlCqi({{1, 15}, {2, 10}});
+    tester.ReportBsr({{1, 63}});
+    tester.ReportDlBuffer(2, 3, 100000);
+
+    std::vector<DciInfoElementTdma> dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_EQ(dcis.size(), 1, "Only the DCI of UE 2 expected");
+    NS_TEST_ASSERT_MSG_EQ(+dcis[0].m_format, +DciInfoElementTdma::DL_dci, "DL DCI expected");
+    NS_TEST_ASSERT_MSG_EQ(dcis[0].m_rnti, 2, "DCI of UE 2 expected");
+}
+
+/**
+ * \brief Check that the MaxWeight scheduler serves the flows with the same
+ * deadline by RNTI, and ages a reconfigured flow only once per slot
+ */
+class FlexTtiSchedulerMaxWeightTieTestCase : public TestCase
+{
+  public:
+    FlexTtiSchedulerMaxWeightTieTestCase()
+        : TestCase("ns3::MmWaveFlexTtiMaxWeightMacScheduler: flows with the same deadline")
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+};
+
+void
+FlexTtiSchedulerMaxWeightTieTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester("ns3::MmWaveFlexTtiMaxWeightMacScheduler", false);
+    const uint16_t numUes = 20;
+    for (uint16_t rnti = numUes; rnti >= 1; rnti--)
+    {
+        tester.ConfigureUe(rnti);
+        tester.ConfigureDlLc(rnti, 3);
+        tester.ReportDlCqi({{rnti, 0}});
+        tester.ReportDlPacket(rnti, 3, 20);
+    }
+    tester.ConfigureDlLc(numUes, 3);
+
+    // the packets wait for one slot with the CQIs out of range
+    NS_TEST_ASSERT_MSG_EQ(tester.Trigger().size(), 0, "No DCI expected without CQI");
+
+    // one packet per symbol: the slot cannot serve all the UEs
+    for (uint16_t rnti = 1; rnti <= numUes; rnti++)
+    {
+        tester.ReportDlCqi({{rnti, 15}});
+    }
+    std::vector<DciInfoElementTdma> dcis = tester.Trigger();
+    NS_TEST_ASSERT_MSG_GT(dcis.size(), 0, "DCIs expected");
+    NS_TEST_ASSERT_MSG_LT(dcis.size(), numUes, "Too many UEs for one slot expected");
+    for (uint16_t i = 0; i < dcis.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(dcis[i].m_rnti, i + 1, "UEs not served by RNTI");
+    }
+}
+
+/**
+ * \brief Check that the MAC and RLC headers are counted in the size of a DL TB
+ */
+class FlexTtiSchedulerDlHeaderTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param schedulerType the TypeId name of the scheduler
+     */
+    FlexTtiSchedulerDlHeaderTestCase(std::string schedulerType)
+        : TestCase(schedulerType + ": headers of a DL TB"),
+          m_schedulerType(schedulerType)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    std::string m_schedulerType; //!< the TypeId name of the scheduler
+};
+
+void
+FlexTtiSchedulerDlHeaderTestCase::DoRun()
+{
+    FlexTtiSchedulerTester tester(m_schedulerType);
+    Ptr<MmWaveAmc> amc = CreateObject<MmWaveAmc>(tester.GetConfig());
+    const uint32_t hdrSize = 7; // MAC subheader and RLC header
+    // the data fits in one symbol, but not together with its headers
+    uint32_t bufSize = amc->CalculateTbSize(amc->GetMcsFromCqi(15), 1) - hdrSize / 2;
+
+    tester.ConfigureUe(1);
+    tester.ReportDlCqi({{1, 15}});
+    tester.ReportDlBuffer(1, 3, bufSize);
+    tester.Trigger();
+
+    const std::vector<TtiAllocInfo>& ttis = tester.GetLastTtis();
+    NS_TEST_ASSERT_MSG_EQ(ttis.size(), 1, "One DL TTI expected");
+    NS_TEST_ASSERT_MSG_EQ(+ttis[0].m_dci.m_numSym, 2, "One more symbol for the headers expected");
+    NS_TEST_ASSERT_MSG_EQ(ttis[0].m_rlcPduInfo.size(), 1, "One RLC PDU expected");
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(ttis[0].m_rlcPduInfo[0].m_size,
+                                bufSize + hdrSize,
+                                "RLC PDU with the data and its headers expected");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(ttis[0].m_rlcPduInfo[0].m_size,
+                                ttis[0].m_dci.m_tbSize,
+                                "RLC PDU exceeds the TB");
+}
+
+/**
+ * \brief Functional test suite for the Flex-TTI MAC schedulers
+ */
+class MmWaveFlexTtiSchedulerTestSuite : public TestSuite
+{
+  public:
+    MmWaveFlexTtiSchedulerTestSuite()
+        : TestSuite("mmwave-flex-tti-scheduler", Type::UNIT)
+    {
+        AddTestCase(new FlexTtiSchedulerReleaseTestCase("ns3::MmWaveFlexTtiMacScheduler"),
+                    Duration::QUICK);
+        AddTestCase(new FlexTtiSchedulerBsrOrderTestCase("ns3::MmWaveFlexTtiMacScheduler"),
+                    Duration::QUICK);
+        AddTestCase(new FlexTtiSchedulerPfUlAverageTestCase(), Duration::QUICK);
+        AddTestCase(new FlexTtiSchedulerPfTieTestCase(), Duration::QUICK);
+        AddTestCase(new FlexTtiSchedulerMaxRateMcsTestCase(), Duration::QUICK);
+        AddTestCase(new FlexTtiSchedulerMaxWeightTieTestCase(), Duration::QUICK);
+        for (const std::string schedulerType : {"ns3::MmWaveFlexTtiMacScheduler",
+                                                "ns3::MmWaveFlexTtiPfMacScheduler",
+                                                "ns3::MmWaveFlexTtiMaxRateMacScheduler"})
+        {
+            AddTestCase(new FlexTtiSchedulerDlRlcPduTestCase(schedulerType), Duration::QUICK);
+            AddTestCase(new FlexTtiSchedulerIdleUlTestCase(schedulerType), Duration::QUICK);
+            AddTestCase(new FlexTtiSchedulerDlHeaderTestCase(schedulerType), Duration::QUICK);
+        }
+        for (const std::string schedulerType : {"ns3::MmWaveFlexTtiMacScheduler",
+                                                "ns3::MmWaveFlexTtiPfMacScheduler",
+                                                "ns3::MmWaveFlexTtiMaxRateMacScheduler",
+                                                "ns3::MmWaveFlexTtiMaxWeightMacScheduler"})
+        {
+            AddTestCase(new FlexTtiSchedulerReleaseDataTestCase(schedulerType), Duration::QUICK);
+        }
+    }
+};
+
+static MmWaveFlexTtiSchedulerTestSuite
+    mmwaveFlexTtiSchedulerTestSuite; //!< Flex-TTI scheduler test suite
@@ -0,0 +1,129 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/beamforming-codebook.h"
+#include "ns3/mmwave-beamforming-model.h"
+#include "ns3/mmwave-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <ctime>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-install-perf-test.cc
+ * \ingroup test
+ *
+ * \brief Measure the time spent by MmWaveHelper to install the devices of a
+ * scenario with many UEs.
+ */
+
+/**
+ * \brief Install one eNB and m_numUes UEs with codebook-based beamforming
+ *
+ * The codebooks are imported at the first beam search, so none of them must
+ * be initialized once the devices are installed.
+ */
+class MmWaveInstallPerfTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param numUes the number of UEs to install
+     */
+    MmWaveInstallPerfTestCase(uint32_t numUes)
+        : TestCase("Installation time of " + std::to_string(numUes) + " UEs"),
+          m_numUes(numUes)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    uint32_t m_numUes; //!< UEs to install
+};
+
+void
+MmWaveInstallPerfTestCase::DoRun()
+{
+    std::string codebookDir = std::string(NS_TEST_SOURCEDIR) + "/../model/Codebooks/";
+
+    Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper>();
+    helper->SetPathlossModelType("ns3::ThreeGppUmaPropagationLossModel");
+    helper->SetChannelConditionModelType("ns3::ThreeGppUmaChannelConditionModel");
+    helper->SetChannelModelType("ns3::ThreeGppSpectrumPropagationLossModel");
+    helper->SetBeamformingModelType("ns3::MmWaveCodebookBeamforming");
+    helper->SetUeBeamformingCodebookAttribute("CodebookFilename",
+                                              StringValue(codebookDir + "2x2.txt"));
+    helper->SetEnbBeamformingCodebookAttribute("CodebookFilename",
+                                               StringValue(codebookDir + "8x8.txt"));
+
+    NodeContainer enbNodes;
+    enbNodes.Create(1);
+    NodeContainer ueNodes;
+    ueNodes.Create(m_numUes);
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(enbNodes);
+    mobility.SetPositionAllocator("ns3::RandomDiscPositionAllocator",
+                                  "Rho",
+                                  StringValue("ns3::UniformRandomVariable[Min=10|Max=200]"));
+    mobility.Install(ueNodes);
+
+    clock_t start = clock();
+    NetDeviceContainer enbDevs = helper->InstallEnbDevice(enbNodes);
+    NetDeviceContainer ueDevs = helper->InstallUeDevice(ueNodes);
+    clock_t installed = clock();
+
+    NS_TEST_ASSERT_MSG_EQ(ueDevs.GetN(), m_numUes, "Wrong number of UE devices");
+    uint32_t numInitializedCodebooks = 0;
+    for (NetDeviceContainer::Iterator it = ueDevs.Begin(); it != ueDevs.End(); ++it)
+    {
+        Ptr<MmWaveUeNetDevice> ueDev = DynamicCast<MmWaveUeNetDevice>(*it);
+        Ptr<BeamformingCodebook> codebook =
+            ueDev->GetAntenna(0)->GetObject<BeamformingCodebook>();
+        NS_TEST_ASSERT_MSG_NE(codebook, nullptr, "No codebook aggregated to the UE antenna");
+        numInitializedCodebooks += codebook->IsInitialized();
+    }
+    NS_TEST_ASSERT_MSG_EQ(numInitializedCodebooks,
+                          0,
+                          "The codebooks must be imported at the first beam search");
+
+    std::cout << GetName() << ": " << 1e3 * (installed - start) / CLOCKS_PER_SEC << " ms"
+              << std::endl;
+
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Performance suite for the installation of the devices
+ */
+class MmWaveInstallPerfTestSuite : public TestSuite
+{
+  public:
+    MmWaveInstallPerfTestSuite()
+        : TestSuite("mmwave-install-perf", Type::PERFORMANCE)
+    {
+        AddTestCase(new MmWaveInstallPerfTestCase(1000), Duration::QUICK);
+    }
+};
+
+static MmWaveInstallPerfTestSuite mmwaveInstallPerfTestSuite; //!< installation perf suite
@@ -22,8 +22,13 @@
 #include "ns3/mmwave-eesm-error-model.h"
 #include "ns3/mmwave-eesm-ir-t1.h"
 #include "ns3/mmwave-eesm-ir-t2.h"
+#include "ns3/mmwave-lte-mi-error-model.h"
+#include "ns3/object-factory.h"
 #include "ns3/test.h"
 
+#include <ctime>
+#include <iostream>
+
 using namespace ns3;
 using namespace mmwave;
 
@@ -305,3 +310,108 @@ class MmWaveTestL2smEesm : public TestSuite
 };
 
 static MmWaveTestL2smEesm mmwaveTestSuite; //!< MmWave test suite
+
+/**
+ * \brief Measure the cost of the error model evaluations of a slot
+ *
+ * Every slot decodes one TB per UE. The time spent is measured both when a new
+ * error model is created for every TB and when a single instance, created
+ * once, is reused for all the TBs (as done by MmWaveSpectrumPhy).
+ */
+class MmWaveErrorModelPerfTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param errorModelType the type of the error model to benchmark
+     */
+    MmWaveErrorModelPerfTestCase(TypeId errorModelType)
+        : TestCase("Slot processing time with " + errorModelType.GetName()),
+          m_errorModelType(errorModelType)
+    {
+    }
+
+  private:
+    void DoRun(void) override;
+
+    /**
+     * \brief Decode all the TBs of m_numSlots slots
+     * \param reuse if true, reuse the same error model instance for all the TBs
+     * \return the elapsed clock ticks
+     */
+    clock_t RunSlots(bool reuse) const;
+
+    TypeId m_errorModelType;                //!< the type of the error model
+    static const uint32_t m_numUes = 100;   //!< TBs decoded in each slot
+    static const uint32_t m_numSlots = 100; //!< number of simulated slots
+    static const uint32_t m_numRbs = 72;    //!< number of RBs in the SINR vector
+};
+
+clock_t
+MmWaveErrorModelPerfTestCase::RunSlots(bool reuse) const
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < m_numRbs; i++)
+    {
+        freqs.push_back(28e9 + i * 1e6);
+    }
+    SpectrumValue sinr(Create<SpectrumModel>(freqs));
+    std::vector<int> map;
+    for (uint32_t i = 0; i < m_numRbs; i++)
+    {
+        sinr[i] = 10.0 + i % 5;
+        map.push_back(i);
+    }
+
+    ObjectFactory emFactory;
+    emFactory.SetTypeId(m_errorModelType);
+    Ptr<MmWaveErrorModel> cached = DynamicCast<MmWaveErrorModel>(emFactory.Create());
+    uint8_t mcs = 10;
+    uint32_t tbSize = cached->GetPayloadSize(132, mcs, m_numRbs, MmWaveErrorModel::DL);
+
+    clock_t start = clock();
+    for (uint32_t slot = 0; slot < m_numSlots; slot++)
+    {
+        for (uint32_t ue = 0; ue < m_numUes; ue++)
+        {
+            Ptr<MmWaveErrorModel> em =
+                reuse ? cached : DynamicCast<MmWaveErrorModel>(emFactory.Create());
+            em->GetTbDecodificationStats(sinr,
+                                         map,
+                                         tbSize,
+                                         mcs,
+                                         MmWaveErrorModel::MmWaveErrorModelHistory());
+        }
+    }
+    return clock() - start;
+}
+
+void
+MmWaveErrorModelPerfTestCase::DoRun()
+{
+    clock_t perTb = RunSlots(false);
+    clock_t reused = RunSlots(true);
+
+    double slots = m_numSlots * double(CLOCKS_PER_SEC);
+    std::cout << GetName() << ": " << m_numUes << " TBs per slot" << std::endl
+              << "  new error model per TB: " << 1e6 * perTb / slots << " us/slot" << std::endl
+              << "  reused error model:     " << 1e6 * reused / slots << " us/slot" << std::endl;
+}
+
+/**
+ * \brief Performance suite for the error models used by MmWaveSpectrumPhy
+ */
+class MmWaveErrorModelPerfTestSuite : public TestSuite
+{
+  public:
+    MmWaveErrorModelPerfTestSuite()
+        : TestSuite("mmwave-error-model-perf", Type::PERFORMANCE)
+    {
+        AddTestCase(new MmWaveErrorModelPerfTestCase(MmWaveEesmIrT1::GetTypeId()),
+                    Duration::QUICK);
+        AddTestCase(new MmWaveErrorModelPerfTestCase(MmWaveLteMiErrorModel::GetTypeId()),
+                    Duration::QUICK);
+    }
+};
+
+static MmWaveErrorModelPerfTestSuite mmwaveErrorModelPerfTestSuite; //!< Error model perf suite
@@ -56,13 +56,16 @@ struct ByteTagListData
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<ByteTagListData*>
+class ByteTagListDataFreeList : public std::vector<ByteTagListData*>
 {
   public:
     ~ByteTagListDataFreeList();
-} g_freeList; //!< Container for struct ByteTagListData
+};
+
+/// Container for struct ByteTagListData, kept by each thread
+static thread_local ByteTagListDataFreeList g_freeList;
 
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+static thread_local uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList()
 {
@@ -36,10 +36,11 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
-bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+std::atomic<bool> PacketMetadata::m_metadataSkipped(false);
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+std::atomic<uint16_t> PacketMetadata::m_chunkUid(0);
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local bool PacketMetadata::m_freeListDestroyed = false;
 
 PacketMetadata::DataFreeList::~DataFreeList()
 {
@@ -48,7 +49,17 @@ PacketMetadata::DataFreeList::~DataFreeList()
     {
         PacketMetadata::Deallocate(*i);
     }
-    PacketMetadata::m_enable = false;
+    PacketMetadata::m_freeListDestroyed = true;
+}
+
+void
+PacketMetadata::MarkMetadataSkipped()
+{
+    // check first, so that the threads do not keep writing the shared flag
+    if (!m_metadataSkipped.load(std::memory_order_relaxed))
+    {
+        m_metadataSkipped.store(true, std::memory_order_relaxed);
+    }
 }
 
 void
@@ -572,7 +583,7 @@ PacketMetadata::Create(uint32_t size)
     {
         m_maxSize = size;
     }
-    while (!m_freeList.empty())
+    while (!m_freeListDestroyed && !m_freeList.empty())
     {
         PacketMetadata::Data* data = m_freeList.back();
         m_freeList.pop_back();
@@ -593,7 +604,7 @@ void
 PacketMetadata::Recycle(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    if (!m_enable)
+    if (!m_enable || m_freeListDestroyed)
     {
         PacketMetadata::Deallocate(data);
         return;
@@ -661,7 +672,7 @@ PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
     NS_LOG_FUNCTION(this << uid << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
 
@@ -670,8 +681,7 @@ PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
     item.prev = 0xffff;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = m_chunkUid++;
     uint16_t written = AddSmall(&item);
     UpdateHead(written);
 }
@@ -683,7 +693,7 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
     NS_LOG_FUNCTION(this << &header << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
     PacketMetadata::SmallItem item;
@@ -728,7 +738,7 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
     NS_LOG_FUNCTION(this << &trailer << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
     PacketMetadata::SmallItem item;
@@ -736,8 +746,7 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
     item.prev = m_tail;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = m_chunkUid++;
     uint16_t written = AddSmall(&item);
     UpdateTail(written);
     NS_ASSERT(IsStateOk());
@@ -750,7 +759,7 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
     NS_LOG_FUNCTION(this << &trailer << size);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
     PacketMetadata::SmallItem item;
@@ -794,7 +803,7 @@ PacketMetadata::AddAtEnd(const PacketMetadata& o)
     NS_LOG_FUNCTION(this << &o);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
     if (m_tail == 0xffff)
@@ -870,7 +879,7 @@ PacketMetadata::AddPaddingAtEnd(uint32_t end)
     NS_LOG_FUNCTION(this << end);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
 }
@@ -881,7 +890,7 @@ PacketMetadata::RemoveAtStart(uint32_t start)
     NS_LOG_FUNCTION(this << start);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
     NS_ASSERT(m_data != nullptr);
@@ -942,7 +951,7 @@ PacketMetadata::RemoveAtEnd(uint32_t end)
     NS_LOG_FUNCTION(this << end);
     if (!m_enable)
     {
-        m_metadataSkipped = true;
+        MarkMetadataSkipped();
         return;
     }
     NS_ASSERT(m_data != nullptr);
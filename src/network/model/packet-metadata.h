@@ -25,6 +25,7 @@
 #include "ns3/callback.h"
 #include "ns3/type-id.h"
 
+#include <atomic>
 #include <limits>
 #include <stdint.h>
 #include <vector>
@@ -675,19 +676,30 @@ class PacketMetadata
      */
     static void Deallocate(PacketMetadata::Data* data);
 
-    static DataFreeList m_freeList; //!< the metadata data storage
-    static bool m_enable;           //!< Enable the packet metadata
-    static bool m_enableChecking;   //!< Enable the packet metadata checking
+    /**
+     * \brief Record that adding metadata to a packet was skipped
+     */
+    static void MarkMetadataSkipped();
+
+    /*
+     * The free list and the maximum size are kept by each thread and the
+     * counters are atomic, so that the partitions of a ParallelSimulatorImpl
+     * can create and modify packets concurrently.
+     */
+    static thread_local DataFreeList m_freeList;  //!< the metadata data storage
+    static thread_local bool m_freeListDestroyed; //!< m_freeList has been destroyed
+    static bool m_enable;                         //!< Enable the packet metadata
+    static bool m_enableChecking;                 //!< Enable the packet metadata checking
 
     /**
      * Set to true when adding metadata to a packet is skipped because
      * m_enable is false; used to detect enabling of metadata in the
      * middle of a simulation, which isn't allowed.
      */
-    static bool m_metadataSkipped;
+    static std::atomic<bool> m_metadataSkipped;
 
-    static uint32_t m_maxSize;  //!< maximum metadata size
-    static uint16_t m_chunkUid; //!< Chunk Uid
+    static thread_local uint32_t m_maxSize;  //!< maximum metadata size
+    static std::atomic<uint16_t> m_chunkUid; //!< Chunk Uid
 
     Data* m_data; //!< Metadata storage
     /*
@@ -33,6 +33,7 @@
 #include "ns3/mac48-address.h"
 #include "ns3/ptr.h"
 
+#include <atomic>
 #include <stdint.h>
 
 namespace ns3
@@ -795,7 +796,12 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-    static uint32_t m_globalUid; //!< Global counter of packets Uid
+    /**
+     * Global counter of packets Uid. It is atomic, so that the packets
+     * created by several threads of a ParallelSimulatorImpl get distinct
+     * uids.
+     */
+    static std::atomic<uint32_t> m_globalUid;
 };
 
 /**
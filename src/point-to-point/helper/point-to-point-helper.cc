@@ -23,8 +23,10 @@
 #include "ns3/names.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/packet.h"
+#include "ns3/parallel-simulator-impl.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-partition-channel.h"
 #include "ns3/simulator.h"
 
 #ifdef NS3_MPI
@@ -262,40 +264,54 @@ PointToPointHelper::Install(Ptr<Node> a, Ptr<Node> b)
 
     Ptr<PointToPointChannel> channel = nullptr;
 
-    // If MPI is enabled, we need to see if both nodes have the same system id
-    // (rank), and the rank is the same as this instance.  If both are true,
-    // use a normal p2p channel, otherwise use a remote channel
-#ifdef NS3_MPI
-    bool useNormalChannel = true;
-    if (MpiInterface::IsEnabled())
+    // If the nodes are in different partitions of a ParallelSimulatorImpl,
+    // use a partition channel, which gives each packet a copy of its own
+    Ptr<ParallelSimulatorImpl> parallel =
+        DynamicCast<ParallelSimulatorImpl>(Simulator::GetImplementation());
+    if (parallel &&
+        parallel->GetContextPartition(a->GetId()) != parallel->GetContextPartition(b->GetId()))
     {
-        uint32_t n1SystemId = a->GetSystemId();
-        uint32_t n2SystemId = b->GetSystemId();
-        uint32_t currSystemId = MpiInterface::GetSystemId();
-        if (n1SystemId != currSystemId || n2SystemId != currSystemId)
-        {
-            useNormalChannel = false;
-        }
-    }
-    if (useNormalChannel)
-    {
-        m_channelFactory.SetTypeId("ns3::PointToPointChannel");
-        channel = m_channelFactory.Create<PointToPointChannel>();
+        ObjectFactory channelFactory = m_channelFactory;
+        channelFactory.SetTypeId("ns3::PointToPointPartitionChannel");
+        channel = channelFactory.Create<PointToPointPartitionChannel>();
     }
     else
     {
-        m_channelFactory.SetTypeId("ns3::PointToPointRemoteChannel");
-        channel = m_channelFactory.Create<PointToPointRemoteChannel>();
-        Ptr<MpiReceiver> mpiRecA = CreateObject<MpiReceiver>();
-        Ptr<MpiReceiver> mpiRecB = CreateObject<MpiReceiver>();
-        mpiRecA->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devA));
-        mpiRecB->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devB));
-        devA->AggregateObject(mpiRecA);
-        devB->AggregateObject(mpiRecB);
-    }
+        // If MPI is enabled, we need to see if both nodes have the same system id
+        // (rank), and the rank is the same as this instance.  If both are true,
+        // use a normal p2p channel, otherwise use a remote channel
+#ifdef NS3_MPI
+        bool useNormalChannel = true;
+        if (MpiInterface::IsEnabled())
+        {
+            uint32_t n1SystemId = a->GetSystemId();
+            uint32_t n2SystemId = b->GetSystemId();
+            uint32_t currSystemId = MpiInterface::GetSystemId();
+            if (n1SystemId != currSystemId || n2SystemId != currSystemId)
+            {
+                useNormalChannel = false;
+            }
+        }
+        if (useNormalChannel)
+        {
+            m_channelFactory.SetTypeId("ns3::PointToPointChannel");
+            channel = m_channelFactory.Create<PointToPointChannel>();
+        }
+        else
+        {
+            m_channelFactory.SetTypeId("ns3::PointToPointRemoteChannel");
+            channel = m_channelFactory.Create<PointToPointRemoteChannel>();
+            Ptr<MpiReceiver> mpiRecA = CreateObject<MpiReceiver>();
+            Ptr<MpiReceiver> mpiRecB = CreateObject<MpiReceiver>();
+            mpiRecA->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devA));
+            mpiRecB->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devB));
+            devA->AggregateObject(mpiRecA);
+            devB->AggregateObject(mpiRecB);
+        }
 #else
-    channel = m_channelFactory.Create<PointToPointChannel>();
+        channel = m_channelFactory.Create<PointToPointChannel>();
 #endif
+    }
 
     devA->Attach(channel);
     devB->Attach(channel);
@@ -122,7 +122,10 @@ class PointToPointHelper : public PcapHelperForDevice, public AsciiTraceHelperFo
      *
      * Saves you from having to construct a temporary NodeContainer.
      * Also, if MPI is enabled, for distributed simulations,
-     * appropriate remote point-to-point channels are created.
+     * appropriate remote point-to-point channels are created, and if the
+     * nodes are in different partitions of a ParallelSimulatorImpl, a
+     * PointToPointPartitionChannel is created: the partitions must be
+     * assigned before calling this method.
      */
     NetDeviceContainer Install(Ptr<Node> a, Ptr<Node> b);
 
@@ -129,6 +129,15 @@ PointToPointChannel::GetDevice(std::size_t i) const
     return GetPointToPointDevice(i);
 }
 
+Address
+PointToPointChannel::GetRemoteAddress(const PointToPointNetDevice* device) const
+{
+    NS_LOG_FUNCTION(this << device);
+    NS_ASSERT(m_nDevices == N_DEVICES);
+    return PeekPointer(m_link[0].m_src) == device ? m_link[1].m_src->GetAddress()
+                                                  : m_link[0].m_src->GetAddress();
+}
+
 Time
 PointToPointChannel::GetDelay() const
 {
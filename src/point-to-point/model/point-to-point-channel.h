@@ -18,6 +18,7 @@
 #ifndef POINT_TO_POINT_CHANNEL_H
 #define POINT_TO_POINT_CHANNEL_H
 
+#include "ns3/address.h"
 #include "ns3/channel.h"
 #include "ns3/data-rate.h"
 #include "ns3/nstime.h"
@@ -70,7 +71,7 @@ class PointToPointChannel : public Channel
      * \brief Attach a given netdevice to this channel
      * \param device pointer to the netdevice to attach to the channel
      */
-    void Attach(Ptr<PointToPointNetDevice> device);
+    virtual void Attach(Ptr<PointToPointNetDevice> device);
 
     /**
      * \brief Transmit a packet over this channel
@@ -101,6 +102,17 @@ class PointToPointChannel : public Channel
      */
     Ptr<NetDevice> GetDevice(std::size_t i) const override;
 
+    /**
+     * \brief Get the address of the device at the other end of the channel
+     *
+     * Unlike GetDevice, it does not copy a Ptr to the other device, so the
+     * device may call it when the two devices are used by different threads.
+     *
+     * \param device the device attached to this channel
+     * \returns the address of the other device
+     */
+    Address GetRemoteAddress(const PointToPointNetDevice* device) const;
+
   protected:
     /**
      * \brief Get the delay associated with this channel
@@ -0,0 +1,93 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "point-to-point-partition-channel.h"
+
+#include "point-to-point-net-device.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointPartitionChannel");
+
+NS_OBJECT_ENSURE_REGISTERED(PointToPointPartitionChannel);
+
+TypeId
+PointToPointPartitionChannel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::PointToPointPartitionChannel")
+                            .SetParent<PointToPointChannel>()
+                            .SetGroupName("PointToPoint")
+                            .AddConstructor<PointToPointPartitionChannel>();
+    return tid;
+}
+
+PointToPointPartitionChannel::PointToPointPartitionChannel()
+    : PointToPointChannel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PointToPointPartitionChannel::Attach(Ptr<PointToPointNetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    NS_ASSERT_MSG(device->GetNode(), "The device must be added to its node first");
+    PointToPointChannel::Attach(device);
+    if (GetNDevices() == 2)
+    {
+        for (uint32_t wire = 0; wire < 2; ++wire)
+        {
+            m_src[wire] = PeekPointer(GetSource(wire));
+            m_dst[wire] = PeekPointer(GetDestination(wire));
+            m_dstNode[wire] = m_dst[wire]->GetNode()->GetId();
+        }
+    }
+}
+
+bool
+PointToPointPartitionChannel::TransmitStart(Ptr<const Packet> p,
+                                            Ptr<PointToPointNetDevice> src,
+                                            Time txTime)
+{
+    NS_LOG_FUNCTION(this << p << src);
+    NS_LOG_LOGIC("UID is " << p->GetUid() << ")");
+
+    IsInitialized();
+
+    uint32_t wire = PeekPointer(src) == m_src[0] ? 0 : 1;
+
+    // A copy made by Packet::Copy shares its buffers with p, so serialize p
+    // to give the other partition a packet of its own.
+    std::vector<uint8_t> buffer(p->GetSerializedSize());
+    p->Serialize(buffer.data(), buffer.size());
+    Ptr<Packet> copy = Create<Packet>(buffer.data(), buffer.size(), true);
+
+    Simulator::ScheduleWithContext(m_dstNode[wire],
+                                   txTime + GetDelay(),
+                                   &PointToPointNetDevice::Receive,
+                                   m_dst[wire],
+                                   copy);
+    return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,88 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef POINT_TO_POINT_PARTITION_CHANNEL_H
+#define POINT_TO_POINT_PARTITION_CHANNEL_H
+
+#include "point-to-point-channel.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ *
+ * \brief A Point-To-Point Channel between two partitions of a
+ * ParallelSimulatorImpl
+ *
+ * This object connects two point-to-point net devices whose nodes are in
+ * different partitions, so that their events may be executed by different
+ * threads at the same time. It delivers a deep copy of each packet,
+ * obtained by serializing it, so that the two threads never share a
+ * reference-counted object: the reference counts are not atomic. For the
+ * same reason, it does not fire the TxRxPointToPoint trace source, whose
+ * arguments hold the receiving device.
+ *
+ * The propagation delay of the channel must not be smaller than the
+ * Lookahead attribute of the ParallelSimulatorImpl.
+ */
+class PointToPointPartitionChannel : public PointToPointChannel
+{
+  public:
+    /**
+     * \brief Get the TypeId
+     *
+     * \return The TypeId for this class
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Constructor
+     */
+    PointToPointPartitionChannel();
+
+    /**
+     * \brief Attach a given netdevice to this channel
+     *
+     * The device must already be added to its node.
+     *
+     * \param device pointer to the netdevice to attach to the channel
+     */
+    void Attach(Ptr<PointToPointNetDevice> device) override;
+
+    /**
+     * \brief Transmit the packet
+     *
+     * \param p Packet to transmit
+     * \param src Source PointToPointNetDevice
+     * \param txTime Transmit time to apply
+     * \returns true if successful (currently always true)
+     */
+    bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override;
+
+  private:
+    /*
+     * The devices and the ids of their nodes, cached when the second device
+     * is attached, so that TransmitStart does not copy a Ptr to the device
+     * or to the node of the other partition.
+     */
+    const PointToPointNetDevice* m_src[2]{nullptr, nullptr}; //!< Source device of each wire
+    PointToPointNetDevice* m_dst[2]{nullptr, nullptr};       //!< Destination device of each wire
+    uint32_t m_dstNode[2]{0, 0}; //!< Node id of the destination device of each wire
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_PARTITION_CHANNEL_H */
@@ -17,14 +17,23 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include "ns3/config.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/node-container.h"
+#include "ns3/parallel-simulator-impl.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-partition-channel.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 #include <string>
+#include <tuple>
+#include <vector>
 
 using namespace ns3;
 
@@ -139,6 +148,183 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test class for the PointToPointPartitionChannel
+ *
+ * Pairs of nodes, whose nodes are in different partitions of a
+ * ParallelSimulatorImpl, exchange packets of decreasing sizes over
+ * point-to-point links. The packets received by each node must be the same
+ * as with DefaultSimulatorImpl, whatever the number of threads, and their
+ * payloads must be intact.
+ */
+class PointToPointPartitionTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointPartitionTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /** The packets received by a node: time stamp, size and payload check. */
+    using Received = std::vector<std::tuple<int64_t, uint32_t, bool>>;
+
+    /**
+     * \brief Run the scenario
+     *
+     * \param simulatorType The simulator implementation.
+     * \param threads The number of threads of ParallelSimulatorImpl.
+     */
+    void RunScenario(const std::string& simulatorType, uint32_t threads);
+    /**
+     * \brief Send a packet whose payload is computed from its size
+     *
+     * \param device The sending device.
+     * \param size The size of the packet.
+     */
+    static void SendPacket(Ptr<NetDevice> device, uint32_t size);
+    /**
+     * \brief Record a packet and reply with a smaller one
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+
+    std::vector<Received> m_received; //!< The packets received by each node
+    uint32_t m_firstNodeId;           //!< Id of the first node
+    uint32_t m_partitionChannels;     //!< Number of partition channels created
+};
+
+/** Number of nodes of PointToPointPartitionTest. */
+static constexpr uint32_t PARTITION_TEST_NODES = 8;
+
+PointToPointPartitionTest::PointToPointPartitionTest()
+    : TestCase("PointToPoint between the partitions of a ParallelSimulatorImpl")
+{
+}
+
+void
+PointToPointPartitionTest::SendPacket(Ptr<NetDevice> device, uint32_t size)
+{
+    std::vector<uint8_t> payload(size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        payload[i] = static_cast<uint8_t>(size + i * 7);
+    }
+    device->Send(Create<Packet>(payload.data(), size), device->GetBroadcast(), 0x800);
+}
+
+bool
+PointToPointPartitionTest::RxPacket(Ptr<NetDevice> dev,
+                                    Ptr<const Packet> pkt,
+                                    uint16_t mode,
+                                    const Address& sender)
+{
+    uint32_t size = pkt->GetSize();
+    std::vector<uint8_t> payload(size);
+    pkt->CopyData(payload.data(), size);
+    bool intact = true;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        intact = intact && payload[i] == static_cast<uint8_t>(size + i * 7);
+    }
+    // only the data of this node, the partitions may run concurrently
+    m_received[Simulator::GetContext() - m_firstNodeId].emplace_back(
+        Simulator::Now().GetTimeStep(),
+        size,
+        intact);
+    if (size > 100)
+    {
+        SendPacket(dev, size - 37);
+    }
+    return true;
+}
+
+void
+PointToPointPartitionTest::RunScenario(const std::string& simulatorType, uint32_t threads)
+{
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue(simulatorType));
+    Config::SetDefault("ns3::ParallelSimulatorImpl::ThreadCount", UintegerValue(threads));
+    Config::SetDefault("ns3::ParallelSimulatorImpl::Lookahead", TimeValue(MilliSeconds(1)));
+    m_received.assign(PARTITION_TEST_NODES, {});
+    m_partitionChannels = 0;
+
+    NodeContainer nodes(PARTITION_TEST_NODES);
+    m_firstNodeId = nodes.Get(0)->GetId();
+    // the partitions must be known before the links are installed
+    Ptr<ParallelSimulatorImpl> impl =
+        DynamicCast<ParallelSimulatorImpl>(Simulator::GetImplementation());
+    for (uint32_t i = 0; impl && i < PARTITION_TEST_NODES; ++i)
+    {
+        impl->SetContextPartition(nodes.Get(i)->GetId(), 1 + i % 4);
+    }
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("1ms"));
+    for (uint32_t i = 0; i < PARTITION_TEST_NODES; i += 2)
+    {
+        NetDeviceContainer devices = p2p.Install(nodes.Get(i), nodes.Get(i + 1));
+        for (uint32_t j = 0; j < 2; ++j)
+        {
+            devices.Get(j)->SetReceiveCallback(
+                MakeCallback(&PointToPointPartitionTest::RxPacket, this));
+        }
+        if (DynamicCast<PointToPointPartitionChannel>(devices.Get(0)->GetChannel()))
+        {
+            m_partitionChannels++;
+        }
+        Simulator::ScheduleWithContext(nodes.Get(i)->GetId(),
+                                       MicroSeconds(10 * i),
+                                       &PointToPointPartitionTest::SendPacket,
+                                       devices.Get(0),
+                                       1400 - 100 * i);
+    }
+
+    Simulator::Run();
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+void
+PointToPointPartitionTest::DoRun()
+{
+    RunScenario("ns3::DefaultSimulatorImpl", 1);
+    NS_TEST_EXPECT_MSG_EQ(m_partitionChannels, 0, "No partition channel expected");
+    std::vector<Received> reference = m_received;
+
+    for (uint32_t threads : {1, 4})
+    {
+        RunScenario("ns3::ParallelSimulatorImpl", threads);
+        NS_TEST_EXPECT_MSG_EQ(m_partitionChannels,
+                              PARTITION_TEST_NODES / 2,
+                              "The links cross the partitions");
+        for (uint32_t node = 0; node < PARTITION_TEST_NODES; ++node)
+        {
+            NS_TEST_EXPECT_MSG_GT(m_received[node].size(), 5, "Too few packets received");
+            for (const auto& [time, size, intact] : m_received[node])
+            {
+                NS_TEST_EXPECT_MSG_EQ(intact, true, "Corrupted payload of size " << size);
+            }
+            NS_TEST_EXPECT_MSG_EQ((m_received[node] == reference[node]),
+                                  true,
+                                  "Packets of the node " << node << " differ with " << threads
+                                                         << " threads");
+        }
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +341,7 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", Type::UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::Duration::QUICK);
+    AddTestCase(new PointToPointPartitionTest, TestCase::Duration::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -39,6 +39,7 @@
 #include <ns3/simulator.h>
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <utility>
 
@@ -81,7 +82,10 @@ RxSpectrumModelInfo::RxSpectrumModelInfo(Ptr<const SpectrumModel> rxSpectrumMode
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel()
-    : m_numDevices{0}
+    : m_numDevices{0},
+      m_maxRange{0},
+      m_rxIndexValid{false},
+      m_rxIndexMaxSpeed{0}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -92,6 +96,12 @@ MultiModelSpectrumChannel::DoDispose()
     NS_LOG_FUNCTION(this);
     m_txSpectrumModelInfoMap.clear();
     m_rxSpectrumModelInfoMap.clear();
+    DisconnectRxIndexMobility();
+    m_rxIndexPhys.clear();
+    m_rxIndexModelUids.clear();
+    m_rxGrid.clear();
+    m_rxUnindexed.clear();
+    m_rxIndexValid = false;
     SpectrumChannel::DoDispose();
 }
 
@@ -102,6 +112,15 @@ MultiModelSpectrumChannel::GetTypeId()
                             .SetParent<SpectrumChannel>()
                             .SetGroupName("Spectrum")
                             .AddConstructor<MultiModelSpectrumChannel>()
+                            .AddAttribute(
+                                "MaxRange",
+                                "If positive, only the receivers within this distance (in meters) "
+                                "from the transmitter are considered for each transmission, using "
+                                "a spatial index of the receivers. Receivers without a mobility "
+                                "model are always considered. 0 disables the culling.",
+                                DoubleValue(0),
+                                MakeDoubleAccessor(&MultiModelSpectrumChannel::m_maxRange),
+                                MakeDoubleChecker<double>(0))
 
         ;
     return tid;
@@ -127,6 +146,7 @@ MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
         {
             rxInfoIterator->second.m_rxPhys.erase(phyIt);
             --m_numDevices;
+            m_rxIndexValid = false;
             break; // there should be at most one entry
         }
     }
@@ -155,6 +175,7 @@ MultiModelSpectrumChannel::AddRx(Ptr<SpectrumPhy> phy)
     // rxInfoIterator points either to the newly inserted element or to the element that
     // prevented insertion. In both cases, add the phy to the element pointed to by rxInfoIterator
     rxInfoIterator->second.m_rxPhys.push_back(phy);
+    m_rxIndexValid = false;
 
     if (inserted)
     {
@@ -231,15 +252,57 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
 
     NS_ASSERT(txParams->txPhy);
     NS_ASSERT(txParams->psd);
-    Ptr<SpectrumSignalParameters> txParamsTrace =
-        txParams->Copy(); // copy it since traced value cannot be const (because of potential
-                          // underlying DynamicCasts)
-    m_txSigParamsTrace(txParamsTrace);
+    if (!m_txSigParamsTrace.IsEmpty())
+    {
+        Ptr<SpectrumSignalParameters> txParamsTrace =
+            txParams->Copy(); // copy it since traced value cannot be const (because of potential
+                              // underlying DynamicCasts)
+        m_txSigParamsTrace(txParamsTrace);
+    }
 
     auto txMobility = txParams->txPhy->GetMobility();
     auto txSpectrumModelUid = txParams->psd->GetSpectrumModelUid();
     NS_LOG_LOGIC("txSpectrumModelUid " << txSpectrumModelUid);
 
+    if (m_maxRange > 0 && txMobility)
+    {
+        Time now = Simulator::Now();
+        if (m_rxIndexValid && m_rxIndexMaxSpeed * (now - m_rxIndexTime).GetSeconds() > m_maxRange)
+        {
+            // the receivers may have moved too far from their indexed cells
+            m_rxIndexValid = false;
+        }
+        if (!m_rxIndexValid)
+        {
+            BuildRxIndex();
+        }
+
+        Vector txPosition = txMobility->GetPosition();
+        std::vector<uint32_t> candidates;
+        GetRxCandidates(txPosition, candidates);
+        NS_LOG_LOGIC(candidates.size() << " candidate receivers out of " << m_rxIndexPhys.size());
+
+        for (uint32_t i : candidates)
+        {
+            Ptr<SpectrumPhy> rxPhy = m_rxIndexPhys[i];
+            NS_ASSERT_MSG(rxPhy->GetRxSpectrumModel()->GetUid() == m_rxIndexModelUids[i],
+                          "SpectrumModel change was not notified to MultiModelSpectrumChannel "
+                          "(i.e., AddRx should be called again after model is changed)");
+            if (rxPhy == txParams->txPhy)
+            {
+                continue;
+            }
+            auto receiverMobility = rxPhy->GetMobility();
+            if (receiverMobility &&
+                CalculateDistance(txPosition, receiverMobility->GetPosition()) > m_maxRange)
+            {
+                continue;
+            }
+            StartTxToReceiver(txParams, txMobility, rxPhy);
+        }
+        return;
+    }
+
     for (auto rxInfoIterator = m_rxSpectrumModelInfoMap.begin();
          rxInfoIterator != m_rxSpectrumModelInfoMap.end();
          ++rxInfoIterator)
@@ -257,109 +320,220 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
 
             if ((*rxPhyIterator) != txParams->txPhy)
             {
-                auto rxNetDevice = (*rxPhyIterator)->GetDevice();
-                auto txNetDevice = txParams->txPhy->GetDevice();
-
-                if (rxNetDevice && txNetDevice)
-                {
-                    // we assume that devices are attached to a node
-                    if (rxNetDevice->GetNode()->GetId() == txNetDevice->GetNode()->GetId())
-                    {
-                        NS_LOG_DEBUG(
-                            "Skipping the pathloss calculation among different antennas of the "
-                            "same node, not supported yet by any pathloss model in ns-3.");
-                        continue;
-                    }
-                }
-
-                if (m_filter && m_filter->Filter(txParams, *rxPhyIterator))
-                {
-                    continue;
-                }
-
-                NS_LOG_LOGIC("copying signal parameters " << txParams);
-                auto rxParams = txParams->Copy();
-                rxParams->psd = Copy<SpectrumValue>(txParams->psd);
-                Time delay{0};
-
-                auto receiverMobility = (*rxPhyIterator)->GetMobility();
-
-                if (txMobility && receiverMobility)
-                {
-                    auto txAntennaGain{0.0};
-                    auto rxAntennaGain{0.0};
-                    auto propagationGainDb{0.0};
-                    auto pathLossDb{0.0};
-                    if (rxParams->txAntenna)
-                    {
-                        Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
-                        txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
-                        NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
-                        pathLossDb -= txAntennaGain;
-                    }
-                    auto rxAntenna = DynamicCast<AntennaModel>((*rxPhyIterator)->GetAntenna());
-                    if (rxAntenna)
-                    {
-                        Angles rxAngles(txMobility->GetPosition(), receiverMobility->GetPosition());
-                        rxAntennaGain = rxAntenna->GetGainDb(rxAngles);
-                        NS_LOG_LOGIC("rxAntennaGain = " << rxAntennaGain << " dB");
-                        pathLossDb -= rxAntennaGain;
-                    }
-                    if (m_propagationLoss)
-                    {
-                        propagationGainDb =
-                            m_propagationLoss->CalcRxPower(0, txMobility, receiverMobility);
-                        NS_LOG_LOGIC("propagationGainDb = " << propagationGainDb << " dB");
-                        pathLossDb -= propagationGainDb;
-                    }
-                    NS_LOG_LOGIC("total pathLoss = " << pathLossDb << " dB");
-                    // Gain trace
-                    m_gainTrace(txMobility,
-                                receiverMobility,
-                                txAntennaGain,
-                                rxAntennaGain,
-                                propagationGainDb,
-                                pathLossDb);
-                    // Pathloss trace
-                    m_pathLossTrace(txParams->txPhy, *rxPhyIterator, pathLossDb);
-                    if (pathLossDb > m_maxLossDb)
-                    {
-                        // beyond range
-                        continue;
-                    }
-                    auto pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-                    *(rxParams->psd) *= pathGainLinear;
-
-                    if (m_propagationDelay)
-                    {
-                        delay = m_propagationDelay->GetDelay(txMobility, receiverMobility);
-                    }
-                }
-
-                if (rxNetDevice)
-                {
-                    // the receiver has a NetDevice, so we expect that it is attached to a Node
-                    auto dstNode = rxNetDevice->GetNode()->GetId();
-                    Simulator::ScheduleWithContext(dstNode,
-                                                   delay,
-                                                   &MultiModelSpectrumChannel::StartRx,
-                                                   this,
-                                                   rxParams,
-                                                   *rxPhyIterator);
-                }
-                else
-                {
-                    // the receiver is not attached to a NetDevice, so we cannot assume that it is
-                    // attached to a node
-                    Simulator::Schedule(delay,
-                                        &MultiModelSpectrumChannel::StartRx,
-                                        this,
-                                        rxParams,
-                                        *rxPhyIterator);
-                }
+                StartTxToReceiver(txParams, txMobility, *rxPhyIterator);
+            }
+        }
+    }
+}
+
+void
+MultiModelSpectrumChannel::StartTxToReceiver(Ptr<SpectrumSignalParameters> txParams,
+                                             Ptr<MobilityModel> txMobility,
+                                             Ptr<SpectrumPhy> rxPhy)
+{
+    NS_LOG_FUNCTION(this << txParams << rxPhy);
+
+    auto rxNetDevice = rxPhy->GetDevice();
+    auto txNetDevice = txParams->txPhy->GetDevice();
+
+    if (rxNetDevice && txNetDevice)
+    {
+        // we assume that devices are attached to a node
+        if (rxNetDevice->GetNode()->GetId() == txNetDevice->GetNode()->GetId())
+        {
+            NS_LOG_DEBUG("Skipping the pathloss calculation among different antennas of the "
+                         "same node, not supported yet by any pathloss model in ns-3.");
+            return;
+        }
+    }
+
+    if (m_filter && m_filter->Filter(txParams, rxPhy))
+    {
+        return;
+    }
+
+    Time delay{0};
+    double pathGainLinear{1.0};
+
+    auto receiverMobility = rxPhy->GetMobility();
+
+    if (txMobility && receiverMobility)
+    {
+        auto txAntennaGain{0.0};
+        auto rxAntennaGain{0.0};
+        auto propagationGainDb{0.0};
+        auto pathLossDb{0.0};
+        if (txParams->txAntenna)
+        {
+            Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
+            txAntennaGain = txParams->txAntenna->GetGainDb(txAngles);
+            NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
+            pathLossDb -= txAntennaGain;
+        }
+        auto rxAntenna = DynamicCast<AntennaModel>(rxPhy->GetAntenna());
+        if (rxAntenna)
+        {
+            Angles rxAngles(txMobility->GetPosition(), receiverMobility->GetPosition());
+            rxAntennaGain = rxAntenna->GetGainDb(rxAngles);
+            NS_LOG_LOGIC("rxAntennaGain = " << rxAntennaGain << " dB");
+            pathLossDb -= rxAntennaGain;
+        }
+        if (m_propagationLoss)
+        {
+            propagationGainDb = m_propagationLoss->CalcRxPower(0, txMobility, receiverMobility);
+            NS_LOG_LOGIC("propagationGainDb = " << propagationGainDb << " dB");
+            pathLossDb -= propagationGainDb;
+        }
+        NS_LOG_LOGIC("total pathLoss = " << pathLossDb << " dB");
+        // Gain trace
+        m_gainTrace(txMobility,
+                    receiverMobility,
+                    txAntennaGain,
+                    rxAntennaGain,
+                    propagationGainDb,
+                    pathLossDb);
+        // Pathloss trace
+        m_pathLossTrace(txParams->txPhy, rxPhy, pathLossDb);
+        if (pathLossDb > m_maxLossDb)
+        {
+            // beyond range
+            return;
+        }
+        pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
+
+        if (m_propagationDelay)
+        {
+            delay = m_propagationDelay->GetDelay(txMobility, receiverMobility);
+        }
+    }
+
+    // the signal parameters (and their PSD) are copied only for the receivers within range
+    NS_LOG_LOGIC("copying signal parameters " << txParams);
+    auto rxParams = txParams->Copy();
+    if (pathGainLinear != 1.0)
+    {
+        *(rxParams->psd) *= pathGainLinear;
+    }
+
+    if (rxNetDevice)
+    {
+        // the receiver has a NetDevice, so we expect that it is attached to a Node
+        auto dstNode = rxNetDevice->GetNode()->GetId();
+        Simulator::ScheduleWithContext(dstNode,
+                                       delay,
+                                       &MultiModelSpectrumChannel::StartRx,
+                                       this,
+                                       rxParams,
+                                       rxPhy);
+    }
+    else
+    {
+        // the receiver is not attached to a NetDevice, so we cannot assume that it is
+        // attached to a node
+        Simulator::Schedule(delay, &MultiModelSpectrumChannel::StartRx, this, rxParams, rxPhy);
+    }
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetRxGridKey(int64_t x, int64_t y)
+{
+    // shift the unsigned representation, left-shifting a negative value is undefined
+    return (static_cast<uint64_t>(x) << 32) ^ (static_cast<uint64_t>(y) & 0xffffffff);
+}
+
+void
+MultiModelSpectrumChannel::DisconnectRxIndexMobility()
+{
+    for (const auto& mobility : m_rxIndexMobility)
+    {
+        mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&MultiModelSpectrumChannel::NotifyRxCourseChange, this));
+    }
+    m_rxIndexMobility.clear();
+}
+
+void
+MultiModelSpectrumChannel::NotifyRxCourseChange(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    // the trace is being invoked, hence the rebuild (which disconnects it) is deferred
+    m_rxIndexValid = false;
+}
+
+void
+MultiModelSpectrumChannel::BuildRxIndex()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_maxRange > 0);
+
+    DisconnectRxIndexMobility();
+    m_rxIndexPhys.clear();
+    m_rxIndexModelUids.clear();
+    m_rxGrid.clear();
+    m_rxUnindexed.clear();
+    m_rxIndexMaxSpeed = 0;
+    for (const auto& rxInfo : m_rxSpectrumModelInfoMap)
+    {
+        for (const auto& rxPhy : rxInfo.second.m_rxPhys)
+        {
+            uint32_t i = m_rxIndexPhys.size();
+            m_rxIndexPhys.push_back(rxPhy);
+            m_rxIndexModelUids.push_back(rxInfo.first);
+
+            auto mobility = rxPhy->GetMobility();
+            if (!mobility)
+            {
+                m_rxUnindexed.push_back(i);
+                continue;
+            }
+            Vector position = mobility->GetPosition();
+            auto x = static_cast<int64_t>(std::floor(position.x / m_maxRange));
+            auto y = static_cast<int64_t>(std::floor(position.y / m_maxRange));
+            m_rxGrid[GetRxGridKey(x, y)].push_back(i);
+            m_rxIndexMaxSpeed = std::max(m_rxIndexMaxSpeed, mobility->GetVelocity().GetLength());
+
+            if (m_rxIndexMobility.insert(mobility).second)
+            {
+                mobility->TraceConnectWithoutContext(
+                    "CourseChange",
+                    MakeCallback(&MultiModelSpectrumChannel::NotifyRxCourseChange, this));
+            }
+        }
+    }
+    m_rxIndexTime = Simulator::Now();
+    m_rxIndexValid = true;
+    NS_LOG_LOGIC("indexed " << m_rxIndexPhys.size() << " receivers in " << m_rxGrid.size()
+                            << " cells");
+}
+
+void
+MultiModelSpectrumChannel::GetRxCandidates(const Vector& position,
+                                           std::vector<uint32_t>& candidates) const
+{
+    // widen the search by the distance the receivers may have travelled since the last rebuild
+    double radius =
+        m_maxRange + m_rxIndexMaxSpeed * (Simulator::Now() - m_rxIndexTime).GetSeconds();
+    auto minX = static_cast<int64_t>(std::floor((position.x - radius) / m_maxRange));
+    auto maxX = static_cast<int64_t>(std::floor((position.x + radius) / m_maxRange));
+    auto minY = static_cast<int64_t>(std::floor((position.y - radius) / m_maxRange));
+    auto maxY = static_cast<int64_t>(std::floor((position.y + radius) / m_maxRange));
+
+    candidates = m_rxUnindexed;
+    for (int64_t x = minX; x <= maxX; x++)
+    {
+        for (int64_t y = minY; y <= maxY; y++)
+        {
+            auto cell = m_rxGrid.find(GetRxGridKey(x, y));
+            if (cell != m_rxGrid.end())
+            {
+                candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
             }
         }
     }
+    // keep the order in which the receivers are visited without the index, so that the
+    // receptions are scheduled in the same order
+    std::sort(candidates.begin(), candidates.end());
 }
 
 void
@@ -25,10 +25,13 @@
 #include "spectrum-propagation-loss-model.h"
 #include "spectrum-value.h"
 
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
 #include <ns3/propagation-delay-model.h>
 
 #include <map>
 #include <set>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -99,6 +102,16 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * If the MaxRange attribute is set, the receivers are kept in a uniform grid
+ * of MaxRange-sized cells, and StartTx only considers the receivers with a
+ * mobility model within MaxRange of the transmitter. The grid is rebuilt
+ * lazily after receivers are added or removed, or after a CourseChange of
+ * their mobility; between rebuilds the search radius is widened by the
+ * distance the receivers may have travelled at their last known velocity.
+ * Culled receivers are skipped before any signal copy, antenna gain or
+ * propagation loss computation, hence they do not fire the Gain and
+ * PathLoss traces.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -145,6 +158,53 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      */
     virtual void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+    /**
+     * Compute the gains between the transmitter and one receiver, and
+     * schedule the reception if the receiver is within range.
+     *
+     * \param txParams The signal parameters.
+     * \param txMobility The mobility of the transmitter, possibly null.
+     * \param rxPhy The receiver SpectrumPhy.
+     */
+    void StartTxToReceiver(Ptr<SpectrumSignalParameters> txParams,
+                           Ptr<MobilityModel> txMobility,
+                           Ptr<SpectrumPhy> rxPhy);
+
+    /**
+     * Rebuild the spatial index of the receivers, used when MaxRange is set.
+     */
+    void BuildRxIndex();
+
+    /**
+     * Invalidate the spatial index of the receivers when one of them changes course.
+     *
+     * \param mobility The mobility model of the receiver.
+     */
+    void NotifyRxCourseChange(Ptr<const MobilityModel> mobility);
+
+    /**
+     * Disconnect from the CourseChange traces of the indexed receivers.
+     */
+    void DisconnectRxIndexMobility();
+
+    /**
+     * Get the key of the grid cell with the given coordinates.
+     *
+     * \param x The cell index along the x axis.
+     * \param y The cell index along the y axis.
+     * \return the key of the cell in m_rxGrid
+     */
+    static uint64_t GetRxGridKey(int64_t x, int64_t y);
+
+    /**
+     * Collect the receivers which may be within MaxRange of a position.
+     *
+     * \param position The position of the transmitter.
+     * \param [out] candidates The indices in m_rxIndexPhys of the receivers,
+     * in increasing order.
+     */
+    void GetRxCandidates(const Vector& position, std::vector<uint32_t>& candidates) const;
+
     /**
      * Data structure holding, for each TX SpectrumModel,  all the
      * converters to any RX SpectrumModel, and all the corresponding
@@ -163,6 +223,21 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      * Number of devices connected to the channel.
      */
     std::size_t m_numDevices;
+
+    double m_maxRange; //!< max distance of the receivers considered by StartTx, 0 to disable
+
+    /**
+     * All the receivers, in the order in which StartTx visits them without
+     * the spatial index.
+     */
+    std::vector<Ptr<SpectrumPhy>> m_rxIndexPhys;
+    std::vector<SpectrumModelUid_t> m_rxIndexModelUids; //!< Rx SpectrumModel of each receiver
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_rxGrid; //!< receivers in each cell
+    std::vector<uint32_t> m_rxUnindexed; //!< receivers without a mobility model
+    std::set<Ptr<MobilityModel>> m_rxIndexMobility; //!< mobility models traced by the index
+    bool m_rxIndexValid;                             //!< whether the index is up to date
+    Time m_rxIndexTime;                              //!< time of the last rebuild
+    double m_rxIndexMaxSpeed; //!< max speed of the receivers at the last rebuild
 };
 
 } // namespace ns3
@@ -104,10 +104,13 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
     NS_ASSERT_MSG(txParams->psd, "NULL txPsd");
     NS_ASSERT_MSG(txParams->txPhy, "NULL txPhy");
 
-    Ptr<SpectrumSignalParameters> txParamsTrace =
-        txParams->Copy(); // copy it since traced value cannot be const (because of potential
-                          // underlying DynamicCasts)
-    m_txSigParamsTrace(txParamsTrace);
+    if (!m_txSigParamsTrace.IsEmpty())
+    {
+        Ptr<SpectrumSignalParameters> txParamsTrace =
+            txParams->Copy(); // copy it since traced value cannot be const (because of potential
+                              // underlying DynamicCasts)
+        m_txSigParamsTrace(txParamsTrace);
+    }
 
     // just a sanity check routine. We might want to remove it to save some computational load --
     // one "if" statement  ;-)
@@ -148,10 +151,9 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
         if ((*rxPhyIterator) != txParams->txPhy)
         {
             Time delay = MicroSeconds(0);
+            double pathGainLinear = 1.0;
 
             Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility();
-            NS_LOG_LOGIC("copying signal parameters " << txParams);
-            Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
 
             if (senderMobility && receiverMobility)
             {
@@ -159,10 +161,10 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                 double rxAntennaGain = 0;
                 double propagationGainDb = 0;
                 double pathLossDb = 0;
-                if (rxParams->txAntenna)
+                if (txParams->txAntenna)
                 {
                     Angles txAngles(receiverMobility->GetPosition(), senderMobility->GetPosition());
-                    txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
+                    txAntennaGain = txParams->txAntenna->GetGainDb(txAngles);
                     NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
                     pathLossDb -= txAntennaGain;
                 }
@@ -197,8 +199,7 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     // beyond range
                     continue;
                 }
-                double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-                *(rxParams->psd) *= pathGainLinear;
+                pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
 
                 if (m_propagationDelay)
                 {
@@ -206,6 +207,14 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                 }
             }
 
+            // the signal parameters (and their PSD) are copied only for the receivers in range
+            NS_LOG_LOGIC("copying signal parameters " << txParams);
+            Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
+            if (pathGainLinear != 1.0)
+            {
+                *(rxParams->psd) *= pathGainLinear;
+            }
+
             if (rxNetDevice)
             {
                 // the receiver has a NetDevice, so we expect that it is attached to a Node
@@ -87,9 +87,9 @@ struct SpectrumSignalParameters : public SimpleRefCount<SpectrumSignalParameters
      * underwater acoustic communications. Other transmission media to
      * be defined.
      *
-     * \note when SpectrumSignalParameters is copied, only the pointer to the PSD will be copied.
-     * This is because SpectrumChannel objects normally overwrite the psd anyway, so there is no
-     * point in making a copy.
+     * \note when SpectrumSignalParameters is copied, the PSD is copied as well, since each
+     * receiver scales its own copy in place. SpectrumChannel objects therefore copy the
+     * parameters only for the receivers which are within range.
      */
     Ptr<SpectrumValue> psd;
 
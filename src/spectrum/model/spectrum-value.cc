@@ -127,6 +127,46 @@ SpectrumValue::Add(double s)
     }
 }
 
+void
+SpectrumValue::AddScaled(const SpectrumValue& x, double a)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size());
+
+    // plain indexed loop over the raw buffers, so that the compiler can vectorize it
+    double* v = m_values.data();
+    const double* px = x.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] += a * px[i];
+    }
+}
+
+void
+SpectrumValue::SetSinr(const SpectrumValue& signal,
+                       const SpectrumValue& allSignals,
+                       const SpectrumValue& noise)
+{
+    NS_ASSERT(signal.m_spectrumModel == allSignals.m_spectrumModel);
+    NS_ASSERT(signal.m_spectrumModel == noise.m_spectrumModel);
+    NS_ASSERT(signal.m_values.size() == allSignals.m_values.size());
+    NS_ASSERT(signal.m_values.size() == noise.m_values.size());
+
+    m_spectrumModel = signal.m_spectrumModel;
+    m_values.resize(signal.m_values.size());
+
+    double* v = m_values.data();
+    const double* s = signal.m_values.data();
+    const double* all = allSignals.m_values.data();
+    const double* nf = noise.m_values.data();
+    const size_t n = m_values.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] = s[i] / (all[i] - s[i] + nf[i]);
+    }
+}
+
 void
 SpectrumValue::Subtract(const SpectrumValue& x)
 {
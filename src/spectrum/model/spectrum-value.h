@@ -474,6 +474,29 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     SpectrumValue& operator=(double rhs);
 
+    /**
+     * Add each component of x, multiplied by a, to the corresponding
+     * component of *this. No temporary SpectrumValue is created.
+     *
+     * @param x the SpectrumValue to add
+     * @param a the scale factor
+     */
+    void AddScaled(const SpectrumValue& x, double a);
+
+    /**
+     * Set each component of *this to the Signal to Interference plus Noise
+     * Ratio signal / (allSignals - signal + noise), in a single pass and
+     * without creating temporary SpectrumValue instances.
+     *
+     * @param signal the power spectral density of the useful signal
+     * @param allSignals the power spectral density of all the received
+     * signals, including the useful one
+     * @param noise the noise power spectral density
+     */
+    void SetSinr(const SpectrumValue& signal,
+                 const SpectrumValue& allSignals,
+                 const SpectrumValue& noise);
+
     /**
      *
      * @param x the operand
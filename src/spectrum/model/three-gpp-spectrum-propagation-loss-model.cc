@@ -24,6 +24,7 @@
 #include "spectrum-signal-parameters.h"
 #include "three-gpp-channel-model.h"
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/net-device.h"
@@ -42,6 +43,9 @@ NS_LOG_COMPONENT_DEFINE("ThreeGppSpectrumPropagationLossModel");
 NS_OBJECT_ENSURE_REGISTERED(ThreeGppSpectrumPropagationLossModel);
 
 ThreeGppSpectrumPropagationLossModel::ThreeGppSpectrumPropagationLossModel()
+    : m_cacheChannelResponse{false},
+      m_channelResponseCacheHits{0},
+      m_channelResponseCacheMisses{0}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -55,6 +59,7 @@ void
 ThreeGppSpectrumPropagationLossModel::DoDispose()
 {
     m_longTermMap.clear();
+    m_channelResponseMap.clear();
     m_channelModel->Dispose();
     m_channelModel = nullptr;
 }
@@ -73,7 +78,15 @@ ThreeGppSpectrumPropagationLossModel::GetTypeId()
                 StringValue("ns3::ThreeGppChannelModel"),
                 MakePointerAccessor(&ThreeGppSpectrumPropagationLossModel::SetChannelModel,
                                     &ThreeGppSpectrumPropagationLossModel::GetChannelModel),
-                MakePointerChecker<MatrixBasedChannelModel>());
+                MakePointerChecker<MatrixBasedChannelModel>())
+            .AddAttribute(
+                "CacheChannelResponse",
+                "If true, the frequency response of each link is cached and reused by the "
+                "transmissions evaluated over the same link at the same time, with the same "
+                "beams and node speeds",
+                BooleanValue(false),
+                MakeBooleanAccessor(&ThreeGppSpectrumPropagationLossModel::m_cacheChannelResponse),
+                MakeBooleanChecker());
     return tid;
 }
 
@@ -89,6 +102,18 @@ ThreeGppSpectrumPropagationLossModel::GetChannelModel() const
     return m_channelModel;
 }
 
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetChannelResponseCacheHits() const
+{
+    return m_channelResponseCacheHits;
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetChannelResponseCacheMisses() const
+{
+    return m_channelResponseCacheMisses;
+}
+
 double
 ThreeGppSpectrumPropagationLossModel::GetFrequency() const
 {
@@ -205,21 +230,14 @@ ThreeGppSpectrumPropagationLossModel::CalculateLongTermComponent(
     return txSum;
 }
 
-Ptr<SpectrumSignalParameters>
-ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
-    Ptr<const SpectrumSignalParameters> params,
+PhasedArrayModel::ComplexVector
+ThreeGppSpectrumPropagationLossModel::CalcDoppler(
     Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
     Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
     const Vector& sSpeed,
-    const ns3::Vector& uSpeed,
-    uint8_t numTxPorts,
-    uint8_t numRxPorts,
-    bool isReverse) const
-
+    const Vector& uSpeed) const
 {
-    NS_LOG_FUNCTION(this);
-    Ptr<SpectrumSignalParameters> rxParams = params->Copy();
     size_t numCluster = channelMatrix->m_channel.GetNumPages();
     // compute the doppler term
     // NOTE the update of Doppler is simplified by only taking the center angle of
@@ -281,17 +299,122 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     }
 
     NS_ASSERT(numCluster <= doppler.GetSize());
+    return doppler;
+}
+
+Ptr<SpectrumSignalParameters>
+ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
+    Ptr<const SpectrumSignalParameters> params,
+    Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+    const Vector& sSpeed,
+    const ns3::Vector& uSpeed,
+    uint8_t numTxPorts,
+    uint8_t numRxPorts,
+    bool isReverse) const
+
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<SpectrumSignalParameters> rxParams = params->Copy();
+
+    if (!m_cacheChannelResponse)
+    {
+        // set the channel matrix
+        auto doppler = CalcDoppler(longTerm, channelMatrix, channelParams, sSpeed, uSpeed);
+        rxParams->spectrumChannelMatrix = GenSpectrumChannelMatrix(rxParams->psd,
+                                                                   longTerm,
+                                                                   channelMatrix,
+                                                                   channelParams,
+                                                                   doppler,
+                                                                   numTxPorts,
+                                                                   numRxPorts,
+                                                                   isReverse);
+        CalcRxPsd(rxParams);
+        return rxParams;
+    }
 
-    // set the channel matrix
-    rxParams->spectrumChannelMatrix = GenSpectrumChannelMatrix(rxParams->psd,
-                                                               longTerm,
-                                                               channelMatrix,
-                                                               channelParams,
-                                                               doppler,
-                                                               numTxPorts,
-                                                               numRxPorts,
-                                                               isReverse);
+    uint64_t linkId = MatrixBasedChannelModel::GetKey(channelMatrix->m_antennaPair.first,
+                                                      channelMatrix->m_antennaPair.second);
+    Ptr<ChannelResponse>& response = m_channelResponseMap[std::make_pair(linkId, isReverse)];
+    if (response && response->m_longTerm == longTerm &&
+        response->m_channelParams == channelParams && response->m_time == Simulator::Now() &&
+        response->m_sSpeed == sSpeed && response->m_uSpeed == uSpeed &&
+        response->m_spectrumModelUid == rxParams->psd->GetSpectrumModelUid() &&
+        response->m_numTxPorts == numTxPorts && response->m_numRxPorts == numRxPorts)
+    {
+        NS_LOG_DEBUG("reusing the channel response of link " << linkId);
+        m_channelResponseCacheHits++;
+        if (response->m_precodingMatrix == rxParams->precodingMatrix &&
+            response->m_inPsd == rxParams->psd->GetValues())
+        {
+            // same transmission as the last one, the RX PSD is the same as well
+            rxParams->spectrumChannelMatrix = response->m_spectrumChannelMatrix;
+            rxParams->psd->SetValues(response->m_outPsd);
+            return rxParams;
+        }
+    }
+    else
+    {
+        NS_LOG_DEBUG("computing the channel response of link " << linkId);
+        m_channelResponseCacheMisses++;
+        response = Create<ChannelResponse>();
+        response->m_longTerm = longTerm;
+        response->m_channelParams = channelParams;
+        response->m_time = Simulator::Now();
+        response->m_sSpeed = sSpeed;
+        response->m_uSpeed = uSpeed;
+        response->m_spectrumModelUid = rxParams->psd->GetSpectrumModelUid();
+        response->m_numTxPorts = numTxPorts;
+        response->m_numRxPorts = numRxPorts;
+
+        // the response for a unit PSD over all the RBs, so that it can be scaled
+        // by the PSD of any transmission
+        auto unitPsd = Create<SpectrumValue>(rxParams->psd->GetSpectrumModel());
+        (*unitPsd) = 1.0;
+        auto doppler = CalcDoppler(longTerm, channelMatrix, channelParams, sSpeed, uSpeed);
+        response->m_response = *GenSpectrumChannelMatrix(unitPsd,
+                                                         longTerm,
+                                                         channelMatrix,
+                                                         channelParams,
+                                                         doppler,
+                                                         numTxPorts,
+                                                         numRxPorts,
+                                                         isReverse);
+    }
 
+    // scale the response by the square root of the TX PSD, as GenSpectrumChannelMatrix does
+    response->m_inPsd = rxParams->psd->GetValues();
+    auto numRb = response->m_inPsd.size();
+    auto chanSpct =
+        Create<MatrixBasedChannelModel::Complex3DVector>(numRxPorts, numTxPorts, (uint16_t)numRb);
+    for (size_t iRb = 0; iRb < numRb; iRb++)
+    {
+        if (response->m_inPsd[iRb] != 0.00)
+        {
+            auto sqrtVit = sqrt(response->m_inPsd[iRb]);
+            for (auto rxPortIdx = 0; rxPortIdx < numRxPorts; rxPortIdx++)
+            {
+                for (auto txPortIdx = 0; txPortIdx < numTxPorts; txPortIdx++)
+                {
+                    chanSpct->Elem(rxPortIdx, txPortIdx, iRb) =
+                        sqrtVit * response->m_response.Elem(rxPortIdx, txPortIdx, iRb);
+                }
+            }
+        }
+    }
+    rxParams->spectrumChannelMatrix = chanSpct;
+    CalcRxPsd(rxParams);
+
+    response->m_precodingMatrix = rxParams->precodingMatrix;
+    response->m_spectrumChannelMatrix = rxParams->spectrumChannelMatrix;
+    response->m_outPsd = rxParams->psd->GetValues();
+    return rxParams;
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::CalcRxPsd(Ptr<SpectrumSignalParameters> rxParams) const
+{
     // The precoding matrix is not set
     if (!rxParams->precodingMatrix)
     {
@@ -335,7 +458,6 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
             }
         }
     }
-    return rxParams;
 }
 
 Ptr<MatrixBasedChannelModel::Complex3DVector>
@@ -23,6 +23,7 @@
 
 #include "matrix-based-channel-model.h"
 #include "phased-array-spectrum-propagation-loss-model.h"
+#include "spectrum-value.h"
 
 #include "ns3/random-variable-stream.h"
 
@@ -104,6 +105,21 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      */
     void GetChannelModelAttribute(const std::string& name, AttributeValue& value) const;
 
+    /**
+     * \brief Get the number of transmissions which reused a cached channel response
+     *
+     * \return the number of cache hits
+     */
+    uint64_t GetChannelResponseCacheHits() const;
+
+    /**
+     * \brief Get the number of transmissions which generated a new channel response
+     * while the CacheChannelResponse attribute was true
+     *
+     * \return the number of cache misses
+     */
+    uint64_t GetChannelResponseCacheMisses() const;
+
     /**
      * \brief Computes the received PSD.
      *
@@ -117,6 +133,13 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      * To reduce the computational load, the long term component associated with
      * a certain channel is cached and recomputed only when the channel realization
      * is updated, or when the beamforming vectors change.
+     * If the CacheChannelResponse attribute is true, the frequency response of
+     * each link and direction (long term component, delay and Doppler terms) is
+     * also cached, and reused by the other transmissions evaluated over the same
+     * link at the same time instant, with the same beams, node speeds and
+     * SpectrumModel. Only the scaling by the TX PSD is then recomputed, and if
+     * the TX PSD and precoding matrix are also the same, the previous spectrum
+     * channel matrix and RX PSD are reused as they are.
      *
      * \param spectrumSignalParams spectrum signal tx parameters
      * \param a first node mobility model
@@ -170,6 +193,58 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         uint8_t numRxPorts,
         bool isReverse) const;
 
+    /**
+     * Data structure that stores the frequency response of a link, i.e., the
+     * spectrum channel matrix for a unit TX PSD, together with the inputs it
+     * was computed from
+     */
+    struct ChannelResponse : public SimpleRefCount<ChannelResponse>
+    {
+        Ptr<const MatrixBasedChannelModel::Complex3DVector>
+            m_longTerm; //!< the long term component, which identifies channel and beams
+        Ptr<const MatrixBasedChannelModel::ChannelParams>
+            m_channelParams;                   //!< the channel parameters
+        Time m_time;                           //!< the time instant of the Doppler term
+        Vector m_sSpeed;                       //!< the speed of the s node
+        Vector m_uSpeed;                       //!< the speed of the u node
+        SpectrumModelUid_t m_spectrumModelUid; //!< the SpectrumModel of the PSD
+        uint8_t m_numTxPorts;                  //!< the number of TX ports
+        uint8_t m_numRxPorts;                  //!< the number of RX ports
+        MatrixBasedChannelModel::Complex3DVector
+            m_response; //!< the spectrum channel matrix for a unit TX PSD
+        Values m_inPsd; //!< the TX PSD of the last transmission
+        Ptr<const ComplexMatrixArray>
+            m_precodingMatrix; //!< the precoding matrix of the last transmission
+        Ptr<const MatrixBasedChannelModel::Complex3DVector>
+            m_spectrumChannelMatrix; //!< the spectrum channel matrix of the last transmission
+        Values m_outPsd;             //!< the RX PSD of the last transmission
+    };
+
+    /**
+     * \brief Computes the Doppler term of each cluster at the current time
+     *
+     * \param longTerm the long term component
+     * \param channelMatrix the channel matrix structure
+     * \param channelParams the channel parameters
+     * \param sSpeed speed of the first node
+     * \param uSpeed speed of the second node
+     * \return the Doppler term of each cluster
+     */
+    PhasedArrayModel::ComplexVector CalcDoppler(
+        Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+        Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+        const Vector& sSpeed,
+        const Vector& uSpeed) const;
+
+    /**
+     * \brief Computes the RX PSD from the spectrum channel matrix and, if set,
+     * the precoding matrix of the signal parameters
+     *
+     * \param rxParams the RX signal parameters, whose PSD is overwritten
+     */
+    void CalcRxPsd(Ptr<SpectrumSignalParameters> rxParams) const;
+
     /**
      * Get the operating frequency
      * \return the operating frequency in Hz
@@ -249,6 +324,12 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
     mutable std::unordered_map<uint64_t, Ptr<const LongTerm>>
         m_longTermMap;                           //!< map containing the long term components
     Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
+
+    bool m_cacheChannelResponse; //!< whether the channel responses are cached
+    mutable std::map<std::pair<uint64_t, bool>, Ptr<ChannelResponse>>
+        m_channelResponseMap; //!< the last channel response of each link and direction
+    mutable uint64_t m_channelResponseCacheHits;   //!< number of cache hits
+    mutable uint64_t m_channelResponseCacheMisses; //!< number of cache misses
 };
 } // namespace ns3
 
@@ -0,0 +1,220 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/net-device.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/simulator.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/test.h>
+
+#include <ctime>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief SpectrumPhy which only counts the received signals
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     * \param rxModel the Rx SpectrumModel
+     */
+    CountingSpectrumPhy(Ptr<const SpectrumModel> rxModel)
+        : m_rxModel(rxModel)
+    {
+    }
+
+    void SetDevice(Ptr<NetDevice> d) override
+    {
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return nullptr;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel> c) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return m_rxModel;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return nullptr;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> params) override
+    {
+        m_numRx++;
+    }
+
+    uint32_t m_numRx{0}; //!< number of received signals
+
+  private:
+    Ptr<const SpectrumModel> m_rxModel; //!< the Rx SpectrumModel
+    Ptr<MobilityModel> m_mobility;      //!< the mobility model
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Measure the cost of MultiModelSpectrumChannel::StartTx with many receivers
+ *
+ * The receivers are spread uniformly over a square area centered on the
+ * origin, so that the grid of the channel has cells with negative
+ * coordinates, and a subset of them transmits once. With MaxRange set, the test also checks that exactly the
+ * receivers within range get the signals.
+ */
+class SpectrumChannelScalingTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param numPhys the number of SpectrumPhy attached to the channel
+     * \param maxRange the MaxRange attribute of the channel, 0 to disable culling
+     */
+    SpectrumChannelScalingTestCase(uint32_t numPhys, double maxRange)
+        : TestCase("StartTx with " + std::to_string(numPhys) + " receivers, MaxRange " +
+                   std::to_string(static_cast<uint32_t>(maxRange)) + " m"),
+          m_numPhys(numPhys),
+          m_maxRange(maxRange)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_numPhys;                    //!< number of SpectrumPhy
+    double m_maxRange;                     //!< MaxRange of the channel
+    static const uint32_t m_numTx = 50;    //!< number of transmissions
+    static constexpr double m_side = 2000; //!< side of the area, in meters
+};
+
+void
+SpectrumChannelScalingTestCase::DoRun()
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        freqs.push_back(28e9 + i * 1e6);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+
+    Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->SetAttribute("MaxRange", DoubleValue(m_maxRange));
+    channel->AddPropagationLossModel(CreateObject<LogDistancePropagationLossModel>());
+
+    // place the receivers on a regular grid
+    uint32_t perSide = std::ceil(std::sqrt(m_numPhys));
+    double origin = -m_side / 2;
+    std::vector<Ptr<CountingSpectrumPhy>> phys;
+    for (uint32_t i = 0; i < m_numPhys; i++)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(origin + m_side * (i % perSide) / perSide,
+                                     origin + m_side * (i / perSide) / perSide,
+                                     1.5));
+        Ptr<CountingSpectrumPhy> phy = Create<CountingSpectrumPhy>(model);
+        phy->SetMobility(mobility);
+        channel->AddRx(phy);
+        phys.push_back(phy);
+    }
+
+    clock_t start = clock();
+    for (uint32_t i = 0; i < m_numTx; i++)
+    {
+        Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+        params->psd = Create<SpectrumValue>(model);
+        (*params->psd) = 1e-9;
+        params->duration = MicroSeconds(100);
+        params->txPhy = phys[(i * 7919) % m_numPhys];
+        channel->StartTx(params);
+    }
+    Simulator::Run();
+    clock_t elapsed = clock() - start;
+
+    uint32_t numRx = 0;
+    for (const auto& phy : phys)
+    {
+        numRx += phy->m_numRx;
+    }
+    uint32_t expectedRx = 0;
+    for (uint32_t i = 0; i < m_numTx; i++)
+    {
+        Vector txPosition = phys[(i * 7919) % m_numPhys]->GetMobility()->GetPosition();
+        for (const auto& phy : phys)
+        {
+            double distance = CalculateDistance(txPosition, phy->GetMobility()->GetPosition());
+            if (distance > 0 && (m_maxRange == 0 || distance <= m_maxRange))
+            {
+                expectedRx++;
+            }
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(numRx, expectedRx, "Unexpected number of received signals");
+
+    std::cout << GetName() << ": " << numRx << " receptions, "
+              << 1e6 * elapsed / (double(CLOCKS_PER_SEC) * m_numTx) << " us per StartTx"
+              << std::endl;
+
+    channel->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Scaling benchmark of MultiModelSpectrumChannel with and without receiver culling
+ */
+class SpectrumChannelScalingTestSuite : public TestSuite
+{
+  public:
+    SpectrumChannelScalingTestSuite()
+        : TestSuite("spectrum-channel-scaling", Type::PERFORMANCE)
+    {
+        for (uint32_t numPhys : {500, 2000})
+        {
+            AddTestCase(new SpectrumChannelScalingTestCase(numPhys, 0), Duration::QUICK);
+            AddTestCase(new SpectrumChannelScalingTestCase(numPhys, 200), Duration::QUICK);
+        }
+    }
+};
+
+/// Static variable for test initialization
+static SpectrumChannelScalingTestSuite g_spectrumChannelScalingTestSuite;
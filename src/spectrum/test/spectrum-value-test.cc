@@ -226,6 +226,22 @@ SpectrumValueTestSuite::SpectrumValueTestSuite()
     AddTestCase(new SpectrumValueTestCase(tv5, v5, "tv5 *= v2"), TestCase::Duration::QUICK);
     AddTestCase(new SpectrumValueTestCase(tv6, v6, "tv6 div= v2"), TestCase::Duration::QUICK);
 
+    tv3 = v1;
+    tv3.AddScaled(v2, 1.0);
+    AddTestCase(new SpectrumValueTestCase(tv3, v3, "tv3.AddScaled (v2, 1)"),
+                TestCase::Duration::QUICK);
+
+    tv4 = v1;
+    tv4.AddScaled(v2, -1.0);
+    AddTestCase(new SpectrumValueTestCase(tv4, v4, "tv4.AddScaled (v2, -1)"),
+                TestCase::Duration::QUICK);
+
+    // v1 / (v3 - v1 + v1) == v1 / v3
+    SpectrumValue tv11(f);
+    tv11.SetSinr(v1, v3, v1);
+    AddTestCase(new SpectrumValueTestCase(tv11, v1 / v3, "tv11.SetSinr (v1, v3, v1)"),
+                TestCase::Duration::QUICK);
+
     SpectrumValue tv7a(f);
     SpectrumValue tv8a(f);
     SpectrumValue tv9a(f);
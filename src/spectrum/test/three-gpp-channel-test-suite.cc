@@ -17,6 +17,7 @@
 
 #include "ns3/abort.h"
 #include "ns3/angles.h"
+#include "ns3/boolean.h"
 #include "ns3/channel-condition-model.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
@@ -1441,6 +1442,166 @@ ThreeGppMimoPolarizationTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the CacheChannelResponse attribute of
+ * ThreeGppSpectrumPropagationLossModel. It checks that a model caching the
+ * channel responses returns exactly the same spectrum channel matrix and RX
+ * PSD as a model without cache, and that the cache is hit only when the link,
+ * direction, beams and time instant are the same.
+ */
+class ThreeGppChannelResponseCacheTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppChannelResponseCacheTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * Compare the RX signal parameters computed with and without cache
+     * \param cached the parameters computed by the model with cache
+     * \param uncached the parameters computed by the model without cache
+     * \param msg the message to print if they differ
+     */
+    void CheckEqual(Ptr<const SpectrumSignalParameters> cached,
+                    Ptr<const SpectrumSignalParameters> uncached,
+                    const std::string& msg);
+};
+
+ThreeGppChannelResponseCacheTest::ThreeGppChannelResponseCacheTest()
+    : TestCase("Check that caching the channel responses does not change the RX PSD")
+{
+}
+
+void
+ThreeGppChannelResponseCacheTest::CheckEqual(Ptr<const SpectrumSignalParameters> cached,
+                                             Ptr<const SpectrumSignalParameters> uncached,
+                                             const std::string& msg)
+{
+    NS_TEST_ASSERT_MSG_EQ((*cached->psd == *uncached->psd), true, msg << ": different RX PSD");
+    NS_TEST_ASSERT_MSG_EQ((*cached->spectrumChannelMatrix == *uncached->spectrumChannelMatrix),
+                          true,
+                          msg << ": different spectrum channel matrix");
+}
+
+void
+ThreeGppChannelResponseCacheTest::DoRun()
+{
+    Ptr<ThreeGppSpectrumPropagationLossModel> uncachedModel =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    uncachedModel->SetChannelModelAttribute("Frequency", DoubleValue(2.4e9));
+    uncachedModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+    uncachedModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+
+    // the two models share the same channel realizations
+    Ptr<ThreeGppSpectrumPropagationLossModel> cachedModel =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    cachedModel->SetChannelModel(uncachedModel->GetChannelModel());
+    cachedModel->SetAttribute("CacheChannelResponse", BooleanValue(true));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel>();
+    txMob->SetPosition(Vector(0.0, 0.0, 10.0));
+    Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel>();
+    rxMob->SetPosition(Vector(15.0, 0.0, 10.0));
+    nodes.Get(0)->AggregateObject(txMob);
+    nodes.Get(1)->AggregateObject(rxMob);
+
+    Ptr<PhasedArrayModel> txAntenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumColumns",
+        UintegerValue(4),
+        "NumRows",
+        UintegerValue(4),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()),
+        "NumVerticalPorts",
+        UintegerValue(2),
+        "NumHorizontalPorts",
+        UintegerValue(2));
+    Ptr<PhasedArrayModel> rxAntenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumColumns",
+        UintegerValue(2),
+        "NumRows",
+        UintegerValue(2),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()),
+        "NumVerticalPorts",
+        UintegerValue(1),
+        "NumHorizontalPorts",
+        UintegerValue(1));
+    txAntenna->SetBeamformingVector(
+        txAntenna->GetBeamformingVector(Angles(rxMob->GetPosition(), txMob->GetPosition())));
+    rxAntenna->SetBeamformingVector(
+        rxAntenna->GetBeamformingVector(Angles(txMob->GetPosition(), rxMob->GetPosition())));
+
+    SpectrumValue5MhzFactory sf;
+    Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters>();
+    txParams->psd = sf.CreateTxPowerSpectralDensity(0.1, 1);
+    Ptr<SpectrumSignalParameters> lowPowerParams = Create<SpectrumSignalParameters>();
+    lowPowerParams->psd = sf.CreateTxPowerSpectralDensity(0.01, 1);
+
+    // first transmission over the link: miss
+    CheckEqual(
+        cachedModel->DoCalcRxPowerSpectralDensity(txParams, txMob, rxMob, txAntenna, rxAntenna),
+        uncachedModel->DoCalcRxPowerSpectralDensity(txParams, txMob, rxMob, txAntenna, rxAntenna),
+        "First transmission");
+
+    // same transmission: hit, the whole result is reused
+    CheckEqual(
+        cachedModel->DoCalcRxPowerSpectralDensity(txParams, txMob, rxMob, txAntenna, rxAntenna),
+        uncachedModel->DoCalcRxPowerSpectralDensity(txParams, txMob, rxMob, txAntenna, rxAntenna),
+        "Same transmission");
+
+    // different TX PSD: hit, the response is scaled by the new PSD
+    CheckEqual(cachedModel->DoCalcRxPowerSpectralDensity(lowPowerParams,
+                                                         txMob,
+                                                         rxMob,
+                                                         txAntenna,
+                                                         rxAntenna),
+               uncachedModel->DoCalcRxPowerSpectralDensity(lowPowerParams,
+                                                           txMob,
+                                                           rxMob,
+                                                           txAntenna,
+                                                           rxAntenna),
+               "Different TX PSD");
+
+    // reverse direction: miss
+    CheckEqual(
+        cachedModel->DoCalcRxPowerSpectralDensity(txParams, rxMob, txMob, rxAntenna, txAntenna),
+        uncachedModel->DoCalcRxPowerSpectralDensity(txParams, rxMob, txMob, rxAntenna, txAntenna),
+        "Reverse direction");
+
+    // new beam: miss
+    PhasedArrayModel::ComplexVector txBfVector = txAntenna->GetBeamformingVector();
+    txBfVector[0] = std::complex<double>(0.0, 0.0);
+    txAntenna->SetBeamformingVector(txBfVector);
+    CheckEqual(
+        cachedModel->DoCalcRxPowerSpectralDensity(txParams, txMob, rxMob, txAntenna, rxAntenna),
+        uncachedModel->DoCalcRxPowerSpectralDensity(txParams, txMob, rxMob, txAntenna, rxAntenna),
+        "New beam");
+
+    NS_TEST_ASSERT_MSG_EQ(cachedModel->GetChannelResponseCacheHits(), 2, "Unexpected cache hits");
+    NS_TEST_ASSERT_MSG_EQ(cachedModel->GetChannelResponseCacheMisses(),
+                          3,
+                          "Unexpected cache misses");
+    NS_TEST_ASSERT_MSG_EQ(uncachedModel->GetChannelResponseCacheMisses(),
+                          0,
+                          "The cache should be disabled by default");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -1477,6 +1638,7 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest(4, 2, 2, 1),
                 TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppCalcLongTermMultiPortTest(), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppChannelResponseCacheTest(), TestCase::Duration::QUICK);
 
     /**
      *  The TX and RX antennas are configured face-to-face.
@@ -18,8 +18,10 @@
  */
 
 #include "ns3/core-module.h"
+#include "ns3/default-simulator-impl.h"
 
 #include <cmath> // sqrt
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -47,6 +49,68 @@ std::string g_me;
 /** Output field width for numeric data. */
 int g_fwidth = 6;
 
+/** Whether the released events are kept for reuse. */
+bool g_eventPool = true;
+
+/** Slot duration (ns) the event times are aligned to, 0 to disable. */
+uint64_t g_slot = 0;
+
+/** Bytes currently allocated with operator new. */
+std::size_t g_allocatedBytes = 0;
+/** Maximum of g_allocatedBytes since the last reset. */
+std::size_t g_peakAllocatedBytes = 0;
+
+/**
+ * Allocate memory, keeping track of the allocated bytes.
+ *
+ * The size of the block is stored in front of it, to be subtracted when it
+ * is released.
+ *
+ * \param [in] size The size of the block.
+ * \returns The block.
+ */
+void*
+operator new(std::size_t size)
+{
+    void* block = std::malloc(size + alignof(std::max_align_t));
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(block) = size;
+    g_allocatedBytes += size;
+    g_peakAllocatedBytes = std::max(g_peakAllocatedBytes, g_allocatedBytes);
+    return static_cast<char*>(block) + alignof(std::max_align_t);
+}
+
+/**
+ * Release memory allocated by operator new.
+ *
+ * \param [in] p The block.
+ */
+void
+operator delete(void* p) noexcept
+{
+    if (!p)
+    {
+        return;
+    }
+    void* block = static_cast<char*>(p) - alignof(std::max_align_t);
+    g_allocatedBytes -= *static_cast<std::size_t*>(block);
+    std::free(block);
+}
+
+/**
+ * Release memory allocated by operator new.
+ *
+ * \param [in] p The block.
+ */
+void
+operator delete(void* p, std::size_t /* size */) noexcept
+{
+    operator delete(p);
+}
+
 /**
  *  Benchmark instance which can do a single run.
  *
@@ -100,6 +164,16 @@ class Bench
         m_total = total;
     }
 
+    /**
+     * Align the event times to slot boundaries, rounding the delays up to a
+     * multiple of the slot duration, as in slotted models.
+     * \param [in] slot The slot duration in ns, or 0 to keep the delays as is.
+     */
+    void SetSlot(const uint64_t slot)
+    {
+        m_slot = slot;
+    }
+
     /** The output. */
     struct Result
     {
@@ -123,10 +197,18 @@ class Bench
      */
     void Cb();
 
+    /**
+     * Get the delay of the next event.
+     *
+     * \returns The delay, aligned to the slots if requested.
+     */
+    Time NextDelay();
+
     Ptr<RandomVariableStream> m_rand; /**< Stream for event delays. */
     uint64_t m_population;            /**< Event population size. */
     uint64_t m_total;                 /**< Total number of events to execute. */
     uint64_t m_count;                 /**< Count of events executed so far. */
+    uint64_t m_slot{0};               /**< Slot duration (ns), or 0. */
 
 }; // class Bench
 
@@ -143,7 +225,7 @@ Bench::Run()
     timer.Start();
     for (uint64_t i = 0; i < m_population; ++i)
     {
-        Time at = NanoSeconds(m_rand->GetValue());
+        Time at = NextDelay();
         Simulator::Schedule(at, &Bench::Cb, this);
     }
     init = timer.End() / 1000.0;
@@ -170,11 +252,22 @@ Bench::Cb()
     }
     DEB("event at " << Simulator::Now().GetSeconds() << "s");
 
-    Time after = NanoSeconds(m_rand->GetValue());
+    Time after = NextDelay();
     Simulator::Schedule(after, &Bench::Cb, this);
     ++m_count;
 }
 
+Time
+Bench::NextDelay()
+{
+    auto delay = static_cast<uint64_t>(m_rand->GetValue());
+    if (m_slot > 0)
+    {
+        delay = (delay / m_slot + 1) * m_slot;
+    }
+    return NanoSeconds(delay);
+}
+
 /** Benchmark which performs an ensemble of runs. */
 class BenchSuite
 {
@@ -241,6 +334,7 @@ class BenchSuite
 
     std::string m_scheduler;       /**< Descriptive string for the scheduler. */
     std::vector<Result> m_results; /**< Store for the run results. */
+    EventImpl::AllocationStats m_allocations; /**< Event allocations of all the runs. */
 
 }; // BenchSuite
 
@@ -282,11 +376,18 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     {
         m_scheduler += " (default)";
     }
+    if (!g_eventPool)
+    {
+        m_scheduler += ", event free lists disabled";
+    }
+    EventImpl::SetPoolEnabled(g_eventPool);
+    EventImpl::ResetAllocationStats();
 
     Bench bench(pop, total);
     bench.SetRandomStream(eventStream);
     bench.SetPopulation(pop);
     bench.SetTotal(total);
+    bench.SetSlot(g_slot);
 
     m_results.reserve(runs);
     Header();
@@ -305,6 +406,7 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     }
 
     Simulator::Destroy();
+    m_allocations = EventImpl::GetAllocationStats();
 
 } // BenchSuite::Run
 
@@ -331,6 +433,8 @@ BenchSuite::Header() const
 void
 BenchSuite::Log() const
 {
+    LOG("Event allocations: " << m_allocations.allocations << ", from the free lists: "
+                              << m_allocations.poolAllocations);
     if (m_results.size() < 2)
     {
         LOG("");
@@ -387,6 +491,77 @@ BenchSuite::Log() const
 
 } // BenchSuite::Log()
 
+/**
+ * Replay an event trace against a scheduler.
+ *
+ * The events are inserted and removed as in the traced run. Before each
+ * record, the events earlier than the time of the record are removed
+ * from the front of the schedule, as the simulator would have executed them.
+ *
+ * \param [in] factory The factory of the scheduler.
+ * \param [in] records The event trace.
+ * \param [in] runs The number of runs.
+ */
+void
+Replay(ObjectFactory& factory,
+       const std::vector<DefaultSimulatorImpl::EventTraceRecord>& records,
+       uint64_t runs)
+{
+    LOG("");
+    LOG(factory.GetTypeId().GetName());
+    LOG(std::left << std::setw(g_fwidth) << "Run #" << std::left << std::setw(g_fwidth)
+                  << "Time (s)" << std::left << std::setw(g_fwidth) << "Rate (op/s)"
+                  << std::left << std::setw(g_fwidth) << "Per (s/op)" << std::left
+                  << std::setw(g_fwidth) << "Peak events" << std::left << "Peak memory (B)");
+
+    for (uint64_t run = 0; run < runs; ++run)
+    {
+        Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+        std::size_t baseBytes = g_allocatedBytes;
+        g_peakAllocatedBytes = baseBytes;
+        uint64_t operations = 0;
+        uint64_t events = 0;
+        uint64_t peakEvents = 0;
+
+        SystemWallClockMs timer;
+        timer.Start();
+        for (const auto& record : records)
+        {
+            while (!scheduler->IsEmpty() && scheduler->PeekNext().key.m_ts < record.ts)
+            {
+                scheduler->RemoveNext();
+                --events;
+                ++operations;
+            }
+            Scheduler::Event ev = {nullptr,
+                                   {record.ts + record.delay, record.uid, record.context}};
+            if (record.remove)
+            {
+                scheduler->Remove(ev);
+                --events;
+            }
+            else
+            {
+                scheduler->Insert(ev);
+                peakEvents = std::max(peakEvents, ++events);
+            }
+            ++operations;
+        }
+        while (!scheduler->IsEmpty())
+        {
+            scheduler->RemoveNext();
+            ++operations;
+        }
+        double time = timer.End() / 1000.0;
+
+        LOG(std::left << std::setw(g_fwidth) << run << std::left << std::setw(g_fwidth) << time
+                      << std::left << std::setw(g_fwidth) << operations / time << std::left
+                      << std::setw(g_fwidth) << time / operations << std::left
+                      << std::setw(g_fwidth) << peakEvents << std::left
+                      << g_peakAllocatedBytes - baseBytes);
+    }
+}
+
 /**
  *  Create a RandomVariableStream to generate next event delays.
  *
@@ -460,12 +635,15 @@ main(int argc, char* argv[])
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
+    bool schedBatch = false;
 
     uint64_t pop = 100000;
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
     bool calRev = false;
+    bool comparePool = false;
+    std::string replay = "";
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark the simulator scheduler.\n"
@@ -477,8 +655,13 @@ main(int argc, char* argv[])
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
               "\n"
+              "With --replay=\"<filename>\", the schedulers replay instead the\n"
+              "event trace of a simulation, written by DefaultSimulatorImpl when\n"
+              "its EventTraceFile attribute is set.\n"
+              "\n"
               "If no scheduler is specified the MapScheduler will be run.");
     cmd.AddValue("all", "use all schedulers", allSched);
+    cmd.AddValue("batch", "use BatchedHeapScheduler", schedBatch);
     cmd.AddValue("cal", "use CalendarScheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
@@ -490,7 +673,13 @@ main(int argc, char* argv[])
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("replay", "event trace file to replay", replay);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
+    cmd.AddValue("slot", "align the event times to slots of this duration (ns)", g_slot);
+    cmd.AddValue("pool", "keep the released events for reuse", g_eventPool);
+    cmd.AddValue("comparepool",
+                 "run each scheduler without, then with the event free lists",
+                 comparePool);
     cmd.Parse(argc, argv);
 
     g_me = cmd.GetName() + ": ";
@@ -498,60 +687,108 @@ main(int argc, char* argv[])
 
     LOG(std::setprecision(g_fwidth - 6)); // prints blank line
     LOGME(" Benchmark the simulator scheduler");
-    LOG("  Event population size:        " << pop);
-    LOG("  Total events per run:         " << total);
+    if (replay.empty())
+    {
+        LOG("  Event population size:        " << pop);
+        LOG("  Total events per run:         " << total);
+    }
     LOG("  Number of runs per scheduler: " << runs);
+    if (g_slot > 0)
+    {
+        LOG("  Event times aligned to slots: " << g_slot << " ns");
+    }
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedList = schedMap = schedPQ = schedBatch = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ || schedBatch))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
-
-    ObjectFactory factory("ns3::MapScheduler");
-    if (schedCal)
+    if (!replay.empty())
     {
-        factory.SetTypeId("ns3::CalendarScheduler");
-        factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
-        if (allSched)
+        auto records = DefaultSimulatorImpl::ReadEventTrace(replay);
+        LOG("  Event trace:                  " << replay << ", " << records.size()
+                                               << " records");
+        std::vector<std::pair<bool, std::string>> schedulers = {
+            {schedCal, "ns3::CalendarScheduler"},
+            {schedHeap, "ns3::HeapScheduler"},
+            {schedList, "ns3::ListScheduler"},
+            {schedMap, "ns3::MapScheduler"},
+            {schedPQ, "ns3::PriorityQueueScheduler"},
+            {schedBatch, "ns3::BatchedHeapScheduler"},
+        };
+        for (const auto& [enabled, name] : schedulers)
         {
-            factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            if (enabled)
+            {
+                ObjectFactory factory(name);
+                Replay(factory, records, runs);
+            }
         }
+        return 0;
     }
-    if (schedHeap)
-    {
-        factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
-    }
-    if (schedList)
+
+    auto eventStream = GetRandomStream(filename);
+
+    for (bool eventPool : {false, true})
     {
-        factory.SetTypeId("ns3::ListScheduler");
-        auto listTotal = total;
-        if (allSched)
+        if (comparePool)
         {
-            LOG("Running List scheduler with 1/10 total events");
-            listTotal /= 10;
+            g_eventPool = eventPool;
+        }
+        else if (!eventPool)
+        {
+            continue;
+        }
+
+        ObjectFactory factory("ns3::MapScheduler");
+        if (schedCal)
+        {
+            factory.SetTypeId("ns3::CalendarScheduler");
+            factory.Set("Reverse", BooleanValue(calRev));
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+            if (allSched)
+            {
+                factory.Set("Reverse", BooleanValue(!calRev));
+                BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            }
+        }
+        if (schedHeap)
+        {
+            factory.SetTypeId("ns3::HeapScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        }
+        if (schedList)
+        {
+            factory.SetTypeId("ns3::ListScheduler");
+            auto listTotal = total;
+            if (allSched)
+            {
+                LOG("Running List scheduler with 1/10 total events");
+                listTotal /= 10;
+            }
+            BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        }
+        if (schedMap)
+        {
+            factory.SetTypeId("ns3::MapScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        }
+        if (schedPQ)
+        {
+            factory.SetTypeId("ns3::PriorityQueueScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        }
+        if (schedBatch)
+        {
+            factory.SetTypeId("ns3::BatchedHeapScheduler");
+            BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
-    }
-    if (schedMap)
-    {
-        factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
-    }
-    if (schedPQ)
-    {
-        factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
 
     return 0;